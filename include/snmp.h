@@ -6,9 +6,14 @@
 #include <string.h>
 #include <netinet/in.h>
 #include "snmp_mib.h"
+#include "snmp_config.h"
+#include "snmp_cache.h"
+#include "snmp_acl.h"
 
 #define MAX_SNMP_PACKET_SIZE 1500
 #define SNMP_PORT 161
+#define SNMP_MIN_MESSAGE_SIZE 484     // Smallest msgMaxSize / receive buffer (RFC 3417)
+#define SNMP_RESPONSE_RESERVE 72      // Response buffer room above max_response (GETBULK header)
 
 typedef unsigned long oid;
 
@@ -20,6 +25,21 @@ typedef unsigned long oid;
 #define SNMP_ERROR_READ_ONLY       4
 #define SNMP_ERROR_GENERAL_ERROR   5
 
+// SNMPv2 Error Codes (RFC 3416)
+#define SNMP_ERROR_NO_ACCESS             6
+#define SNMP_ERROR_WRONG_TYPE            7
+#define SNMP_ERROR_WRONG_LENGTH          8
+#define SNMP_ERROR_WRONG_ENCODING        9
+#define SNMP_ERROR_WRONG_VALUE           10
+#define SNMP_ERROR_NO_CREATION           11
+#define SNMP_ERROR_INCONSISTENT_VALUE    12
+#define SNMP_ERROR_RESOURCE_UNAVAILABLE  13
+#define SNMP_ERROR_COMMIT_FAILED         14
+#define SNMP_ERROR_UNDO_FAILED           15
+#define SNMP_ERROR_AUTHORIZATION_ERROR   16
+#define SNMP_ERROR_NOT_WRITABLE          17
+#define SNMP_ERROR_INCONSISTENT_NAME     18
+
 // SNMP Exception Codes (for SNMPv2c and SNMPv3)
 #define SNMP_EXCEPTION_NO_SUCH_OBJECT    0x80
 #define SNMP_EXCEPTION_NO_SUCH_INSTANCE  0x81
@@ -32,6 +52,26 @@ typedef unsigned long oid;
 #define SNMPERR_USM_AUTHENTICATIONFAILURE    1406
 #define SNMPERR_USM_NOTINTIMEWINDOW          1407
 #define SNMPERR_USM_DECRYPTIONERROR          1408
+#define SNMPERR_UNKNOWN_CONTEXT              1409   // snmpUnknownContexts (VACM)
+
+#define MAX_VARBINDS 32
+#define SNMP_ENGINE_ID_MAX 32         // SnmpEngineID is 5..32 octets (RFC 3411)
+#define SNMP_ADMIN_STRING_MAX 32      // User and context names (SnmpAdminString, RFC 3414)
+#define VARBIND_OID_MAX 64            // Longest encoded OID accepted in a VarBind
+#define VARBIND_OID_STRING_MAX (VARBIND_OID_MAX * 4 + 8)  // Dotted form of a VarBind OID
+#define VARBIND_STORAGE_SIZE 256      // Encoded OID + value of a VarBind built by the agent
+#define SNMP_USM_PARAMS_MAX 64        // msgAuthenticationParameters / msgPrivacyParameters
+
+// VarBind Structure. oid and value point into the message the VarBind was
+// parsed from (or into caller storage for VarBinds built by the agent), so
+// the list is not copied out of the receive buffer.
+typedef struct {
+    const unsigned char *oid;
+    int oid_len;
+    unsigned char value_type;
+    const unsigned char *value;
+    int value_len;
+} VarBind;
 
 // SNMP Packet Structure
 typedef struct {
@@ -43,20 +83,27 @@ typedef struct {
     int error_index;                   // Error index
     int non_repeaters;                 // For GET-BULK
     int max_repetitions;               // For GET-BULK
-    unsigned char oid[128];            // Requested OID
+    const unsigned char *oid;          // Requested OID (first VarBind, in the request buffer)
     int oid_len;                       // Length of OID
     int varbind_count;                 // Number of VarBinds
+    VarBind varbind_list[MAX_VARBINDS]; // VarBind list (only varbind_count entries are valid)
     // Add additional fields as needed
 } SNMPPacket;
 
-// VarBind Structure
+// Notification to send (Trap, SNMPv2-Trap, InformRequest)
 typedef struct {
-    unsigned char oid[64];
-    int oid_len;
-    unsigned char value_type;
-    unsigned char value[128];
-    int value_len;
-} VarBind;
+    int version;                               // SNMP_VERSION_1 / 2c / 3
+    char security_name[32];                    // Community (v1/v2c) or USM user (v3)
+    unsigned char pdu_type;                    // 0xA7 SNMPv2-Trap, 0xA6 InformRequest (v1 always Trap)
+    unsigned int request_id;                   // Request ID / msgID
+    char trap_oid[64];                         // snmpTrapOID.0 value
+    char enterprise[64];                       // v1 enterprise for generic traps (sysObjectID)
+    unsigned char agent_addr[4];               // v1 agent-addr
+    unsigned long timestamp;                   // sysUpTime (TimeTicks)
+    int varbind_count;                         // Number of VarBinds
+    VarBind varbind_list[MAX_VARBINDS];        // Objects carried by the notification
+    unsigned char storage[MAX_VARBINDS][VARBIND_STORAGE_SIZE]; // Encoded OIDs and values of varbind_list
+} SNMPNotification;
 
 // SNMPv3 Packet Structure
 typedef struct {
@@ -65,49 +112,101 @@ typedef struct {
     unsigned int msgMaxSize;                   // Maximum message size
     unsigned char msgFlags[1];                 // Message flags
     int msgSecurityModel;                      // Security model
-    unsigned char msgAuthoritativeEngineID[128];    // Engine ID
+    unsigned char msgAuthoritativeEngineID[SNMP_ENGINE_ID_MAX];    // Engine ID
     int msgAuthoritativeEngineID_len;          // Length of Engine ID
     int msgAuthoritativeEngineBoots;           // Engine boots
     int msgAuthoritativeEngineTime;            // Engine time
-    char msgUserName[128];                     // User name
-    unsigned char msgAuthenticationParameters[128]; // Authentication parameters
+    char msgUserName[SNMP_ADMIN_STRING_MAX + 1];   // User name
+    const unsigned char *msgAuthenticationParameters; // Authentication parameters (in the request buffer)
     int msgAuthenticationParameters_len;       // Length of authentication parameters
-    unsigned char msgPrivacyParameters[128];   // Privacy parameters
+    const unsigned char *msgPrivacyParameters; // Privacy parameters (in the request buffer)
     int msgPrivacyParameters_len;              // Length of privacy parameters
-    unsigned char contextEngineID[128];        // Context Engine ID
+    unsigned char contextEngineID[SNMP_ENGINE_ID_MAX];   // Context Engine ID
     int contextEngineID_len;                   // Length of context Engine ID
-    char contextName[128];                     // Context name
+    char contextName[SNMP_ADMIN_STRING_MAX + 1];   // Context name
     unsigned char pdu_type;                    // PDU type
     unsigned int request_id;                   // Request ID
     int error_status;                          // Error status
     int error_index;                           // Error index
     int varbind_count;                         // Number of VarBinds
-    VarBind varbind_list[32];                  // VarBind list
+    VarBind varbind_list[MAX_VARBINDS];        // VarBind list
 } SNMPv3Packet;
 
+// Parsed request, reused for every message. Resetting clears the header
+// fields only; VarBinds past varbind_count are stale and never read.
+typedef struct {
+    SNMPPacket packet;                         // SNMPv1/v2c request
+    SNMPv3Packet v3_packet;                    // SNMPv3 request
+} SNMPRequestContext;
+
+// Function to clear a packet before parsing into it (header fields and the first VarBind)
+void snmp_packet_reset(SNMPPacket *packet);
+void snmpv3_packet_reset(SNMPv3Packet *packet);
+
 // char* snmp_version(int version);
 // char* pdu_type_str(unsigned char pdu_type);
 
 // Function to create SNMP response (SNMPv1/v2c)
 void create_snmp_response(SNMPPacket *request_packet, unsigned char *response, int *response_len,
-                          unsigned char *response_oid, int response_oid_len, MIBNode *entry,
+                          const unsigned char *response_oid, int response_oid_len, MIBNode *entry,
                           int error_status, int error_index, int snmp_version);
 
 // Function to create SNMPv3 response
 void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *response, int *response_len,
-                            unsigned char *response_oid, int response_oid_len, MIBNode *entry,
+                            const unsigned char *response_oid, int response_oid_len, MIBNode *entry,
                             int error_status, int error_index);
 
 // Function to create SNMPv3 Report response
 void create_snmpv3_report_response(SNMPv3Packet *request_packet, unsigned char *response, int *response_len, int error);
 
-// Function to create Bulk response (SNMPv2c)
-void create_bulk_response(SNMPPacket *request_packet, unsigned char *response, int *response_len, MIBTree *mib_tree,
-                          int non_repeaters, int max_repetitions);
-
-// Function to handle SNMP request
-void snmp_request(unsigned char *buffer, int n, struct sockaddr_in *cliaddr, int sockfd,
-                  int snmp_version, const char *allowed_community, MIBTree *mib_tree);
+// Function to create Bulk response (SNMPv2c), filling up to max_len bytes
+// (response holds max_len + SNMP_RESPONSE_RESERVE)
+void create_bulk_response(SNMPPacket *request_packet, unsigned char *response, int *response_len, int max_len,
+                          MIBTree *mib_tree, SNMPView *view, int non_repeaters, int max_repetitions);
+
+// Function to create Bulk response (SNMPv3), filling up to max_len bytes
+// (response holds max_len + SNMP_RESPONSE_RESERVE)
+void create_snmpv3_bulk_response(SNMPv3Packet *request_packet, unsigned char *response, int *response_len,
+                                 int max_len, MIBTree *mib_tree, SNMPView *view,
+                                 int non_repeaters, int max_repetitions);
+
+// Function to create a response echoing a VarBind list (SET, SNMPv1/v2c),
+// a tooBig without VarBinds if the list does not fit in max_len bytes
+void create_varbind_list_response(SNMPPacket *request_packet, unsigned char *response, int *response_len,
+                                  int max_len, const VarBind *varbind_list, int varbind_count,
+                                  int error_status, int error_index);
+
+// Function to create a response echoing a VarBind list (SET, SNMPv3),
+// a tooBig without VarBinds if the list does not fit in max_len bytes
+void create_snmpv3_varbind_list_response(SNMPv3Packet *request_packet, unsigned char *response, int *response_len,
+                                         int max_len, const VarBind *varbind_list, int varbind_count,
+                                         int error_status, int error_index);
+
+// Function to encode the current value of a node as a VarBind, the encoded
+// OID and value are written to storage (VARBIND_STORAGE_SIZE bytes)
+int mib_node_to_varbind(const MIBNode *node, VarBind *varbind, unsigned char *storage);
+
+// Function to create a notification message (Trap, SNMPv2-Trap, InformRequest) of at most
+// max_len bytes (message holds max_len + SNMP_RESPONSE_RESERVE)
+int create_notification(const SNMPNotification *notification, unsigned char *message, int *message_len,
+                        int max_len);
+
+// Where the response to a request goes: a datagram back to the client on the
+// agent socket, or the output queue of the client's TCP connection
+typedef struct SNMPTransport {
+    int sockfd;                                   // Socket the request came in on
+    const struct sockaddr_storage *addr;          // Client address
+    unsigned char *response;                      // Response buffer, max_response + SNMP_RESPONSE_RESERVE bytes
+    int max_response;                             // Largest response the client can take
+    int (*send)(void *ctx, const unsigned char *data, int len);   // NULL: sendto() the client
+    void *ctx;
+} SNMPTransport;
+
+// Function to handle SNMP request (version taken from the packet header)
+// (context holds the parsed request, which points into buffer)
+void snmp_request(unsigned char *buffer, int n, const SNMPTransport *transport, SNMPRequestContext *context,
+                  const SNMPAgentConfig *config, SNMPAccessControl *acl, MIBTree *mib_tree,
+                  SNMPResponseCache *cache);
 
 // Utility functions
 void print_snmp_packet(SNMPPacket *snmp_packet);
@@ -0,0 +1,113 @@
+#ifndef SNMP_ACL_H
+#define SNMP_ACL_H
+
+#include "snmp_mib.h"
+#include "snmp_config.h"
+
+#define ACL_OID_MAX        128    // Sub-identifiers of an instance OID
+#define ACL_SUBTREE_MAX    32     // Sub-identifiers of a view subtree (64 character OIDs)
+
+// Per-node view state kept in the view bitmaps
+#define VIEW_NODE_OUT      0      // No instance of the node is in the view
+#define VIEW_NODE_IN       1      // Every instance of the node is in the view
+#define VIEW_NODE_MIXED    2      // A family inside a table entry decides per instance
+
+// View types of a vacmAccessEntry
+#define VACM_VIEW_READ     0
+#define VACM_VIEW_WRITE    1
+#define VACM_VIEW_NOTIFY   2
+#define VACM_VIEW_TYPES    3
+
+// Results of acl_vacm_access (RFC 3415 isAccessAllowed)
+#define VACM_ACCESS_ALLOWED    0
+#define VACM_NO_SUCH_CONTEXT   1
+#define VACM_NO_GROUP_NAME     2
+#define VACM_NO_ACCESS_ENTRY   3
+#define VACM_NO_SUCH_VIEW      4
+
+// vacmViewTreeFamilyEntry: OIDs under subtree, where sub-identifiers whose
+// mask bit is 0 match any value
+typedef struct {
+    unsigned int subtree[ACL_SUBTREE_MAX];
+    int subtree_len;
+    unsigned char mask[VIEW_MASK_MAX];
+    int mask_len;                                 // Missing mask bits are 1
+    int included;
+} ViewFamily;
+
+// View compiled for lookup. Families are sorted most specific first, so the
+// first family matching an OID decides (RFC 3415). Membership of the
+// registry nodes is cached in two bitmaps over the sorted node index: a GET
+// or a GETNEXT step costs one bit test, and only tables with a family inside
+// their entry (VIEW_NODE_MIXED) are checked per instance. The bitmaps depend
+// on node OIDs only and are rebuilt when a node is registered.
+typedef struct {
+    char name[32];
+    ViewFamily families[MAX_VIEW_SUBTREES];
+    int family_count;
+    unsigned long long *in_bits;                  // VIEW_NODE_IN nodes
+    unsigned long long *mixed_bits;               // VIEW_NODE_MIXED nodes
+    int bitmap_words;
+    unsigned int node_epoch;                      // MIBTree.node_epoch the bitmaps were built for
+    int bitmap_valid;
+} SNMPView;
+
+// Roots of the source prefix tries
+#define ACL_TRIE_IPV4      0      // 0.0.0.0/0, IPv4 and IPv4-mapped sources
+#define ACL_TRIE_IPV6      1      // ::/0
+#define ACL_TRIE_ROOTS     2
+
+// Source prefix trie node. A rule of community c ends here if bit c of
+// community_mask is set; rule[c] is its index in the policy.
+typedef struct {
+    int child[2];                                 // 0: none (a root is never a child)
+    unsigned int community_mask;
+    signed char rule[MAX_COMMUNITIES];
+} AclTrieNode;
+
+// Community rules of one version compiled for lookup: the community string
+// is resolved once to an id, then the source address walks the trie and the
+// longest matching prefix of that community wins.
+typedef struct {
+    const SNMPCommunityPolicy *policy;
+    char communities[MAX_COMMUNITIES][32];        // Distinct community strings (id = position)
+    int community_count;
+    AclTrieNode *nodes;                           // nodes[ACL_TRIE_IPV4], nodes[ACL_TRIE_IPV6] are the roots
+    int node_count;
+    int node_capacity;
+    int view_ids[MAX_COMMUNITIES];                // View of each rule: position + 1, 0 whole MIB, -1 unknown (denied)
+} SNMPCommunityAcl;
+
+typedef struct {
+    SNMPView views[MAX_VIEWS];
+    int view_count;
+    SNMPCommunityAcl v1;
+    SNMPCommunityAcl v2c;
+    const SNMPVacmConfig *vacm;                   // NULL: VACM off (no group configured)
+    int vacm_views[MAX_VACM_ACCESS][VACM_VIEW_TYPES]; // View of each access entry: position + 1, 0 none
+} SNMPAccessControl;
+
+// Access granted to one request
+typedef struct {
+    int access;                                   // SNMP_ACCESS_*
+    SNMPView *view;                               // NULL: whole MIB
+    int view_id;                                  // Position of view + 1, 0 for the whole MIB (cache key)
+} AclGrant;
+
+int acl_init(SNMPAccessControl *acl, const SNMPAgentConfig *config);
+
+void acl_close(SNMPAccessControl *acl);
+
+int acl_community_access(SNMPAccessControl *acl, const SNMPCommunityAcl *community_acl,
+                         const char *community, const SNMPHostAddr *source, AclGrant *grant);
+
+int acl_vacm_access(SNMPAccessControl *acl, int security_model, const char *security_name, int security_level,
+                    const char *context, int view_type, AclGrant *grant);
+
+int acl_view_contains(const SNMPView *view, const char *oid);
+
+MIBNode *find_view_instance(MIBTree *mib_tree, SNMPView *view, const char *oid, MIBNode *cell);
+
+MIBNode *find_next_view_instance(MIBTree *mib_tree, SNMPView *view, const char *oid, MIBNode *cell);
+
+#endif // SNMP_ACL_H
@@ -0,0 +1,36 @@
+#ifndef SNMP_ADDR_H
+#define SNMP_ADDR_H
+
+#include <stddef.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#define ADDR_STRING_MAX  INET6_ADDRSTRLEN   // Text form of a host address
+
+// Host part of a transport address. IPv4-mapped IPv6 addresses (::ffff:a.b.c.d,
+// seen on a dual-stack socket) are reduced to IPv4 so a client has the same
+// identity for the rate limiter and the source prefix rules on every socket.
+typedef struct {
+    int family;                        // AF_INET or AF_INET6 (AF_UNSPEC: none)
+    unsigned char bytes[16];           // Network byte order, 4 used for AF_INET
+} SNMPHostAddr;
+
+int addr_parse(const char *text, int default_port, struct sockaddr_storage *addr);
+
+int addr_parse_host(const char *text, SNMPHostAddr *host);
+
+int addr_host(const struct sockaddr_storage *addr, SNMPHostAddr *host);
+
+int addr_port(const struct sockaddr_storage *addr);
+
+socklen_t addr_len(const struct sockaddr_storage *addr);
+
+int addr_equal(const struct sockaddr_storage *a, const struct sockaddr_storage *b);
+
+void addr_to_mapped(const struct sockaddr_storage *addr, struct sockaddr_storage *mapped);
+
+const char *addr_host_string(const SNMPHostAddr *host, char *text, size_t size);
+
+const char *addr_to_string(const struct sockaddr_storage *addr, char *text, size_t size);
+
+#endif // SNMP_ADDR_H
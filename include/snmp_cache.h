@@ -0,0 +1,58 @@
+#ifndef SNMP_CACHE_H
+#define SNMP_CACHE_H
+
+#include "snmp_mib.h"
+
+#define SNMP_CACHE_WAYS      4      // Entries per hash set, replaced in LRU order
+#define SNMP_CACHE_KEY_MAX   256    // Request PDU bytes after the request-id
+#define SNMP_CACHE_MAX_REFS  32     // Scalar nodes an answer may depend on
+
+// One encoded answer. The key is the request PDU after its request-id
+// (error-status/non-repeaters, error-index/max-repetitions and the varbind
+// list), the MIB view it was answered in and the response size limit it was
+// built for (UDP and TCP trim GETBULK answers differently), the body the
+// response PDU after its request-id.
+typedef struct {
+    int in_use;
+    unsigned int hash;
+    int version;                                // Wire version of the request
+    int view_id;                                // MIB view the answer was built in (0: whole MIB)
+    int max_response;                           // Effective response size limit of the request
+    unsigned char pdu_type;                     // GET, GETNEXT or GETBULK
+    unsigned char key[SNMP_CACHE_KEY_MAX];
+    int key_len;
+    unsigned char body[BUFFER_SIZE];
+    int body_len;
+    const MIBNode *refs[SNMP_CACHE_MAX_REFS];   // Nodes whose values are in the body
+    unsigned int ref_seq[SNMP_CACHE_MAX_REFS];  // Their value_seq when the body was encoded
+    int ref_count;
+    int structural;                             // Also depends on which nodes and rows exist
+    unsigned int structure_epoch;               // mib_tree->structure_epoch when encoded
+    unsigned long last_used;
+} SNMPCacheEntry;
+
+// Response cache for pollers that repeat the same request. An entry stays
+// valid while the value_seq of every node it encoded is unchanged, so a
+// hit only needs the new request-id and community/msgID around the body.
+typedef struct {
+    SNMPCacheEntry *entries;
+    int capacity;                               // 0: cache disabled
+    unsigned long clock;                        // LRU clock
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long stores;
+    unsigned long invalidations;
+} SNMPResponseCache;
+
+int response_cache_init(SNMPResponseCache *cache, int entries);
+
+int response_cache_lookup(SNMPResponseCache *cache, const MIBTree *mib_tree, int view_id, int max_response,
+                          const unsigned char *request, int request_len, const unsigned char **body);
+
+void response_cache_store(SNMPResponseCache *cache, MIBTree *mib_tree, int view_id, int max_response,
+                          const unsigned char *request, int request_len,
+                          const unsigned char *response, int response_len);
+
+void response_cache_close(SNMPResponseCache *cache);
+
+#endif // SNMP_CACHE_H
@@ -0,0 +1,311 @@
+#ifndef SNMP_CONFIG_H
+#define SNMP_CONFIG_H
+
+#include "snmp_addr.h"
+
+#define SNMP_CONFIG_FILE     "snmp_agent.conf"
+
+#define MAX_COMMUNITIES      16     // Community rules per version
+#define MAX_USM_USERS        8
+#define MAX_VIEWS            8
+#define MAX_VIEW_SUBTREES    16     // Included/excluded subtrees per view
+#define VIEW_MASK_MAX        16     // vacmViewTreeFamilyMask octets
+#define MAX_VACM_CONTEXTS    8      // Contexts besides the default ""
+#define MAX_VACM_GROUPS      16     // Security name to group mappings
+#define MAX_VACM_ACCESS      16     // Group access entries
+
+// Persistent SET store defaults
+#define SNMP_STORE_JOURNAL_FILE    "snmp_agent.journal"
+#define SNMP_STORE_SNAPSHOT_FILE   "snmp_agent.snap"
+#define SNMP_STORE_FLUSH_INTERVAL  1000          // Group commit interval (ms)
+#define SNMP_STORE_COMPACT_SIZE    (64 * 1024)   // Journal size that triggers compaction (bytes)
+
+// SNMPv3 USM
+#define SNMP_USM_BOOTS_FILE        "snmp_agent.boots" // snmpEngineBoots across restarts
+#define SNMP_USM_KEY_MAX           20            // Localized authentication key (SHA-1 digest)
+#define SNMP_USM_PASSWORD_MIN      8             // Shortest authentication password (RFC 3414 11.2)
+
+// MIB modules
+#define MAX_MIB_DIRS               8
+#define MAX_MIB_MODULES            16
+#define SNMP_MIB_DEFAULT_MODULE    "CAMERA-MIB"  // Loaded when no mib_module is configured
+#define SNMP_MIB_IMAGE_FILE        "snmp_agent.mib" // Precompiled image (make mib)
+
+// Response cache
+#define SNMP_CACHE_ENTRIES         64            // Cached responses, 0 disables the cache
+
+// Per-client rate limit
+#define SNMP_RATE_LIMIT_RATE       50            // Sustained requests per second per client
+#define SNMP_RATE_LIMIT_BURST      100           // Requests accepted back to back
+#define SNMP_RATE_LIMIT_CLIENTS    256           // Clients tracked (LRU replaced)
+
+// Request scheduling
+#define SNMP_SCHED_GET_WEIGHT      4             // Cheap requests served per round
+#define SNMP_SCHED_BULK_WEIGHT     1             // Expensive requests served per round
+#define SNMP_SCHED_BULK_COST       8             // Varbinds x max-repetitions above which a request is expensive
+
+// Agent sockets
+#define MAX_LISTEN_ADDRESSES       4             // Bind addresses (listen directives)
+#define SNMP_UDP_BUFFER            1472          // Largest datagram received or sent (udp_buffer)
+#define SNMP_UDP_BUFFER_MAX        65507         // Largest UDP payload over IPv4
+#define SNMP_PATH_MTU              1500          // Responses fit one IP packet on this MTU
+
+// SNMP over TCP (RFC 3430)
+#define SNMP_TCP_MAX_CONNECTIONS   16            // Open client connections
+#define SNMP_TCP_MAX_MESSAGE       131072        // Largest request or response on a connection
+#define SNMP_TCP_IDLE_TIMEOUT      60000         // Connections idle longer are closed (ms)
+
+// Notification defaults
+#define MAX_TRAP_TARGETS           8
+#define MAX_TRAP_TRIGGERS          16
+#define SNMP_TRAP_PORT             162
+#define SNMP_TRAP_CHECK_INTERVAL   5000          // Trigger evaluation interval (ms)
+#define SNMP_INFORM_TIMEOUT        1000          // First InformRequest retransmit timeout (ms)
+#define SNMP_INFORM_RETRIES        3             // Retransmissions before an inform is given up
+
+// Trigger kinds
+#define TRAP_TRIGGER_ABOVE         0             // INTEGER value rises above a threshold
+#define TRAP_TRIGGER_CHANGE        1             // Value changes
+
+// Wire values of the msgVersion / version field
+#define SNMP_VERSION_1       0
+#define SNMP_VERSION_2c      1
+#define SNMP_VERSION_3       3
+
+// SNMPv3 security levels (msgFlags auth/priv bits)
+#define SNMP_SEC_LEVEL_NOAUTH    0
+#define SNMP_SEC_LEVEL_AUTHNOPRIV 1
+#define SNMP_SEC_LEVEL_AUTHPRIV  3
+
+// Security models (vacmSecurityModel)
+#define SNMP_SEC_MODEL_ANY   0
+#define SNMP_SEC_MODEL_V1    1
+#define SNMP_SEC_MODEL_V2C   2
+#define SNMP_SEC_MODEL_USM   3
+
+// Access rights of a community or USM user
+#define SNMP_ACCESS_NONE        -1
+#define SNMP_ACCESS_READ_ONLY   0
+#define SNMP_ACCESS_READ_WRITE  1
+
+// Community based access policy (SNMPv1, SNMPv2c). A community may have
+// several rules, one per source prefix; the longest matching prefix applies.
+typedef struct {
+    int enabled;                                  // Version enabled flag
+    char communities[MAX_COMMUNITIES][32];        // Accepted community strings
+    int access[MAX_COMMUNITIES];                  // SNMP_ACCESS_READ_ONLY / READ_WRITE
+    SNMPHostAddr source[MAX_COMMUNITIES];         // Source prefix (family AF_UNSPEC: any source)
+    int prefix_len[MAX_COMMUNITIES];              // Source prefix length
+    char view[MAX_COMMUNITIES][32];               // MIB view ("": whole MIB)
+    int community_count;                          // Number of rules
+} SNMPCommunityPolicy;
+
+// MIB view (vacmViewTreeFamilyTable): an OID is in the view if the most
+// specific family matching it is included. A family matches OIDs under its
+// subtree; sub-identifiers whose mask bit is 0 match any value.
+typedef struct {
+    char name[32];
+    char subtrees[MAX_VIEW_SUBTREES][64];         // Subtree OIDs
+    int included[MAX_VIEW_SUBTREES];              // 1: included, 0: excluded
+    unsigned char masks[MAX_VIEW_SUBTREES][VIEW_MASK_MAX]; // Bit 7 of octet 0 is sub-identifier 1
+    int mask_len[MAX_VIEW_SUBTREES];              // Mask octets (0: all ones)
+    int subtree_count;
+} SNMPViewConfig;
+
+// vacmSecurityToGroupTable entry
+typedef struct {
+    int security_model;                           // SNMP_SEC_MODEL_V1 / V2C / USM
+    char security_name[32];                       // Community or USM user
+    char group[32];
+} SNMPVacmGroup;
+
+// vacmAccessTable entry
+typedef struct {
+    char group[32];
+    char context[32];                             // Context name or prefix ("": default context)
+    int security_model;                           // SNMP_SEC_MODEL_* (ANY: every model)
+    int security_level;                           // Minimum SNMP_SEC_LEVEL_*
+    int prefix_match;                             // context is a prefix (vacmAccessContextMatch)
+    char read_view[32];                           // "": no access
+    char write_view[32];
+    char notify_view[32];
+} SNMPVacmAccess;
+
+// View-based access control of SNMPv3 requests (RFC 3415). Off while no
+// group is configured; USM users then keep their ro/rw access to the whole MIB.
+typedef struct {
+    char contexts[MAX_VACM_CONTEXTS][32];         // vacmContextTable besides ""
+    int context_count;
+    SNMPVacmGroup groups[MAX_VACM_GROUPS];
+    int group_count;
+    SNMPVacmAccess access[MAX_VACM_ACCESS];
+    int access_count;
+} SNMPVacmConfig;
+
+// SNMPv3 USM user
+typedef struct {
+    char user_name[32];                           // msgUserName
+    int security_level;                           // SNMP_SEC_LEVEL_*
+    int access;                                   // SNMP_ACCESS_READ_ONLY / READ_WRITE
+    char auth_protocol[16];                       // MD5, SHA
+    char auth_password[64];
+    char priv_protocol[16];                       // DES, AES
+    char priv_password[64];
+    int auth_algorithm;                           // USM_AUTH_* (snmp_usm.h)
+    unsigned char auth_key[SNMP_USM_KEY_MAX];     // auth_password localized to the engine ID (usm_init)
+} SNMPUsmUser;
+
+// User based access policy (SNMPv3)
+typedef struct {
+    int enabled;                                  // Version enabled flag
+    SNMPUsmUser users[MAX_USM_USERS];             // Accepted USM users
+    int user_count;                               // Number of users
+    char boots_path[128];                         // File keeping snmpEngineBoots
+} SNMPUsmPolicy;
+
+// Write-behind store for committed SET values
+typedef struct {
+    int enabled;                                  // Persist SET values
+    char journal_path[128];                       // Append-only journal of committed SETs
+    char snapshot_path[128];                      // Compacted snapshot
+    int flush_interval_ms;                        // Group commit interval
+    long compact_size;                            // Journal size that triggers compaction
+} SNMPStoreConfig;
+
+// Notification receiver
+typedef struct {
+    int version;                                  // SNMP_VERSION_1 / 2c / 3
+    char host[64];                                // Receiver address as configured
+    struct sockaddr_storage addr;                 // Receiver address and port (162)
+    char security_name[32];                       // Community (v1/v2c) or USM user (v3)
+    int inform;                                   // Send acknowledged InformRequests
+} SNMPTrapTarget;
+
+// Notification trigger on an existing MIB node
+typedef struct {
+    char node_name[32];                           // Watched node
+    int kind;                                     // TRAP_TRIGGER_ABOVE / TRAP_TRIGGER_CHANGE
+    int threshold;                                // For TRAP_TRIGGER_ABOVE
+} SNMPTrapTrigger;
+
+typedef struct {
+    SNMPTrapTarget targets[MAX_TRAP_TARGETS];
+    int target_count;
+    SNMPTrapTrigger triggers[MAX_TRAP_TRIGGERS];
+    int trigger_count;
+    int check_interval_ms;                        // Trigger evaluation interval
+    int inform_timeout_ms;                        // First retransmit timeout, doubled per retry
+    int inform_retries;                           // Retransmissions per inform
+} SNMPTrapConfig;
+
+// SMIv2 modules served by the agent
+typedef struct {
+    char dirs[MAX_MIB_DIRS][128];                 // Module search directories (default ".")
+    int dir_count;
+    char modules[MAX_MIB_MODULES][64];            // Module names or file paths
+    int module_count;
+    char image_path[128];                         // Precompiled image, "" to always parse modules
+} SNMPMibConfig;
+
+// Encoded response cache for repeated polls
+typedef struct {
+    int entries;                                  // Cached responses (0: off)
+} SNMPCacheConfig;
+
+// Token bucket per source address
+typedef struct {
+    int rate;                                     // Requests per second (0: off)
+    int burst;                                    // Bucket size in requests
+    int clients;                                  // Tracked clients
+} SNMPRateLimitConfig;
+
+// Weighted service of cheap and expensive requests
+typedef struct {
+    int get_weight;                               // GET class share of a round
+    int bulk_weight;                              // GETBULK/walk class share of a round
+    int bulk_cost;                                // Estimated varbinds above which a request is bulk
+} SNMPSchedConfig;
+
+// Log output
+typedef struct {
+    int console;                                  // Write messages to stdout
+    int syslog;                                   // Write messages to syslog (LOG_DAEMON)
+} SNMPLogConfig;
+
+// Agent sockets
+typedef struct {
+    char addresses[MAX_LISTEN_ADDRESSES][64];     // Bind addresses (none: [::] dual stack, else 0.0.0.0)
+    int address_count;
+    int ipv6_only;                                // IPV6_V6ONLY on IPv6 sockets
+    int udp_buffer;                               // Receive buffer and largest response
+    int path_mtu;                                 // Response limit in IP packet size (0: udp_buffer only)
+} SNMPListenConfig;
+
+// TCP listener (off while no tcp_listen address is configured)
+typedef struct {
+    char addresses[MAX_LISTEN_ADDRESSES][64];     // Bind addresses
+    int address_count;
+    int max_connections;                          // Open client connections
+    int max_message;                              // Largest message in bytes
+    int idle_timeout_ms;                          // Idle connection timeout
+} SNMPTcpConfig;
+
+// Agent configuration shared by every request
+typedef struct {
+    SNMPListenConfig listen;                      // Agent sockets
+    SNMPTcpConfig tcp;                            // TCP transport
+    SNMPCommunityPolicy v1;                       // SNMPv1 policy
+    SNMPCommunityPolicy v2c;                      // SNMPv2c policy
+    SNMPUsmPolicy v3;                             // SNMPv3 policy
+    SNMPStoreConfig store;                        // SET persistence
+    SNMPTrapConfig trap;                          // Notification targets and triggers
+    SNMPMibConfig mib;                            // Loaded MIB modules
+    SNMPCacheConfig cache;                        // Response cache
+    SNMPRateLimitConfig rate_limit;               // Request storm protection
+    SNMPSchedConfig sched;                        // Request scheduling
+    SNMPLogConfig log;                            // Log output
+    SNMPViewConfig views[MAX_VIEWS];              // MIB views of community rules and VACM
+    int view_count;
+    SNMPVacmConfig vacm;                          // SNMPv3 groups and access entries
+} SNMPAgentConfig;
+
+void init_agent_config(SNMPAgentConfig *config);
+
+int add_listen_address(SNMPListenConfig *listen, const char *address);
+
+int add_tcp_listen_address(SNMPTcpConfig *tcp, const char *address);
+
+int add_community(SNMPCommunityPolicy *policy, const char *community, int access);
+
+int add_community_rule(SNMPCommunityPolicy *policy, const char *community, int access,
+                       const char *source, const char *view);
+
+int add_view_subtree(SNMPAgentConfig *config, const char *view, const char *type, const char *subtree,
+                     const char *mask);
+
+int add_vacm_context(SNMPVacmConfig *vacm, const char *context);
+
+int add_vacm_group(SNMPVacmConfig *vacm, const char *group, const char *security_model, const char *security_name);
+
+int add_vacm_access(SNMPVacmConfig *vacm, const char *group, const char *context, const char *security_model,
+                    const char *security_level, const char *match, const char *read_view,
+                    const char *write_view, const char *notify_view);
+
+int add_usm_user(SNMPUsmPolicy *policy, const char *user_name, const char *security_level,
+                 const char *auth_protocol, const char *auth_password,
+                 const char *priv_protocol, const char *priv_password);
+
+int parse_security_level(const char *security_level);
+
+int load_agent_config(const char *path, SNMPAgentConfig *config);
+
+int add_trap_target(SNMPTrapConfig *trap, const char *version, const char *address, const char *security_name,
+                    int inform);
+
+int add_trap_trigger(SNMPTrapConfig *trap, const char *node_name, int kind, int threshold);
+
+const SNMPUsmUser *find_usm_user(const SNMPUsmPolicy *policy, const char *user_name);
+
+void print_agent_config(const SNMPAgentConfig *config);
+
+#endif // SNMP_CONFIG_H
@@ -0,0 +1,50 @@
+#ifndef SNMP_CPUSTAT_H
+#define SNMP_CPUSTAT_H
+
+#include "snmp_mib.h"
+#include "snmp_table.h"
+#include "snmp_event.h"
+
+#define CPUSTAT_CORE_ENTRY_OID "1.3.6.1.4.1.127.1.2.7.1"   // cpuCoreEntry (systemInfo.7.1)
+#define CPUSTAT_USAGE_OID      "1.3.6.1.4.1.127.1.2.3"     // cpuUsage (systemInfo.3)
+#define CPUSTAT_PROC_STAT      "/proc/stat"
+
+#define CPUSTAT_MAX_CPUS     64
+#define CPUSTAT_SAMPLE_MS    1000
+#define CPUSTAT_RING_SIZE    512    // Samples kept, power of two above the longest window
+#define CPUSTAT_WINDOW_5SEC  5      // Window lengths in samples
+#define CPUSTAT_WINDOW_1MIN  60
+#define CPUSTAT_WINDOW_5MIN  300
+
+// Busy time of every core over one sample period, in 1/1000
+typedef struct {
+    unsigned short load[CPUSTAT_MAX_CPUS];
+} CpuSample;
+
+// Per-core utilization computed from /proc/stat deltas once per second.
+// The sampler is the only writer of the ring: it fills the slot at head
+// and then publishes head (release), readers load head (acquire) and
+// only read the slots behind it, so neither side takes a lock.
+typedef struct {
+    MIBTable table;                     // cpuCoreTable
+    CpuSample ring[CPUSTAT_RING_SIZE];
+    unsigned int head;                  // Samples published so far
+    unsigned char online[CPUSTAT_MAX_CPUS];
+    unsigned int since[CPUSTAT_MAX_CPUS];      // First sample of the core's current window
+    unsigned long long busy[CPUSTAT_MAX_CPUS];  // Counters of the previous sample
+    unsigned long long total[CPUSTAT_MAX_CPUS];
+    EventLoop *loop;
+    int timer_id;
+} CpuStat;
+
+int cpustat_init(CpuStat *cpustat, MIBTree *mib_tree, EventLoop *loop);
+
+void cpustat_sample(void *ctx);
+
+int cpustat_window(const CpuStat *cpustat, int cpu, int samples, int *average, int *max);
+
+int cpustat_usage(const CpuStat *cpustat, int samples);
+
+void cpustat_close(CpuStat *cpustat);
+
+#endif // SNMP_CPUSTAT_H
@@ -0,0 +1,59 @@
+#ifndef SNMP_EVENT_H
+#define SNMP_EVENT_H
+
+#include <poll.h>
+#include <signal.h>
+
+#define MAX_EVENT_FDS     64
+#define MAX_EVENT_TIMERS  16
+
+// fd 이벤트 콜백 (revents: POLLIN, POLLOUT, ...)
+typedef void (*EventFdHandler)(int fd, short revents, void *ctx);
+
+// 타이머 콜백
+typedef void (*EventTimerHandler)(void *ctx);
+
+typedef struct {
+    int fd;                       // Watched file descriptor
+    short events;                 // poll() events of interest
+    EventFdHandler handler;       // Callback
+    void *ctx;                    // Callback context
+} EventFd;
+
+typedef struct {
+    int active;                   // 0: free slot
+    long interval_ms;             // Period, 0 for a one-shot timer
+    long long expire_ms;          // Next expiry (monotonic clock)
+    EventTimerHandler handler;    // Callback
+    void *ctx;                    // Callback context
+} EventTimer;
+
+// Single threaded poll() loop shared by the agent socket and periodic work
+typedef struct {
+    EventFd fds[MAX_EVENT_FDS];
+    int fd_count;
+    EventTimer timers[MAX_EVENT_TIMERS];
+    volatile sig_atomic_t running;  // Cleared by event_loop_stop()
+} EventLoop;
+
+void event_loop_init(EventLoop *loop);
+
+long long event_loop_now_ms(void);
+
+long long event_loop_now_us(void);
+
+int event_loop_add_fd(EventLoop *loop, int fd, short events, EventFdHandler handler, void *ctx);
+
+int event_loop_set_fd_events(EventLoop *loop, int fd, short events);
+
+void event_loop_remove_fd(EventLoop *loop, int fd);
+
+int event_loop_add_timer(EventLoop *loop, long delay_ms, long interval_ms, EventTimerHandler handler, void *ctx);
+
+void event_loop_cancel_timer(EventLoop *loop, int timer_id);
+
+void event_loop_run(EventLoop *loop);
+
+void event_loop_stop(EventLoop *loop);
+
+#endif // SNMP_EVENT_H
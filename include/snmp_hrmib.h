@@ -0,0 +1,101 @@
+#ifndef SNMP_HRMIB_H
+#define SNMP_HRMIB_H
+
+#include "snmp_mib.h"
+#include "snmp_table.h"
+
+#define HRMIB_SYSTEM_OID          "1.3.6.1.2.1.25.1"
+#define HRMIB_MEMORY_SIZE_OID     "1.3.6.1.2.1.25.2.2.0"
+#define HRMIB_STORAGE_ENTRY_OID   "1.3.6.1.2.1.25.2.3.1"
+#define HRMIB_DEVICE_ENTRY_OID    "1.3.6.1.2.1.25.3.2.1"
+#define HRMIB_PROCESSOR_ENTRY_OID "1.3.6.1.2.1.25.3.3.1"
+
+#define HRMIB_PROC_STAT       "/proc/stat"
+#define HRMIB_PROC_MEMINFO    "/proc/meminfo"
+#define HRMIB_PROC_MTD        "/proc/mtd"
+#define HRMIB_PROC_MOUNTS     "/proc/mounts"
+#define HRMIB_PROC_PARTITIONS "/proc/partitions"
+#define HRMIB_PROC_CPUINFO    "/proc/cpuinfo"
+#define HRMIB_PID_MAX         "/proc/sys/kernel/pid_max"
+
+#define HRMIB_MAX_CPUS    64
+#define HRMIB_MAX_STORAGE 64
+#define HRMIB_MAX_DEVICES (HRMIB_MAX_CPUS + 32)
+
+// hrDeviceIndex ranges per device type (processor and disk bases as in net-snmp)
+#define HRMIB_DEVICE_PROCESSOR 768     // + N of cpuN
+#define HRMIB_DEVICE_MTD       1536    // + N of mtdN
+#define HRMIB_DEVICE_MMC       1600    // + N of mmcblkN
+#define HRMIB_DEVICE_SD        1664    // + letter of sdX
+
+// hrStorageIndex of the memory rows (same numbering as net-snmp), file
+// systems are numbered from HRMIB_STORAGE_FS_INDEX
+#define HRMIB_STORAGE_RAM      1
+#define HRMIB_STORAGE_VIRTUAL  3
+#define HRMIB_STORAGE_BUFFERS  6
+#define HRMIB_STORAGE_CACHED   7
+#define HRMIB_STORAGE_SWAP     10
+#define HRMIB_STORAGE_FS_INDEX 31
+
+typedef struct {
+    unsigned int index;                 // hrStorageIndex
+    const char *type;                   // hrStorageType (AutonomousType OID)
+    char descr[64];                     // hrStorageDescr (mount point for file systems)
+    int units;                          // hrStorageAllocationUnits in bytes
+    int size;                           // hrStorageSize in units
+    int used;                           // hrStorageUsed in units
+} HrStorage;
+
+typedef struct {
+    unsigned int index;                 // hrDeviceIndex
+    const char *type;                   // hrDeviceType
+    char descr[64];                     // hrDeviceDescr
+    int load;                           // hrProcessorLoad (processors only)
+} HrDevice;
+
+// One sample of every /proc source, taken once per interval
+typedef struct {
+    unsigned long uptime;               // hrSystemUptime
+    unsigned char date[11];             // hrSystemDate (DateAndTime)
+    unsigned int users;
+    unsigned int processes;
+    int max_processes;
+    int memory_kb;                      // hrMemorySize
+    int cpu_count;
+    int cpu_number[HRMIB_MAX_CPUS];     // N of the /proc/stat "cpuN" line
+    unsigned long long cpu_busy[HRMIB_MAX_CPUS];
+    unsigned long long cpu_total[HRMIB_MAX_CPUS];
+    HrStorage storage[HRMIB_MAX_STORAGE];
+    int storage_count;
+    HrDevice devices[HRMIB_MAX_DEVICES];
+    int device_count;
+} HrSnapshot;
+
+// HOST-RESOURCES-MIB hrSystem, hrStorageTable, hrDeviceTable and
+// hrProcessorTable served from the current snapshot. The tables only
+// read the snapshot, so the cost per poll does not depend on the number
+// of requests.
+typedef struct {
+    MIBTable storage_table;
+    MIBTable device_table;
+    MIBTable processor_table;
+    MIBNode *system_uptime;
+    MIBNode *system_date;
+    MIBNode *system_users;
+    MIBNode *system_processes;
+    MIBNode *system_max_processes;
+    MIBNode *memory_size;
+    HrSnapshot snapshots[2];
+    HrSnapshot *current;                // Rows point into this snapshot
+    unsigned int next_fs_index;         // Next hrStorageIndex for a new mount point
+    char cpu_descr[64];                 // From /proc/cpuinfo, read once
+    unsigned long refresh_count;
+} HrMib;
+
+int hrmib_init(HrMib *hrmib, MIBTree *mib_tree);
+
+int hrmib_refresh(HrMib *hrmib);
+
+void hrmib_close(HrMib *hrmib);
+
+#endif // SNMP_HRMIB_H
@@ -0,0 +1,63 @@
+#ifndef SNMP_IFMIB_H
+#define SNMP_IFMIB_H
+
+#include <net/if.h>
+
+#include "snmp_mib.h"
+#include "snmp_table.h"
+
+#define IFMIB_IF_NUMBER_OID  "1.3.6.1.2.1.2.1.0"
+#define IFMIB_IF_ENTRY_OID   "1.3.6.1.2.1.2.2.1"
+#define IFMIB_IFX_ENTRY_OID  "1.3.6.1.2.1.31.1.1.1"
+#define IFMIB_PROC_NET_DEV   "/proc/net/dev"
+#define IFMIB_SYS_CLASS_NET  "/sys/class/net"
+#define IFMIB_NETLINK_BUFFER (32 * 1024)
+
+// One interface as sampled by the last refresh
+typedef struct {
+    unsigned int index;                 // ifIndex (kernel ifindex)
+    char name[IF_NAMESIZE];             // ifDescr / ifName
+    char alias[64];                     // ifAlias
+    int type;                           // IANAifType
+    int mtu;
+    unsigned int speed_mbps;            // From sysfs, re-read on link changes only
+    unsigned char phys_address[8];
+    int phys_address_len;
+    int admin_status;                   // up(1), down(2)
+    int oper_status;                    // RFC 2863 ifOperStatus
+    int promiscuous;
+    unsigned long last_change;          // sysUpTime of the last ifOperStatus change
+    unsigned long long rx_bytes;
+    unsigned long long rx_packets;
+    unsigned long long rx_multicast;
+    unsigned long long rx_errors;
+    unsigned long long rx_dropped;
+    unsigned long long tx_bytes;
+    unsigned long long tx_packets;
+    unsigned long long tx_errors;
+    unsigned long long tx_dropped;
+} IfEntry;
+
+// IF-MIB ifTable / ifXTable served from a snapshot taken once per sampling
+// interval (one RTM_GETLINK dump, or one read of /proc/net/dev if netlink is
+// unavailable). GET/GETNEXT/GETBULK only read the snapshot.
+typedef struct {
+    MIBTable if_table;
+    MIBTable ifx_table;
+    MIBNode *if_number;                 // ifNumber.0
+    int netlink_fd;                     // -1: /proc/net/dev fallback
+    unsigned int netlink_seq;
+    IfEntry *entries;                   // Current snapshot, sorted by ifIndex
+    int entry_count;
+    IfEntry *next;                      // Snapshot being built
+    int capacity;                       // Allocated entries in both buffers
+    unsigned long refresh_count;
+} IfMib;
+
+int ifmib_init(IfMib *ifmib, MIBTree *mib_tree);
+
+int ifmib_refresh(IfMib *ifmib);
+
+void ifmib_close(IfMib *ifmib);
+
+#endif // SNMP_IFMIB_H
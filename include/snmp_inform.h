@@ -0,0 +1,51 @@
+#ifndef SNMP_INFORM_H
+#define SNMP_INFORM_H
+
+#include <netinet/in.h>
+
+#include "snmp.h"
+#include "snmp_trap.h"
+
+#define INFORM_TABLE_SIZE  256   // Outstanding InformRequests (power of two)
+
+// InformRequest waiting for its Response
+typedef struct {
+    int in_use;
+    unsigned int request_id;
+    int target;                        // Index into SNMPTrapConfig.targets
+    int retries_left;                  // Retransmissions left
+    long timeout_ms;                   // Current timeout, doubled per retransmit
+    long long deadline_ms;             // Next retransmit (monotonic clock)
+    int heap_pos;                      // Position in the deadline heap
+    int len;
+    unsigned char *data;               // Encoded message, resent unchanged (notifier max_message bytes)
+} InformEntry;
+
+// In-flight table. The slot of an inform is request_id % INFORM_TABLE_SIZE;
+// request IDs are allocated sequentially, so a busy slot holds an older inform,
+// which is dropped (drop-oldest policy). Retransmit deadlines are kept in a
+// min-heap served by a single one-shot event loop timer.
+typedef struct SNMPInformTable {
+    SNMPNotifier *notifier;
+    InformEntry entries[INFORM_TABLE_SIZE];
+    int heap[INFORM_TABLE_SIZE];       // Slots ordered by deadline_ms
+    int count;                         // Outstanding informs
+    int timer_id;                      // Timer for heap[0], -1 if not armed
+    unsigned long acked_count;         // Informs acknowledged
+    unsigned long retransmit_count;    // Retransmissions sent
+    unsigned long failed_count;        // Informs given up after the last retry
+    unsigned long drop_count;          // Informs evicted from a full table
+    unsigned char *pool;               // Message storage of every entry
+} SNMPInformTable;
+
+int inform_table_init(SNMPInformTable *table, SNMPNotifier *notifier);
+
+void inform_table_close(SNMPInformTable *table);
+
+int inform_send(SNMPInformTable *table, int target, unsigned int request_id,
+                const unsigned char *data, int len);
+
+int inform_handle_response(SNMPInformTable *table, unsigned char *buffer, int n,
+                           const struct sockaddr_storage *from);
+
+#endif // SNMP_INFORM_H
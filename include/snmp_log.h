@@ -0,0 +1,80 @@
+#ifndef SNMP_LOG_H
+#define SNMP_LOG_H
+
+#include "snmp_event.h"
+
+// Levels use the syslog priority values
+#define SNMP_LOG_ERROR     3
+#define SNMP_LOG_WARN      4
+#define SNMP_LOG_INFO      6
+#define SNMP_LOG_DEBUG     7
+
+// Most verbose level compiled in (make LOG_LEVEL=7 for debug dumps). Calls
+// above it are still type checked but generate no code.
+#ifndef SNMP_LOG_LEVEL
+#define SNMP_LOG_LEVEL     SNMP_LOG_INFO
+#endif
+
+// Output targets (log_target directive)
+#define SNMP_LOG_CONSOLE   0x01
+#define SNMP_LOG_SYSLOG    0x02
+
+#define SNMP_LOG_RING_SIZE   64     // Messages waiting to be written
+#define SNMP_LOG_LINE_MAX    160    // Message length, longer ones are truncated
+#define SNMP_LOG_FLUSH_MS    100    // Delay before queued messages are written
+#define SNMP_LOG_FLUSH_BATCH 16     // Messages written per flush
+#define SNMP_LOG_RATE        10     // Warnings and below per second
+#define SNMP_LOG_BURST       20     // Warnings and below accepted back to back
+
+typedef struct {
+    int level;
+    char text[SNMP_LOG_LINE_MAX];
+} LogEntry;
+
+// Messages are formatted into a ring and written from the event loop, so a
+// slow console never blocks request processing. Everything below error is
+// rate limited; dropped messages are reported as a count.
+typedef struct {
+    LogEntry entries[SNMP_LOG_RING_SIZE];
+    int head;
+    int count;
+    int targets;                       // SNMP_LOG_CONSOLE | SNMP_LOG_SYSLOG
+    EventLoop *loop;                   // NULL: write synchronously (startup, shutdown)
+    int flush_timer_id;                // Pending flush, -1 if none
+    long long tokens;                  // Rate limit tokens (1/1000 message units)
+    long long last_ms;
+    unsigned long suppressed_count;    // Rate limited since the last report
+    unsigned long dropped_count;       // Lost on a full ring since the last report
+} SNMPLog;
+
+void log_init(int targets);
+
+void log_attach(EventLoop *loop);
+
+void log_flush(void);
+
+void log_close(void);
+
+void snmp_log(int level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+#define log_error(...) snmp_log(SNMP_LOG_ERROR, __VA_ARGS__)
+
+#if SNMP_LOG_LEVEL >= SNMP_LOG_WARN
+#define log_warn(...)  snmp_log(SNMP_LOG_WARN, __VA_ARGS__)
+#else
+#define log_warn(...)  do { if (0) snmp_log(0, __VA_ARGS__); } while (0)
+#endif
+
+#if SNMP_LOG_LEVEL >= SNMP_LOG_INFO
+#define log_info(...)  snmp_log(SNMP_LOG_INFO, __VA_ARGS__)
+#else
+#define log_info(...)  do { if (0) snmp_log(0, __VA_ARGS__); } while (0)
+#endif
+
+#if SNMP_LOG_LEVEL >= SNMP_LOG_DEBUG
+#define log_debug(...) snmp_log(SNMP_LOG_DEBUG, __VA_ARGS__)
+#else
+#define log_debug(...) do { if (0) snmp_log(0, __VA_ARGS__); } while (0)
+#endif
+
+#endif // SNMP_LOG_H
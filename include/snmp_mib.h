@@ -6,7 +6,8 @@
 #include <string.h>
 
 #define BUFFER_SIZE 1024
-#define MAX_NODES 100
+#define MIB_TREE_INITIAL_CAPACITY 64   // Registry grows by doubling
+#define MIB_OID_BER_MAX 64             // Encoded form of a MIBNode.oid (128 characters)
 
 #define HANDLER_CAN_RONLY  0  // Read-only access
 #define HANDLER_CAN_RWRITE 1  // Read-write access
@@ -16,23 +17,66 @@ typedef enum {
     VALUE_TYPE_STRING,
     VALUE_TYPE_OID,
     VALUE_TYPE_TIME_TICKS,
+    VALUE_TYPE_COUNTER32,
+    VALUE_TYPE_GAUGE32,               // Gauge32 / Unsigned32
+    VALUE_TYPE_COUNTER64,
+    VALUE_TYPE_OCTETS,                // Binary OCTET STRING (PhysAddress, ...)
     // Add other types as needed
 } ValueType;
 
+#define MIB_OCTETS_MAX 120
+
+typedef union {
+    int int_value;                    // INTEGER value
+    char str_value[128];              // STRING value
+    unsigned long ticks_value;        // TimeTicks value
+    char oid_value[128];              // OID value
+    unsigned int uint_value;          // Counter32 / Gauge32 value
+    unsigned long long counter64_value; // Counter64 value
+    struct {
+        unsigned char data[MIB_OCTETS_MAX];
+        int len;
+    } octets;                         // Binary OCTET STRING value
+    // Add other value types as needed
+} MIBValue;
+
+// SET processing phases passed to a node's write handler
+#define MIB_SET_ACTION_CHECK   0  // Validate the new value, no side effects
+#define MIB_SET_ACTION_COMMIT  1  // Apply the new value
+#define MIB_SET_ACTION_UNDO    2  // Revert a committed value (value = old value)
+
+struct MIBNode;
+struct MIBTable;
+
+// Per-node write callback, returns an SNMP error status (0: noError)
+typedef int (*MIBWriteHandler)(struct MIBNode *node, int action, const MIBValue *value);
+
+// Value callback of a volatile scalar (counters), called on every read instead of
+// copying the stored value
+typedef void (*MIBReadHandler)(const struct MIBNode *node, MIBValue *value);
+
+// Called once per node after a whole SET has been committed (e.g. persistence)
+typedef void (*MIBCommitHook)(void *ctx, struct MIBNode *node);
+
 typedef struct MIBNode {
     char name[32];           // Node name
-    char oid[64];            // Node's OID
+    char oid[128];           // Node's OID (table cells carry the row index)
+    unsigned char oid_ber[MIB_OID_BER_MAX]; // Encoded OID, registry sort key (set on insert)
+    int oid_ber_len;
     char type[32];            // Data type
     int isWritable;           // Writable flag (0: read-only, 1: read-write)
     char status[32];          // Status (e.g., "current")
+    int has_range;            // SYNTAX value range (INTEGER, Gauge32) or SIZE (OCTET STRING) from the MIB
+    long long range_min;
+    long long range_max;
     ValueType value_type;     // Type of the value
-    union {
-        int int_value;                    // INTEGER value
-        char str_value[128];              // STRING value
-        unsigned long ticks_value;        // TimeTicks value
-        char oid_value[128];              // OID value
-        // Add other value types as needed
-    } value;
+    MIBValue value;           // Current value (guarded by value_seq)
+    unsigned int value_seq;   // Seqlock counter, odd while a write is in progress
+    MIBWriteHandler write_handler; // Optional SET callback
+    MIBReadHandler read_handler;   // Optional value callback (value/value_seq unused)
+    void *read_ctx;           // Context of read_handler
+    int preallocated;         // Part of a node block (MIB image), not freed individually
+    struct MIBTable *table;   // Conceptual table registered at this entry OID (NULL: scalar)
     struct MIBNode *parent;   // Parent node
     struct MIBNode *child;    // Child node
     struct MIBNode *next;     // Sibling node
@@ -40,11 +84,20 @@ typedef struct MIBNode {
 
 typedef struct MIBTree {
     MIBNode *root;               // Root node of the MIB tree
-    MIBNode *nodes[MAX_NODES];   // Array of all nodes
+    MIBNode **nodes;             // Registered nodes, sorted by OID
     int node_count;              // Number of nodes
+    int sorted_count;            // Leading nodes in OID order (all of them outside a bulk load)
+    int bulk_loading;            // mib_tree_bulk_begin() called: out-of-order nodes are appended
+    int node_capacity;           // Allocated entries in nodes
+    MIBCommitHook commit_hook;   // Optional SET commit listener
+    void *commit_hook_ctx;       // Listener context
+    unsigned int structure_epoch; // Bumped when a node or table row is added or removed
+    unsigned int node_epoch;     // Bumped when a node is added (registry indexes shift)
 } MIBTree;
 
 
+ValueType mib_value_type(const char *type);
+
 MIBNode *add_mib_node(MIBTree *mib_tree, const char *name, const char *oid, const char *type,
                       int isWritable, const char *status, const void *value, MIBNode *parent);
 
@@ -52,24 +105,40 @@ void print_all_mib_nodes(MIBTree *mib_tree);
 
 MIBNode *find_mib_node(MIBNode *node, const char *name);
 
-void parse_object_identifier(char *line, MIBTree *mib_tree);
-
-void parse_object_type(char *line, FILE *file, MIBTree *mib_tree);
-
-void oid_to_string(unsigned char *oid, int oid_len, char *oid_str);
+void oid_to_string(const unsigned char *oid, int oid_len, char *oid_str);
 
 int parse_oid_string(const char *oid_str, unsigned int *oid_parts);
 
 int compare_oids(const char *oid1, const char *oid2);
 
-int find_next_mib_entry(MIBTree *mib_tree, unsigned char *oid, int oid_len, MIBNode **nextEntry);
+int mib_tree_insert(MIBTree *mib_tree, MIBNode *node);
+
+void mib_tree_bulk_begin(MIBTree *mib_tree);
+
+int mib_tree_bulk_end(MIBTree *mib_tree);
+
+int mib_tree_next_index(const MIBTree *mib_tree, const char *oid);
 
 int string_to_oid(const char *oid_str, unsigned char *oid_buf);
 
 void update_dynamic_values(MIBTree *mib_tree);
 
+void update_status_values(MIBTree *mib_tree);
+
+void update_network_values(MIBTree *mib_tree);
+
 int update_mib_node_value(MIBTree *mib_tree, const char *name, const void *value);
 
+MIBNode *find_mib_node_by_oid(MIBTree *mib_tree, const char *oid);
+
+void mib_node_read_value(const MIBNode *node, MIBValue *value);
+
+void mib_node_write_value(MIBNode *node, const MIBValue *value);
+
+void mib_node_snapshot(const MIBNode *node, MIBNode *snapshot);
+
+int register_write_handler(MIBTree *mib_tree, const char *name, MIBWriteHandler handler);
+
 void free_mib_nodes(MIBTree *mib_tree);
 
 #endif // SNMP_MIB_H
@@ -0,0 +1,80 @@
+#ifndef SNMP_MIB_IMAGE_H
+#define SNMP_MIB_IMAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "snmp_mib.h"
+#include "snmp_smi.h"
+#include "snmp_config.h"
+
+#define MIB_IMAGE_MAGIC      "SNMPMIB1"
+#define MIB_IMAGE_VERSION    3
+#define MIB_IMAGE_BYTE_ORDER 0x01020304u   // Written in the compiler's byte order
+
+// Precompiled MIB image produced by mibc. Every reference is an offset from
+// the start of the file, so the image is mapped read-only as is:
+//   [MIBImageHeader][MIBImageRecord x record_count, sorted by OID]
+//   [MIBImageSource x source_count][data]
+// The data area holds NUL terminated strings and BER encoded OIDs; offset 0
+// is an empty string.
+typedef struct {
+    char magic[8];             // MIB_IMAGE_MAGIC
+    uint32_t version;          // MIB_IMAGE_VERSION
+    uint32_t byte_order;       // MIB_IMAGE_BYTE_ORDER
+    uint32_t image_size;       // Total file size
+    uint32_t record_count;
+    uint32_t record_offset;    // MIBImageRecord array
+    uint32_t source_count;
+    uint32_t source_offset;    // MIBImageSource array
+    uint32_t data_offset;      // Strings and encoded OIDs
+    uint32_t data_size;
+    uint32_t checksum;         // FNV-1a of everything after the header
+} MIBImageHeader;
+
+typedef struct {
+    uint32_t name;             // Data offset of the descriptor
+    uint32_t oid_str;          // Data offset of the dotted OID
+    uint32_t oid;              // Data offset of the BER encoded OID
+    uint32_t type;             // Data offset of the SYNTAX base type
+    uint32_t default_str;      // Data offset of the STRING / OID default
+    int32_t default_int;       // INTEGER / TimeTicks default
+    int64_t range_min;         // SYNTAX range or SIZE (if has_range)
+    int64_t range_max;
+    uint16_t oid_len;          // Encoded OID length
+    uint8_t value_type;        // ValueType
+    uint8_t access;            // HANDLER_CAN_RONLY / HANDLER_CAN_RWRITE
+    uint8_t has_range;         // Range or SIZE constraint present
+} MIBImageRecord;
+
+// Module the image was compiled from. The agent parses the modules instead
+// of using the image when its mib_module list or a source file differs; the
+// file is hashed only when its size matches but the mtime does not (copies).
+typedef struct {
+    char module[SMI_MAX_NAME]; // Module name or path as given to mibc or imported
+    int64_t mtime;             // Source file modification time, -1 if none
+    int64_t size;              // Source file size
+    uint32_t hash;             // FNV-1a of the source file
+    uint8_t requested;         // Named on the mibc command line
+    uint8_t reserved[3];
+} MIBImageSource;
+
+// Mapped image and the node block built from it
+typedef struct {
+    void *map;                 // Read-only mapping, NULL if not loaded
+    size_t size;
+    const MIBImageHeader *header;
+    const MIBImageRecord *records;
+    const MIBImageSource *sources;
+    const char *data;
+    MIBNode *nodes;            // One allocation for every record
+    int node_count;
+} MIBImage;
+
+int mib_image_write(SMITree *tree, const char *path);
+
+int mib_image_load(MIBImage *image, const SNMPMibConfig *mib, SMITree *smi_tree, MIBTree *mib_tree);
+
+void mib_image_close(MIBImage *image);
+
+#endif // SNMP_MIB_IMAGE_H
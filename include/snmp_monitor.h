@@ -0,0 +1,40 @@
+#ifndef SNMP_MONITOR_H
+#define SNMP_MONITOR_H
+
+#include "snmp_mib.h"
+#include "snmp_event.h"
+#include "snmp_trap.h"
+#include "snmp_ifmib.h"
+#include "snmp_hrmib.h"
+#include "snmp_cpustat.h"
+
+#define MONITOR_DEV_DIR  "/dev"
+
+// Event driven collectors: the MIB values are refreshed when the kernel
+// reports a change instead of being re-probed on every request.
+//   inotify  /dev            -> sdCardStatus (mmcblk hot-plug)
+//   netlink  IPv4 addr/route -> ipAddressInfo, subnetMask, gateway
+//   netlink  link            -> IF-MIB snapshot (status / address changes)
+//   event loop timer (1 s)   -> per-core CPU sample ring (cpuCoreTable, cpuUsage)
+//   timerfd                  -> periodic metrics (memoryusage, IF-MIB counters,
+//                               HOST-RESOURCES-MIB snapshot, ...)
+typedef struct {
+    MIBTree *mib_tree;
+    SNMPNotifier *notifier;      // Triggers evaluated after every refresh
+    int inotify_fd;              // -1 if unavailable
+    int netlink_fd;              // -1 if unavailable
+    int timer_fd;                // -1 if unavailable
+    IfMib ifmib;                 // ifTable / ifXTable snapshot
+    HrMib hrmib;                 // hrSystem / hrStorage / hrDevice / hrProcessor snapshot
+    CpuStat cpustat;             // Per-core utilization ring
+    unsigned long storage_events;
+    unsigned long network_events;
+    unsigned long link_events;
+} SNMPMonitor;
+
+int monitor_init(SNMPMonitor *monitor, MIBTree *mib_tree, SNMPNotifier *notifier,
+                 EventLoop *loop, int interval_ms);
+
+void monitor_close(SNMPMonitor *monitor);
+
+#endif // SNMP_MONITOR_H
@@ -8,10 +8,15 @@
 #define TYPE_INTEGER        0x02
 #define TYPE_OCTET_STRING   0x04
 #define TYPE_OID            0x06
+#define TYPE_IP_ADDRESS     0x40
+#define TYPE_COUNTER32      0x41
+#define TYPE_GAUGE32        0x42
+#define TYPE_TIME_TICKS     0x43
+#define TYPE_COUNTER64      0x46
 
-int read_length(unsigned char *buffer, int *index);
+int read_length(const unsigned char *buffer, int end, int *index);
 
-int read_integer(unsigned char *buffer, int *index, int len);
+int read_integer(const unsigned char *buffer, int *index, int len);
 
 int write_length(unsigned char *buffer, int len);
 
@@ -20,9 +25,13 @@ int encode_length_at(unsigned char *buffer, int length);
 // Function to encode length field
 int encode_length(unsigned char *buffer, int length);
 
-// Function to encode integer value
+// Function to encode integer value (minimal two's complement, at most ENCODED_INTEGER_MAX bytes)
+#define ENCODED_INTEGER_MAX ((int)sizeof(long))
 int encode_integer(long value, unsigned char *buffer);
 
+// Function to encode an unsigned value (Counter32, Gauge32, TimeTicks, Counter64)
+int encode_unsigned(unsigned long long value, unsigned char *buffer);
+
 // Function to encode OID to binary format
 int encode_oid(const oid *oid_numbers, int oid_len, unsigned char *buffer);
 
@@ -30,10 +39,18 @@ int encode_oid(const oid *oid_numbers, int oid_len, unsigned char *buffer);
 int oid_compare(const unsigned char *oid1, int oid1_len, const unsigned char *oid2, int oid2_len);
 
 // SNMP message parsing functions
-void parse_tlv(unsigned char *buffer, int *index, int length, SNMPPacket *snmp_packet);
-void parse_pdu(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet, unsigned char pdu_type);
-void parse_scoped_pdu(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet);
-void parse_usm_security_parameters(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet);
-void parse_snmpv3_message(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet);
+int peek_snmp_version(unsigned char *buffer, int length);
+int read_tlv(const unsigned char *buffer, int end, int *index, unsigned char *tag, int *length);
+int skip_tlv(const unsigned char *buffer, int end, int *index, unsigned char expected);
+int locate_snmp_pdu(const unsigned char *message, int message_len, int *version, unsigned char *pdu_type,
+                    int *tail, int *tail_len);
+int parse_varbind_list(unsigned char *buffer, int *index, int varbind_list_end,
+                       VarBind *varbind_list, int *varbind_count);
+int parse_snmp_message(unsigned char *buffer, int *index, int length, SNMPPacket *snmp_packet);
+int parse_pdu(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet, unsigned char pdu_type);
+int parse_scoped_pdu(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet);
+int parse_usm_security_parameters(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet);
+int parse_snmpv3_message(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet);
+void printSNMPv3Packet(SNMPv3Packet *packet);
 
 #endif // SNMP_PARSE_H
@@ -0,0 +1,40 @@
+#ifndef SNMP_RATELIMIT_H
+#define SNMP_RATELIMIT_H
+
+#include "snmp_addr.h"
+
+#define RATE_LIMIT_WAYS    4      // Clients per hash set, replaced in LRU order
+#define RATE_LIMIT_TOKEN   1000   // One request in bucket units (1/1000 token)
+
+// Token bucket of one source address
+typedef struct {
+    int in_use;
+    SNMPHostAddr addr;                 // Source address (port ignored)
+    long long tokens;                  // Available tokens in 1/1000
+    long long last_ms;                 // Last refill, also the LRU time
+    int limited;                       // Requests dropped since the bucket ran dry
+    unsigned long drop_count;          // Requests dropped from this client
+} RateLimitClient;
+
+// Per-client request limiter, checked on the raw datagram before any
+// parsing so a manager walking in a tight loop costs one recvfrom per
+// packet instead of a decode and a MIB update. Clients live in a fixed
+// size set associative table; a new client replaces the least recently
+// seen one of its set.
+typedef struct {
+    RateLimitClient *clients;
+    int capacity;                      // 0: limiter disabled
+    int rate;                          // Sustained requests per second
+    int burst;                         // Bucket size in requests
+    unsigned long allowed_count;       // Requests passed on
+    unsigned long drop_count;          // Requests dropped
+    unsigned long evict_count;         // Clients replaced in a full set
+} SNMPRateLimiter;
+
+int rate_limit_init(SNMPRateLimiter *limiter, int clients, int rate, int burst);
+
+int rate_limit_allow(SNMPRateLimiter *limiter, const struct sockaddr_storage *addr, long long now_ms);
+
+void rate_limit_close(SNMPRateLimiter *limiter);
+
+#endif // SNMP_RATELIMIT_H
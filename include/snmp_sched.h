@@ -0,0 +1,65 @@
+#ifndef SNMP_SCHED_H
+#define SNMP_SCHED_H
+
+#include <netinet/in.h>
+
+#include "snmp_mib.h"
+
+#define SCHED_CLASS_GET    0      // GET, SET and small GETNEXT/GETBULK
+#define SCHED_CLASS_BULK   1      // Requests above the bulk cost (walks)
+#define SCHED_CLASSES      2
+
+#define SCHED_QUEUE_SIZE   32     // Requests waiting per class
+#define SCHED_BATCH        16     // Requests served per event loop pass
+#define SCHED_RECEIVE_MAX  (SCHED_QUEUE_SIZE * SCHED_CLASSES)  // Datagrams read per drain
+
+// Datagram waiting for its turn
+typedef struct {
+    unsigned char *data;               // max_message bytes of the scheduler's pool
+    int len;
+    struct sockaddr_storage addr;
+    int sockfd;                        // Agent socket the datagram arrived on (answered on it)
+    long long enqueued_us;             // Arrival (monotonic clock)
+} SchedRequest;
+
+typedef struct {
+    SchedRequest entries[SCHED_QUEUE_SIZE];   // Ring buffer
+    int head;
+    int count;                         // Current queue depth
+    int weight;                        // Requests served per round
+    int credit;                        // Requests left in the current round
+    int max_depth;                     // Deepest the queue has been
+    unsigned long enqueued_count;
+    unsigned long served_count;
+    unsigned long drop_count;          // Arrivals dropped on a full queue
+    unsigned long long latency_total_us;  // Arrival to response, summed over served requests
+    unsigned long latency_max_us;
+} SchedQueue;
+
+// Weighted round robin between a cheap and an expensive request class.
+// Requests are classified on arrival by varbind count x max-repetitions,
+// so a health check GET waits behind at most one round of walk requests.
+typedef struct {
+    SchedQueue queues[SCHED_CLASSES];
+    int bulk_cost;                     // Cost above which a request is SCHED_CLASS_BULK
+    int current;                       // Class of the request being served
+    int max_message;                   // Largest datagram queued
+    unsigned char *pool;               // Datagram storage of every queue entry
+} SNMPScheduler;
+
+int sched_init(SNMPScheduler *sched, int get_weight, int bulk_weight, int bulk_cost, int max_message);
+
+void sched_close(SNMPScheduler *sched);
+
+int sched_request_cost(const unsigned char *buffer, int n);
+
+int sched_enqueue(SNMPScheduler *sched, const unsigned char *buffer, int n,
+                  const struct sockaddr_storage *addr, int sockfd);
+
+SchedRequest *sched_next(SNMPScheduler *sched);
+
+void sched_complete(SNMPScheduler *sched, const SchedRequest *request);
+
+int sched_pending(const SNMPScheduler *sched);
+
+#endif // SNMP_SCHED_H
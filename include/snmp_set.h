@@ -0,0 +1,19 @@
+#ifndef SNMP_SET_H
+#define SNMP_SET_H
+
+#include "snmp.h"
+#include "snmp_mib.h"
+
+// Function to process the VarBinds of a SET-REQUEST.
+// Every VarBind is validated first, then all of them are committed;
+// if a commit fails the already committed VarBinds are undone.
+// Returns an SNMPv2 error status and sets *error_index (1-based) on failure.
+int process_set_request(MIBTree *mib_tree, const VarBind *varbind_list, int varbind_count, int *error_index);
+
+// Function to map an SNMPv2 error status to its SNMPv1 equivalent (RFC 2576)
+int snmp_v1_error_status(int error_status);
+
+// Write handler for DisplayString objects (NVT ASCII only)
+int display_string_write_handler(MIBNode *node, int action, const MIBValue *value);
+
+#endif // SNMP_SET_H
@@ -0,0 +1,122 @@
+#ifndef SNMP_SMI_H
+#define SNMP_SMI_H
+
+#include "snmp_mib.h"
+
+#define SMI_MAX_NAME       64    // Descriptor / module name length
+#define SMI_MAX_SUBIDS     32    // Sub-identifiers of a resolved OID
+#define SMI_MAX_DEF_SUBIDS 16    // Sub-identifiers written in one OID value
+#define SMI_MAX_INDEX      8     // INDEX objects of a row
+#define SMI_MAX_MODULES    64    // Loaded modules
+#define SMI_MAX_PATHS      8     // Module search directories
+
+// Object kind, OBJECT-TYPEs are classified once the tree is resolved
+typedef enum {
+    SMI_KIND_NODE,          // OBJECT IDENTIFIER, MODULE-IDENTITY, OBJECT-IDENTITY
+    SMI_KIND_SCALAR,        // OBJECT-TYPE outside of a table
+    SMI_KIND_TABLE,         // SYNTAX SEQUENCE OF <Entry>
+    SMI_KIND_ROW,           // OBJECT-TYPE with INDEX or AUGMENTS
+    SMI_KIND_COLUMN,        // OBJECT-TYPE under a row
+    SMI_KIND_NOTIFICATION,  // NOTIFICATION-TYPE
+    SMI_KIND_GROUP          // OBJECT-GROUP, MODULE-COMPLIANCE, AGENT-CAPABILITIES, ...
+} SMIKind;
+
+// MAX-ACCESS (or SMIv1 ACCESS)
+typedef enum {
+    SMI_ACCESS_NOT_ACCESSIBLE,
+    SMI_ACCESS_NOTIFY,
+    SMI_ACCESS_READ_ONLY,
+    SMI_ACCESS_READ_WRITE,
+    SMI_ACCESS_READ_CREATE
+} SMIAccess;
+
+typedef struct {
+    char name[SMI_MAX_NAME];             // Descriptor
+    char module[SMI_MAX_NAME];           // Defining module
+    char parent[SMI_MAX_NAME];           // First OID component, "" for an absolute value
+    unsigned int subids[SMI_MAX_DEF_SUBIDS]; // Remaining OID components
+    int subid_count;
+    unsigned int oid[SMI_MAX_SUBIDS];    // Resolved OID
+    int oid_len;                         // 0: not resolved yet, -1: unresolvable
+    SMIKind kind;
+    char syntax[SMI_MAX_NAME];           // SYNTAX as written (DisplayString, IfEntry, ...)
+    char base_type[24];                  // Resolved ASN.1 / SMI base type
+    int sequence_of;                     // SYNTAX SEQUENCE OF (table)
+    SMIAccess access;
+    char status[16];                     // current, deprecated, obsolete, mandatory
+    int has_range;                       // Value range or SIZE constraint present
+    long long range_min;
+    long long range_max;
+    char index[SMI_MAX_INDEX][SMI_MAX_NAME]; // Row INDEX objects
+    int index_count;
+    int implied;                         // Last index is IMPLIED
+    char augments[SMI_MAX_NAME];         // Row AUGMENTS target
+    char defval[64];                     // DEFVAL as written (number, string or label)
+    int has_defval;
+    char *description;                   // DESCRIPTION text (may span lines)
+} SMIObject;
+
+// Type assignment or TEXTUAL-CONVENTION
+typedef struct {
+    char name[SMI_MAX_NAME];
+    char syntax[SMI_MAX_NAME];           // Underlying type as written
+    int has_range;
+    long long range_min;
+    long long range_max;
+} SMIType;
+
+// Source file of a loaded module, recorded in MIB images to detect stale ones
+typedef struct {
+    long long mtime;                     // Modification time, -1 if built in or defined in another file
+    long long size;
+    unsigned int hash;                   // FNV-1a of the file contents
+    int requested;                       // Named by smi_load_module() rather than IMPORTS
+} SMISource;
+
+// Every object of every loaded module, indexed by descriptor.
+// Descriptors share one namespace; the first definition of a name wins.
+typedef struct {
+    char paths[SMI_MAX_PATHS][128];      // Module search directories
+    int path_count;
+    char modules[SMI_MAX_MODULES][SMI_MAX_NAME]; // Loaded (or loading) modules
+    SMISource sources[SMI_MAX_MODULES];  // Source file of each module
+    int module_count;
+    int load_depth;                      // Nested smi_load_module() calls (IMPORTS)
+    SMIObject *objects;
+    int object_count;
+    int object_capacity;
+    int *hash;                           // Open addressing, object index + 1 (0: empty)
+    int hash_size;
+    SMIType *types;
+    int type_count;
+    int type_capacity;
+    int resolved;                        // OIDs and kinds are up to date
+} SMITree;
+
+void smi_init(SMITree *tree);
+
+int smi_add_path(SMITree *tree, const char *dir);
+
+int smi_find_module_file(SMITree *tree, const char *name, char *path, size_t size);
+
+int smi_hash_file(const char *path, unsigned int *hash);
+
+int smi_load_module(SMITree *tree, const char *name);
+
+SMIObject *smi_find_object(SMITree *tree, const char *name);
+
+int smi_resolve(SMITree *tree);
+
+int smi_oid_to_string(const SMIObject *object, char *oid_str, size_t size);
+
+int smi_collect_scalars(SMITree *tree, SMIObject ***objects);
+
+const char *smi_value_type_name(const SMIObject *object);
+
+int smi_default_value(SMITree *tree, const SMIObject *object, MIBValue *value);
+
+int smi_register_objects(SMITree *tree, MIBTree *mib_tree);
+
+void smi_free(SMITree *tree);
+
+#endif // SNMP_SMI_H
@@ -0,0 +1,107 @@
+#ifndef SNMP_STATS_H
+#define SNMP_STATS_H
+
+#include "snmp_mib.h"
+#include "snmp_table.h"
+#include "snmp_cache.h"
+#include "snmp_ratelimit.h"
+#include "snmp_sched.h"
+
+#define STATS_SNMP_GROUP_OID   "1.3.6.1.2.1.11"          // SNMPv2-MIB snmp group
+#define STATS_AGENT_OID        "1.3.6.1.4.1.127.1.5"     // agentInfo (cam.5)
+
+#define STATS_MAX_THREADS  8      // Threads with their own counter slot
+#define STATS_PDU_TYPES    9      // PDU tags 0xA0 - 0xA8
+#define STATS_BUCKETS      8      // Latency histogram buckets
+
+// Request processing stages timed per request
+typedef enum {
+    STATS_STAGE_DECODE,           // Parse and community/USM check
+    STATS_STAGE_LOOKUP,           // MIB instance lookups (GET, GETNEXT)
+    STATS_STAGE_ENCODE,           // Response encoding (GETBULK: walk and encoding)
+    STATS_STAGES
+} StatsStage;
+
+// SNMPv2-MIB snmp group counters (RFC 3418, obsolete ones from RFC 1213)
+typedef enum {
+    STATS_IN_PKTS,
+    STATS_OUT_PKTS,
+    STATS_IN_BAD_VERSIONS,
+    STATS_IN_BAD_COMMUNITY_NAMES,
+    STATS_IN_BAD_COMMUNITY_USES,
+    STATS_IN_ASN_PARSE_ERRS,
+    STATS_IN_TOO_BIGS,
+    STATS_IN_NO_SUCH_NAMES,
+    STATS_IN_BAD_VALUES,
+    STATS_IN_READ_ONLYS,
+    STATS_IN_GEN_ERRS,
+    STATS_IN_TOTAL_REQ_VARS,
+    STATS_IN_TOTAL_SET_VARS,
+    STATS_IN_GET_REQUESTS,
+    STATS_IN_GET_NEXTS,
+    STATS_IN_SET_REQUESTS,
+    STATS_IN_GET_RESPONSES,
+    STATS_IN_TRAPS,
+    STATS_OUT_TOO_BIGS,
+    STATS_OUT_NO_SUCH_NAMES,
+    STATS_OUT_BAD_VALUES,
+    STATS_OUT_GEN_ERRS,
+    STATS_OUT_GET_REQUESTS,
+    STATS_OUT_GET_NEXTS,
+    STATS_OUT_SET_REQUESTS,
+    STATS_OUT_GET_RESPONSES,
+    STATS_OUT_TRAPS,
+    STATS_SILENT_DROPS,
+    STATS_PROXY_DROPS,
+    STATS_COUNTERS
+} StatsCounter;
+
+// Counters of one thread. Only the owning thread writes its slot, readers
+// add up every slot, so the hot path needs neither atomics nor locks and
+// no two threads share a cache line.
+typedef struct {
+    unsigned long counters[STATS_COUNTERS];
+    unsigned long pdu_count[STATS_PDU_TYPES];
+    unsigned long long pdu_time_us[STATS_PDU_TYPES];   // Decode to response, summed
+    unsigned long histogram[STATS_STAGES][STATS_BUCKETS];
+} __attribute__((aligned(64))) SNMPStatsSlot;
+
+extern SNMPStatsSlot snmp_stats_slots[STATS_MAX_THREADS];
+extern __thread SNMPStatsSlot *snmp_stats_slot;
+
+SNMPStatsSlot *stats_attach_thread(void);
+
+static inline SNMPStatsSlot *stats_thread_slot(void) {
+    return snmp_stats_slot ? snmp_stats_slot : stats_attach_thread();
+}
+
+static inline void stats_add(StatsCounter counter, unsigned long count) {
+    stats_thread_slot()->counters[counter] += count;
+}
+
+static inline void stats_inc(StatsCounter counter) {
+    stats_add(counter, 1);
+}
+
+void stats_record_stage(StatsStage stage, long long elapsed_us);
+
+void stats_record_pdu(unsigned char pdu_type, long long elapsed_us);
+
+unsigned long stats_read(StatsCounter counter);
+
+// SNMP views of the counters and of the cache, limiter and scheduler state
+typedef struct {
+    const SNMPResponseCache *cache;
+    const SNMPRateLimiter *limiter;
+    const SNMPScheduler *sched;
+    MIBTable pdu_table;                // agentPduTable
+    MIBTable latency_table;            // agentLatencyTable
+    MIBTable queue_table;              // agentQueueTable
+} SNMPAgentStats;
+
+int stats_init(SNMPAgentStats *stats, MIBTree *mib_tree, const SNMPResponseCache *cache,
+               const SNMPRateLimiter *limiter, const SNMPScheduler *sched);
+
+void stats_close(SNMPAgentStats *stats);
+
+#endif // SNMP_STATS_H
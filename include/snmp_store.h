@@ -0,0 +1,44 @@
+#ifndef SNMP_STORE_H
+#define SNMP_STORE_H
+
+#include "snmp_mib.h"
+#include "snmp_config.h"
+
+#define STORE_PENDING_SIZE  (16 * 1024)   // Group commit buffer
+
+// Journal/snapshot file magic (8 bytes). Version 2 records end with a CRC32,
+// version 1 files (no CRC) are still loaded and rewritten on compaction.
+#define STORE_JOURNAL_MAGIC      "SNMPJRN2"
+#define STORE_SNAPSHOT_MAGIC     "SNMPSNP2"
+#define STORE_JOURNAL_MAGIC_V1   "SNMPJRN1"
+#define STORE_SNAPSHOT_MAGIC_V1  "SNMPSNP1"
+#define STORE_MAGIC_LEN          8
+
+// Write-behind store: committed SETs are buffered and written to an
+// append-only journal in one write + fdatasync per flush interval.
+typedef struct {
+    SNMPStoreConfig config;
+    MIBTree *mib_tree;
+    int journal_fd;                              // Journal opened for append
+    long journal_size;                           // Current journal size (bytes)
+    unsigned char pending[STORE_PENDING_SIZE];   // Records not yet written
+    int pending_len;
+    unsigned long flush_count;                   // Number of group commits
+    unsigned long record_count;                  // Records written to the journal
+    unsigned long drop_count;                    // Records lost because the journal could not be written
+    int compact_needed;                          // A record was dropped: compact on the next good flush
+} SNMPStore;
+
+int store_open(SNMPStore *store, const SNMPStoreConfig *config, MIBTree *mib_tree);
+
+int store_record_set(SNMPStore *store, MIBNode *node);
+
+int store_flush(SNMPStore *store);
+
+int store_compact(SNMPStore *store);
+
+void store_flush_timer(void *ctx);
+
+void store_close(SNMPStore *store);
+
+#endif // SNMP_STORE_H
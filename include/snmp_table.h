@@ -0,0 +1,87 @@
+#ifndef SNMP_TABLE_H
+#define SNMP_TABLE_H
+
+#include "snmp_mib.h"
+
+#define MIB_TABLE_MAX_COLUMNS   32   // Columnar objects of a row
+#define MIB_TABLE_MAX_INDEX     4    // INDEX objects of a row
+#define MIB_TABLE_MAX_SUBIDS    40   // Sub-identifiers of an encoded instance suffix
+#define MIB_TABLE_INITIAL_ROWS  16   // Row container grows by doubling
+
+// INDEX syntax, encoded as in RFC 2578 7.7
+typedef enum {
+    MIB_INDEX_INTEGER,      // One sub-identifier
+    MIB_INDEX_STRING,       // Length followed by one sub-identifier per octet
+    MIB_INDEX_IP_ADDRESS,   // Four sub-identifiers
+    MIB_INDEX_OID           // Length followed by the sub-identifiers
+} MIBIndexType;
+
+// One INDEX value of a row key, the member matching the index type is used
+typedef struct {
+    unsigned int int_value;
+    const char *str_value;
+    unsigned char ip_value[4];      // Network byte order
+    const unsigned int *oid_value;
+    int oid_len;
+} MIBIndexValue;
+
+typedef struct {
+    unsigned int index[MIB_TABLE_MAX_SUBIDS]; // Encoded instance suffix
+    int index_len;
+    void *data;                     // Row context passed to the column handlers
+} MIBTableRow;
+
+// Column value callback, returns 0 with *value filled or -1 if the cell does not exist
+typedef int (*MIBColumnHandler)(const MIBTableRow *row, unsigned int column, MIBValue *value);
+
+typedef struct {
+    unsigned int subid;             // Column number under the entry
+    char name[32];
+    char type[32];                  // SYNTAX, e.g. Counter32
+    ValueType value_type;
+    MIBColumnHandler handler;
+} MIBTableColumn;
+
+// Conceptual table served from its row container. Only the entry OID is
+// registered in the MIB tree; instances are built on lookup, column by
+// column (GETNEXT order), so no MIBNode exists per cell.
+typedef struct MIBTable {
+    char name[32];                  // Entry descriptor (ifEntry, ...)
+    char oid[64];                   // Entry OID
+    MIBIndexType index_types[MIB_TABLE_MAX_INDEX];
+    int index_count;
+    MIBTableColumn columns[MIB_TABLE_MAX_COLUMNS]; // Sorted by subid
+    int column_count;
+    MIBTableRow *rows;              // Sorted by encoded index
+    int row_count;
+    int row_capacity;
+    MIBTree *mib_tree;              // Registry the table is registered in (row epoch)
+} MIBTable;
+
+int mib_table_init(MIBTable *table, const char *name, const char *oid,
+                   const MIBIndexType *index_types, int index_count);
+
+int mib_table_add_column(MIBTable *table, unsigned int subid, const char *name, const char *type,
+                         MIBColumnHandler handler);
+
+MIBNode *mib_table_register(MIBTree *mib_tree, MIBTable *table);
+
+MIBTableRow *mib_table_add_row(MIBTable *table, const MIBIndexValue *index, void *data);
+
+MIBTableRow *mib_table_find_row(MIBTable *table, const MIBIndexValue *index);
+
+int mib_table_remove_row(MIBTable *table, const MIBIndexValue *index);
+
+void mib_table_clear_rows(MIBTable *table);
+
+void mib_table_free(MIBTable *table);
+
+MIBNode *mib_instance_at(MIBTree *mib_tree, int index, const char *oid, MIBNode *cell);
+
+MIBNode *mib_next_instance_at(MIBTree *mib_tree, int index, const char *oid, MIBNode *cell);
+
+MIBNode *find_mib_instance(MIBTree *mib_tree, const char *oid, MIBNode *cell);
+
+MIBNode *find_next_mib_instance(MIBTree *mib_tree, const char *oid, MIBNode *cell);
+
+#endif // SNMP_TABLE_H
@@ -0,0 +1,65 @@
+#ifndef SNMP_TCP_H
+#define SNMP_TCP_H
+
+#include "snmp.h"
+#include "snmp_config.h"
+#include "snmp_event.h"
+
+#define TCP_BUFFER_INITIAL  2048      // First input/output buffer of a connection, doubled as needed
+#define TCP_LISTEN_BACKLOG  16
+#define TCP_BATCH           8         // Messages served per connection before other fds get a turn
+#define TCP_IDLE_CHECK_MS   1000      // Idle connection scan interval
+
+// Callback serving one complete message; the response is sent through transport
+typedef void (*TcpRequestHandler)(void *ctx, const SNMPTransport *transport, unsigned char *buffer, int n);
+
+// Growable byte buffer (data[start, len) is pending)
+typedef struct {
+    unsigned char *data;
+    int start;
+    int len;
+    int size;
+} TcpBuffer;
+
+struct SNMPTcpServer;
+
+// One client connection
+typedef struct {
+    int fd;                            // -1: free slot
+    struct SNMPTcpServer *server;
+    struct sockaddr_storage addr;      // Client address
+    TcpBuffer in;                      // Received bytes not yet served
+    TcpBuffer out;                     // Responses not yet written
+    long long last_ms;                 // Last activity, for the idle timeout
+    int pending;                       // Complete messages left after a batch
+    int eof;                           // Peer done sending, closed once the output is written
+    int broken;                        // Write failed, closed after the current batch
+} TcpConnection;
+
+// SNMP over TCP (RFC 3430). Each message is one BER SEQUENCE on the
+// stream; its length comes from the BER header so reads can stop anywhere
+// in a message. Connections are served from the event loop like the UDP
+// sockets, one message at a time in arrival order, and responses may be
+// as large as max_message instead of one datagram.
+typedef struct SNMPTcpServer {
+    const SNMPTcpConfig *config;
+    EventLoop *loop;
+    int listen_fds[MAX_LISTEN_ADDRESSES];
+    int listen_count;
+    TcpConnection *connections;        // max_connections slots
+    unsigned char *response;           // Shared response buffer (max_message + SNMP_RESPONSE_RESERVE)
+    TcpRequestHandler handler;
+    void *handler_ctx;
+    int idle_timer_id;
+    int batch_timer_id;                // Pending batch timer, -1 if none
+    unsigned long accept_count;        // Connections accepted
+    unsigned long refuse_count;        // Connections refused (table full)
+    unsigned long oversize_count;      // Connections closed on a message above max_message
+} SNMPTcpServer;
+
+int tcp_server_init(SNMPTcpServer *server, const SNMPTcpConfig *config, int ipv6_only, EventLoop *loop,
+                    TcpRequestHandler handler, void *handler_ctx);
+
+void tcp_server_close(SNMPTcpServer *server);
+
+#endif // SNMP_TCP_H
@@ -0,0 +1,70 @@
+#ifndef SNMP_TRAP_H
+#define SNMP_TRAP_H
+
+#include <netinet/in.h>
+
+#include "snmp.h"
+#include "snmp_mib.h"
+#include "snmp_config.h"
+#include "snmp_event.h"
+
+#define TRAP_QUEUE_SIZE  64   // Pending notification messages
+
+// snmpTrapOID.0 values
+#define SNMP_TRAP_COLD_START         "1.3.6.1.6.3.1.1.5.1"
+#define SNMP_TRAP_THRESHOLD_EXCEEDED "1.3.6.1.4.1.127.1.0.1"   // cam.0.1
+#define SNMP_TRAP_VALUE_CHANGED      "1.3.6.1.4.1.127.1.0.2"   // cam.0.2
+
+// Encoded notification waiting for the socket to become writable
+typedef struct {
+    int target;                                   // Index into SNMPTrapConfig.targets
+    int len;
+    unsigned char *data;                          // max_message bytes of the notifier's pool
+} TrapMessage;
+
+// Runtime state of a trigger
+typedef struct {
+    MIBNode *node;           // Watched node (NULL if not found)
+    int initialized;         // last_value is valid
+    int above;               // TRAP_TRIGGER_ABOVE: currently above the threshold
+    MIBValue last_value;     // TRAP_TRIGGER_CHANGE: previous value
+} TrapTriggerState;
+
+struct SNMPInformTable;
+
+typedef struct {
+    const SNMPTrapConfig *config;
+    MIBTree *mib_tree;
+    EventLoop *loop;
+    int sockfds[MAX_LISTEN_ADDRESSES];            // Agent sockets, also used for sending
+    int sockfd_count;
+    struct sockaddr_storage target_addrs[MAX_TRAP_TARGETS]; // IPv4-mapped when sent from a dual-stack socket
+    int target_fds[MAX_TRAP_TARGETS];             // Agent socket reaching the target
+    int target_valid[MAX_TRAP_TARGETS];
+    TrapTriggerState states[MAX_TRAP_TRIGGERS];
+    TrapMessage queue[TRAP_QUEUE_SIZE];           // Ring buffer drained on POLLOUT
+    int queue_head;
+    int queue_count;
+    unsigned int next_request_id;
+    unsigned long sent_count;                     // Notifications sent
+    unsigned long drop_count;                     // Dropped (queue full or send error)
+    struct SNMPInformTable *informs;              // In-flight InformRequests
+    int max_message;                              // Largest notification message
+    unsigned char *pool;                          // Message storage of every queue entry
+    unsigned char *message;                       // Encoding buffer (max_message + SNMP_RESPONSE_RESERVE)
+} SNMPNotifier;
+
+int notifier_init(SNMPNotifier *notifier, const SNMPTrapConfig *config, MIBTree *mib_tree,
+                  EventLoop *loop, const int *sockfds, int sockfd_count, int max_message);
+
+void notifier_close(SNMPNotifier *notifier);
+
+void notifier_enqueue(SNMPNotifier *notifier, int target, const unsigned char *data, int len);
+
+int send_notification(SNMPNotifier *notifier, const char *trap_oid, MIBNode **nodes, int node_count);
+
+void notifier_drain(SNMPNotifier *notifier);
+
+void notifier_check_triggers(SNMPNotifier *notifier);
+
+#endif // SNMP_TRAP_H
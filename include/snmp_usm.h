@@ -0,0 +1,35 @@
+#ifndef SNMP_USM_H
+#define SNMP_USM_H
+
+#include "snmp_config.h"
+
+#define USM_AUTH_PARAMS_LEN   12            // HMAC-MD5-96 / HMAC-SHA-96 digest in msgAuthenticationParameters
+#define USM_TIME_WINDOW       150           // Accepted msgAuthoritativeEngineTime difference (seconds)
+#define USM_MAX_ENGINE_BOOTS  2147483647    // snmpEngineBoots latches here (RFC 3414 2.2.2)
+
+// Authentication protocols (usmUserAuthProtocol)
+#define USM_AUTH_NONE         0
+#define USM_AUTH_MD5          1             // usmHMACMD5AuthProtocol
+#define USM_AUTH_SHA          2             // usmHMACSHAAuthProtocol
+
+// Result of usm_check_time
+#define USM_TIME_OK           0
+#define USM_TIME_NOT_IN_WINDOW -1
+
+int usm_auth_protocol(const char *name);
+
+int usm_init(SNMPUsmPolicy *policy);
+
+int usm_engine_id(unsigned char *engine_id);
+
+int usm_engine_boots(void);
+
+int usm_engine_time(void);
+
+int usm_check_time(int boots, int engine_time);
+
+int usm_authenticate(const SNMPUsmUser *user, unsigned char *message, int message_len);
+
+int usm_sign(const SNMPUsmUser *user, unsigned char *message, int message_len);
+
+#endif // SNMP_USM_H
@@ -0,0 +1,28 @@
+#ifndef SNMP_VACM_H
+#define SNMP_VACM_H
+
+#include "snmp_mib.h"
+#include "snmp_table.h"
+#include "snmp_config.h"
+#include "snmp_acl.h"
+
+#define VACM_MIB_OID   "1.3.6.1.6.3.16.1"   // SNMP-VIEW-BASED-ACM-MIB vacmMIBObjects
+
+// StorageType / RowStatus values of the configured rows
+#define VACM_STORAGE_READ_ONLY   5
+#define VACM_STATUS_ACTIVE       1
+
+// Read-only SNMP views of the VACM configuration (RFC 3415)
+typedef struct {
+    MIBTable context_table;            // vacmContextTable
+    MIBTable group_table;              // vacmSecurityToGroupTable
+    MIBTable access_table;             // vacmAccessTable
+    MIBTable family_table;             // vacmViewTreeFamilyTable
+} SNMPVacmTables;
+
+int vacm_tables_init(SNMPVacmTables *tables, MIBTree *mib_tree, const SNMPAgentConfig *config,
+                     const SNMPAccessControl *acl);
+
+void vacm_tables_close(SNMPVacmTables *tables);
+
+#endif // SNMP_VACM_H
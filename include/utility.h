@@ -1,6 +1,8 @@
 #ifndef AGENT_HANDLER_H
 #define AGENT_HANDLER_H
 
+#include <stddef.h>
+
 #define INTERFACE_NAME "eth0"
 
 unsigned long get_system_uptime();
@@ -11,7 +13,8 @@ char* get_current_ip();
 char* get_current_gateway();
 char* get_current_netmask();
 int read_cpu_times(unsigned long long *idle_time, unsigned long long *total_time);
-int get_cpuUsage();
+int read_load_averages(int *load_1min, int *load_5min, int *load_15min);
+void format_load_average(int load, char *buffer, size_t size);
 char* get_cpu_load(int duration);
 char* check_flash_memory_installed();
 int get_memory_usage();
@@ -3,92 +3,345 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <signal.h>
+#include <unistd.h>
 
 #include "snmp.h"        // SNMP protocol functions
 #include "snmp_mib.h"    // MIB tree functions
 #include "utility.h"     // System utility functions
+#include "snmp_config.h" // Agent configuration
+#include "snmp_acl.h"    // Community and view access control
+#include "snmp_set.h"    // SET write handlers
+#include "snmp_event.h"  // poll() event loop
+#include "snmp_store.h"  // Persistent SET values
+#include "snmp_trap.h"   // Notification generator
+#include "snmp_inform.h" // InformRequest tracking
+#include "snmp_monitor.h" // Event driven collectors
+#include "snmp_smi.h"    // SMIv2 module parser
+#include "snmp_mib_image.h" // Precompiled MIB image
+#include "snmp_ratelimit.h" // Per-client rate limit
+#include "snmp_sched.h"  // GET / GETBULK scheduling
+#include "snmp_stats.h"  // Agent counters
+#include "snmp_log.h"    // Logging
+#include "snmp_vacm.h"   // VACM MIB tables
+#include "snmp_tcp.h"    // SNMP over TCP
+#include "snmp_usm.h"    // USM authentication
+
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [1 [community]] [2c [community]] [3 <username> [noAuthNoPriv|authNoPriv|authPriv] [authProtocol authPassword [privProtocol privPassword]]]\n", prog);
+    printf("       Versions can be combined, e.g. %s 1 public 2c public 3 admin\n", prog);
+}
 
+static int is_version_arg(const char *arg) {
+    return strcmp(arg, "1") == 0 || strcmp(arg, "2c") == 0 || strcmp(arg, "3") == 0;
+}
 
-int main(int argc, char *argv[]) {
-    int sockfd;
-    struct sockaddr_in servaddr, cliaddr;
-    unsigned char buffer[BUFFER_SIZE];
-    
-    // Set default community name(public)
-    const char *allowed_community = "public";
+// sysUpTime은 주기 갱신 사이에도 정확해야 하므로 읽을 때마다 계산
+static void sys_uptime_read_handler(const MIBNode *node, MIBValue *value) {
+    (void)node;
+    value->ticks_value = get_system_uptime();
+}
+
+// 에이전트 소켓 콜백에서 사용하는 상태
+typedef struct {
+    int sockfds[MAX_LISTEN_ADDRESSES];
+    int sockfd_count;
+    const SNMPAgentConfig *config;
+    SNMPAccessControl *acl;
+    MIBTree *mib_tree;
+    SNMPNotifier *notifier;
+    SNMPInformTable *informs;
+    SNMPResponseCache *cache;
+    SNMPRateLimiter *limiter;
+    SNMPScheduler *sched;
+    int sched_timer_id;              // Pending batch timer, -1 if none
+    unsigned char *recv_buffer;      // udp_buffer bytes
+    unsigned char *response;         // UDP response buffer
+    SNMPRequestContext *request;     // Parsed request, reused by UDP and TCP
+} AgentContext;
+
+static EventLoop event_loop;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    event_loop_stop(&event_loop);
+}
+
+// Function to move the datagrams waiting on the agent sockets into the scheduler queues
+static void agent_receive(AgentContext *agent) {
+    unsigned char *buffer = agent->recv_buffer;
+    int buffer_size = agent->config->listen.udp_buffer;
+    struct sockaddr_storage cliaddr;
+    int idle = 0;
+
+    // 소켓을 번갈아 읽어 한 소켓이 다른 소켓을 굶기지 않도록 함
+    for (int i = 0; i < SCHED_RECEIVE_MAX && idle < agent->sockfd_count; i++) {
+        int sockfd = agent->sockfds[i % agent->sockfd_count];
+        socklen_t len = sizeof(cliaddr);
+        int n = recvfrom(sockfd, (char *)buffer, buffer_size, MSG_DONTWAIT | MSG_TRUNC,
+                         (struct sockaddr *)&cliaddr, &len);
+        if (n < 0) {
+            idle++;
+            continue;
+        }
+        idle = 0;
+        stats_inc(STATS_IN_PKTS);
+
+        // MSG_TRUNC: 버퍼보다 긴 데이터그램은 잘린 채로 파싱하지 않고 버림
+        if (n > buffer_size) {
+            char peer[ADDR_STRING_MAX + 8];
+            log_warn("Datagram of %d bytes from %s dropped: udp_buffer is %d", n,
+                     addr_to_string(&cliaddr, peer, sizeof(peer)), buffer_size);
+            stats_inc(STATS_IN_ASN_PARSE_ERRS);
+            continue;
+        }
+
+        // 디코딩 전에 송신자별 요청 수 제한
+        if (!rate_limit_allow(agent->limiter, &cliaddr, event_loop_now_ms())) {
+            stats_inc(STATS_SILENT_DROPS);
+            continue;
+        }
+
+        // InformRequest 응답은 요청 처리 경로로 넘기지 않음 (잘못된 메시지는 이미 집계 후 폐기)
+        int inform_result = inform_handle_response(agent->informs, buffer, n, &cliaddr);
+        if (inform_result < 0) {
+            continue;
+        }
+        if (inform_result > 0) {
+            stats_inc(STATS_IN_GET_RESPONSES);
+            continue;
+        }
+
+        if (sched_enqueue(agent->sched, buffer, n, &cliaddr, sockfd) < 0) {
+            stats_inc(STATS_SILENT_DROPS);
+        }
+    }
+}
+
+static void agent_sched_timer(void *ctx);
+
+// Function to get the largest response to a UDP client: udp_buffer, or less
+// if that would not fit one IP packet on the configured path MTU
+static int udp_max_response(const SNMPListenConfig *listen, const struct sockaddr_storage *addr) {
+    int max_response = listen->udp_buffer;
+    SNMPHostAddr host;
+
+    if (listen->path_mtu > 0 && addr_host(addr, &host) == 0) {
+        // IPv4 20 / IPv6 40 바이트 헤더와 UDP 8 바이트 헤더
+        int payload = listen->path_mtu - (host.family == AF_INET6 ? 48 : 28);
+        if (payload < max_response) {
+            max_response = payload;
+        }
+    }
+    return max_response;
+}
 
-    // default snmp version
-    int snmp_version = 1;
+// Function to serve one batch of queued requests. New arrivals are queued
+// after every request so a GET is not stuck behind the rest of a walk.
+static void agent_serve(AgentContext *agent) {
+    SchedRequest *request;
+    int served = 0;
+
+    while (served < SCHED_BATCH && (request = sched_next(agent->sched)) != NULL) {
+        SNMPTransport transport = { request->sockfd, &request->addr, agent->response,
+                                    udp_max_response(&agent->config->listen, &request->addr), NULL, NULL };
+        snmp_request(request->data, request->len, &transport, agent->request, agent->config, agent->acl,
+                     agent->mib_tree, agent->cache);
+        sched_complete(agent->sched, request);
+        served++;
+        agent_receive(agent);
+    }
+
+    // 남은 요청은 타이머와 다른 fd를 처리한 뒤 이어서 처리
+    if (sched_pending(agent->sched) > 0 && agent->sched_timer_id < 0) {
+        agent->sched_timer_id = event_loop_add_timer(&event_loop, 0, 0, agent_sched_timer, agent);
+    }
+}
+
+static void agent_sched_timer(void *ctx) {
+    AgentContext *agent = (AgentContext *)ctx;
+
+    agent->sched_timer_id = -1;
+    agent_receive(agent);
+    agent_serve(agent);
+}
+
+// Function to serve one request read from a TCP connection. TCP requests
+// skip the scheduler: a connection is served in order and its responses
+// are already bounded by the connection's output queue.
+static void agent_tcp_request(void *ctx, const SNMPTransport *transport, unsigned char *buffer, int n) {
+    AgentContext *agent = (AgentContext *)ctx;
+
+    stats_inc(STATS_IN_PKTS);
+    if (!rate_limit_allow(agent->limiter, transport->addr, event_loop_now_ms())) {
+        stats_inc(STATS_SILENT_DROPS);
+        return;
+    }
+    snmp_request(buffer, n, transport, agent->request, agent->config, agent->acl, agent->mib_tree, agent->cache);
+}
+
+// Function to receive requests from the agent sockets
+static void agent_socket_handler(int fd, short revents, void *ctx) {
+    AgentContext *agent = (AgentContext *)ctx;
+    (void)fd;
+
+    // 대기 중인 알림 전송
+    if (revents & POLLOUT) {
+        notifier_drain(agent->notifier);
+    }
+    if (!(revents & POLLIN)) {
+        return;
+    }
+
+    agent_receive(agent);
+    agent_serve(agent);
+}
+
+// Function to open and bind one agent socket ("a.b.c.d[:port]", "[v6][:port]")
+static int open_agent_socket(const char *address, int ipv6_only) {
+    struct sockaddr_storage servaddr;
+
+    if (addr_parse(address, SNMP_PORT, &servaddr) < 0) {
+        printf("Error: Invalid listen address %s\n", address);
+        return -1;
+    }
+
+    int sockfd = socket(servaddr.ss_family, SOCK_DGRAM, 0);
+    if (sockfd < 0) {
+        perror("socket creation failed");
+        return -1;
+    }
 
-    // SNMPv3 authentication parameters
-    const char *authProtocol = NULL;
-    const char *authPassword = NULL;
-    const char *privProtocol = NULL;
-    const char *privPassword = NULL;
+    // IPV6_V6ONLY off: IPv4 클라이언트도 IPv4-mapped 주소로 같은 소켓에서 수신
+    if (servaddr.ss_family == AF_INET6 &&
+        setsockopt(sockfd, IPPROTO_IPV6, IPV6_V6ONLY, &ipv6_only, sizeof(ipv6_only)) < 0) {
+        perror("setsockopt IPV6_V6ONLY failed");
+    }
+
+    if (bind(sockfd, (const struct sockaddr *)&servaddr, addr_len(&servaddr)) < 0) {
+        perror("bind failed");
+        close(sockfd);
+        return -1;
+    }
+    printf("Listening on %s%s\n", address,
+           servaddr.ss_family == AF_INET6 && !ipv6_only ? " (IPv4 and IPv6)" : "");
+    return sockfd;
+}
 
-    // SNMPv3 security level
-    const char *security_level = "noAuthNoPriv";
+// Function to open the configured agent sockets. Without listen addresses
+// one dual-stack [::] socket is used (plus 0.0.0.0 with ipv6_only on), or
+// 0.0.0.0 alone on hosts without IPv6. Returns the number of sockets.
+static int open_agent_sockets(const SNMPListenConfig *listen, int *sockfds) {
+    int count = 0;
 
-    if (argc > 1) {
-        if (strcmp(argv[1], "1") == 0) {
-            snmp_version = 1;
-        } else if (strcmp(argv[1], "2c") == 0) {
-            snmp_version = 2;
-        } else if (strcmp(argv[1], "3") == 0) {
-            snmp_version = 3;
+    for (int i = 0; i < listen->address_count; i++) {
+        int sockfd = open_agent_socket(listen->addresses[i], listen->ipv6_only);
+        if (sockfd < 0) {
+            exit(EXIT_FAILURE);
+        }
+        sockfds[count++] = sockfd;
+    }
+
+    if (listen->address_count == 0) {
+        int sockfd = open_agent_socket("[::]", listen->ipv6_only);
+        if (sockfd >= 0) {
+            sockfds[count++] = sockfd;
+        }
+        if (sockfd < 0 || listen->ipv6_only) {
+            sockfd = open_agent_socket("0.0.0.0", 0);
+            if (sockfd >= 0) {
+                sockfds[count++] = sockfd;
+            }
+        }
+    }
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    int sockfds[MAX_LISTEN_ADDRESSES];
+    int sockfd_count;
+
+    // 버전별 접근 정책 (v1/v2c 커뮤니티, v3 USM 사용자)
+    SNMPAgentConfig config;
+    init_agent_config(&config);
+
+    if (load_agent_config(SNMP_CONFIG_FILE, &config) == 0) {
+        printf("Loaded configuration from %s\n", SNMP_CONFIG_FILE);
+    }
+
+    // 여러 버전을 동시에 지정 가능: 예) snmp 1 public 2c private 3 admin
+    int i = 1;
+    while (i < argc) {
+        if (strcmp(argv[i], "1") == 0 || strcmp(argv[i], "2c") == 0) {
+            SNMPCommunityPolicy *policy = (strcmp(argv[i], "1") == 0) ? &config.v1 : &config.v2c;
+            i++;
+
+            // Set default community name(public)
+            const char *community = "public";
+            if (i < argc && !is_version_arg(argv[i])) {
+                community = argv[i++];
+            }
+            add_community(policy, community, SNMP_ACCESS_READ_ONLY);
+        } else if (strcmp(argv[i], "3") == 0) {
+            i++;
 
             // Expect additional parameters for SNMPv3
-            if (argc > 2) {
-                allowed_community = argv[2];
-            } else {
-                printf("Usage: %s 3 <username> [noAuthNoPriv|authNoPriv|authPriv] [authProtocol authPassword [privProtocol privPassword]]\n", argv[0]);
+            if (i >= argc || is_version_arg(argv[i])) {
+                print_usage(argv[0]);
                 exit(EXIT_FAILURE);
             }
+            const char *user_name = argv[i++];
 
-            if (argc > 3) {
-                security_level = argv[3];
+            // SNMPv3 security level
+            const char *security_level = "noAuthNoPriv";
+            if (i < argc && !is_version_arg(argv[i])) {
+                security_level = argv[i++];
             }
 
+            // SNMPv3 authentication parameters
+            const char *authProtocol = NULL;
+            const char *authPassword = NULL;
+            const char *privProtocol = NULL;
+            const char *privPassword = NULL;
+
             if (strcmp(security_level, "authNoPriv") == 0 || strcmp(security_level, "authPriv") == 0) {
-                if (argc > 4) {
-                    authProtocol = argv[4];
-                    authPassword = argv[5];
-                } else {
-                    printf("Authentication parameters required for security levels 'authNoPriv' or 'authPriv'\n");
-                    exit(EXIT_FAILURE);
+                if (i + 1 < argc) {
+                    authProtocol = argv[i++];
+                    authPassword = argv[i++];
                 }
             }
 
             if (strcmp(security_level, "authPriv") == 0) {
-                if (argc > 6) {
-                    privProtocol = argv[6];
-                    privPassword = argv[7];
-                } else {
-                    printf("Privacy parameters required for security level 'authPriv'\n");
-                    exit(EXIT_FAILURE);
+                if (i + 1 < argc) {
+                    privProtocol = argv[i++];
+                    privPassword = argv[i++];
                 }
             }
-        } else {
-            printf("Usage: %s [1|2c|3] [community|username] [security_level] [authProtocol authPassword [privProtocol privPassword]]\n", argv[0]);
-            exit(EXIT_FAILURE);
-        }
 
-        if (snmp_version == 1 || snmp_version == 2) {
-            if (argc > 2) {
-                allowed_community = argv[2];
+            if (add_usm_user(&config.v3, user_name, security_level,
+                             authProtocol, authPassword, privProtocol, privPassword) < 0) {
+                exit(EXIT_FAILURE);
             }
+        } else {
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
         }
-    } else {
-        printf("Usage: %s [1|2c|3] [community|username] [security_level] [authProtocol authPassword [privProtocol privPassword]]\n", argv[0]);
-        printf("Using default SNMP version 1 and community 'public'\n");
     }
-    
-    FILE *file = fopen("CAMERA-MIB.txt", "r");
-    if (!file) {
-        perror("Error opening file");
-        return 1;
+
+    if (!config.v1.enabled && !config.v2c.enabled && !config.v3.enabled) {
+        print_usage(argv[0]);
+        printf("Using default SNMP version 1/2c and community 'public'\n");
+        add_community(&config.v1, "public", SNMP_ACCESS_READ_ONLY);
+        add_community(&config.v2c, "public", SNMP_ACCESS_READ_ONLY);
     }
 
+    print_agent_config(&config);
+    log_init((config.log.console ? SNMP_LOG_CONSOLE : 0) | (config.log.syslog ? SNMP_LOG_SYSLOG : 0));
+
+    // 엔진 ID, snmpEngineBoots/Time (v3 응답과 알림) 및 사용자 인증 키
+    usm_init(&config.v3);
+
     MIBTree mib_tree;
     memset(&mib_tree, 0, sizeof(MIBTree));
 
@@ -100,48 +353,74 @@ int main(int argc, char *argv[]) {
                  "1.3.6.1.4.1.127.1.9", NULL);
 
     unsigned long uptime = get_system_uptime();
-    add_mib_node(&mib_tree, "sysUpTime", "1.3.6.1.2.1.1.3.0", "TimeTicks", HANDLER_CAN_RONLY, "current", 
-                 &uptime, NULL);
+    MIBNode *sys_uptime = add_mib_node(&mib_tree, "sysUpTime", "1.3.6.1.2.1.1.3.0", "TimeTicks", HANDLER_CAN_RONLY,
+                                       "current", &uptime, NULL);
+    if (sys_uptime) {
+        sys_uptime->read_handler = sys_uptime_read_handler;
+    }
 
     add_mib_node(&mib_tree, "sysContact", "1.3.6.1.2.1.1.4.0", "DisplayString", HANDLER_CAN_RWRITE, "current", 
                  "admin@example.com", NULL);
 
     add_mib_node(&mib_tree, "sysName", "1.3.6.1.2.1.1.5.0", "DisplayString", HANDLER_CAN_RWRITE, "current", 
                  "EN675", NULL);;
-    mib_tree.root = add_mib_node(&mib_tree, "cam", "1.3.6.1.4.1.127.1", "MODULE-IDENTITY", 0, "current", "", NULL);
 
-    char line[256];
+    // 미리 컴파일된 MIB 이미지를 우선 사용하고, 없으면 MIB 모듈을 파싱
+    static SMITree smi_tree;
+    static MIBImage mib_image;
+    long long load_start = event_loop_now_ms();
+    int registered = -1;
 
-    while (fgets(line, sizeof(line), file)) {
-        if (strstr(line, "IMPORTS")) {
-            while (!strstr(line, ";")) {
-                fgets(line, sizeof(line), file);
-            }
-            continue;
-        }
+    smi_init(&smi_tree);
+    for (int i = 0; i < config.mib.dir_count; i++) {
+        smi_add_path(&smi_tree, config.mib.dirs[i]);
+    }
+    if (config.mib.module_count == 0) {
+        strcpy(config.mib.modules[config.mib.module_count++], SNMP_MIB_DEFAULT_MODULE);
+    }
 
-        if (strstr(line, "OBJECT IDENTIFIER")) {
-            parse_object_identifier(line, &mib_tree);
-        }
+    // 이미지가 설정된 모듈과 다르거나 원본 파일보다 오래되었으면 모듈을 파싱
+    if (config.mib.image_path[0]) {
+        registered = mib_image_load(&mib_image, &config.mib, &smi_tree, &mib_tree);
+    }
 
-        if (strstr(line, "OBJECT-TYPE")) {
-            parse_object_type(line, file, &mib_tree);
+    if (registered >= 0) {
+        printf("Mapped MIB image %s in %lld ms, %d served\n", config.mib.image_path,
+               event_loop_now_ms() - load_start, registered);
+    } else {
+        for (int i = 0; i < config.mib.module_count; i++) {
+            if (smi_load_module(&smi_tree, config.mib.modules[i]) < 0) {
+                printf("Error: Failed to load MIB module %s\n", config.mib.modules[i]);
+                return 1;
+            }
         }
+        registered = smi_register_objects(&smi_tree, &mib_tree);
+        printf("Loaded %d MIB objects from %d modules in %lld ms, %d served\n", smi_tree.object_count,
+               smi_tree.module_count, event_loop_now_ms() - load_start, registered);
     }
 
-    fclose(file);
-
-    int cpu_usage = get_cpuUsage();
     int memory_usage = get_memory_usage();
     
     // -- System Information
     update_mib_node_value(&mib_tree, "modelName", "eyenix EN675");
     update_mib_node_value(&mib_tree, "versionInfo", get_version());
     update_mib_node_value(&mib_tree, "dateTimeInfo", get_date());
-    update_mib_node_value(&mib_tree, "cpuUsage", &cpu_usage);
-    update_mib_node_value(&mib_tree, "cpuLoad1Min", get_cpu_load(1));
-    update_mib_node_value(&mib_tree, "cpuLoad5Min", get_cpu_load(5));
-    update_mib_node_value(&mib_tree, "cpuLoad15Min", get_cpu_load(15));
+
+    // 부하 평균: load x 100 정수와 호환용 문자열 ("0.52")
+    static const char *load_nodes[3][2] = {
+        { "cpuLoadInt1Min", "cpuLoad1Min" },
+        { "cpuLoadInt5Min", "cpuLoad5Min" },
+        { "cpuLoadInt15Min", "cpuLoad15Min" },
+    };
+    int load[3];
+    if (read_load_averages(&load[0], &load[1], &load[2]) == 0) {
+        for (int i = 0; i < 3; i++) {
+            char load_str[16];
+            format_load_average(load[i], load_str, sizeof(load_str));
+            update_mib_node_value(&mib_tree, load_nodes[i][0], &load[i]);
+            update_mib_node_value(&mib_tree, load_nodes[i][1], load_str);
+        }
+    }
 
     // -- Network Information
     update_mib_node_value(&mib_tree, "macAddressInfo", get_mac_address());
@@ -155,32 +434,121 @@ int main(int argc, char *argv[]) {
     update_mib_node_value(&mib_tree, "sdCardStatus", check_sdcard_installed());
     // update_mib_node_value("sdCardCapacity", get_version());
 
-    sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sockfd < 0) {
-        perror("socket creation failed");
+    // -- SET handlers
+    register_write_handler(&mib_tree, "sysContact", display_string_write_handler);
+    register_write_handler(&mib_tree, "sysName", display_string_write_handler);
+
+    // 저장된 SET 값을 소켓 바인드 전에 적용
+    SNMPStore store;
+    if (store_open(&store, &config.store, &mib_tree) < 0) {
+        printf("Error: Failed to open the SET store, persistence disabled.\n");
+    }
+
+    // print_all_mib_nodes(&mib_tree);
+
+    sockfd_count = open_agent_sockets(&config.listen, sockfds);
+    if (sockfd_count == 0) {
         exit(EXIT_FAILURE);
     }
 
-    memset(&servaddr, 0, sizeof(servaddr));
-    servaddr.sin_family = AF_INET;
-    servaddr.sin_addr.s_addr = INADDR_ANY;
-    servaddr.sin_port = htons(SNMP_PORT);
+    static SNMPAccessControl acl;
+    if (acl_init(&acl, &config) < 0) {
+        printf("Error: Failed to compile access control.\n");
+        exit(EXIT_FAILURE);
+    }
+    static SNMPNotifier notifier;
+    static SNMPInformTable informs;
+    static SNMPResponseCache cache;
+    if (response_cache_init(&cache, config.cache.entries) < 0) {
+        printf("Error: Response cache unavailable.\n");
+    }
+    static SNMPRateLimiter limiter;
+    if (rate_limit_init(&limiter, config.rate_limit.clients, config.rate_limit.rate, config.rate_limit.burst) < 0) {
+        printf("Error: Rate limit unavailable.\n");
+    }
+    static SNMPScheduler sched;
+    if (sched_init(&sched, config.sched.get_weight, config.sched.bulk_weight, config.sched.bulk_cost,
+                   config.listen.udp_buffer) < 0) {
+        printf("Error: Failed to allocate the request queues.\n");
+        exit(EXIT_FAILURE);
+    }
+    static SNMPAgentStats stats;
+    if (stats_init(&stats, &mib_tree, &cache, &limiter, &sched) < 0) {
+        printf("Error: Agent statistics unavailable.\n");
+    }
+    static SNMPVacmTables vacm_tables;
+    if (vacm_tables_init(&vacm_tables, &mib_tree, &config, &acl) < 0) {
+        printf("Error: VACM tables unavailable.\n");
+    }
+    // 응답 버퍼는 GETBULK 헤더 자리를 위해 여유를 둠
+    int response_size = config.listen.udp_buffer + SNMP_RESPONSE_RESERVE;
+    unsigned char *recv_buffer = malloc(config.listen.udp_buffer);
+    unsigned char *response = malloc(response_size);
+    if (!recv_buffer || !response) {
+        printf("Error: Failed to allocate the UDP buffers.\n");
+        exit(EXIT_FAILURE);
+    }
+    static SNMPRequestContext request_context;
+    AgentContext agent = { { 0 }, sockfd_count, &config, &acl, &mib_tree, &notifier, &informs, &cache, &limiter,
+                           &sched, -1, recv_buffer, response, &request_context };
+    memcpy(agent.sockfds, sockfds, sizeof(sockfds));
+
+    event_loop_init(&event_loop);
+    log_attach(&event_loop);
+    for (int i = 0; i < sockfd_count; i++) {
+        event_loop_add_fd(&event_loop, sockfds[i], POLLIN, agent_socket_handler, &agent);
+    }
 
-    // print_all_mib_nodes(&mib_tree);
+    static SNMPTcpServer tcp_server;
+    if (tcp_server_init(&tcp_server, &config.tcp, config.listen.ipv6_only, &event_loop, agent_tcp_request,
+                        &agent) < 0) {
+        printf("Error: SNMP over TCP unavailable.\n");
+    }
 
-    if (bind(sockfd, (const struct sockaddr *)&servaddr, sizeof(servaddr)) < 0) {
-        perror("bind failed");
+    if (notifier_init(&notifier, &config.trap, &mib_tree, &event_loop, sockfds, sockfd_count,
+                      config.listen.udp_buffer) < 0 || inform_table_init(&informs, &notifier) < 0) {
+        printf("Error: Failed to allocate the notification buffers.\n");
         exit(EXIT_FAILURE);
     }
 
-    while (1) {
-        socklen_t len = sizeof(cliaddr);
-        int n = recvfrom(sockfd, (char *)buffer, BUFFER_SIZE, 0, (struct sockaddr *)&cliaddr, &len);
+    // 수집기 변경 감지 (inotify, netlink, timerfd)
+    static SNMPMonitor monitor;
+    if (monitor_init(&monitor, &mib_tree, &notifier, &event_loop, config.trap.check_interval_ms) < 0) {
+        printf("Error: Periodic metric refresh unavailable.\n");
+    }
+    send_notification(&notifier, SNMP_TRAP_COLD_START, NULL, 0);
+    if (config.store.enabled) {
+        event_loop_add_timer(&event_loop, config.store.flush_interval_ms, config.store.flush_interval_ms,
+                             store_flush_timer, &store);
+    }
 
-        snmp_request(buffer, n, &cliaddr, sockfd, snmp_version, allowed_community, &mib_tree);
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    event_loop_run(&event_loop);
+    log_close();
+
+    // 종료 전에 대기 중인 SET 값을 기록
+    store_close(&store);
+    tcp_server_close(&tcp_server);
+    monitor_close(&monitor);
+    response_cache_close(&cache);
+    rate_limit_close(&limiter);
+    stats_close(&stats);
+    vacm_tables_close(&vacm_tables);
+    acl_close(&acl);
+    for (int i = 0; i < sockfd_count; i++) {
+        close(sockfds[i]);
     }
+    sched_close(&sched);
+    inform_table_close(&informs);
+    notifier_close(&notifier);
+    free(recv_buffer);
+    free(response);
 
     free_mib_nodes(&mib_tree);
+    mib_image_close(&mib_image);
+    smi_free(&smi_tree);
 
     return 0;
 }
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "snmp_mib.h"    // MIB tree functions
+#include "snmp_table.h"  // Conceptual tables
+
+// MIB registry benchmark (make bench): registration (one by one and as a
+// bulk load sorted once), duplicate rejection, exact lookups and GETNEXT
+// walks at 10k and 100k objects, as scalars and as table cells.
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void make_oid(int i, char *oid, size_t size) {
+    snprintf(oid, size, "1.3.6.1.4.1.9999.%d.%d.%d", i / 10000, (i / 100) % 100, i % 100);
+}
+
+static void run(int count, int shuffled, int bulk) {
+    MIBTree mib_tree;
+    char oid[64];
+    char name[32];
+    int *order = (int *)malloc(count * sizeof(int));
+
+    memset(&mib_tree, 0, sizeof(MIBTree));
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    if (shuffled) {
+        srand(1);
+        for (int i = count - 1; i > 0; i--) {
+            int j = rand() % (i + 1);
+            int tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+        }
+    }
+
+    double start = now_ms();
+    if (bulk) {
+        mib_tree_bulk_begin(&mib_tree);
+    }
+    for (int i = 0; i < count; i++) {
+        make_oid(order[i], oid, sizeof(oid));
+        snprintf(name, sizeof(name), "obj%d", order[i]);
+        add_mib_node(&mib_tree, name, oid, "Integer32", HANDLER_CAN_RONLY, "current", &i, NULL);
+    }
+    if (bulk) {
+        mib_tree_bulk_end(&mib_tree);
+    }
+    double insert_ms = now_ms() - start;
+
+    // 중복 OID는 모두 거부되어야 함
+    start = now_ms();
+    int rejected = 0;
+    for (int i = 0; i < count; i += 10) {
+        make_oid(order[i], oid, sizeof(oid));
+        if (find_mib_node_by_oid(&mib_tree, oid)) {
+            rejected++;
+        }
+    }
+    double duplicate_ms = now_ms() - start;
+
+    start = now_ms();
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        make_oid(order[i], oid, sizeof(oid));
+        if (find_mib_node_by_oid(&mib_tree, oid)) {
+            found++;
+        }
+    }
+    double lookup_ms = now_ms() - start;
+
+    // GETNEXT 순회가 사전순으로 모든 노드를 방문하는지 확인
+    start = now_ms();
+    int walked = 0;
+    int ordered = 1;
+    strcpy(oid, "1.3.6.1.4.1.9999");
+    for (int index = mib_tree_next_index(&mib_tree, oid); index < mib_tree.node_count;
+         index = mib_tree_next_index(&mib_tree, oid)) {
+        if (walked > 0 && compare_oids(mib_tree.nodes[index]->oid, oid) <= 0) {
+            ordered = 0;
+        }
+        strcpy(oid, mib_tree.nodes[index]->oid);
+        walked++;
+    }
+    double walk_ms = now_ms() - start;
+
+    printf("%7d objects (%s%s): insert %8.2f ms, duplicate check %6.3f us/op, lookup %6.3f us/op, "
+           "walk %8.2f ms [%d/%d found, %d/%d rejected, %d walked%s]\n",
+           count, shuffled ? "random" : "sorted", bulk ? ", bulk" : "", insert_ms, duplicate_ms * 1000.0 / (count / 10),
+           lookup_ms * 1000.0 / count, walk_ms, found, count, rejected, count / 10, walked,
+           ordered ? ", ordered" : ", OUT OF ORDER");
+
+    free(order);
+    free_mib_nodes(&mib_tree);
+}
+
+#define BENCH_TABLE_COLUMNS 10
+
+static int bench_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    value->int_value = (int)(row->index[0] * column);
+    return 0;
+}
+
+static void run_table(int count) {
+    MIBTree mib_tree;
+    MIBTable table;
+    MIBIndexType index_type = MIB_INDEX_INTEGER;
+    MIBNode cell;
+    char oid[64];
+    int rows = count / BENCH_TABLE_COLUMNS;
+
+    memset(&mib_tree, 0, sizeof(MIBTree));
+    mib_table_init(&table, "benchEntry", "1.3.6.1.4.1.9999.1.1", &index_type, 1);
+    for (int c = 1; c <= BENCH_TABLE_COLUMNS; c++) {
+        char name[32];
+        snprintf(name, sizeof(name), "benchColumn%d", c);
+        mib_table_add_column(&table, c, name, "Counter32", bench_column);
+    }
+    mib_table_register(&mib_tree, &table);
+
+    double start = now_ms();
+    for (int i = rows; i >= 1; i--) {
+        MIBIndexValue index = { .int_value = i };
+        mib_table_add_row(&table, &index, NULL);
+    }
+    double insert_ms = now_ms() - start;
+
+    start = now_ms();
+    int found = 0;
+    for (int i = 1; i <= rows; i++) {
+        snprintf(oid, sizeof(oid), "1.3.6.1.4.1.9999.1.1.%d.%d", 1 + i % BENCH_TABLE_COLUMNS, i);
+        if (find_mib_instance(&mib_tree, oid, &cell)) {
+            found++;
+        }
+    }
+    double lookup_ms = now_ms() - start;
+
+    // 열 우선 순서로 모든 셀을 순회
+    start = now_ms();
+    int walked = 0;
+    int ordered = 1;
+    strcpy(oid, "1.3.6.1.4.1.9999");
+    for (MIBNode *node = find_next_mib_instance(&mib_tree, oid, &cell); node;
+         node = find_next_mib_instance(&mib_tree, oid, &cell)) {
+        if (compare_oids(node->oid, oid) <= 0) {
+            ordered = 0;
+        }
+        strcpy(oid, node->oid);
+        walked++;
+    }
+    double walk_ms = now_ms() - start;
+
+    printf("%7d cells   (table):  rows %8.2f ms, %zu bytes/cell, lookup %6.3f us/op, walk %8.2f ms "
+           "[%d/%d found, %d walked%s]\n",
+           count, insert_ms, table.row_capacity * sizeof(MIBTableRow) / count, lookup_ms * 1000.0 / rows,
+           walk_ms, found, rows, walked, ordered ? ", ordered" : ", OUT OF ORDER");
+
+    mib_table_free(&table);
+    free_mib_nodes(&mib_tree);
+}
+
+int main(void) {
+    int counts[] = { 10000, 100000 };
+
+    for (int i = 0; i < 2; i++) {
+        run(counts[i], 0, 0);
+        run(counts[i], 1, 0);
+        run(counts[i], 1, 1);
+        run_table(counts[i]);
+    }
+    return 0;
+}
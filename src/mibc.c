@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snmp_config.h"     // Default image path
+#include "snmp_smi.h"        // SMIv2 module parser
+#include "snmp_mib_image.h"  // Precompiled MIB image
+
+// Offline MIB compiler: parses SMIv2 modules and writes the binary image
+// mapped by the agent at startup.
+static void print_usage(const char *prog) {
+    printf("Usage: %s [-I mib_dir]... [-o image] MODULE...\n", prog);
+    printf("       Default image: %s\n", SNMP_MIB_IMAGE_FILE);
+}
+
+int main(int argc, char *argv[]) {
+    const char *output = SNMP_MIB_IMAGE_FILE;
+    static SMITree tree;
+    int module_count = 0;
+
+    smi_init(&tree);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-I") == 0 && i + 1 < argc) {
+            smi_add_path(&tree, argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (argv[i][0] == '-') {
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            if (smi_load_module(&tree, argv[i]) < 0) {
+                return 1;
+            }
+            module_count++;
+        }
+    }
+
+    if (module_count == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (smi_resolve(&tree) < 0) {
+        printf("Error: Unresolved OIDs, image not written\n");
+        smi_free(&tree);
+        return 1;
+    }
+
+    int result = mib_image_write(&tree, output);
+    smi_free(&tree);
+    return result < 0 ? 1 : 0;
+}
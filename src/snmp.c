@@ -6,18 +6,122 @@
 
 #include "snmp.h"        // SNMP protocol definitions and function declarations
 #include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_table.h"  // Conceptual tables
 #include "snmp_parse.h"  // SNMP message parsing functions
+#include "snmp_config.h" // Per-version access policy
+#include "snmp_acl.h"    // Community and view access control
+#include "snmp_set.h"    // SET-REQUEST processing
+#include "snmp_cache.h"  // Response cache
+#include "snmp_event.h"  // Monotonic clock
+#include "snmp_stats.h"  // Agent counters
+#include "snmp_log.h"    // Logging
+#include "snmp_usm.h"    // USM authentication
 #include "utility.h"     // System utility functions
 
+// Function to encode a value as its BER tag and contents, returns the contents length
+static int encode_mib_value(ValueType type, const MIBValue *value, unsigned char *tag, unsigned char *contents) {
+    int len = 0;
+
+    switch (type) {
+        case VALUE_TYPE_INT: {
+            // 최소 길이의 2의 보수 표현 (상위 바이트가 부호 확장일 뿐이면 생략)
+            int v = value->int_value;
+            len = 4;
+            while (len > 1) {
+                int top = (v >> (8 * (len - 1))) & 0xFF;
+                int next_sign = (v >> (8 * (len - 2))) & 0x80;
+                if (!((top == 0x00 && !next_sign) || (top == 0xFF && next_sign))) {
+                    break;
+                }
+                len--;
+            }
+            for (int i = 0; i < len; i++) {
+                contents[i] = (v >> (8 * (len - 1 - i))) & 0xFF;
+            }
+            *tag = TYPE_INTEGER;
+            break;
+        }
+        case VALUE_TYPE_STRING:
+            len = strlen(value->str_value);
+            memcpy(contents, value->str_value, len);
+            *tag = TYPE_OCTET_STRING;
+            break;
+        case VALUE_TYPE_OID:
+            len = string_to_oid(value->oid_value, contents);
+            *tag = TYPE_OID;
+            break;
+        case VALUE_TYPE_TIME_TICKS:
+            len = encode_unsigned(value->ticks_value & 0xFFFFFFFFUL, contents);
+            *tag = TYPE_TIME_TICKS;
+            break;
+        case VALUE_TYPE_COUNTER32:
+            len = encode_unsigned(value->uint_value, contents);
+            *tag = TYPE_COUNTER32;
+            break;
+        case VALUE_TYPE_GAUGE32:
+            len = encode_unsigned(value->uint_value, contents);
+            *tag = TYPE_GAUGE32;
+            break;
+        case VALUE_TYPE_COUNTER64:
+            len = encode_unsigned(value->counter64_value, contents);
+            *tag = TYPE_COUNTER64;
+            break;
+        case VALUE_TYPE_OCTETS:
+            len = value->octets.len;
+            if (len < 0 || len > MIB_OCTETS_MAX) {
+                len = 0;
+            }
+            memcpy(contents, value->octets.data, len);
+            *tag = TYPE_OCTET_STRING;
+            break;
+        default:
+            *tag = 0x05; // NULL
+            break;
+    }
+    return len;
+}
+
+// Function to encode a value as a complete TLV, returns the encoded length
+static int encode_mib_value_field(ValueType type, const MIBValue *value, unsigned char *buffer) {
+    unsigned char contents[sizeof(MIBValue)];
+    int index = 0;
+
+    int contents_len = encode_mib_value(type, value, &buffer[index++], contents);
+    index += encode_length(&buffer[index], contents_len);
+    memcpy(&buffer[index], contents, contents_len);
+    return index + contents_len;
+}
+
+// 메시지 본문은 응답 버퍼의 MESSAGE_BODY_OFFSET 위치부터 바로 작성하고
+// 마지막에 바깥 SEQUENCE 헤더를 앞에 붙임 (임시 버퍼 없이 제자리에서 당김)
+#define MESSAGE_BODY_OFFSET 4   // SEQUENCE 태그 + 길이 최대 3바이트
+#define SNMPV3_HEADER_MAX 512   // msgVersion ~ contextName 최대 길이 (엔진 ID, 사용자, 보안 파라미터 포함)
+
+// Function to prepend the message SEQUENCE header to a body written at
+// message + MESSAGE_BODY_OFFSET, returns the message length
+static int wrap_message(unsigned char *message, int body_len) {
+    message[0] = 0x30; // SEQUENCE
+    int header_len = 1 + encode_length(&message[1], body_len);
+    memmove(&message[header_len], &message[MESSAGE_BODY_OFFSET], body_len);
+    return header_len + body_len;
+}
+
 // SNMP 응답 생성
 void create_snmp_response(SNMPPacket *request_packet, unsigned char *response, int *response_len,
-                          unsigned char *response_oid, int response_oid_len, MIBNode *entry,
+                          const unsigned char *response_oid, int response_oid_len, MIBNode *entry,
                           int error_status, int error_index, int snmp_version)
 {
     int index = 0;
 
-    // 메시지 전체를 임시 버퍼에 작성
-    unsigned char buffer[BUFFER_SIZE];
+    // 동시 SET과 무관하게 일관된 값으로 인코딩
+    MIBNode snapshot;
+    if (entry) {
+        mib_node_snapshot(entry, &snapshot);
+        entry = &snapshot;
+    }
+
+    // 메시지 본문을 응답 버퍼에 바로 작성
+    unsigned char *buffer = response + MESSAGE_BODY_OFFSET;
 
     // 1. SNMP Version
     buffer[index++] = 0x02; // INTEGER
@@ -80,37 +184,7 @@ void create_snmp_response(SNMPPacket *request_packet, unsigned char *response, i
 
     // 3.4.1.2. Value
     if (error_status == SNMP_ERROR_NO_ERROR) {
-        if (entry->value_type == VALUE_TYPE_INT) {
-            buffer[index++] = 0x02; // INTEGER
-            unsigned long value = entry->value.int_value;
-            int value_len = (value <= 0xFF) ? 1 : (value <= 0xFFFF) ? 2 : (value <= 0xFFFFFF) ? 3 : 4;
-            index += encode_length(&buffer[index], value_len);
-            for (int i = value_len - 1; i >= 0; i--) {
-                buffer[index++] = (value >> (i * 8)) & 0xFF;
-            }
-        } else if (entry->value_type == VALUE_TYPE_STRING) {
-            buffer[index++] = 0x04; // OCTET STRING
-            int value_length = strlen(entry->value.str_value);
-            index += encode_length(&buffer[index], value_length);
-            memcpy(&buffer[index], entry->value.str_value, value_length);
-            index += value_length;
-        } else if (entry->value_type == VALUE_TYPE_OID) {
-            buffer[index++] = 0x06; // OBJECT IDENTIFIER
-            int oid_length = string_to_oid(entry->value.oid_value, &buffer[index + 1]);
-            index += encode_length(&buffer[index], oid_length); // OID 길이를 인코딩
-            index += oid_length;
-        } else if (entry->value_type == VALUE_TYPE_TIME_TICKS) {
-            buffer[index++] = 0x43; // TimeTicks (SNMPv2)
-            unsigned long ticks_value = entry->value.ticks_value;
-            int value_len = (ticks_value <= 0xFF) ? 1 : (ticks_value <= 0xFFFF) ? 2 : (ticks_value <= 0xFFFFFF) ? 3 : 4;
-            index += encode_length(&buffer[index], value_len);
-            for (int i = value_len - 1; i >= 0; i--) {
-                buffer[index++] = (ticks_value >> (i * 8)) & 0xFF;
-            }
-        } else {
-            buffer[index++] = 0x05; // NULL
-            index += encode_length(&buffer[index], 0);
-        }
+        index += encode_mib_value_field(entry->value_type, &entry->value, &buffer[index]);
     } else {
         if (snmp_version == 1) {
             buffer[index++] = 0x05; // NULL
@@ -135,48 +209,24 @@ void create_snmp_response(SNMPPacket *request_packet, unsigned char *response, i
 
     // Variable Binding 길이 설정
     int varbind_length = index - varbind_length_pos - 1;
-    int varbind_length_bytes = encode_length(&buffer[varbind_length_pos], varbind_length);
-    memmove(&buffer[varbind_length_pos + varbind_length_bytes],
-            &buffer[varbind_length_pos + 1],
-            index - (varbind_length_pos + 1));
-    index += (varbind_length_bytes - 1);
+    index += encode_length_at(&buffer[varbind_length_pos], varbind_length) - 1;
 
     // Variable Bindings 길이 설정
     int varbind_list_length = index - varbind_list_length_pos - 1;
-    int varbind_list_length_bytes = encode_length(&buffer[varbind_list_length_pos], varbind_list_length);
-    memmove(&buffer[varbind_list_length_pos + varbind_list_length_bytes],
-            &buffer[varbind_list_length_pos + 1],
-            index - (varbind_list_length_pos + 1));
-    index += (varbind_list_length_bytes - 1);
+    index += encode_length_at(&buffer[varbind_list_length_pos], varbind_list_length) - 1;
 
     // PDU 길이 설정
     int pdu_length = index - pdu_length_pos - 1;
-    int pdu_length_bytes = encode_length(&buffer[pdu_length_pos], pdu_length);
-    memmove(&buffer[pdu_length_pos + pdu_length_bytes],
-            &buffer[pdu_length_pos + 1],
-            index - (pdu_length_pos + 1));
-    index += (pdu_length_bytes - 1);
+    index += encode_length_at(&buffer[pdu_length_pos], pdu_length) - 1;
 
     // 전체 메시지를 SEQUENCE로 감싸기
-    unsigned char final_buffer[BUFFER_SIZE];
-    int final_index = 0;
-    final_buffer[final_index++] = 0x30; // SEQUENCE
-    int message_length = index;
-    final_index += encode_length(&final_buffer[final_index], message_length);
-    memcpy(&final_buffer[final_index], buffer, index);
-    final_index += index;
-
-    // 최종 응답 설정
-    memcpy(response, final_buffer, final_index);
-    *response_len = final_index;
+    *response_len = wrap_message(response, index);
 }
 
-// SNMPv3 응답 생성
-void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *response, int *response_len,
-                            unsigned char *response_oid, int response_oid_len, MIBNode *entry,
-                            int error_status, int error_index) {
+// SNMPv3 메시지 헤더 인코딩 (msgVersion ~ contextName)
+// PDU를 쓸 위치를 반환하고 Scoped PDU 길이 위치를 scoped_pdu_length_pos에 저장
+static int encode_snmpv3_header(SNMPv3Packet *request_packet, unsigned char *buffer, int *scoped_pdu_length_pos) {
     int index = 0;
-    unsigned char buffer[BUFFER_SIZE];
 
     // 1. SNMP Version (SNMPv3)
     buffer[index++] = 0x02; // INTEGER
@@ -215,7 +265,7 @@ void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *respons
 
     // Calculate Global Data Length
     int global_data_length = index - global_data_length_pos - 1;
-    encode_length_at(&buffer[global_data_length_pos], global_data_length);
+    index += encode_length_at(&buffer[global_data_length_pos], global_data_length) - 1;
 
     // 3. Security Parameters (OCTET STRING)
     buffer[index++] = 0x04; // OCTET STRING
@@ -233,7 +283,7 @@ void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *respons
 
     // 3.2 msgAuthoritativeEngineBoots
     buffer[index++] = 0x02; // INTEGER
-    unsigned char boots_buf[5];
+    unsigned char boots_buf[ENCODED_INTEGER_MAX];
     int boots_len = encode_integer(request_packet->msgAuthoritativeEngineBoots, boots_buf);
     index += encode_length(&buffer[index], boots_len);
     memcpy(&buffer[index], boots_buf, boots_len);
@@ -241,7 +291,7 @@ void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *respons
 
     // 3.3 msgAuthoritativeEngineTime
     buffer[index++] = 0x02; // INTEGER
-    unsigned char time_buf[5];
+    unsigned char time_buf[ENCODED_INTEGER_MAX];
     int time_len = encode_integer(request_packet->msgAuthoritativeEngineTime, time_buf);
     index += encode_length(&buffer[index], time_len);
     memcpy(&buffer[index], time_buf, time_len);
@@ -269,15 +319,15 @@ void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *respons
 
     // Update USM length
     int usm_length = index - usm_length_pos - 1;
-    encode_length_at(&buffer[usm_length_pos], usm_length);
+    index += encode_length_at(&buffer[usm_length_pos], usm_length) - 1;
 
     // Encode Security Parameters Length
     int sec_params_length = index - sec_params_length_pos - 1;
-    encode_length_at(&buffer[sec_params_length_pos], sec_params_length);
+    index += encode_length_at(&buffer[sec_params_length_pos], sec_params_length) - 1;
 
     // 4. Scoped PDU
     buffer[index++] = 0x30; // SEQUENCE
-    int scoped_pdu_length_pos = index++; // Length placeholder
+    *scoped_pdu_length_pos = index++; // Length placeholder
 
     // 4.1 contextEngineID
     buffer[index++] = 0x04; // OCTET STRING
@@ -292,6 +342,114 @@ void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *respons
     memcpy(&buffer[index], request_packet->contextName, context_name_len);
     index += context_name_len;
 
+    return index;
+}
+
+// Scoped PDU 길이 설정 후 전체 메시지를 SEQUENCE로 감싸기
+// (본문은 response + MESSAGE_BODY_OFFSET에 작성되어 있음)
+static void finish_snmpv3_message(unsigned char *response, int index, int scoped_pdu_length_pos,
+                                  int *response_len) {
+    unsigned char *buffer = response + MESSAGE_BODY_OFFSET;
+
+    // Update Scoped PDU Length
+    int scoped_pdu_length = index - scoped_pdu_length_pos - 1;
+    index += encode_length_at(&buffer[scoped_pdu_length_pos], scoped_pdu_length) - 1;
+
+    // Final wrapping with SEQUENCE
+    *response_len = wrap_message(response, index);
+}
+
+// 캐시된 PDU 본문 앞에 Response 태그와 request-id 작성, max_len을 넘으면 -1
+static int encode_cached_pdu(unsigned char *buffer, int index, int max_len, unsigned char pdu_type,
+                             unsigned int request_id, const unsigned char *body, int body_len) {
+    // request-id는 새로 만든 응답과 같은 형식 (GETBULK 응답만 최소 길이)
+    unsigned char request_id_buf[ENCODED_INTEGER_MAX];
+    int request_id_len = 4;
+    if (pdu_type == 0xA5) {
+        request_id_len = encode_integer((int)request_id, request_id_buf);
+    } else {
+        request_id_buf[0] = (request_id >> 24) & 0xFF;
+        request_id_buf[1] = (request_id >> 16) & 0xFF;
+        request_id_buf[2] = (request_id >> 8) & 0xFF;
+        request_id_buf[3] = request_id & 0xFF;
+    }
+
+    // PDU 헤더 (최대 11바이트)와 바깥 SEQUENCE 헤더 여유
+    if (index + 11 + body_len > max_len) {
+        return -1;
+    }
+
+    buffer[index++] = 0xA2; // GET-RESPONSE PDU
+    index += encode_length(&buffer[index], 2 + request_id_len + body_len);
+
+    buffer[index++] = 0x02; // INTEGER
+    index += encode_length(&buffer[index], request_id_len);
+    memcpy(&buffer[index], request_id_buf, request_id_len);
+    index += request_id_len;
+
+    memcpy(&buffer[index], body, body_len);
+    return index + body_len;
+}
+
+// 캐시된 응답 본문으로 SNMPv1/v2c 응답 생성 (버전, 커뮤니티, request-id만 새로 작성)
+static void create_cached_response(SNMPPacket *request_packet, const unsigned char *body, int body_len,
+                                   unsigned char *response, int *response_len, int max_len) {
+    unsigned char *buffer = response + MESSAGE_BODY_OFFSET;
+    int index = 0;
+
+    buffer[index++] = 0x02; // INTEGER
+    index += encode_length(&buffer[index], 1);
+    buffer[index++] = request_packet->version;
+
+    buffer[index++] = 0x04; // OCTET STRING
+    int community_length = strlen(request_packet->community);
+    index += encode_length(&buffer[index], community_length);
+    memcpy(&buffer[index], request_packet->community, community_length);
+    index += community_length;
+
+    index = encode_cached_pdu(buffer, index, max_len, request_packet->pdu_type, request_packet->request_id,
+                              body, body_len);
+    if (index < 0) {
+        *response_len = 0;
+        return;
+    }
+
+    *response_len = wrap_message(response, index);
+}
+
+// 캐시된 응답 본문으로 SNMPv3 응답 생성 (메시지 헤더와 request-id만 새로 작성)
+static void create_snmpv3_cached_response(SNMPv3Packet *request_packet, const unsigned char *body, int body_len,
+                                          unsigned char *response, int *response_len, int max_len) {
+    unsigned char *buffer = response + MESSAGE_BODY_OFFSET;
+    int scoped_pdu_length_pos;
+
+    int index = encode_snmpv3_header(request_packet, buffer, &scoped_pdu_length_pos);
+    index = encode_cached_pdu(buffer, index, max_len, request_packet->pdu_type, request_packet->request_id,
+                              body, body_len);
+    if (index < 0) {
+        *response_len = 0;
+        return;
+    }
+
+    finish_snmpv3_message(response, index, scoped_pdu_length_pos, response_len);
+}
+
+// SNMPv3 응답 생성
+void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *response, int *response_len,
+                            const unsigned char *response_oid, int response_oid_len, MIBNode *entry,
+                            int error_status, int error_index) {
+    unsigned char *buffer = response + MESSAGE_BODY_OFFSET;
+
+    // 동시 SET과 무관하게 일관된 값으로 인코딩
+    MIBNode snapshot;
+    if (entry) {
+        mib_node_snapshot(entry, &snapshot);
+        entry = &snapshot;
+    }
+
+    int scoped_pdu_length_pos;
+    int index = encode_snmpv3_header(request_packet, buffer, &scoped_pdu_length_pos);
+
     // 4.3 PDU SEQUENCE (Response PDU)
     buffer[index++] = 0xA2; // Response PDU (응답 PDU 타입)
     int pdu_length_pos = index++; // PDU length placeholder
@@ -339,64 +497,7 @@ void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *respons
 
     // 4.3.4.1.2 Value (according to MIB entry type)
     if (entry) {
-        switch(entry->value_type) {
-            case VALUE_TYPE_INT:
-                buffer[index++] = 0x02; // INTEGER 태그
-
-                // INTEGER 값 인코딩
-                unsigned char int_encoded[BUFFER_SIZE];
-                int int_encoded_len = encode_integer(entry->value.int_value, int_encoded);
-
-                // 길이(Byte Length) 인코딩
-                index += encode_length(&buffer[index], int_encoded_len);
-
-                // 인코딩된 INTEGER 값을 버퍼에 복사
-                memcpy(&buffer[index], int_encoded, int_encoded_len);
-                index += int_encoded_len;
-                break;
-            
-            case VALUE_TYPE_STRING:
-                buffer[index++] = 0x04; // OCTET STRING
-                {
-                    int str_len = strlen(entry->value.str_value);
-                    // printf("Debug: STRING Value = %s\n", entry->value.str_value);
-                    index += encode_length(&buffer[index], str_len);
-                    memcpy(&buffer[index], entry->value.str_value, str_len);
-                    index += str_len;
-                }
-                break;
-            
-            case VALUE_TYPE_OID:
-                buffer[index++] = 0x06; // OBJECT IDENTIFIER
-                {
-                    int oid_len = string_to_oid(entry->value.oid_value, &buffer[index + 1]);
-                    // printf("Debug: OID Value = %s (Length: %d)\n", entry->value.oid_value, oid_len);
-                    buffer[index++] = oid_len;
-                    index += oid_len;
-                }
-                break;
-            
-            case VALUE_TYPE_TIME_TICKS:
-                buffer[index++] = 0x43; // TimeTicks (APPLICATION 3)
-                {
-                    unsigned long ticks = entry->value.ticks_value;
-                    // printf("Debug: TimeTicks Value = %lu\n", ticks);
-                    int ticks_len = (ticks <= 0xFF) ? 1 :
-                                    (ticks <= 0xFFFF) ? 2 :
-                                    (ticks <= 0xFFFFFF) ? 3 : 4;
-                    index += encode_length(&buffer[index], ticks_len);
-                    for(int i = ticks_len - 1; i >=0; i--){
-                        buffer[index++] = (ticks >> (i*8)) & 0xFF;
-                    }
-                }
-                break;
-            
-            default:
-                buffer[index++] = 0x05; // NULL
-                index += encode_length(&buffer[index], 0);
-                // printf("Debug: Unsupported Value Type. Encoded as NULL.\n");
-                break;
-        }
+        index += encode_mib_value_field(entry->value_type, &entry->value, &buffer[index]);
     } else {
         buffer[index++] = error_status; // noSuchObject for SNMPv3
         index += encode_length(&buffer[index], 0);
@@ -405,33 +506,17 @@ void create_snmpv3_response(SNMPv3Packet *request_packet, unsigned char *respons
 
     // Update VarBind Length
     int varbind_length = index - varbind_length_pos - 1;
-    encode_length_at(&buffer[varbind_length_pos], varbind_length);
+    index += encode_length_at(&buffer[varbind_length_pos], varbind_length) - 1;
 
     // Update VarBind List Length
     int varbind_list_length = index - varbind_list_length_pos - 1;
-    encode_length_at(&buffer[varbind_list_length_pos], varbind_list_length);
+    index += encode_length_at(&buffer[varbind_list_length_pos], varbind_list_length) - 1;
 
     // Update PDU Length
     int pdu_length = index - pdu_length_pos - 1;
-    encode_length_at(&buffer[pdu_length_pos], pdu_length);
-
-    // Update Scoped PDU Length
-    int scoped_pdu_length = index - scoped_pdu_length_pos - 1;
-    encode_length_at(&buffer[scoped_pdu_length_pos], scoped_pdu_length);
+    index += encode_length_at(&buffer[pdu_length_pos], pdu_length) - 1;
 
-    // Final wrapping with SEQUENCE
-    unsigned char final_buffer[BUFFER_SIZE];
-    int final_index = 0;
-    final_buffer[final_index++] = 0x30; // SEQUENCE tag for the entire SNMP message
-
-    // Encode the length of the entire message
-    int message_length = index;
-    final_index += encode_length(&final_buffer[final_index], message_length);
-    memcpy(&final_buffer[final_index], buffer, index);
-    final_index += index;
-
-    memcpy(response, final_buffer, final_index);
-    *response_len = final_index;
+    finish_snmpv3_message(response, index, scoped_pdu_length_pos, response_len);
 }
 
 
@@ -443,6 +528,7 @@ void create_snmpv3_report_response(SNMPv3Packet *request_packet, unsigned char *
     static const oid unknownEngineID[]      = {1, 3, 6, 1, 6, 3, 15, 1, 1, 4, 0};
     static const oid wrongDigest[]          = {1, 3, 6, 1, 6, 3, 15, 1, 1, 5, 0};
     static const oid decryptionError[]      = {1, 3, 6, 1, 6, 3, 15, 1, 1, 6, 0};
+    static const oid unknownContexts[]      = {1, 3, 6, 1, 6, 3, 12, 1, 5, 0};
 
     const oid *err_oid;
     int err_oid_len;
@@ -473,8 +559,12 @@ void create_snmpv3_report_response(SNMPv3Packet *request_packet, unsigned char *
             err_oid = decryptionError;
             err_oid_len = sizeof(decryptionError) / sizeof(oid);
             break;
+        case SNMPERR_UNKNOWN_CONTEXT:
+            err_oid = unknownContexts;
+            err_oid_len = sizeof(unknownContexts) / sizeof(oid);
+            break;
         default:
-            printf("Unknown SNMPv3 error type: %d\n", error);
+            log_error("Unknown SNMPv3 error type: %d", error);
             *response_len = 0;
             return;
     }
@@ -486,81 +576,17 @@ void create_snmpv3_report_response(SNMPv3Packet *request_packet, unsigned char *
     //     0x74, 0xA4, 0xAA, 0xDF, 0x66
     // };
 
-    unsigned char engine_id[10]; // Adjust size based on generate_engine_id output length
-    generate_engine_id(engine_id);
-
-    int engine_id_len = sizeof(engine_id);
+    unsigned char engine_id[SNMP_ENGINE_ID_MAX];
+    int engine_id_len = usm_engine_id(engine_id);
 
-    // Report PDU construction
-    unsigned char report_pdu[BUFFER_SIZE];
-    int pdu_len = 0;
-
-    report_pdu[pdu_len++] = 0xA8; // REPORT PDU
-    int pdu_length_pos = pdu_len++; // PDU length position placeholder
-
-    // Request ID
-    unsigned char request_id_buf[5];
-    int request_id_len = encode_integer(request_packet->request_id, request_id_buf);
-
-    report_pdu[pdu_len++] = 0x02; // INTEGER
-    pdu_len += encode_length(&report_pdu[pdu_len], request_id_len);
-    memcpy(&report_pdu[pdu_len], request_id_buf, request_id_len);
-    pdu_len += request_id_len;
-
-    // Error Status
-    report_pdu[pdu_len++] = 0x02; // INTEGER
-    report_pdu[pdu_len++] = 0x01; // Length
-    report_pdu[pdu_len++] = 0x00; // noError
-
-    // Error Index
-    report_pdu[pdu_len++] = 0x02; // INTEGER
-    report_pdu[pdu_len++] = 0x01; // Length
-    report_pdu[pdu_len++] = 0x00; // noError
-
-    // Variable Bindings
-    report_pdu[pdu_len++] = 0x30; // SEQUENCE
-    int varbind_list_len_pos = pdu_len++; // Length placeholder
-
-    // Variable Binding
-    report_pdu[pdu_len++] = 0x30; // SEQUENCE
-    int varbind_len_pos = pdu_len++; // Length placeholder
-
-    // OID
-    unsigned char oid_buffer[64];
-    int oid_encoded_len = encode_oid(err_oid, err_oid_len, oid_buffer);
-
-    report_pdu[pdu_len++] = 0x06; // OBJECT IDENTIFIER
-    pdu_len += encode_length(&report_pdu[pdu_len], oid_encoded_len);
-    memcpy(&report_pdu[pdu_len], oid_buffer, oid_encoded_len);
-    pdu_len += oid_encoded_len;
-
-    // Value (Counter32 with value 1)
-    report_pdu[pdu_len++] = 0x41; // Counter32
-    unsigned char error_counter_buf[5];
-    int error_counter_len = encode_integer(1, error_counter_buf);
-
-    pdu_len += encode_length(&report_pdu[pdu_len], error_counter_len);
-    memcpy(&report_pdu[pdu_len], error_counter_buf, error_counter_len);
-    pdu_len += error_counter_len;
-
-    // Variable Binding Length
-    int varbind_len = pdu_len - varbind_len_pos - 1;
-    int len_bytes_varbind  = encode_length_at(&report_pdu[varbind_len_pos], varbind_len);
-    pdu_len += (len_bytes_varbind  - 1);
+    // notInTimeWindow는 관리자가 시간을 맞출 수 있도록 요청한 사용자로 인증해서 보냄 (RFC 3414 3.2.7 a),
+    // 서명은 호출한 쪽에서 usm_sign으로 작성
+    int authenticated = (error == SNMPERR_USM_NOTINTIMEWINDOW);
 
-    // Variable Bindings Length
-    int varbind_list_len = pdu_len - varbind_list_len_pos - 1;
-    len_bytes_varbind  = encode_length_at(&report_pdu[varbind_list_len_pos], varbind_list_len);
-    pdu_len += (len_bytes_varbind  - 1);
-
-    // PDU Length
-    int pdu_content_length = pdu_len - pdu_length_pos - 1;
-    len_bytes_varbind  = encode_length_at(&report_pdu[pdu_length_pos], pdu_content_length);
-    pdu_len += (len_bytes_varbind  - 1);
-
-    // SNMPv3 Message construction
-    unsigned char buffer[BUFFER_SIZE];
+    // SNMPv3 Message construction (응답 버퍼에 바로 작성)
+    unsigned char *buffer = response;
     int index = 0;
+    int len_bytes;
 
     buffer[index++] = 0x30; // SEQUENCE
     int snmp_msg_length_pos = index++; // Length placeholder
@@ -575,7 +601,7 @@ void create_snmpv3_report_response(SNMPv3Packet *request_packet, unsigned char *
     int global_data_length_pos = index++; // Length placeholder
 
     // msgID
-    unsigned char msg_id_buf[5];
+    unsigned char msg_id_buf[ENCODED_INTEGER_MAX];
     int msg_id_len = encode_integer(request_packet->msgID, msg_id_buf);
 
     buffer[index++] = 0x02; // INTEGER
@@ -584,7 +610,7 @@ void create_snmpv3_report_response(SNMPv3Packet *request_packet, unsigned char *
     index += msg_id_len;
 
     // msgMaxSize
-    unsigned char msg_max_size_buf[5];
+    unsigned char msg_max_size_buf[ENCODED_INTEGER_MAX];
     int msg_max_size_len = encode_integer(request_packet->msgMaxSize, msg_max_size_buf);
 
     buffer[index++] = 0x02; // INTEGER
@@ -601,8 +627,10 @@ void create_snmpv3_report_response(SNMPv3Packet *request_packet, unsigned char *
 
     // 오류 유형에 따른 보안 수준 설정
     if (error == SNMPERR_USM_UNKNOWNENGINEID) {
-        // 인증 필요 (authNoPriv)
         msg_flags = 0x00;
+    } else if (authenticated) {
+        // authNoPriv
+        msg_flags = SNMP_SEC_LEVEL_AUTHNOPRIV;
     } else {
         // noAuthNoPriv (기본값)
         // msg_flags는 이미 0x04로 설정되어 있음
@@ -618,672 +646,1373 @@ void create_snmpv3_report_response(SNMPv3Packet *request_packet, unsigned char *
 
     // msgGlobalData Length
     int global_data_length = index - global_data_length_pos - 1;
-    len_bytes_varbind  = encode_length_at(&buffer[global_data_length_pos], global_data_length);
-    index += (len_bytes_varbind  - 1);
+    len_bytes = encode_length_at(&buffer[global_data_length_pos], global_data_length);
+    index += (len_bytes - 1);
 
     // msgSecurityParameters
     buffer[index++] = 0x04; // OCTET STRING
     int sec_params_length_pos = index++; // Length placeholder
 
-    // Encode USM Security Parameters
-    unsigned char sec_params_buffer[BUFFER_SIZE];
-    int sec_params_index = 0;
-
-    sec_params_buffer[sec_params_index++] = 0x30; // SEQUENCE
-    int usm_length_pos = sec_params_index++; // Length placeholder
+    // USM Security Parameters
+    buffer[index++] = 0x30; // SEQUENCE
+    int usm_length_pos = index++; // Length placeholder
 
     // msgAuthoritativeEngineID (Agent's own engine ID)
-    sec_params_buffer[sec_params_index++] = 0x04; // OCTET STRING
-    sec_params_index += encode_length(&sec_params_buffer[sec_params_index], engine_id_len);
-    memcpy(&sec_params_buffer[sec_params_index], engine_id, engine_id_len);
-    sec_params_index += engine_id_len;
-
-    // msgAuthoritativeEngineBoots (set to 0)
-    sec_params_buffer[sec_params_index++] = 0x02; // INTEGER
-    unsigned char boots_buf[5];
-    int boots_len = encode_integer(48, boots_buf);
-    sec_params_index += encode_length(&sec_params_buffer[sec_params_index], boots_len);
-    memcpy(&sec_params_buffer[sec_params_index], boots_buf, boots_len);
-    sec_params_index += boots_len;
-
-    // msgAuthoritativeEngineTime (set to 0)
-    sec_params_buffer[sec_params_index++] = 0x02; // INTEGER
-    unsigned char time_buf[5];
-    int time_len = encode_integer(2885, time_buf);
-    sec_params_index += encode_length(&sec_params_buffer[sec_params_index], time_len);
-    memcpy(&sec_params_buffer[sec_params_index], time_buf, time_len);
-    sec_params_index += time_len;
-
-    // msgUserName (empty string)
-    sec_params_buffer[sec_params_index++] = 0x04; // OCTET STRING
-    sec_params_buffer[sec_params_index++] = 0x00; // Length
-    // No user name to copy
-
-    // msgAuthenticationParameters (empty string)
-    sec_params_buffer[sec_params_index++] = 0x04; // OCTET STRING
-    sec_params_buffer[sec_params_index++] = 0x00; // Length
-    // No auth parameters
+    buffer[index++] = 0x04; // OCTET STRING
+    index += encode_length(&buffer[index], engine_id_len);
+    memcpy(&buffer[index], engine_id, engine_id_len);
+    index += engine_id_len;
+
+    // msgAuthoritativeEngineBoots
+    buffer[index++] = 0x02; // INTEGER
+    unsigned char boots_buf[ENCODED_INTEGER_MAX];
+    int boots_len = encode_integer(usm_engine_boots(), boots_buf);
+    index += encode_length(&buffer[index], boots_len);
+    memcpy(&buffer[index], boots_buf, boots_len);
+    index += boots_len;
+
+    // msgAuthoritativeEngineTime
+    buffer[index++] = 0x02; // INTEGER
+    unsigned char time_buf[ENCODED_INTEGER_MAX];
+    int time_len = encode_integer(usm_engine_time(), time_buf);
+    index += encode_length(&buffer[index], time_len);
+    memcpy(&buffer[index], time_buf, time_len);
+    index += time_len;
+
+    if (authenticated) {
+        // msgUserName (요청한 사용자)
+        int user_name_len = strlen(request_packet->msgUserName);
+        buffer[index++] = 0x04; // OCTET STRING
+        buffer[index++] = user_name_len;
+        memcpy(&buffer[index], request_packet->msgUserName, user_name_len);
+        index += user_name_len;
+
+        // msgAuthenticationParameters (서명 자리)
+        buffer[index++] = 0x04; // OCTET STRING
+        buffer[index++] = USM_AUTH_PARAMS_LEN;
+        memset(&buffer[index], 0, USM_AUTH_PARAMS_LEN);
+        index += USM_AUTH_PARAMS_LEN;
+    } else {
+        // msgUserName (empty string)
+        buffer[index++] = 0x04; // OCTET STRING
+        buffer[index++] = 0x00; // Length
+        // No user name to copy
+
+        // msgAuthenticationParameters (empty string)
+        buffer[index++] = 0x04; // OCTET STRING
+        buffer[index++] = 0x00; // Length
+        // No auth parameters
+    }
 
     // msgPrivacyParameters (empty string)
-    sec_params_buffer[sec_params_index++] = 0x04; // OCTET STRING
-    sec_params_buffer[sec_params_index++] = 0x00; // Length
+    buffer[index++] = 0x04; // OCTET STRING
+    buffer[index++] = 0x00; // Length
     // No privacy parameters
 
     // Update USM length
-    int usm_length = sec_params_index - usm_length_pos - 1;
-    len_bytes_varbind  = encode_length_at(&sec_params_buffer[usm_length_pos], usm_length);
-    sec_params_index += (len_bytes_varbind  - 1);
-
-    // Copy Security Parameters to buffer
-    memcpy(&buffer[index], sec_params_buffer, sec_params_index);
-    index += sec_params_index;
+    int usm_length = index - usm_length_pos - 1;
+    len_bytes = encode_length_at(&buffer[usm_length_pos], usm_length);
+    index += (len_bytes - 1);
 
     // Calculate length of msgSecurityParameters
     int sec_params_length = index - sec_params_length_pos - 1;
-    len_bytes_varbind  = encode_length_at(&buffer[sec_params_length_pos], sec_params_length);
-    index += (len_bytes_varbind  - 1);
+    len_bytes = encode_length_at(&buffer[sec_params_length_pos], sec_params_length);
+    index += (len_bytes - 1);
 
     // msgData (ScopedPDUData)
     // 암호화를 사용하지 않으므로 ScopedPDU를 직접 포함
-    int scoped_pdu_start = index; // ScopedPDU 시작 위치
-
-    // ScopedPDU 생성
-    unsigned char scoped_pdu[BUFFER_SIZE];
-    int scoped_index = 0;
-
-    // ScopedPDU SEQUENCE 시작
-    scoped_pdu[scoped_index++] = 0x30; // SEQUENCE
-    int scoped_pdu_length_pos = scoped_index++; // Length placeholder
+    buffer[index++] = 0x30; // SEQUENCE
+    int scoped_pdu_length_pos = index++; // Length placeholder
 
     // contextEngineID (에이전트의 엔진 ID)
-    scoped_pdu[scoped_index++] = 0x04; // OCTET STRING
-    scoped_pdu[scoped_index++] = engine_id_len;
-    memcpy(&scoped_pdu[scoped_index], engine_id, engine_id_len);
-    scoped_index += engine_id_len;
+    buffer[index++] = 0x04; // OCTET STRING
+    buffer[index++] = engine_id_len;
+    memcpy(&buffer[index], engine_id, engine_id_len);
+    index += engine_id_len;
 
     // contextName (빈 문자열)
-    scoped_pdu[scoped_index++] = 0x04; // OCTET STRING
-    scoped_pdu[scoped_index++] = 0x00;
+    buffer[index++] = 0x04; // OCTET STRING
+    buffer[index++] = 0x00;
     // contextName 없음
 
     // data (Report PDU)
-    memcpy(&scoped_pdu[scoped_index], report_pdu, pdu_len);
-    scoped_index += pdu_len;
+    buffer[index++] = 0xA8; // REPORT PDU
+    int pdu_length_pos = index++; // PDU length position placeholder
 
-    // ScopedPDU 길이 설정
-    int scoped_pdu_length = scoped_index - scoped_pdu_length_pos - 1;
-    int len_bytes = encode_length_at(&scoped_pdu[scoped_pdu_length_pos], scoped_pdu_length);
-    scoped_index += (len_bytes - 1);
+    // Request ID
+    unsigned char request_id_buf[ENCODED_INTEGER_MAX];
+    int request_id_len = encode_integer((int)request_packet->request_id, request_id_buf);
+
+    buffer[index++] = 0x02; // INTEGER
+    index += encode_length(&buffer[index], request_id_len);
+    memcpy(&buffer[index], request_id_buf, request_id_len);
+    index += request_id_len;
+
+    // Error Status
+    buffer[index++] = 0x02; // INTEGER
+    buffer[index++] = 0x01; // Length
+    buffer[index++] = 0x00; // noError
+
+    // Error Index
+    buffer[index++] = 0x02; // INTEGER
+    buffer[index++] = 0x01; // Length
+    buffer[index++] = 0x00; // noError
+
+    // Variable Bindings
+    buffer[index++] = 0x30; // SEQUENCE
+    int varbind_list_len_pos = index++; // Length placeholder
+
+    // Variable Binding
+    buffer[index++] = 0x30; // SEQUENCE
+    int varbind_len_pos = index++; // Length placeholder
+
+    // OID
+    unsigned char oid_buffer[64];
+    int oid_encoded_len = encode_oid(err_oid, err_oid_len, oid_buffer);
+
+    buffer[index++] = 0x06; // OBJECT IDENTIFIER
+    index += encode_length(&buffer[index], oid_encoded_len);
+    memcpy(&buffer[index], oid_buffer, oid_encoded_len);
+    index += oid_encoded_len;
+
+    // Value (Counter32 with value 1)
+    buffer[index++] = 0x41; // Counter32
+    unsigned char error_counter_buf[ENCODED_INTEGER_MAX];
+    int error_counter_len = encode_integer(1, error_counter_buf);
+
+    index += encode_length(&buffer[index], error_counter_len);
+    memcpy(&buffer[index], error_counter_buf, error_counter_len);
+    index += error_counter_len;
+
+    // Variable Binding Length
+    int varbind_len = index - varbind_len_pos - 1;
+    len_bytes = encode_length_at(&buffer[varbind_len_pos], varbind_len);
+    index += (len_bytes - 1);
+
+    // Variable Bindings Length
+    int varbind_list_len = index - varbind_list_len_pos - 1;
+    len_bytes = encode_length_at(&buffer[varbind_list_len_pos], varbind_list_len);
+    index += (len_bytes - 1);
 
-    // ScopedPDU를 메인 버퍼에 복사
-    memcpy(&buffer[index], scoped_pdu, scoped_index);
-    index += scoped_index;
+    // PDU Length
+    int pdu_content_length = index - pdu_length_pos - 1;
+    len_bytes = encode_length_at(&buffer[pdu_length_pos], pdu_content_length);
+    index += (len_bytes - 1);
 
-    // msgData 길이 계산 및 설정이 필요하지 않음 (ScopedPDU를 직접 포함하므로)
+    // ScopedPDU 길이 설정
+    int scoped_pdu_length = index - scoped_pdu_length_pos - 1;
+    len_bytes = encode_length_at(&buffer[scoped_pdu_length_pos], scoped_pdu_length);
+    index += (len_bytes - 1);
 
     // SNMPv3Message 전체 길이 설정
     int snmp_msg_length = index - snmp_msg_length_pos - 1;
     len_bytes = encode_length_at(&buffer[snmp_msg_length_pos], snmp_msg_length);
     index += (len_bytes - 1);
 
-    // Copy the response to the output
     *response_len = index;
-    memcpy(response, buffer, index);
 }
 
 
-void create_bulk_response(SNMPPacket *request_packet, unsigned char *response, int *response_len, MIBTree *mib_tree, 
-                          int non_repeaters, int max_repetitions) {
-    unsigned char varbind_list[BUFFER_SIZE];
-    int varbind_list_len = 0;
-
-    char requested_oid_str[BUFFER_SIZE];
-    oid_to_string(request_packet->oid, request_packet->oid_len, requested_oid_str);
-    // printf("requested_oid_str: %s\n", requested_oid_str);
-
-    int start_index = -1;
+// BER 길이 필드의 바이트 수
+static int length_field_size(int len) {
+    unsigned char length_buf[8];
+    return encode_length(length_buf, len);
+}
 
-    // 요청된 OID 이후의 첫 번째 항목을 찾기
-    for (int i = 0; i < mib_tree->node_count; i++) {
-        unsigned char mib_oid[BUFFER_SIZE];
-        int mib_oid_len = string_to_oid(mib_tree->nodes[i]->oid, mib_oid);
-        int cmp_result = oid_compare(request_packet->oid, request_packet->oid_len, mib_oid, mib_oid_len);
-        if (cmp_result < 0) {
-            start_index = i; // 요청된 OID 이후의 첫 번째 항목 설정
-            break;
-        } else if (cmp_result == 0) {
-            start_index = i + 1;
-            break;
-        }
+// GETBULK 응답 메시지에서 VarBindList 길이와 무관한 부분의 길이
+typedef struct {
+    int prefix_len;        // PDU(v3는 ScopedPDU) 앞의 필드: 버전과 커뮤니티 또는 msgGlobalData와 보안 파라미터
+    int scoped_prefix_len; // ScopedPDU의 contextEngineID와 contextName (v1/v2c는 -1)
+    int fields_len;        // request-id, error-status, error-index 필드
+} BulkLayout;
+
+// VarBindList 내용이 varbind_list_len 바이트일 때 GETBULK 응답 메시지의 전체 길이
+static int bulk_message_length(const BulkLayout *layout, int varbind_list_len) {
+    int pdu_content_len = layout->fields_len + 1 + length_field_size(varbind_list_len) + varbind_list_len;
+    int inner_len = 1 + length_field_size(pdu_content_len) + pdu_content_len;
+    if (layout->scoped_prefix_len >= 0) {
+        int scoped_content_len = layout->scoped_prefix_len + inner_len;
+        inner_len = 1 + length_field_size(scoped_content_len) + scoped_content_len;
     }
+    int message_content_len = layout->prefix_len + inner_len;
+    return 1 + length_field_size(message_content_len) + message_content_len;
+}
 
-    if (start_index == -1) {
-        *response_len = 0;
-        return;
+// GETBULK 응답의 VarBindList 끝에 VarBind 하나 (SEQUENCE { OID, Value })를 바로 인코딩.
+// 길이를 먼저 계산해 메시지가 max_len을 넘으면 쓰지 않고 -1
+static int append_bulk_varbind(unsigned char *varbind_list, int *varbind_list_len, const BulkLayout *layout,
+                               int max_len, const char *oid, unsigned char value_tag,
+                               const unsigned char *contents, int contents_len) {
+    unsigned char oid_buffer[sizeof(((MIBNode *)0)->oid)];
+    int oid_len = string_to_oid(oid, oid_buffer);
+    int oid_field_len = 1 + length_field_size(oid_len) + oid_len;
+    int value_field_len = 1 + length_field_size(contents_len) + contents_len;
+    int varbind_len = 1 + length_field_size(oid_field_len + value_field_len) + oid_field_len + value_field_len;
+
+    // 응답 버퍼에 들어가지 않으면 여기까지만 응답 (RFC 3416 4.2.3)
+    if (bulk_message_length(layout, *varbind_list_len + varbind_len) > max_len) {
+        return -1;
     }
 
-    int i = start_index;
+    unsigned char *varbind = &varbind_list[*varbind_list_len];
+    int index = 0;
+    varbind[index++] = 0x30; // SEQUENCE
+    index += encode_length(&varbind[index], oid_field_len + value_field_len);
+    varbind[index++] = 0x06; // OBJECT IDENTIFIER
+    index += encode_length(&varbind[index], oid_len);
+    memcpy(&varbind[index], oid_buffer, oid_len);
+    index += oid_len;
+    varbind[index++] = value_tag;
+    index += encode_length(&varbind[index], contents_len);
+    memcpy(&varbind[index], contents, contents_len);
+
+    *varbind_list_len += varbind_len;
+    return 0;
+}
 
-    // Non-repeaters 처리
-    for (int j = 0; j < non_repeaters && i < mib_tree->node_count; j++, i++) {
-        MIBNode *current_node = mib_tree->nodes[i];
-        unsigned char varbind[BUFFER_SIZE];
-        int varbind_len = 0;
-
-        // OID 인코딩
-        unsigned char oid_buffer[BUFFER_SIZE];
-        int oid_len = string_to_oid(current_node->oid, oid_buffer);
-
-        // Value 인코딩
-        unsigned char value_buffer[BUFFER_SIZE];
-        int value_len = 0;
-        if (current_node->value_type == VALUE_TYPE_STRING) {
-            value_len = strlen(current_node->value.str_value);
-            memcpy(value_buffer, current_node->value.str_value, value_len);
-        } else if (current_node->value_type == VALUE_TYPE_INT) {
-            int int_value = current_node->value.int_value;
-            value_len = encode_integer(int_value, value_buffer);
-        } else if (current_node->value_type == VALUE_TYPE_OID) {
-            value_len = string_to_oid(current_node->value.oid_value, value_buffer);
-        } else if (current_node->value_type == VALUE_TYPE_TIME_TICKS) {
-            unsigned long ticks_value = current_node->value.ticks_value;
-            value_len = encode_integer(ticks_value, value_buffer);
-        }
+// 요청된 OID 이후의 항목으로 GETBULK 응답의 VarBindList 내용을 인코딩하고 길이를 반환
+static int encode_bulk_varbind_list(const unsigned char *requested_oid, int requested_oid_len,
+                                    unsigned char *varbind_list, const BulkLayout *layout, int max_len,
+                                    MIBTree *mib_tree, SNMPView *view, int non_repeaters, int max_repetitions) {
+    int varbind_list_len = 0;
 
-        // Value 필드 작성
-        unsigned char value_field[BUFFER_SIZE];
-        int value_field_len = 0;
-        if (current_node->value_type == VALUE_TYPE_STRING) {
-            value_field[value_field_len++] = 0x04; // OCTET STRING
-        } else if (current_node->value_type == VALUE_TYPE_INT) {
-            value_field[value_field_len++] = 0x02; // INTEGER
-        } else if (current_node->value_type == VALUE_TYPE_OID) {
-            value_field[value_field_len++] = 0x06; // OBJECT IDENTIFIER
-        } else if (current_node->value_type == VALUE_TYPE_TIME_TICKS) {
-            value_field[value_field_len++] = 0x43; // TimeTicks
-        } else {
-            value_field[value_field_len++] = 0x05; // NULL
-            value_len = 0;
-        }
-        value_field_len += encode_length(&value_field[value_field_len], value_len);
-        if (value_len > 0) {
-            memcpy(&value_field[value_field_len], value_buffer, value_len);
-            value_field_len += value_len;
-        }
+    char requested_oid_str[VARBIND_OID_STRING_MAX];
+    oid_to_string(requested_oid, requested_oid_len, requested_oid_str);
+    // printf("requested_oid_str: %s\n", requested_oid_str);
+
+    // 요청된 OID 이후의 첫 번째 항목을 찾기 (스칼라 또는 테이블 셀)
+    MIBNode cell;
+    // 뷰나 MIB의 끝이면 아래에서 endOfMibView로 응답
+    MIBNode *next = find_next_view_instance(mib_tree, view, requested_oid_str, &cell);
 
-        // OID 필드 작성 (OBJECT IDENTIFIER)
-        unsigned char oid_field[BUFFER_SIZE];
-        int oid_field_len = 0;
-        oid_field[oid_field_len++] = 0x06; // OBJECT IDENTIFIER
-        oid_field_len += encode_length(&oid_field[oid_field_len], oid_len);
-        memcpy(&oid_field[oid_field_len], oid_buffer, oid_len);
-        oid_field_len += oid_len;
-
-        // VarBind 작성 (SEQUENCE)
-        varbind[varbind_len++] = 0x30; // SEQUENCE
-        int varbind_content_len = oid_field_len + value_field_len;
-        varbind_len += encode_length(&varbind[varbind_len], varbind_content_len);
-        memcpy(&varbind[varbind_len], oid_field, oid_field_len);
-        varbind_len += oid_field_len;
-        memcpy(&varbind[varbind_len], value_field, value_field_len);
-        varbind_len += value_field_len;
+    // 마지막으로 응답에 넣은 OID (endOfMibView에 사용)
+    char last_oid[sizeof(cell.oid)];
+    strncpy(last_oid, requested_oid_str, sizeof(last_oid) - 1);
+    last_oid[sizeof(last_oid) - 1] = '\0';
+
+    unsigned char contents[sizeof(MIBValue)];
+    unsigned char value_tag;
+
+    // Non-repeaters 처리
+    for (int j = 0; j < non_repeaters && next != NULL; j++) {
+        MIBNode current_snapshot;
+        mib_node_snapshot(next, &current_snapshot);
+        MIBNode *current_node = &current_snapshot;
+        strcpy(last_oid, current_node->oid);
+        next = find_next_view_instance(mib_tree, view, last_oid, &cell);
 
         // VarBind를 VarBindList에 추가
-        memcpy(&varbind_list[varbind_list_len], varbind, varbind_len);
-        varbind_list_len += varbind_len;
+        int contents_len = encode_mib_value(current_node->value_type, &current_node->value, &value_tag, contents);
+        if (append_bulk_varbind(varbind_list, &varbind_list_len, layout, max_len,
+                                current_node->oid, value_tag, contents, contents_len) < 0) {
+            break;
+        }
     }
 
     // Max-repetitions 처리
     for (int repetitions = 0; repetitions < max_repetitions; repetitions++) {
-        if (i >= mib_tree->node_count) {
-            // MIB 트리의 끝에 도달했을 경우, endOfMibView 추가
-            unsigned char varbind[BUFFER_SIZE];
-            int varbind_len = 0;
-
-            // OID 인코딩 (마지막 항목의 OID를 그대로 사용)
-            unsigned char oid_buffer[BUFFER_SIZE];
-            int oid_len = string_to_oid(mib_tree->nodes[mib_tree->node_count - 1]->oid, oid_buffer);
-
-            // Value 필드 작성 (endOfMibView)
-            unsigned char value_field[BUFFER_SIZE];
-            int value_field_len = 0;
-            value_field[value_field_len++] = 0x82; // endOfMibView
-            value_field_len += encode_length(&value_field[value_field_len], 0);
-
-            // OID 필드 작성 (OBJECT IDENTIFIER)
-            unsigned char oid_field[BUFFER_SIZE];
-            int oid_field_len = 0;
-            oid_field[oid_field_len++] = 0x06; // OBJECT IDENTIFIER
-            oid_field_len += encode_length(&oid_field[oid_field_len], oid_len);
-            memcpy(&oid_field[oid_field_len], oid_buffer, oid_len);
-            oid_field_len += oid_len;
-
-            // VarBind 작성 (SEQUENCE)
-            varbind[varbind_len++] = 0x30; // SEQUENCE
-            int varbind_content_len = oid_field_len + value_field_len;
-            varbind_len += encode_length(&varbind[varbind_len], varbind_content_len);
-            memcpy(&varbind[varbind_len], oid_field, oid_field_len);
-            varbind_len += oid_field_len;
-            memcpy(&varbind[varbind_len], value_field, value_field_len);
-            varbind_len += value_field_len;
-
-            // VarBind를 VarBindList에 추가
-            memcpy(&varbind_list[varbind_list_len], varbind, varbind_len);
-            varbind_list_len += varbind_len;
+        if (next == NULL) {
+            // MIB 트리의 끝에 도달했을 경우, endOfMibView 추가 (마지막 항목의 OID를 그대로 사용)
+            append_bulk_varbind(varbind_list, &varbind_list_len, layout, max_len,
+                                last_oid, 0x82, contents, 0);
             break; // endOfMibView가 추가되면 반복을 종료
         }
 
-        MIBNode *current_node = mib_tree->nodes[i];
+        MIBNode current_snapshot;
+        mib_node_snapshot(next, &current_snapshot);
+        MIBNode *current_node = &current_snapshot;
+        strcpy(last_oid, current_node->oid);
 
         // OID와 Value를 VarBind에 추가
-        unsigned char varbind[BUFFER_SIZE];
-        int varbind_len = 0;
-
-        // OID 인코딩
-        unsigned char oid_buffer[BUFFER_SIZE];
-        int oid_len = string_to_oid(current_node->oid, oid_buffer);
-
-        // Value 인코딩
-        unsigned char value_buffer[BUFFER_SIZE];
-        int value_len = 0;
-        if (current_node->value_type == VALUE_TYPE_STRING) {
-            value_len = strlen(current_node->value.str_value);
-            memcpy(value_buffer, current_node->value.str_value, value_len);
-        } else if (current_node->value_type == VALUE_TYPE_INT) {
-            int int_value = current_node->value.int_value;
-            value_len = encode_integer(int_value, value_buffer);
-        } else if (current_node->value_type == VALUE_TYPE_OID) {
-            value_len = string_to_oid(current_node->value.oid_value, value_buffer);
-        } else if (current_node->value_type == VALUE_TYPE_TIME_TICKS) {
-            unsigned long ticks_value = current_node->value.ticks_value;
-            value_len = encode_integer(ticks_value, value_buffer);
-        }
-
-        // Value 필드 작성
-        unsigned char value_field[BUFFER_SIZE];
-        int value_field_len = 0;
-        if (current_node->value_type == VALUE_TYPE_STRING) {
-            value_field[value_field_len++] = 0x04; // OCTET STRING
-        } else if (current_node->value_type == VALUE_TYPE_INT) {
-            value_field[value_field_len++] = 0x02; // INTEGER
-        } else if (current_node->value_type == VALUE_TYPE_OID) {
-            value_field[value_field_len++] = 0x06; // OBJECT IDENTIFIER
-        } else if (current_node->value_type == VALUE_TYPE_TIME_TICKS) {
-            value_field[value_field_len++] = 0x43; // TimeTicks
-        } else {
-            value_field[value_field_len++] = 0x05; // NULL
-            value_len = 0;
-        }
-        value_field_len += encode_length(&value_field[value_field_len], value_len);
-        if (value_len > 0) {
-            memcpy(&value_field[value_field_len], value_buffer, value_len);
-            value_field_len += value_len;
+        int contents_len = encode_mib_value(current_node->value_type, &current_node->value, &value_tag, contents);
+        if (append_bulk_varbind(varbind_list, &varbind_list_len, layout, max_len,
+                                current_node->oid, value_tag, contents, contents_len) < 0) {
+            break;
         }
 
-        // OID 필드 작성 (OBJECT IDENTIFIER)
-        unsigned char oid_field[BUFFER_SIZE];
-        int oid_field_len = 0;
-        oid_field[oid_field_len++] = 0x06; // OBJECT IDENTIFIER
-        oid_field_len += encode_length(&oid_field[oid_field_len], oid_len);
-        memcpy(&oid_field[oid_field_len], oid_buffer, oid_len);
-        oid_field_len += oid_len;
-
-        // VarBind 작성 (SEQUENCE)
-        varbind[varbind_len++] = 0x30; // SEQUENCE
-        int varbind_content_len = oid_field_len + value_field_len;
-        varbind_len += encode_length(&varbind[varbind_len], varbind_content_len);
-        memcpy(&varbind[varbind_len], oid_field, oid_field_len);
-        varbind_len += oid_field_len;
-        memcpy(&varbind[varbind_len], value_field, value_field_len);
-        varbind_len += value_field_len;
-
-        // VarBind를 VarBindList에 추가
-        memcpy(&varbind_list[varbind_list_len], varbind, varbind_len);
-        varbind_list_len += varbind_len;
-
-        // 다음 반복을 위해 인덱스 증가
-        i++;
+        // 다음 반복을 위한 항목 (테이블은 열 우선 순서로 이어짐)
+        next = find_next_view_instance(mib_tree, view, last_oid, &cell);
     }
 
-    // Variable Bindings 작성 (SEQUENCE)
-    unsigned char varbind_list_field[BUFFER_SIZE];
-    int varbind_list_field_len = 0;
-    varbind_list_field[varbind_list_field_len++] = 0x30; // SEQUENCE
-    varbind_list_field_len += encode_length(&varbind_list_field[varbind_list_field_len], varbind_list_len);
-    memcpy(&varbind_list_field[varbind_list_field_len], varbind_list, varbind_list_len);
-    varbind_list_field_len += varbind_list_len;
+    return varbind_list_len;
+}
 
-    // 이후 PDU 작성 및 응답 생성
-    unsigned char pdu[BUFFER_SIZE];
-    int pdu_len = 0;
-    pdu[pdu_len++] = 0xA2; // GET-RESPONSE PDU
-    unsigned char pdu_content[BUFFER_SIZE];
-    int pdu_content_len = 0;
+// GETBULK 응답 PDU 헤더 (PDU 태그와 길이, Request ID, Error Status, Error Index, VarBindList 헤더)
+static int encode_bulk_pdu_header(unsigned char *buffer, const unsigned char *request_id_buf, int request_id_len,
+                                  int varbind_list_len) {
+    unsigned char pdu_fields[32];
+    int pdu_fields_len = 0;
 
     // Request ID
-    pdu_content[pdu_content_len++] = 0x02; // INTEGER
-    unsigned char request_id_buf[5];
-    int request_id_len = encode_integer(request_packet->request_id, request_id_buf);
-    pdu_content_len += encode_length(&pdu_content[pdu_content_len], request_id_len);
-    memcpy(&pdu_content[pdu_content_len], request_id_buf, request_id_len);
-    pdu_content_len += request_id_len;
+    pdu_fields[pdu_fields_len++] = 0x02; // INTEGER
+    pdu_fields_len += encode_length(&pdu_fields[pdu_fields_len], request_id_len);
+    memcpy(&pdu_fields[pdu_fields_len], request_id_buf, request_id_len);
+    pdu_fields_len += request_id_len;
 
     // Error Status
-    pdu_content[pdu_content_len++] = 0x02; // INTEGER
-    pdu_content[pdu_content_len++] = 0x01; // 길이 1바이트
-    pdu_content[pdu_content_len++] = 0x00; // noError
+    pdu_fields[pdu_fields_len++] = 0x02; // INTEGER
+    pdu_fields[pdu_fields_len++] = 0x01; // 길이 1바이트
+    pdu_fields[pdu_fields_len++] = 0x00; // noError
 
     // Error Index
-    pdu_content[pdu_content_len++] = 0x02; // INTEGER
-    pdu_content[pdu_content_len++] = 0x01; // 길이 1바이트
-    pdu_content[pdu_content_len++] = 0x00; // noError
+    pdu_fields[pdu_fields_len++] = 0x02; // INTEGER
+    pdu_fields[pdu_fields_len++] = 0x01; // 길이 1바이트
+    pdu_fields[pdu_fields_len++] = 0x00; // noError
 
-    // Variable Bindings 추가
-    memcpy(&pdu_content[pdu_content_len], varbind_list_field, varbind_list_field_len);
-    pdu_content_len += varbind_list_field_len;
+    // Variable Bindings (SEQUENCE)
+    pdu_fields[pdu_fields_len++] = 0x30; // SEQUENCE
+    pdu_fields_len += encode_length(&pdu_fields[pdu_fields_len], varbind_list_len);
 
-    // PDU 길이 설정
-    pdu_len += encode_length(&pdu[pdu_len], pdu_content_len);
-    memcpy(&pdu[pdu_len], pdu_content, pdu_content_len);
-    pdu_len += pdu_content_len;
+    int index = 0;
+    buffer[index++] = 0xA2; // GET-RESPONSE PDU
+    index += encode_length(&buffer[index], pdu_fields_len + varbind_list_len);
+    memcpy(&buffer[index], pdu_fields, pdu_fields_len);
+    return index + pdu_fields_len;
+}
+
+// 응답은 max_len 바이트까지 채움. VarBind는 메시지 헤더 자리를 비워 두고
+// response에 바로 인코딩한 뒤 헤더 뒤로 당기므로 response에는
+// SNMP_RESPONSE_RESERVE 바이트의 여유가 더 있어야 함
+void create_bulk_response(SNMPPacket *request_packet, unsigned char *response, int *response_len, int max_len,
+                          MIBTree *mib_tree, SNMPView *view, int non_repeaters, int max_repetitions) {
+    int community_len = strlen(request_packet->community);
+
+    // 메시지 헤더 (버전, 커뮤니티, PDU 필드, 각 SEQUENCE의 최대 5바이트 태그+길이) 자리
+    int header_max = 40 + community_len;
+    unsigned char *varbind_list = response + header_max;
+
+    // 헤더 길이는 VarBindList 길이에 따라 달라지므로 VarBind마다 정확한 메시지 길이로 검사
+    unsigned char request_id_buf[ENCODED_INTEGER_MAX];
+    int request_id_len = encode_integer((int)request_packet->request_id, request_id_buf);
+    BulkLayout layout = { 3 + 1 + length_field_size(community_len) + community_len, -1,
+                          2 + request_id_len + 3 + 3 };
+
+    int varbind_list_len = encode_bulk_varbind_list(request_packet->oid, request_packet->oid_len, varbind_list,
+                                                    &layout, max_len, mib_tree, view,
+                                                    non_repeaters, max_repetitions);
+
+    // PDU 헤더
+    unsigned char pdu_header[40];
+    int pdu_header_len = encode_bulk_pdu_header(pdu_header, request_id_buf, request_id_len, varbind_list_len);
 
-    // 전체 메시지 작성 (SEQUENCE)
-    int cursor = 0;
-    response[cursor++] = 0x30; // SEQUENCE
+    // 메시지 헤더 (SEQUENCE, 버전, 커뮤니티, PDU 헤더)
+    unsigned char header[64 + sizeof(request_packet->community)];
+    int message_content_len = layout.prefix_len + pdu_header_len + varbind_list_len;
+    int header_len = 0;
 
-    // 메시지 내용 작성
-    unsigned char message_content[BUFFER_SIZE];
-    int message_content_len = 0;
+    header[header_len++] = 0x30; // SEQUENCE
+    header_len += encode_length(&header[header_len], message_content_len);
 
     // SNMP 버전
-    message_content[message_content_len++] = 0x02; // INTEGER
-    message_content[message_content_len++] = 0x01; // 길이 1바이트
-    message_content[message_content_len++] = request_packet->version;
+    header[header_len++] = 0x02; // INTEGER
+    header[header_len++] = 0x01; // 길이 1바이트
+    header[header_len++] = request_packet->version;
 
     // 커뮤니티 문자열
-    message_content[message_content_len++] = 0x04; // OCTET STRING
-    int community_len = strlen(request_packet->community);
-    message_content_len += encode_length(&message_content[message_content_len], community_len);
-    memcpy(&message_content[message_content_len], request_packet->community, community_len);
-    message_content_len += community_len;
+    header[header_len++] = 0x04; // OCTET STRING
+    header_len += encode_length(&header[header_len], community_len);
+    memcpy(&header[header_len], request_packet->community, community_len);
+    header_len += community_len;
 
-    // PDU 추가
-    memcpy(&message_content[message_content_len], pdu, pdu_len);
-    message_content_len += pdu_len;
+    // PDU
+    memcpy(&header[header_len], pdu_header, pdu_header_len);
+    header_len += pdu_header_len;
 
-    // 전체 메시지 길이 설정
-    cursor += encode_length(&response[cursor], message_content_len);
-    memcpy(&response[cursor], message_content, message_content_len);
-    cursor += message_content_len;
+    // VarBind를 헤더 바로 뒤로 당기고 헤더를 앞에 씀
+    memmove(response + header_len, varbind_list, varbind_list_len);
+    memcpy(response, header, header_len);
 
     // 응답 길이 설정
-    *response_len = cursor;
+    *response_len = header_len + varbind_list_len;
+}
+
+// SNMPv3 GETBULK 응답 생성 (v1/v2c와 같이 max_len 바이트까지 채우고
+// response에는 SNMP_RESPONSE_RESERVE 바이트의 여유가 더 있어야 함)
+void create_snmpv3_bulk_response(SNMPv3Packet *request_packet, unsigned char *response, int *response_len,
+                                 int max_len, MIBTree *mib_tree, SNMPView *view,
+                                 int non_repeaters, int max_repetitions) {
+    // msgVersion ~ contextName (Scoped PDU 태그와 1바이트 길이 자리 포함)
+    unsigned char v3_header[SNMPV3_HEADER_MAX];
+    int scoped_pdu_length_pos;
+    int v3_header_len = encode_snmpv3_header(request_packet, v3_header, &scoped_pdu_length_pos);
+
+    // 메시지 헤더 (v3 헤더, PDU 필드, 각 SEQUENCE의 최대 5바이트 태그+길이) 자리
+    int header_max = v3_header_len + 40;
+    unsigned char *varbind_list = response + header_max;
+
+    unsigned char request_id_buf[ENCODED_INTEGER_MAX];
+    int request_id_len = encode_integer((int)request_packet->request_id, request_id_buf);
+    BulkLayout layout = { scoped_pdu_length_pos - 1, v3_header_len - scoped_pdu_length_pos - 1,
+                          2 + request_id_len + 3 + 3 };
+
+    int varbind_list_len = encode_bulk_varbind_list(request_packet->varbind_list[0].oid,
+                                                    request_packet->varbind_list[0].oid_len, varbind_list,
+                                                    &layout, max_len, mib_tree, view,
+                                                    non_repeaters, max_repetitions);
+
+    unsigned char pdu_header[40];
+    int pdu_header_len = encode_bulk_pdu_header(pdu_header, request_id_buf, request_id_len, varbind_list_len);
+
+    // 헤더는 VarBind 자리 앞에 들어가므로 response에 바로 작성
+    int scoped_content_len = layout.scoped_prefix_len + pdu_header_len + varbind_list_len;
+    int message_content_len = layout.prefix_len + 1 + length_field_size(scoped_content_len) + scoped_content_len;
+    int header_len = 0;
+
+    response[header_len++] = 0x30; // SEQUENCE
+    header_len += encode_length(&response[header_len], message_content_len);
+
+    // msgVersion, msgGlobalData, msgSecurityParameters
+    memcpy(&response[header_len], v3_header, layout.prefix_len);
+    header_len += layout.prefix_len;
+
+    // Scoped PDU (contextEngineID, contextName, PDU 헤더)
+    response[header_len++] = 0x30; // SEQUENCE
+    header_len += encode_length(&response[header_len], scoped_content_len);
+    memcpy(&response[header_len], &v3_header[scoped_pdu_length_pos + 1], layout.scoped_prefix_len);
+    header_len += layout.scoped_prefix_len;
+    memcpy(&response[header_len], pdu_header, pdu_header_len);
+    header_len += pdu_header_len;
+
+    // VarBind를 헤더 바로 뒤로 당김
+    memmove(response + header_len, varbind_list, varbind_list_len);
+
+    // 응답 길이 설정
+    *response_len = header_len + varbind_list_len;
+}
+
+// 요청 VarBind를 그대로 인코딩 (SEQUENCE { OID, Value })
+static int encode_raw_varbind(unsigned char *buffer, const VarBind *varbind) {
+    unsigned char length_buf[8];
+    int content_len = 1 + encode_length(length_buf, varbind->oid_len) + varbind->oid_len +
+                      1 + encode_length(length_buf, varbind->value_len) + varbind->value_len;
+    int index = 0;
+
+    buffer[index++] = 0x30; // SEQUENCE
+    index += encode_length(&buffer[index], content_len);
+
+    buffer[index++] = 0x06; // OBJECT IDENTIFIER
+    index += encode_length(&buffer[index], varbind->oid_len);
+    memcpy(&buffer[index], varbind->oid, varbind->oid_len);
+    index += varbind->oid_len;
+
+    buffer[index++] = varbind->value_type;
+    index += encode_length(&buffer[index], varbind->value_len);
+    memcpy(&buffer[index], varbind->value, varbind->value_len);
+    index += varbind->value_len;
+
+    return index;
 }
 
-void snmp_request(unsigned char *buffer, int n, struct sockaddr_in *cliaddr, int sockfd,
-                  int snmp_version, const char *allowed_community, MIBTree *mib_tree) {
-    update_dynamic_values(mib_tree);
+// PDU 본문 (request-id ~ VarBind list) 인코딩, 버퍼가 부족하면 -1
+static int encode_varbind_list_pdu(unsigned char *buffer, int index, int buffer_size, unsigned char pdu_type,
+                                   unsigned int request_id, const VarBind *varbind_list, int varbind_count,
+                                   int error_status, int error_index) {
+    buffer[index++] = pdu_type; // GET-RESPONSE, SNMPv2-Trap, InformRequest
+    int pdu_length_pos = index++; // PDU 길이 위치를 저장
+
+    // Request ID
+    buffer[index++] = 0x02; // INTEGER
+    index += encode_length(&buffer[index], 4);
+    buffer[index++] = (request_id >> 24) & 0xFF;
+    buffer[index++] = (request_id >> 16) & 0xFF;
+    buffer[index++] = (request_id >> 8) & 0xFF;
+    buffer[index++] = request_id & 0xFF;
+
+    // Error Status
+    buffer[index++] = 0x02; // INTEGER
+    index += encode_length(&buffer[index], 1);
+    buffer[index++] = error_status;
+
+    // Error Index
+    buffer[index++] = 0x02; // INTEGER
+    index += encode_length(&buffer[index], 1);
+    buffer[index++] = error_index;
 
-    if (snmp_version == 3) {
-        SNMPv3Packet snmp_packet;
-        memset(&snmp_packet, 0, sizeof(SNMPv3Packet));
+    // Variable Bindings
+    buffer[index++] = 0x30; // SEQUENCE
+    int varbind_list_length_pos = index++; // Variable Bindings 길이 위치 저장
 
-        int index = 0;
-        parse_snmpv3_message(buffer, &index, n, &snmp_packet);
+    for (int i = 0; i < varbind_count; i++) {
+        // OID + 값 + TLV 헤더(최대 12바이트)
+        if (index + varbind_list[i].oid_len + varbind_list[i].value_len + 12 > buffer_size) {
+            return -1;
+        }
+        index += encode_raw_varbind(&buffer[index], &varbind_list[i]);
+    }
 
-        printSNMPv3Packet(&snmp_packet);
+    // Variable Bindings 길이 설정
+    int varbind_list_length = index - varbind_list_length_pos - 1;
+    index += encode_length_at(&buffer[varbind_list_length_pos], varbind_list_length) - 1;
 
-        if (snmp_packet.msgAuthoritativeEngineID_len == 0) {
-            unsigned char response[BUFFER_SIZE];
-            int response_len = 0;
+    // PDU 길이 설정
+    int pdu_length = index - pdu_length_pos - 1;
+    index += encode_length_at(&buffer[pdu_length_pos], pdu_length) - 1;
 
-            // 보고서 응답 생성
-            create_snmpv3_report_response(&snmp_packet, response, &response_len, SNMPERR_USM_UNKNOWNENGINEID);
+    return index;
+}
 
-            // 응답 전송
-            if (response_len > 0) {
-                sendto(sockfd, response, response_len, 0, (struct sockaddr *)cliaddr, sizeof(*cliaddr));
+void create_varbind_list_response(SNMPPacket *request_packet, unsigned char *response, int *response_len,
+                                  int max_len, const VarBind *varbind_list, int varbind_count,
+                                  int error_status, int error_index) {
+    unsigned char *buffer = response + MESSAGE_BODY_OFFSET;
+    int index = 0;
+
+    // 1. SNMP Version
+    buffer[index++] = 0x02; // INTEGER
+    index += encode_length(&buffer[index], 1);
+    buffer[index++] = request_packet->version;
+
+    // 2. Community String
+    buffer[index++] = 0x04; // OCTET STRING
+    int community_length = strlen(request_packet->community);
+    index += encode_length(&buffer[index], community_length);
+    memcpy(&buffer[index], request_packet->community, community_length);
+    index += community_length;
+
+    // 3. PDU (max_len을 넘으면 VarBind 없이 tooBig)
+    int pdu_pos = index;
+    index = encode_varbind_list_pdu(buffer, pdu_pos, max_len, 0xA2, request_packet->request_id,
+                                    varbind_list, varbind_count, error_status, error_index);
+    if (index < 0) {
+        index = encode_varbind_list_pdu(buffer, pdu_pos, max_len, 0xA2, request_packet->request_id,
+                                        NULL, 0, SNMP_ERROR_TOO_BIG, 0);
+    }
+
+    // 전체 메시지를 SEQUENCE로 감싸기
+    *response_len = wrap_message(response, index);
+}
+
+void create_snmpv3_varbind_list_response(SNMPv3Packet *request_packet, unsigned char *response, int *response_len,
+                                         int max_len, const VarBind *varbind_list, int varbind_count,
+                                         int error_status, int error_index) {
+    unsigned char *buffer = response + MESSAGE_BODY_OFFSET;
+
+    int scoped_pdu_length_pos;
+    int pdu_pos = encode_snmpv3_header(request_packet, buffer, &scoped_pdu_length_pos);
+
+    // max_len을 넘으면 VarBind 없이 tooBig
+    int index = encode_varbind_list_pdu(buffer, pdu_pos, max_len, 0xA2, request_packet->request_id,
+                                        varbind_list, varbind_count, error_status, error_index);
+    if (index < 0) {
+        index = encode_varbind_list_pdu(buffer, pdu_pos, max_len, 0xA2, request_packet->request_id,
+                                        NULL, 0, SNMP_ERROR_TOO_BIG, 0);
+    }
+
+    finish_snmpv3_message(response, index, scoped_pdu_length_pos, response_len);
+}
+
+// Function to encode the current value of a node as a VarBind
+// (OID in the first half of storage, value in the second)
+int mib_node_to_varbind(const MIBNode *node, VarBind *varbind, unsigned char *storage) {
+    MIBValue value;
+    mib_node_read_value(node, &value);
+
+    varbind->oid = storage;
+    varbind->oid_len = string_to_oid(node->oid, storage);
+    varbind->value = storage + VARBIND_STORAGE_SIZE / 2;
+    varbind->value_len = encode_mib_value(node->value_type, &value, &varbind->value_type,
+                                          storage + VARBIND_STORAGE_SIZE / 2);
+
+    return 0;
+}
+
+// Function to build a VarBind with an OID value (snmpTrapOID.0, ...)
+static void make_oid_varbind(VarBind *varbind, unsigned char *storage, const char *name_oid, const char *value_oid) {
+    varbind->oid = storage;
+    varbind->oid_len = string_to_oid(name_oid, storage);
+    varbind->value_type = TYPE_OID;
+    varbind->value = storage + VARBIND_STORAGE_SIZE / 2;
+    varbind->value_len = string_to_oid(value_oid, storage + VARBIND_STORAGE_SIZE / 2);
+}
+
+// Function to encode an SNMPv1 Trap-PDU (RFC 1157).
+// snmpTrapOID is translated to enterprise/generic/specific as in RFC 3584 3.2.
+static int encode_v1_trap_pdu(const SNMPNotification *notification, unsigned char *buffer, int index, int max_len) {
+    char enterprise[64];
+    int generic_trap;
+    int specific_trap = 0;
+    const char *standard_traps = "1.3.6.1.6.3.1.1.5.";
+
+    if (strncmp(notification->trap_oid, standard_traps, strlen(standard_traps)) == 0) {
+        // coldStart(1) ~ linkUp(4), authenticationFailure(5)
+        generic_trap = atoi(notification->trap_oid + strlen(standard_traps)) - 1;
+        strncpy(enterprise, notification->enterprise, sizeof(enterprise) - 1);
+        enterprise[sizeof(enterprise) - 1] = '\0';
+    } else {
+        generic_trap = 6; // enterpriseSpecific
+        strncpy(enterprise, notification->trap_oid, sizeof(enterprise) - 1);
+        enterprise[sizeof(enterprise) - 1] = '\0';
+
+        char *last = strrchr(enterprise, '.');
+        if (last) {
+            specific_trap = atoi(last + 1);
+            *last = '\0';
+            // <enterprise>.0.<specific> 형식이면 ".0"도 제거
+            int len = strlen(enterprise);
+            if (len > 2 && strcmp(&enterprise[len - 2], ".0") == 0) {
+                enterprise[len - 2] = '\0';
             }
-            return;
         }
+    }
+
+    buffer[index++] = 0xA4; // Trap-PDU
+    int pdu_length_pos = index++;
+
+    // enterprise
+    buffer[index++] = 0x06; // OBJECT IDENTIFIER
+    int oid_len = string_to_oid(enterprise, &buffer[index + 1]);
+    index += encode_length_at(&buffer[index], oid_len);
+    index += oid_len;
+
+    // agent-addr
+    buffer[index++] = 0x40; // IpAddress
+    index += encode_length(&buffer[index], 4);
+    memcpy(&buffer[index], notification->agent_addr, 4);
+    index += 4;
+
+    // generic-trap, specific-trap
+    buffer[index++] = 0x02; // INTEGER
+    index += encode_length(&buffer[index], 1);
+    buffer[index++] = generic_trap;
+
+    buffer[index++] = 0x02; // INTEGER
+    int specific_len = encode_integer(specific_trap, &buffer[index + 1]);
+    index += encode_length_at(&buffer[index], specific_len);
+    index += specific_len;
 
-        // 요청된 OID를 문자열로 변환
-        char requested_oid_str[BUFFER_SIZE];
-        oid_to_string(snmp_packet.varbind_list[0].oid, snmp_packet.varbind_list[0].oid_len, requested_oid_str);
+    // time-stamp
+    buffer[index++] = 0x43; // TimeTicks
+    int ticks_len = encode_integer(notification->timestamp & 0xFFFFFFFFUL, &buffer[index + 1]);
+    index += encode_length_at(&buffer[index], ticks_len);
+    index += ticks_len;
 
-        unsigned char response[BUFFER_SIZE];
-        int response_len = 0;
+    // variable-bindings
+    buffer[index++] = 0x30; // SEQUENCE
+    int varbind_list_length_pos = index++;
+
+    for (int i = 0; i < notification->varbind_count; i++) {
+        const VarBind *varbind = &notification->varbind_list[i];
+        if (index + varbind->oid_len + varbind->value_len + 12 > max_len) {
+            return -1;
+        }
+        index += encode_raw_varbind(&buffer[index], varbind);
+    }
 
-        // MIB에서 해당 OID를 검색
-        MIBNode *entry = NULL;
-        for (int i = 0; i < mib_tree->node_count; i++) {
-            if (strcmp(mib_tree->nodes[i]->oid, requested_oid_str) == 0) {
-                entry = mib_tree->nodes[i];
-                break;
+    int varbind_list_length = index - varbind_list_length_pos - 1;
+    index += encode_length_at(&buffer[varbind_list_length_pos], varbind_list_length) - 1;
+
+    int pdu_length = index - pdu_length_pos - 1;
+    index += encode_length_at(&buffer[pdu_length_pos], pdu_length) - 1;
+
+    return index;
+}
+
+// Function to build a notification message (v1 Trap, v2c/v3 SNMPv2-Trap or InformRequest).
+// For v2c/v3 sysUpTime.0 and snmpTrapOID.0 are prepended to the VarBind list.
+int create_notification(const SNMPNotification *notification, unsigned char *message, int *message_len,
+                        int max_len) {
+    unsigned char *buffer = message + MESSAGE_BODY_OFFSET;
+    int index = 0;
+
+    *message_len = 0;
+
+    if (notification->version == SNMP_VERSION_1 || notification->version == SNMP_VERSION_2c) {
+        buffer[index++] = 0x02; // INTEGER
+        index += encode_length(&buffer[index], 1);
+        buffer[index++] = notification->version;
+
+        buffer[index++] = 0x04; // OCTET STRING
+        int community_length = strlen(notification->security_name);
+        index += encode_length(&buffer[index], community_length);
+        memcpy(&buffer[index], notification->security_name, community_length);
+        index += community_length;
+
+        if (notification->version == SNMP_VERSION_1) {
+            index = encode_v1_trap_pdu(notification, buffer, index, max_len);
+            if (index < 0) {
+                return -1;
             }
+
+            *message_len = wrap_message(message, index);
+            return 0;
         }
+    }
 
-        // PDU 타입에 따라 처리
-        switch (snmp_packet.pdu_type) {
-            case 0xA0: // GetRequest
-                if (entry != NULL) {
-                    // MIB 항목을 찾았을 때 정상적인 응답 생성
-                    create_snmpv3_response(&snmp_packet, response, &response_len,
-                                           snmp_packet.varbind_list[0].oid,
-                                           snmp_packet.varbind_list[0].oid_len,
-                                           entry, SNMP_ERROR_NO_ERROR, 0);
-                    // printf("GetRequest 처리 완료\n");
-                } else {
-                    // MIB 항목을 찾지 못했을 때 오류 응답 생성 (noSuchObject)
-                    create_snmpv3_response(&snmp_packet, response, &response_len,
-                                           snmp_packet.varbind_list[0].oid,
-                                           snmp_packet.varbind_list[0].oid_len,
-                                           NULL, SNMP_EXCEPTION_NO_SUCH_OBJECT, 0);
-                    // printf("GetRequest: noSuchObject 오류 응답 생성\n");
-                }
-                break;
-
-            case 0xA1: // GetNextRequest
-                {
-                    MIBNode *nextEntry = NULL;
-                    int found = find_next_mib_entry(mib_tree,
-                                                    snmp_packet.varbind_list[0].oid,
-                                                    snmp_packet.varbind_list[0].oid_len,
-                                                    &nextEntry);
-
-                    if (found && nextEntry != NULL) {
-                        // 다음 OID를 바이너리 형식으로 변환
-                        unsigned char next_oid_binary[BUFFER_SIZE];
-                        int next_oid_binary_len = string_to_oid(nextEntry->oid, next_oid_binary);
-
-                        // 응답에 다음 OID를 포함하여 생성
-                        create_snmpv3_response(&snmp_packet, response, &response_len,
-                                               next_oid_binary, next_oid_binary_len,
-                                               nextEntry, SNMP_ERROR_NO_ERROR, 0);
-                        // printf("GetNextRequest 처리 완료: 다음 OID = %s\n", nextEntry->oid);
-                    } else {
-                        // 더 이상 OID가 없을 때 오류 응답 생성 (endOfMibView)
-                        create_snmpv3_response(&snmp_packet, response, &response_len,
-                                               snmp_packet.varbind_list[0].oid,
-                                               snmp_packet.varbind_list[0].oid_len,
-                                               NULL, SNMP_EXCEPTION_END_OF_MIB_VIEW, 0);
-                        // printf("GetNextRequest: endOfMibView 오류 응답 생성\n");
-                    }
-                }
-                break;
+    // SNMPv2-Trap / InformRequest VarBind 목록: sysUpTime.0, snmpTrapOID.0, 이후 객체들
+    VarBind varbind_list[MAX_VARBINDS];
+    unsigned char storage[2][VARBIND_STORAGE_SIZE];
+    int varbind_count = 0;
+
+    varbind_list[0].oid = storage[0];
+    varbind_list[0].oid_len = string_to_oid("1.3.6.1.2.1.1.3.0", storage[0]);
+    varbind_list[0].value_type = 0x43; // TimeTicks
+    varbind_list[0].value = storage[0] + VARBIND_STORAGE_SIZE / 2;
+    varbind_list[0].value_len = encode_integer(notification->timestamp & 0xFFFFFFFFUL,
+                                               storage[0] + VARBIND_STORAGE_SIZE / 2);
+    make_oid_varbind(&varbind_list[1], storage[1], "1.3.6.1.6.3.1.1.4.1.0", notification->trap_oid);
+    varbind_count = 2;
+
+    for (int i = 0; i < notification->varbind_count && varbind_count < MAX_VARBINDS; i++) {
+        varbind_list[varbind_count++] = notification->varbind_list[i];
+    }
+
+    if (notification->version == SNMP_VERSION_2c) {
+        index = encode_varbind_list_pdu(buffer, index, max_len, notification->pdu_type,
+                                        notification->request_id, varbind_list, varbind_count, 0, 0);
+        if (index < 0) {
+            return -1;
+        }
+
+        *message_len = wrap_message(message, index);
+        return 0;
+    }
+
+    // SNMPv3 Trap: 알림 발신자가 권한 엔진 (noAuthNoPriv). v3 Inform은 설정에서 거부됨
+    static SNMPv3Packet header;
+    snmpv3_packet_reset(&header);
+    header.version = SNMP_VERSION_3;
+    header.msgID = notification->request_id;
+    header.msgMaxSize = MAX_SNMP_PACKET_SIZE;
+    header.msgFlags[0] = (notification->pdu_type == 0xA6) ? 0x04 : 0x00; // Inform은 reportable
+    header.msgSecurityModel = 3; // USM
+    header.msgAuthoritativeEngineID_len = usm_engine_id(header.msgAuthoritativeEngineID);
+    header.msgAuthoritativeEngineBoots = usm_engine_boots();
+    header.msgAuthoritativeEngineTime = usm_engine_time();
+    strncpy(header.msgUserName, notification->security_name, sizeof(header.msgUserName) - 1);
+    memcpy(header.contextEngineID, header.msgAuthoritativeEngineID, header.msgAuthoritativeEngineID_len);
+    header.contextEngineID_len = header.msgAuthoritativeEngineID_len;
+
+    int scoped_pdu_length_pos;
+    index = encode_snmpv3_header(&header, buffer, &scoped_pdu_length_pos);
+    index = encode_varbind_list_pdu(buffer, index, max_len, notification->pdu_type,
+                                    notification->request_id, varbind_list, varbind_count, 0, 0);
+    if (index < 0) {
+        return -1;
+    }
+
+    finish_snmpv3_message(message, index, scoped_pdu_length_pos, message_len);
+    return 0;
+}
 
-            default:
-                // 지원하지 않는 PDU 타입에 대한 오류 처리
-                printf("지원하지 않는 PDU Type for SNMPv3: %02X\n", snmp_packet.pdu_type);
-                create_snmpv3_report_response(&snmp_packet, response, &response_len, SNMP_ERROR_GENERAL_ERROR);
-                break;
+// Function to send a response and count it in the snmp group: PDU type,
+// error-status and, for a successful request, the variables it covered
+static void send_response(const SNMPTransport *transport, const unsigned char *response, int response_len,
+                          unsigned char request_type) {
+    if (transport->send) {
+        if (transport->send(transport->ctx, response, response_len) < 0) {
+            return;
         }
+    } else if (sendto(transport->sockfd, response, response_len, 0, (const struct sockaddr *)transport->addr,
+                      addr_len(transport->addr)) < 0) {
+        return;
+    }
+    stats_inc(STATS_OUT_PKTS);
+
+    int version;
+    unsigned char pdu_type;
+    int index;
+    int end;
+    unsigned char tag;
+    int length;
+
+    // 암호화된 SNMPv3 응답은 PDU를 볼 수 없음
+    if (locate_snmp_pdu(response, response_len, &version, &pdu_type, &index, &end) < 0 || pdu_type != 0xA2) {
+        return;
+    }
+    end += index;
+    stats_inc(STATS_OUT_GET_RESPONSES);
+
+    if (read_tlv(response, end, &index, &tag, &length) < 0 || tag != TYPE_INTEGER || length != 1) {
+        return;
+    }
+    switch (response[index]) {
+        case SNMP_ERROR_NO_ERROR:      break;
+        case SNMP_ERROR_TOO_BIG:       stats_inc(STATS_OUT_TOO_BIGS); return;
+        case SNMP_ERROR_NO_SUCH_NAME:  stats_inc(STATS_OUT_NO_SUCH_NAMES); return;
+        case SNMP_ERROR_BAD_VALUE:     stats_inc(STATS_OUT_BAD_VALUES); return;
+        case SNMP_ERROR_GENERAL_ERROR: stats_inc(STATS_OUT_GEN_ERRS); return;
+        default:                       return;
+    }
+    index += length;
+
+    if (request_type != 0xA0 && request_type != 0xA1 && request_type != 0xA3 && request_type != 0xA5) {
+        return;
+    }
+    if (skip_tlv(response, end, &index, TYPE_INTEGER) < 0 ||
+        read_tlv(response, end, &index, &tag, &length) < 0 || tag != TYPE_SEQUENCE) {
+        return;
+    }
+
+    // 예외 값(noSuchObject 등)이 아닌 변수만 센다
+    unsigned long variables = 0;
+    int list_end = index + length;
+    while (index < list_end && read_tlv(response, list_end, &index, &tag, &length) == 0 && tag == TYPE_SEQUENCE) {
+        int varbind_end = index + length;
+        if (skip_tlv(response, varbind_end, &index, TYPE_OID) == 0 &&
+            index < varbind_end && (response[index] < 0x80 || response[index] > 0x82)) {
+            variables++;
+        }
+        index = varbind_end;
+    }
+    stats_add(request_type == 0xA3 ? STATS_IN_TOTAL_SET_VARS : STATS_IN_TOTAL_REQ_VARS, variables);
+}
+
+static void count_request_pdu(unsigned char pdu_type) {
+    switch (pdu_type) {
+        case 0xA0: stats_inc(STATS_IN_GET_REQUESTS); break;
+        case 0xA1: stats_inc(STATS_IN_GET_NEXTS); break;
+        case 0xA3: stats_inc(STATS_IN_SET_REQUESTS); break;
+        default:   break;
+    }
+}
+
+// Function to time an instance lookup in a view (GET, or GETNEXT if next is set)
+static MIBNode *timed_lookup(MIBTree *mib_tree, SNMPView *view, const char *oid, MIBNode *cell, int next,
+                             long long *lookup_us) {
+    long long start_us = event_loop_now_us();
+    MIBNode *node = next ? find_next_view_instance(mib_tree, view, oid, cell)
+                         : find_view_instance(mib_tree, view, oid, cell);
+
+    long long elapsed_us = event_loop_now_us() - start_us;
+
+    *lookup_us += elapsed_us;
+    stats_record_stage(STATS_STAGE_LOOKUP, elapsed_us);
+    return node;
+}
+
+// Function to record the stage times of a served request, whatever is not
+// decode or lookup is response encoding
+static void record_request_time(unsigned char pdu_type, long long start_us, long long decode_us, long long lookup_us) {
+    long long total_us = event_loop_now_us() - start_us;
+
+    stats_record_stage(STATS_STAGE_ENCODE, total_us - decode_us - lookup_us);
+    stats_record_pdu(pdu_type, total_us);
+}
+
+// Function to check that a SET may write every varbind: write access, and
+// each object in the view. Returns noError or noAccess with error_index set.
+static int check_set_access(const AclGrant *grant, const VarBind *varbind_list, int varbind_count, int *error_index) {
+    if (grant->access != SNMP_ACCESS_READ_WRITE) {
+        *error_index = 1;
+        return SNMP_ERROR_NO_ACCESS;
+    }
+
+    // 뷰 밖의 객체는 쓸 수 없음
+    for (int i = 0; i < varbind_count && grant->view; i++) {
+        char oid_str[VARBIND_OID_STRING_MAX];
+        oid_to_string(varbind_list[i].oid, varbind_list[i].oid_len, oid_str);
+        if (!acl_view_contains(grant->view, oid_str)) {
+            *error_index = i + 1;
+            return SNMP_ERROR_NO_ACCESS;
+        }
+    }
+    return SNMP_ERROR_NO_ERROR;
+}
+
+// SNMPv3 응답 전송, 인증 수준의 요청이면 응답에 서명 (unknownContext 보고서는 서명하지 않음)
+static void send_snmpv3_response(const SNMPTransport *transport, const SNMPUsmUser *user,
+                                 const SNMPv3Packet *packet, unsigned char *response, int response_len,
+                                 unsigned char request_type) {
+    if (response_len <= 0) {
+        return;
+    }
+    if (request_type != 0 && (packet->msgFlags[0] & SNMP_SEC_LEVEL_AUTHNOPRIV) &&
+        usm_sign(user, response, response_len) < 0) {
+        log_error("Failed to sign SNMPv3 response for %s", user->user_name);
+        return;
+    }
+    send_response(transport, response, response_len, request_type);
+}
+
+// SNMPv3 요청 처리
+static void handle_snmpv3_request(unsigned char *buffer, int n, const SNMPTransport *transport,
+                                  SNMPv3Packet *packet, const SNMPUsmPolicy *policy, SNMPAccessControl *acl,
+                                  MIBTree *mib_tree, SNMPResponseCache *cache) {
+    long long start_us = event_loop_now_us();
+    long long lookup_us = 0;
+    unsigned char *response = transport->response;
+    int response_len = 0;
+
+    // 요청마다 재사용하는 패킷 (VarBind 목록은 요청 버퍼를 가리킴)
+    snmpv3_packet_reset(packet);
+
+    int index = 0;
+    if (parse_snmpv3_message(buffer, &index, n, packet) < 0) {
+        log_debug("Malformed SNMPv3 message dropped");
+        stats_inc(STATS_IN_ASN_PARSE_ERRS);
+        return;
+    }
+
+#if SNMP_LOG_LEVEL >= SNMP_LOG_DEBUG
+    printSNMPv3Packet(packet);
+#endif
+
+    // 로컬 엔진 ID가 아니면 (발견 과정 포함) unknownEngineID 보고서로 엔진 ID와 Boots/Time 알림
+    unsigned char engine_id[SNMP_ENGINE_ID_MAX];
+    int engine_id_len = usm_engine_id(engine_id);
+    if (packet->msgAuthoritativeEngineID_len != engine_id_len ||
+        memcmp(packet->msgAuthoritativeEngineID, engine_id, engine_id_len) != 0) {
+        // 보고서 응답 생성
+        create_snmpv3_report_response(packet, response, &response_len, SNMPERR_USM_UNKNOWNENGINEID);
 
         // 응답 전송
         if (response_len > 0) {
-            sendto(sockfd, response, response_len, 0, (struct sockaddr *)cliaddr, sizeof(*cliaddr));
+            send_response(transport, response, response_len, 0);
+        }
+        return;
+    }
+
+    // USM 사용자, 보안 수준, 메시지 인증과 시간 확인 (RFC 3414 3.2).
+    // 보안 수준은 사용자 설정과 정확히 같아야 하고 암호화(authPriv)는 지원하지 않음
+    const SNMPUsmUser *user = find_usm_user(policy, packet->msgUserName);
+    int security_level = packet->msgFlags[0] & SNMP_SEC_LEVEL_AUTHPRIV;
+    int usm_error = 0;
+    if (user == NULL) {
+        usm_error = SNMPERR_USM_UNKNOWNSECURITYNAME;
+    } else if (security_level != user->security_level || security_level == SNMP_SEC_LEVEL_AUTHPRIV) {
+        usm_error = SNMPERR_USM_UNSUPPORTEDSECURITYLEVEL;
+    } else if (security_level == SNMP_SEC_LEVEL_AUTHNOPRIV) {
+        if (usm_authenticate(user, buffer, n) < 0) {
+            usm_error = SNMPERR_USM_AUTHENTICATIONFAILURE;
+        } else if (usm_check_time(packet->msgAuthoritativeEngineBoots,
+                                  packet->msgAuthoritativeEngineTime) != USM_TIME_OK) {
+            usm_error = SNMPERR_USM_NOTINTIMEWINDOW;
+        }
+    }
+
+    if (usm_error != 0) {
+        if (usm_error == SNMPERR_USM_NOTINTIMEWINDOW) {
+            log_debug("SNMPv3 message of %s not in time window", packet->msgUserName);
+        } else {
+            log_warn("Unauthorized SNMPv3 user: %s", packet->msgUserName);
         }
 
+        create_snmpv3_report_response(packet, response, &response_len, usm_error);
+        if (response_len > 0 && usm_error == SNMPERR_USM_NOTINTIMEWINDOW &&
+            usm_sign(user, response, response_len) < 0) {
+            response_len = 0;
+        }
+        if (response_len > 0) {
+            send_response(transport, response, response_len, 0);
+        }
         return;
     }
 
-    SNMPPacket snmp_packet;
-    unsigned char response[BUFFER_SIZE];
+    // 응답은 로컬 엔진의 Boots/Time을 담고, 인증 수준이면 서명 자리를 둠 (reportable 플래그는 해제)
+    static const unsigned char auth_placeholder[USM_AUTH_PARAMS_LEN];
+    packet->msgAuthoritativeEngineBoots = usm_engine_boots();
+    packet->msgAuthoritativeEngineTime = usm_engine_time();
+    packet->msgFlags[0] = security_level;
+    packet->msgAuthenticationParameters = auth_placeholder;
+    packet->msgAuthenticationParameters_len = security_level ? USM_AUTH_PARAMS_LEN : 0;
+    packet->msgPrivacyParameters_len = 0;
+
+    long long decode_us = event_loop_now_us() - start_us;
+    stats_record_stage(STATS_STAGE_DECODE, decode_us);
+    count_request_pdu(packet->pdu_type);
+
+    // 응답 크기는 전송 경로의 한도와 관리자의 msgMaxSize 중 작은 값까지
+    int max_response = transport->max_response;
+    if (packet->msgMaxSize >= SNMP_MIN_MESSAGE_SIZE && packet->msgMaxSize < (unsigned int)max_response) {
+        max_response = (int)packet->msgMaxSize;
+    }
+
+    // VACM이 설정되어 있으면 그룹, 컨텍스트, 보안 수준으로 뷰 결정
+    AclGrant grant = { user->access, NULL, 0 };
+    if (acl->vacm) {
+        int status = acl_vacm_access(acl, SNMP_SEC_MODEL_USM, user->user_name,
+                                     packet->msgFlags[0] & SNMP_SEC_LEVEL_AUTHPRIV, packet->contextName,
+                                     packet->pdu_type == 0xA3 ? VACM_VIEW_WRITE : VACM_VIEW_READ, &grant);
+        if (status == VACM_NO_SUCH_CONTEXT) {
+            log_debug("SNMPv3 request for unknown context %s", packet->contextName);
+            create_snmpv3_report_response(packet, response, &response_len, SNMPERR_UNKNOWN_CONTEXT);
+        } else if (status != VACM_ACCESS_ALLOWED) {
+            log_warn("VACM denied user %s in context \"%s\"", user->user_name, packet->contextName);
+            create_snmpv3_varbind_list_response(packet, response, &response_len, max_response,
+                                                packet->varbind_list, packet->varbind_count,
+                                                SNMP_ERROR_AUTHORIZATION_ERROR, 0);
+        }
+        if (status != VACM_ACCESS_ALLOWED) {
+            send_snmpv3_response(transport, user, packet, response, response_len,
+                                 status == VACM_NO_SUCH_CONTEXT ? 0 : packet->pdu_type);
+            return;
+        }
+    }
+
+    // 같은 요청이 반복되면 캐시된 본문에 헤더만 새로 붙여 응답
+    const unsigned char *cached_body;
+    int cached_len = response_cache_lookup(cache, mib_tree, grant.view_id, max_response, buffer, n, &cached_body);
+    if (cached_len >= 0) {
+        create_snmpv3_cached_response(packet, cached_body, cached_len, response, &response_len, max_response);
+        if (response_len > 0 && response_len <= max_response) {
+            record_request_time(packet->pdu_type, start_us, decode_us, 0);
+            send_snmpv3_response(transport, user, packet, response, response_len, packet->pdu_type);
+            return;
+        }
+    }
+
+    // 요청된 OID를 문자열로 변환
+    char requested_oid_str[VARBIND_OID_STRING_MAX];
+    oid_to_string(packet->varbind_list[0].oid, packet->varbind_list[0].oid_len, requested_oid_str);
+
+    // MIB에서 해당 OID를 검색 (테이블 셀은 cell에 생성)
+    MIBNode cell;
+    MIBNode *entry = NULL;
+    if (packet->pdu_type == 0xA0) {
+        entry = timed_lookup(mib_tree, grant.view, requested_oid_str, &cell, 0, &lookup_us);
+    }
+
+    // PDU 타입에 따라 처리
+    switch (packet->pdu_type) {
+        case 0xA0: // GetRequest
+            if (entry != NULL) {
+                // MIB 항목을 찾았을 때 정상적인 응답 생성
+                create_snmpv3_response(packet, response, &response_len,
+                                       packet->varbind_list[0].oid,
+                                       packet->varbind_list[0].oid_len,
+                                       entry, SNMP_ERROR_NO_ERROR, 0);
+                // printf("GetRequest 처리 완료\n");
+            } else {
+                // MIB 항목을 찾지 못했을 때 오류 응답 생성 (noSuchObject)
+                create_snmpv3_response(packet, response, &response_len,
+                                       packet->varbind_list[0].oid,
+                                       packet->varbind_list[0].oid_len,
+                                       NULL, SNMP_EXCEPTION_NO_SUCH_OBJECT, 0);
+                // printf("GetRequest: noSuchObject 오류 응답 생성\n");
+            }
+            break;
+
+        case 0xA1: // GetNextRequest
+            {
+                MIBNode *nextEntry = timed_lookup(mib_tree, grant.view, requested_oid_str, &cell, 1, &lookup_us);
+
+                if (nextEntry != NULL) {
+                    // 다음 OID를 바이너리 형식으로 변환
+                    unsigned char next_oid_binary[sizeof(nextEntry->oid)];
+                    int next_oid_binary_len = string_to_oid(nextEntry->oid, next_oid_binary);
+
+                    // 응답에 다음 OID를 포함하여 생성
+                    create_snmpv3_response(packet, response, &response_len,
+                                           next_oid_binary, next_oid_binary_len,
+                                           nextEntry, SNMP_ERROR_NO_ERROR, 0);
+                    // printf("GetNextRequest 처리 완료: 다음 OID = %s\n", nextEntry->oid);
+                } else {
+                    // 더 이상 OID가 없을 때 오류 응답 생성 (endOfMibView)
+                    create_snmpv3_response(packet, response, &response_len,
+                                           packet->varbind_list[0].oid,
+                                           packet->varbind_list[0].oid_len,
+                                           NULL, SNMP_EXCEPTION_END_OF_MIB_VIEW, 0);
+                    // printf("GetNextRequest: endOfMibView 오류 응답 생성\n");
+                }
+            }
+            break;
+
+        case 0xA3: // SetRequest
+            {
+                int error_index = 0;
+                int error_status = check_set_access(&grant, packet->varbind_list,
+                                                    packet->varbind_count, &error_index);
+
+                if (error_status == SNMP_ERROR_NO_ERROR) {
+                    error_status = process_set_request(mib_tree, packet->varbind_list,
+                                                       packet->varbind_count, &error_index);
+                }
+
+                create_snmpv3_varbind_list_response(packet, response, &response_len, max_response,
+                                                    packet->varbind_list, packet->varbind_count,
+                                                    error_status, error_index);
+            }
+            break;
+
+        case 0xA5: // GetBulkRequest (non-repeaters, max-repetitions는 error-status, error-index 자리)
+            log_debug("Bulk request: non-repeaters %d, max-repetitions %d",
+                      packet->error_status, packet->error_index);
+            create_snmpv3_bulk_response(packet, response, &response_len, max_response, mib_tree, grant.view,
+                                        packet->error_status, packet->error_index);
+            break;
+
+        default:
+            // 지원하지 않는 PDU 타입은 genErr 응답
+            log_debug("지원하지 않는 PDU Type for SNMPv3: %02X", packet->pdu_type);
+            create_snmpv3_varbind_list_response(packet, response, &response_len, max_response,
+                                                packet->varbind_list, packet->varbind_count,
+                                                SNMP_ERROR_GENERAL_ERROR, 0);
+            break;
+    }
+
+    // 응답이 클라이언트가 받을 수 있는 크기를 넘으면 tooBig
+    if (response_len > max_response) {
+        create_snmpv3_varbind_list_response(packet, response, &response_len, max_response,
+                                            NULL, 0, SNMP_ERROR_TOO_BIG, 0);
+    }
+
+    // 응답 전송
+    if (response_len > 0) {
+        response_cache_store(cache, mib_tree, grant.view_id, max_response, buffer, n, response, response_len);
+        record_request_time(packet->pdu_type, start_us, decode_us, lookup_us);
+        send_snmpv3_response(transport, user, packet, response, response_len, packet->pdu_type);
+    }
+}
+
+// SET-REQUEST 처리 (SNMPv1/SNMPv2c)
+static void handle_set_request(SNMPPacket *snmp_packet, unsigned char *response, int *response_len, int max_len,
+                               MIBTree *mib_tree, const AclGrant *grant, int snmp_version) {
+    int error_index = 0;
+    int error_status = check_set_access(grant, snmp_packet->varbind_list, snmp_packet->varbind_count,
+                                        &error_index);
+
+    if (error_status == SNMP_ERROR_NO_ERROR) {
+        error_status = process_set_request(mib_tree, snmp_packet->varbind_list,
+                                           snmp_packet->varbind_count, &error_index);
+    }
+
+    // SNMPv1은 v2 오류 코드를 v1 오류 코드로 변환 (RFC 2576)
+    if (snmp_version == 1) {
+        error_status = snmp_v1_error_status(error_status);
+    }
+
+    create_varbind_list_response(snmp_packet, response, response_len, max_len,
+                                 snmp_packet->varbind_list, snmp_packet->varbind_count,
+                                 error_status, error_index);
+}
+
+// SNMPv1/SNMPv2c 요청 처리
+static void handle_community_request(unsigned char *buffer, int n, const SNMPTransport *transport,
+                                     SNMPPacket *packet, int snmp_version, SNMPAccessControl *acl,
+                                     const SNMPCommunityAcl *community_acl, MIBTree *mib_tree,
+                                     SNMPResponseCache *cache) {
+    long long start_us = event_loop_now_us();
+    long long lookup_us = 0;
+    unsigned char *response = transport->response;
+    int max_response = transport->max_response;
     int response_len = 0;
 
-    memset(&snmp_packet, 0, sizeof(SNMPPacket));
-    snmp_packet.version = -1;
+    // 요청마다 재사용하는 패킷 (OID와 VarBind 목록은 요청 버퍼를 가리킴)
+    snmp_packet_reset(packet);
 
     int index = 0;
-    parse_tlv(buffer, &index, n, &snmp_packet);
+    if (parse_snmp_message(buffer, &index, n, packet) < 0) {
+        log_debug("Malformed SNMP message dropped");
+        stats_inc(STATS_IN_ASN_PARSE_ERRS);
+        return;
+    }
 
-    if (strcmp(snmp_packet.community, allowed_community) != 0) {
-        printf("Unauthorized community: %s\n", snmp_packet.community);
+    // 커뮤니티와 출발지 주소로 권한과 MIB 뷰 결정
+    AclGrant grant;
+    SNMPHostAddr source;
+    addr_host(transport->addr, &source);
+    int access = acl_community_access(acl, community_acl, packet->community, &source, &grant);
+    if (access == SNMP_ACCESS_NONE) {
+        log_warn("Unauthorized community: %s", packet->community);
+        stats_inc(STATS_IN_BAD_COMMUNITY_NAMES);
         return;
     }
 
-    char requested_oid_str[BUFFER_SIZE];
-    oid_to_string(snmp_packet.oid, snmp_packet.oid_len, requested_oid_str);
+    long long decode_us = event_loop_now_us() - start_us;
+    stats_record_stage(STATS_STAGE_DECODE, decode_us);
+    count_request_pdu(packet->pdu_type);
+    if (packet->pdu_type == 0xA3 && access != SNMP_ACCESS_READ_WRITE) {
+        stats_inc(STATS_IN_BAD_COMMUNITY_USES);
+    }
+
+    // 같은 요청이 반복되면 캐시된 본문에 커뮤니티와 request-id만 새로 붙여 응답
+    const unsigned char *cached_body;
+    int cached_len = response_cache_lookup(cache, mib_tree, grant.view_id, max_response, buffer, n, &cached_body);
+    if (cached_len >= 0) {
+        create_cached_response(packet, cached_body, cached_len, response, &response_len, max_response);
+        if (response_len > 0 && response_len <= max_response) {
+            record_request_time(packet->pdu_type, start_us, decode_us, 0);
+            send_response(transport, response, response_len, packet->pdu_type);
+            return;
+        }
+    }
+
+    char requested_oid_str[VARBIND_OID_STRING_MAX];
+    oid_to_string(packet->oid, packet->oid_len, requested_oid_str);
 
+    MIBNode cell;
     MIBNode *entry = NULL;
     int found = 0;
     int error_status = SNMP_ERROR_NO_ERROR;
 
     switch (snmp_version) {
         case 1: // SNMPv1
-            if (snmp_packet.pdu_type == 0xA0) { // GET-REQUEST
-                for (int i = 0; i < mib_tree->node_count; i++) {
-                    if (strcmp(mib_tree->nodes[i]->oid, requested_oid_str) == 0) {
-                        entry = mib_tree->nodes[i];
-                        found = 1;
-                        break;
-                    }
-                }
+            if (packet->pdu_type == 0xA0) { // GET-REQUEST
+                entry = timed_lookup(mib_tree, grant.view, requested_oid_str, &cell, 0, &lookup_us);
+                found = (entry != NULL);
                 if (found) {
-                    unsigned char response_oid[BUFFER_SIZE];
+                    unsigned char response_oid[sizeof(entry->oid)];
                     int response_oid_len = string_to_oid(entry->oid, response_oid);
 
-                    create_snmp_response(&snmp_packet, response, &response_len,
+                    create_snmp_response(packet, response, &response_len,
                                          response_oid, response_oid_len, entry, error_status, 0, snmp_version);
 
-                    if (response_len > MAX_SNMP_PACKET_SIZE) {
+                    if (response_len > max_response) {
                         error_status = SNMP_ERROR_TOO_BIG;
                         response_len = 0;
-                        create_snmp_response(&snmp_packet, response, &response_len,
-                                             snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 0, snmp_version);
+                        create_snmp_response(packet, response, &response_len,
+                                             packet->oid, packet->oid_len, NULL, error_status, 0, snmp_version);
                     }
                 } else {
                     error_status = SNMP_ERROR_NO_SUCH_NAME;
-                    create_snmp_response(&snmp_packet, response, &response_len,
-                                         snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 1, snmp_version);
+                    create_snmp_response(packet, response, &response_len,
+                                         packet->oid, packet->oid_len, NULL, error_status, 1, snmp_version);
                 }
-            } else if (snmp_packet.pdu_type == 0xA1) { // GET-NEXT
-                found = find_next_mib_entry(mib_tree, snmp_packet.oid, snmp_packet.oid_len, &entry);
+            } else if (packet->pdu_type == 0xA1) { // GET-NEXT
+                entry = timed_lookup(mib_tree, grant.view, requested_oid_str, &cell, 1, &lookup_us);
+                found = (entry != NULL);
 
                 if (found) {
-                    unsigned char response_oid[BUFFER_SIZE];
+                    unsigned char response_oid[sizeof(entry->oid)];
                     int response_oid_len = string_to_oid(entry->oid, response_oid);
 
-                    create_snmp_response(&snmp_packet, response, &response_len,
+                    create_snmp_response(packet, response, &response_len,
                                          response_oid, response_oid_len, entry, error_status, 0, snmp_version);
 
-                    if (response_len > MAX_SNMP_PACKET_SIZE) {
+                    if (response_len > max_response) {
                         error_status = SNMP_ERROR_TOO_BIG;
                         response_len = 0;
-                        create_snmp_response(&snmp_packet, response, &response_len,
-                                             snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 0, snmp_version);
+                        create_snmp_response(packet, response, &response_len,
+                                             packet->oid, packet->oid_len, NULL, error_status, 0, snmp_version);
                     }
                 } else {
                     error_status = SNMP_ERROR_NO_SUCH_NAME;
-                    create_snmp_response(&snmp_packet, response, &response_len,
-                                         snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 1, snmp_version);
+                    create_snmp_response(packet, response, &response_len,
+                                         packet->oid, packet->oid_len, NULL, error_status, 1, snmp_version);
                 }
+            } else if (packet->pdu_type == 0xA3) { // SET-REQUEST
+                handle_set_request(packet, response, &response_len, max_response, mib_tree, &grant, snmp_version);
             } else {
-                printf("Unsupported PDU Type for SNMPv1: %d\n", snmp_packet.pdu_type);
+                log_debug("Unsupported PDU Type for SNMPv1: %d", packet->pdu_type);
                 error_status = SNMP_ERROR_GENERAL_ERROR;
-                create_snmp_response(&snmp_packet, response, &response_len,
-                                     snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 1, snmp_version);
+                create_snmp_response(packet, response, &response_len,
+                                     packet->oid, packet->oid_len, NULL, error_status, 1, snmp_version);
             }
             break;
 
         case 2: // SNMPv2c
-            if (snmp_packet.pdu_type == 0xA0) { // GET-REQUEST
-                for (int i = 0; i < mib_tree->node_count; i++) {
-                    if (strcmp(mib_tree->nodes[i]->oid, requested_oid_str) == 0) {
-                        entry = mib_tree->nodes[i];
-                        found = 1;
-                        break;
-                    }
-                }
+            if (packet->pdu_type == 0xA0) { // GET-REQUEST
+                entry = timed_lookup(mib_tree, grant.view, requested_oid_str, &cell, 0, &lookup_us);
+                found = (entry != NULL);
                 if (found) {
-                    unsigned char response_oid[BUFFER_SIZE];
+                    unsigned char response_oid[sizeof(entry->oid)];
                     int response_oid_len = string_to_oid(entry->oid, response_oid);
 
-                    create_snmp_response(&snmp_packet, response, &response_len,
+                    create_snmp_response(packet, response, &response_len,
                                          response_oid, response_oid_len, entry, SNMP_ERROR_NO_ERROR, 0, snmp_version);
 
-                    if (response_len > MAX_SNMP_PACKET_SIZE) {
+                    if (response_len > max_response) {
                         error_status = SNMP_ERROR_TOO_BIG;
                         response_len = 0;
-                        create_snmp_response(&snmp_packet, response, &response_len,
-                                             snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 0, snmp_version);
+                        create_snmp_response(packet, response, &response_len,
+                                             packet->oid, packet->oid_len, NULL, error_status, 0, snmp_version);
                     }
                 } else {
                     error_status = SNMP_EXCEPTION_NO_SUCH_OBJECT;
-                    create_snmp_response(&snmp_packet, response, &response_len,
-                                         snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 1, snmp_version);
+                    create_snmp_response(packet, response, &response_len,
+                                         packet->oid, packet->oid_len, NULL, error_status, 1, snmp_version);
                 }
-            } else if (snmp_packet.pdu_type == 0xA1) { // GET-NEXT
-                found = find_next_mib_entry(mib_tree, snmp_packet.oid, snmp_packet.oid_len, &entry);
+            } else if (packet->pdu_type == 0xA1) { // GET-NEXT
+                entry = timed_lookup(mib_tree, grant.view, requested_oid_str, &cell, 1, &lookup_us);
+                found = (entry != NULL);
 
                 if (found) {
-                    unsigned char response_oid[BUFFER_SIZE];
+                    unsigned char response_oid[sizeof(entry->oid)];
                     int response_oid_len = string_to_oid(entry->oid, response_oid);
 
-                    create_snmp_response(&snmp_packet, response, &response_len,
+                    create_snmp_response(packet, response, &response_len,
                                          response_oid, response_oid_len, entry, SNMP_ERROR_NO_ERROR, 0, snmp_version);
 
-                    if (response_len > MAX_SNMP_PACKET_SIZE) {
+                    if (response_len > max_response) {
                         error_status = SNMP_ERROR_TOO_BIG;
                         response_len = 0;
-                        create_snmp_response(&snmp_packet, response, &response_len,
-                                             snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 0, snmp_version);
+                        create_snmp_response(packet, response, &response_len,
+                                             packet->oid, packet->oid_len, NULL, error_status, 0, snmp_version);
                     }
                 } else {
                     error_status = SNMP_EXCEPTION_END_OF_MIB_VIEW;
-                    create_snmp_response(&snmp_packet, response, &response_len,
-                                         snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 0, snmp_version);
+                    create_snmp_response(packet, response, &response_len,
+                                         packet->oid, packet->oid_len, NULL, error_status, 0, snmp_version);
                 }
-            } else if (snmp_packet.pdu_type == 0xA5) { // GET-BULK
-                printf("Bulk request received\n");
+            } else if (packet->pdu_type == 0xA5) { // GET-BULK
+                int non_repeaters = packet->non_repeaters;
+                int max_repetitions = packet->max_repetitions;
+                log_debug("Bulk request: non-repeaters %d, max-repetitions %d", non_repeaters, max_repetitions);
 
-                int non_repeaters = snmp_packet.non_repeaters;
-                int max_repetitions = snmp_packet.max_repetitions;
-
-                create_bulk_response(&snmp_packet, response, &response_len, mib_tree,
+                create_bulk_response(packet, response, &response_len, max_response, mib_tree, grant.view,
                                      non_repeaters, max_repetitions);
 
-                if (response_len > MAX_SNMP_PACKET_SIZE) {
+                if (response_len > max_response) {
                     int error_status = SNMP_ERROR_TOO_BIG;
                     response_len = 0;
-                    create_snmp_response(&snmp_packet, response, &response_len,
-                                         snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 0, 2);
+                    create_snmp_response(packet, response, &response_len,
+                                         packet->oid, packet->oid_len, NULL, error_status, 0, 2);
                 }
+            } else if (packet->pdu_type == 0xA3) { // SET-REQUEST
+                handle_set_request(packet, response, &response_len, max_response, mib_tree, &grant, snmp_version);
             } else {
-                printf("Unsupported PDU Type for SNMPv2c: %d\n", snmp_packet.pdu_type);
+                log_debug("Unsupported PDU Type for SNMPv2c: %d", packet->pdu_type);
                 error_status = SNMP_EXCEPTION_END_OF_MIB_VIEW;
-                create_snmp_response(&snmp_packet, response, &response_len,
-                                     snmp_packet.oid, snmp_packet.oid_len, NULL, error_status, 1, snmp_version);
+                create_snmp_response(packet, response, &response_len,
+                                     packet->oid, packet->oid_len, NULL, error_status, 1, snmp_version);
             }
             break;
 
         default:
-            printf("Unsupported SNMP Version: %d\n", snmp_version);
+            log_debug("Unsupported SNMP Version: %d", snmp_version);
             return;
     }
 
+    // SET 응답도 클라이언트가 받을 수 있는 크기를 넘으면 tooBig
+    if (response_len > max_response) {
+        create_varbind_list_response(packet, response, &response_len, max_response, NULL, 0, SNMP_ERROR_TOO_BIG, 0);
+    }
+
     if (response_len > 0) {
-        sendto(sockfd, response, response_len, 0, (struct sockaddr *)cliaddr, sizeof(*cliaddr));
+        response_cache_store(cache, mib_tree, grant.view_id, max_response, buffer, n, response, response_len);
+        record_request_time(packet->pdu_type, start_us, decode_us, lookup_us);
+        send_response(transport, response, response_len, packet->pdu_type);
+    }
+}
+
+// 패킷 헤더의 버전 필드로 v1/v2c/v3 처리 경로 선택
+void snmp_request(unsigned char *buffer, int n, const SNMPTransport *transport, SNMPRequestContext *context,
+                  const SNMPAgentConfig *config, SNMPAccessControl *acl, MIBTree *mib_tree,
+                  SNMPResponseCache *cache) {
+    int version = peek_snmp_version(buffer, n);
+
+    switch (version) {
+        case SNMP_VERSION_1:
+            if (!config->v1.enabled) {
+                log_debug("SNMPv1 request dropped: version disabled");
+                stats_inc(STATS_IN_BAD_VERSIONS);
+                return;
+            }
+            handle_community_request(buffer, n, transport, &context->packet, 1, acl, &acl->v1, mib_tree, cache);
+            break;
+
+        case SNMP_VERSION_2c:
+            if (!config->v2c.enabled) {
+                log_debug("SNMPv2c request dropped: version disabled");
+                stats_inc(STATS_IN_BAD_VERSIONS);
+                return;
+            }
+            handle_community_request(buffer, n, transport, &context->packet, 2, acl, &acl->v2c, mib_tree, cache);
+            break;
+
+        case SNMP_VERSION_3:
+            if (!config->v3.enabled) {
+                log_debug("SNMPv3 request dropped: version disabled");
+                stats_inc(STATS_IN_BAD_VERSIONS);
+                return;
+            }
+            handle_snmpv3_request(buffer, n, transport, &context->v3_packet, &config->v3, acl, mib_tree, cache);
+            break;
+
+        default:
+            log_debug("Unsupported SNMP Version: %d", version);
+            stats_inc(version < 0 ? STATS_IN_ASN_PARSE_ERRS : STATS_IN_BAD_VERSIONS);
+            break;
     }
 }
 
@@ -0,0 +1,543 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_table.h"  // Instance lookup
+#include "snmp_acl.h"    // Community and view access control
+
+#define ACL_TRIE_INITIAL_NODES 64
+
+// Function to parse a dotted OID into sub-identifiers, -1 if too long or invalid
+static int oid_parts(const char *oid, unsigned int *parts, int max) {
+    int len = 0;
+
+    while (*oid == '.') oid++;
+    while (*oid) {
+        char *end;
+        unsigned long value = strtoul(oid, &end, 10);
+        if (end == oid || len == max || value > 0xFFFFFFFFul) {
+            return -1;
+        }
+        parts[len++] = (unsigned int)value;
+        oid = (*end == '.') ? end + 1 : end;
+        if (*end && *end != '.') {
+            return -1;
+        }
+    }
+    return len;
+}
+
+static int family_mask_bit(const ViewFamily *family, int position) {
+    if (position / 8 >= family->mask_len) {
+        return 1;
+    }
+    return (family->mask[position / 8] >> (7 - position % 8)) & 1;
+}
+
+// Function to check that the first len sub-identifiers of an OID agree with
+// a family (all of them if len covers the subtree)
+static int family_matches(const ViewFamily *family, const unsigned int *oid, int len) {
+    int count = len < family->subtree_len ? len : family->subtree_len;
+
+    for (int i = 0; i < count; i++) {
+        if (oid[i] != family->subtree[i] && family_mask_bit(family, i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Most specific first: more sub-identifiers, then the lexicographically greater subtree
+static int compare_families(const void *a, const void *b) {
+    const ViewFamily *family_a = (const ViewFamily *)a;
+    const ViewFamily *family_b = (const ViewFamily *)b;
+
+    if (family_a->subtree_len != family_b->subtree_len) {
+        return family_b->subtree_len - family_a->subtree_len;
+    }
+    for (int i = 0; i < family_a->subtree_len; i++) {
+        if (family_a->subtree[i] != family_b->subtree[i]) {
+            return family_a->subtree[i] < family_b->subtree[i] ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+// Function to compile the families of a view
+static int compile_view(SNMPView *view, const SNMPViewConfig *config) {
+    memset(view, 0, sizeof(SNMPView));
+    strcpy(view->name, config->name);
+
+    for (int i = 0; i < config->subtree_count; i++) {
+        ViewFamily *family = &view->families[view->family_count];
+        family->subtree_len = oid_parts(config->subtrees[i], family->subtree, ACL_SUBTREE_MAX);
+        if (family->subtree_len < 0) {
+            printf("Error: Invalid subtree %s in view %s.\n", config->subtrees[i], config->name);
+            continue;
+        }
+        memcpy(family->mask, config->masks[i], config->mask_len[i]);
+        family->mask_len = config->mask_len[i];
+        family->included = config->included[i];
+        view->family_count++;
+    }
+
+    // 같은 서브트리가 여러 번이면 나중 설정이 우선 (안정 정렬 대신 뒤에서부터 중복 제거)
+    for (int i = view->family_count - 1; i > 0; i--) {
+        for (int j = 0; j < i; j++) {
+            if (compare_families(&view->families[i], &view->families[j]) == 0) {
+                view->families[j] = view->families[i];
+                memmove(&view->families[i], &view->families[i + 1],
+                        (view->family_count - i - 1) * sizeof(ViewFamily));
+                view->family_count--;
+                break;
+            }
+        }
+    }
+    qsort(view->families, view->family_count, sizeof(ViewFamily), compare_families);
+    return 0;
+}
+
+// Function to decide an OID: the first (most specific) matching family
+static int view_decide(const SNMPView *view, const unsigned int *oid, int len) {
+    for (int i = 0; i < view->family_count; i++) {
+        const ViewFamily *family = &view->families[i];
+        if (family->subtree_len <= len && family_matches(family, oid, len)) {
+            return family->included;
+        }
+    }
+    return 0;
+}
+
+// Function to check that an OID is in a view (NULL: whole MIB)
+int acl_view_contains(const SNMPView *view, const char *oid) {
+    unsigned int parts[ACL_OID_MAX];
+
+    if (!view) {
+        return 1;
+    }
+
+    int len = oid_parts(oid, parts, ACL_OID_MAX);
+    return len >= 0 && view_decide(view, parts, len);
+}
+
+// Function to classify a registry node. A scalar is its only instance. The
+// instances of a table all lie under the entry OID, so families no longer
+// than the entry decide them as one; a longer family that may match under
+// the entry with the other type makes the decision per instance.
+static int view_classify_node(const SNMPView *view, const MIBNode *node) {
+    unsigned int parts[ACL_OID_MAX];
+
+    int len = oid_parts(node->oid, parts, ACL_OID_MAX);
+    if (len < 0) {
+        return VIEW_NODE_MIXED;
+    }
+
+    int included = view_decide(view, parts, len);
+    if (!node->table) {
+        return included ? VIEW_NODE_IN : VIEW_NODE_OUT;
+    }
+
+    for (int i = 0; i < view->family_count && view->families[i].subtree_len > len; i++) {
+        const ViewFamily *family = &view->families[i];
+        if (family->included != included && family_matches(family, parts, len)) {
+            return VIEW_NODE_MIXED;
+        }
+    }
+    return included ? VIEW_NODE_IN : VIEW_NODE_OUT;
+}
+
+// Function to rebuild the node bitmaps of a view if nodes were registered
+// since they were built
+static int view_sync(SNMPView *view, const MIBTree *mib_tree) {
+    if (view->bitmap_valid && view->node_epoch == mib_tree->node_epoch) {
+        return 0;
+    }
+
+    int words = (mib_tree->node_count + 63) / 64;
+    if (words > view->bitmap_words) {
+        unsigned long long *in_bits = (unsigned long long *)realloc(view->in_bits, words * sizeof(unsigned long long));
+        if (in_bits) {
+            view->in_bits = in_bits;
+        }
+        unsigned long long *mixed_bits = (unsigned long long *)realloc(view->mixed_bits,
+                                                                       words * sizeof(unsigned long long));
+        if (mixed_bits) {
+            view->mixed_bits = mixed_bits;
+        }
+        if (!in_bits || !mixed_bits) {
+            printf("Error: Memory allocation failed.\n");
+            view->bitmap_valid = 0;
+            return -1;
+        }
+        view->bitmap_words = words;
+    }
+
+    memset(view->in_bits, 0, view->bitmap_words * sizeof(unsigned long long));
+    memset(view->mixed_bits, 0, view->bitmap_words * sizeof(unsigned long long));
+    for (int i = 0; i < mib_tree->node_count; i++) {
+        int state = view_classify_node(view, mib_tree->nodes[i]);
+        if (state == VIEW_NODE_IN) {
+            view->in_bits[i / 64] |= 1ull << (i % 64);
+        } else if (state == VIEW_NODE_MIXED) {
+            view->mixed_bits[i / 64] |= 1ull << (i % 64);
+        }
+    }
+    view->node_epoch = mib_tree->node_epoch;
+    view->bitmap_valid = 1;
+    return 0;
+}
+
+static int view_node_state(const SNMPView *view, int index) {
+    unsigned long long bit = 1ull << (index % 64);
+
+    if (view->in_bits[index / 64] & bit) {
+        return VIEW_NODE_IN;
+    }
+    return (view->mixed_bits[index / 64] & bit) ? VIEW_NODE_MIXED : VIEW_NODE_OUT;
+}
+
+// Function to find the first node from index on with instances in the view,
+// node_count if there is none
+static int view_next_node(const SNMPView *view, const MIBTree *mib_tree, int index) {
+    if (index >= mib_tree->node_count) {
+        return mib_tree->node_count;
+    }
+
+    int word = index / 64;
+    unsigned long long bits = (view->in_bits[word] | view->mixed_bits[word]) & (~0ull << (index % 64));
+    while (!bits) {
+        if (++word == view->bitmap_words) {
+            return mib_tree->node_count;
+        }
+        bits = view->in_bits[word] | view->mixed_bits[word];
+    }
+
+    index = word * 64 + __builtin_ctzll(bits);
+    return index < mib_tree->node_count ? index : mib_tree->node_count;
+}
+
+// Function to look up an instance for GET, as absent if it is outside the view
+MIBNode *find_view_instance(MIBTree *mib_tree, SNMPView *view, const char *oid, MIBNode *cell) {
+    if (!view) {
+        return find_mib_instance(mib_tree, oid, cell);
+    }
+    if (view_sync(view, mib_tree) < 0) {
+        return NULL;
+    }
+
+    int index = mib_tree_next_index(mib_tree, oid) - 1;
+    if (index < 0) {
+        return NULL;
+    }
+
+    int state = view_node_state(view, index);
+    if (state == VIEW_NODE_OUT) {
+        return NULL;
+    }
+
+    MIBNode *node = mib_instance_at(mib_tree, index, oid, cell);
+    if (node && state == VIEW_NODE_MIXED && !acl_view_contains(view, node->oid)) {
+        return NULL;
+    }
+    return node;
+}
+
+// Function to find the next instance of one node after oid (NULL: its first)
+// that is in the view
+static MIBNode *next_view_instance_at(MIBTree *mib_tree, const SNMPView *view, int index, const char *oid,
+                                      MIBNode *cell) {
+    int state = view_node_state(view, index);
+    if (state == VIEW_NODE_OUT) {
+        return NULL;
+    }
+
+    MIBNode *node = mib_next_instance_at(mib_tree, index, oid, cell);
+    while (node && state == VIEW_NODE_MIXED && !acl_view_contains(view, node->oid)) {
+        char cursor[sizeof(cell->oid)];
+        strcpy(cursor, node->oid);
+        node = mib_next_instance_at(mib_tree, index, cursor, cell);
+    }
+    return node;
+}
+
+// Function to find the next instance in the view (GETNEXT/GETBULK order).
+// Nodes outside the view are skipped a bitmap word at a time.
+MIBNode *find_next_view_instance(MIBTree *mib_tree, SNMPView *view, const char *oid, MIBNode *cell) {
+    if (!view) {
+        return find_next_mib_instance(mib_tree, oid, cell);
+    }
+    if (view_sync(view, mib_tree) < 0) {
+        return NULL;
+    }
+
+    int index = mib_tree_next_index(mib_tree, oid);
+
+    // oid가 테이블 안에 있으면 같은 테이블의 다음 셀부터
+    if (index > 0 && mib_tree->nodes[index - 1]->table) {
+        MIBNode *node = next_view_instance_at(mib_tree, view, index - 1, oid, cell);
+        if (node) {
+            return node;
+        }
+    }
+
+    for (index = view_next_node(view, mib_tree, index); index < mib_tree->node_count;
+         index = view_next_node(view, mib_tree, index + 1)) {
+        MIBNode *node = next_view_instance_at(mib_tree, view, index, NULL, cell);
+        if (node) {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+static int source_bit(const unsigned char *bytes, int depth) {
+    return (bytes[depth >> 3] >> (7 - (depth & 7))) & 1;
+}
+
+static int trie_child(SNMPCommunityAcl *community_acl, int node, int bit) {
+    if (community_acl->nodes[node].child[bit]) {
+        return community_acl->nodes[node].child[bit];
+    }
+
+    if (community_acl->node_count == community_acl->node_capacity) {
+        int capacity = community_acl->node_capacity * 2;
+        AclTrieNode *nodes = (AclTrieNode *)realloc(community_acl->nodes, capacity * sizeof(AclTrieNode));
+        if (!nodes) {
+            printf("Error: Memory allocation failed.\n");
+            return -1;
+        }
+        community_acl->nodes = nodes;
+        community_acl->node_capacity = capacity;
+    }
+
+    int child = community_acl->node_count++;
+    memset(&community_acl->nodes[child], 0, sizeof(AclTrieNode));
+    community_acl->nodes[node].child[bit] = child;
+    return child;
+}
+
+// Function to build the source prefix trie of one version's community rules
+static int compile_communities(SNMPCommunityAcl *community_acl, const SNMPCommunityPolicy *policy,
+                               const SNMPAgentConfig *config) {
+    memset(community_acl, 0, sizeof(SNMPCommunityAcl));
+    community_acl->policy = policy;
+    community_acl->nodes = (AclTrieNode *)calloc(ACL_TRIE_INITIAL_NODES, sizeof(AclTrieNode));
+    if (!community_acl->nodes) {
+        printf("Error: Memory allocation failed.\n");
+        return -1;
+    }
+    community_acl->node_capacity = ACL_TRIE_INITIAL_NODES;
+    community_acl->node_count = ACL_TRIE_ROOTS;
+
+    for (int rule = 0; rule < policy->community_count; rule++) {
+        int id = 0;
+        while (id < community_acl->community_count &&
+               strcmp(community_acl->communities[id], policy->communities[rule]) != 0) {
+            id++;
+        }
+        if (id == community_acl->community_count) {
+            strcpy(community_acl->communities[community_acl->community_count++], policy->communities[rule]);
+        }
+
+        community_acl->view_ids[rule] = 0;
+        if (policy->view[rule][0]) {
+            int view = 0;
+            while (view < config->view_count && strcmp(config->views[view].name, policy->view[rule]) != 0) {
+                view++;
+            }
+            if (view == config->view_count) {
+                printf("Error: Unknown view %s for community %s, access denied.\n",
+                       policy->view[rule], policy->communities[rule]);
+                community_acl->view_ids[rule] = -1;
+            } else {
+                community_acl->view_ids[rule] = view + 1;
+            }
+        }
+
+        // 출발지 제한이 없는 규칙은 두 trie의 루트에 모두 둠
+        const SNMPHostAddr *source = &policy->source[rule];
+        for (int root = 0; root < ACL_TRIE_ROOTS; root++) {
+            if (source->family != AF_UNSPEC && source->family != (root == ACL_TRIE_IPV6 ? AF_INET6 : AF_INET)) {
+                continue;
+            }
+
+            int node = root;
+            int prefix_len = source->family == AF_UNSPEC ? 0 : policy->prefix_len[rule];
+            for (int depth = 0; depth < prefix_len && node >= 0; depth++) {
+                node = trie_child(community_acl, node, source_bit(source->bytes, depth));
+            }
+            if (node < 0) {
+                return -1;
+            }
+            community_acl->nodes[node].community_mask |= 1u << id;
+            community_acl->nodes[node].rule[id] = (signed char)rule;
+        }
+    }
+    return 0;
+}
+
+// Function to find the view named by a VACM access entry: position + 1, 0 for
+// none ("")
+static int vacm_view_id(const SNMPAgentConfig *config, const char *name) {
+    if (!name[0]) {
+        return 0;
+    }
+    for (int i = 0; i < config->view_count; i++) {
+        if (strcmp(config->views[i].name, name) == 0) {
+            return i + 1;
+        }
+    }
+    printf("Error: Unknown view %s in VACM access entry, no access.\n", name);
+    return 0;
+}
+
+// Function to compile the views and community rules of the configuration
+int acl_init(SNMPAccessControl *acl, const SNMPAgentConfig *config) {
+    memset(acl, 0, sizeof(SNMPAccessControl));
+
+    for (int i = 0; i < config->view_count; i++) {
+        if (compile_view(&acl->views[i], &config->views[i]) < 0) {
+            return -1;
+        }
+        acl->view_count++;
+    }
+
+    if (compile_communities(&acl->v1, &config->v1, config) < 0 ||
+        compile_communities(&acl->v2c, &config->v2c, config) < 0) {
+        return -1;
+    }
+
+    if (config->vacm.group_count > 0) {
+        acl->vacm = &config->vacm;
+        for (int i = 0; i < config->vacm.access_count; i++) {
+            acl->vacm_views[i][VACM_VIEW_READ] = vacm_view_id(config, config->vacm.access[i].read_view);
+            acl->vacm_views[i][VACM_VIEW_WRITE] = vacm_view_id(config, config->vacm.access[i].write_view);
+            acl->vacm_views[i][VACM_VIEW_NOTIFY] = vacm_view_id(config, config->vacm.access[i].notify_view);
+        }
+    }
+    return 0;
+}
+
+void acl_close(SNMPAccessControl *acl) {
+    for (int i = 0; i < acl->view_count; i++) {
+        free(acl->views[i].in_bits);
+        free(acl->views[i].mixed_bits);
+    }
+    free(acl->v1.nodes);
+    free(acl->v2c.nodes);
+    memset(acl, 0, sizeof(SNMPAccessControl));
+}
+
+// Function to find the rule of a community for a source address: the
+// community string is compared once, then the longest matching prefix of
+// that community is found in one walk down the trie.
+// Returns SNMP_ACCESS_NONE if no rule applies.
+int acl_community_access(SNMPAccessControl *acl, const SNMPCommunityAcl *community_acl,
+                         const char *community, const SNMPHostAddr *source, AclGrant *grant) {
+    int id = 0;
+    while (id < community_acl->community_count && strcmp(community_acl->communities[id], community) != 0) {
+        id++;
+    }
+    if (id == community_acl->community_count) {
+        return SNMP_ACCESS_NONE;
+    }
+
+    unsigned int bit = 1u << id;
+    int rule = -1;
+    int node = source->family == AF_INET6 ? ACL_TRIE_IPV6 : ACL_TRIE_IPV4;
+    int bits = source->family == AF_INET6 ? 128 : 32;
+
+    for (int depth = 0; ; depth++) {
+        if (community_acl->nodes[node].community_mask & bit) {
+            rule = community_acl->nodes[node].rule[id];
+        }
+        if (depth == bits) {
+            break;
+        }
+        node = community_acl->nodes[node].child[source_bit(source->bytes, depth)];
+        if (node == 0) {
+            break;
+        }
+    }
+
+    if (rule < 0 || community_acl->view_ids[rule] < 0) {
+        return SNMP_ACCESS_NONE;
+    }
+
+    grant->access = community_acl->policy->access[rule];
+    grant->view_id = community_acl->view_ids[rule];
+    grant->view = grant->view_id ? &acl->views[grant->view_id - 1] : NULL;
+    return grant->access;
+}
+
+// Function to rank an access entry that applies to a request (RFC 3415 4:
+// the entry's own security model over "any", an exact context over a
+// prefix, a longer prefix, then the higher security level)
+static int vacm_access_rank(const SNMPVacmAccess *access, const char *context) {
+    return (access->security_model != SNMP_SEC_MODEL_ANY) << 16 |
+           (strcmp(access->context, context) == 0) << 15 |
+           (int)strlen(access->context) << 4 |
+           access->security_level;
+}
+
+// Function to decide a request under VACM (RFC 3415 isAccessAllowed): the
+// security name gives the group, the group, context, security model and level
+// select the access entry, and the entry names the view of the request type.
+// Returns VACM_ACCESS_ALLOWED with the view in grant, or the reason of refusal.
+int acl_vacm_access(SNMPAccessControl *acl, int security_model, const char *security_name, int security_level,
+                    const char *context, int view_type, AclGrant *grant) {
+    const SNMPVacmConfig *vacm = acl->vacm;
+
+    int known_context = context[0] == '\0';
+    for (int i = 0; i < vacm->context_count && !known_context; i++) {
+        known_context = strcmp(vacm->contexts[i], context) == 0;
+    }
+    if (!known_context) {
+        return VACM_NO_SUCH_CONTEXT;
+    }
+
+    const char *group = NULL;
+    for (int i = 0; i < vacm->group_count && !group; i++) {
+        if (vacm->groups[i].security_model == security_model &&
+            strcmp(vacm->groups[i].security_name, security_name) == 0) {
+            group = vacm->groups[i].group;
+        }
+    }
+    if (!group) {
+        return VACM_NO_GROUP_NAME;
+    }
+
+    int best = -1;
+    int best_rank = -1;
+    for (int i = 0; i < vacm->access_count; i++) {
+        const SNMPVacmAccess *access = &vacm->access[i];
+        if (strcmp(access->group, group) != 0 ||
+            (access->security_model != SNMP_SEC_MODEL_ANY && access->security_model != security_model) ||
+            access->security_level > security_level ||
+            (access->prefix_match ? strncmp(access->context, context, strlen(access->context)) != 0
+                                  : strcmp(access->context, context) != 0)) {
+            continue;
+        }
+
+        int rank = vacm_access_rank(access, context);
+        if (rank > best_rank) {
+            best = i;
+            best_rank = rank;
+        }
+    }
+    if (best < 0) {
+        return VACM_NO_ACCESS_ENTRY;
+    }
+
+    int view_id = acl->vacm_views[best][view_type];
+    if (view_id == 0) {
+        return VACM_NO_SUCH_VIEW;
+    }
+
+    grant->access = acl->vacm_views[best][VACM_VIEW_WRITE] ? SNMP_ACCESS_READ_WRITE : SNMP_ACCESS_READ_ONLY;
+    grant->view_id = view_id;
+    grant->view = &acl->views[view_id - 1];
+    return VACM_ACCESS_ALLOWED;
+}
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include "snmp_addr.h"   // Transport addresses
+
+// Function to parse a numeric host address (IPv4 or IPv6)
+int addr_parse_host(const char *text, SNMPHostAddr *host) {
+    memset(host, 0, sizeof(SNMPHostAddr));
+
+    if (inet_pton(AF_INET, text, host->bytes) == 1) {
+        host->family = AF_INET;
+        return 0;
+    }
+    if (inet_pton(AF_INET6, text, host->bytes) != 1) {
+        return -1;
+    }
+    host->family = AF_INET6;
+
+    // ::ffff:a.b.c.d는 IPv4로 취급
+    if (IN6_IS_ADDR_V4MAPPED((const struct in6_addr *)host->bytes)) {
+        memmove(host->bytes, host->bytes + 12, 4);
+        memset(host->bytes + 4, 0, 12);
+        host->family = AF_INET;
+    }
+    return 0;
+}
+
+// Function to parse a transport address: "a.b.c.d", "a.b.c.d:port", "::1",
+// "[::1]" or "[::1]:port". The port defaults to default_port.
+int addr_parse(const char *text, int default_port, struct sockaddr_storage *addr) {
+    char host_text[ADDR_STRING_MAX + 2];
+    const char *port_text = NULL;
+
+    if (text[0] == '[') {
+        const char *end = strchr(text, ']');
+        if (!end || end - text - 1 >= (int)sizeof(host_text) || (end[1] != '\0' && end[1] != ':')) {
+            return -1;
+        }
+        memcpy(host_text, text + 1, end - text - 1);
+        host_text[end - text - 1] = '\0';
+        if (end[1] == ':') {
+            port_text = end + 2;
+        }
+    } else {
+        if (strlen(text) >= sizeof(host_text)) {
+            return -1;
+        }
+        strcpy(host_text, text);
+
+        // 콜론이 하나면 IPv4 주소:포트, 여러 개면 괄호 없는 IPv6 주소
+        char *colon = strchr(host_text, ':');
+        if (colon && colon == strrchr(host_text, ':')) {
+            *colon = '\0';
+            port_text = colon + 1;
+        }
+    }
+
+    int port = default_port;
+    if (port_text) {
+        char *end;
+        long value = strtol(port_text, &end, 10);
+        if (*end != '\0' || end == port_text || value <= 0 || value > 65535) {
+            return -1;
+        }
+        port = (int)value;
+    }
+
+    memset(addr, 0, sizeof(struct sockaddr_storage));
+    struct sockaddr_in *in = (struct sockaddr_in *)addr;
+    struct sockaddr_in6 *in6 = (struct sockaddr_in6 *)addr;
+
+    if (inet_pton(AF_INET, host_text, &in->sin_addr) == 1) {
+        in->sin_family = AF_INET;
+        in->sin_port = htons(port);
+        return 0;
+    }
+    if (inet_pton(AF_INET6, host_text, &in6->sin6_addr) == 1) {
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port);
+        return 0;
+    }
+    return -1;
+}
+
+// Function to extract the host part of a transport address
+int addr_host(const struct sockaddr_storage *addr, SNMPHostAddr *host) {
+    memset(host, 0, sizeof(SNMPHostAddr));
+
+    if (addr->ss_family == AF_INET) {
+        memcpy(host->bytes, &((const struct sockaddr_in *)addr)->sin_addr, 4);
+        host->family = AF_INET;
+    } else if (addr->ss_family == AF_INET6) {
+        const struct in6_addr *in6 = &((const struct sockaddr_in6 *)addr)->sin6_addr;
+        if (IN6_IS_ADDR_V4MAPPED(in6)) {
+            memcpy(host->bytes, in6->s6_addr + 12, 4);
+            host->family = AF_INET;
+        } else {
+            memcpy(host->bytes, in6->s6_addr, 16);
+            host->family = AF_INET6;
+        }
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int addr_port(const struct sockaddr_storage *addr) {
+    if (addr->ss_family == AF_INET6) {
+        return ntohs(((const struct sockaddr_in6 *)addr)->sin6_port);
+    }
+    return ntohs(((const struct sockaddr_in *)addr)->sin_port);
+}
+
+// Function to get the length of an address for sendto() and bind()
+socklen_t addr_len(const struct sockaddr_storage *addr) {
+    return addr->ss_family == AF_INET6 ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+}
+
+// Function to compare two transport addresses (host and port), an IPv4
+// address being equal to its IPv4-mapped form
+int addr_equal(const struct sockaddr_storage *a, const struct sockaddr_storage *b) {
+    SNMPHostAddr host_a, host_b;
+
+    if (addr_host(a, &host_a) < 0 || addr_host(b, &host_b) < 0) {
+        return 0;
+    }
+    return host_a.family == host_b.family && memcmp(host_a.bytes, host_b.bytes, 16) == 0 &&
+           addr_port(a) == addr_port(b);
+}
+
+// Function to convert an IPv4 address to its IPv4-mapped form, to send to it
+// from a dual-stack IPv6 socket (IPv6 addresses are copied unchanged)
+void addr_to_mapped(const struct sockaddr_storage *addr, struct sockaddr_storage *mapped) {
+    if (addr->ss_family != AF_INET) {
+        *mapped = *addr;
+        return;
+    }
+
+    const struct sockaddr_in *in = (const struct sockaddr_in *)addr;
+    struct sockaddr_in6 *in6 = (struct sockaddr_in6 *)mapped;
+
+    memset(mapped, 0, sizeof(struct sockaddr_storage));
+    in6->sin6_family = AF_INET6;
+    in6->sin6_port = in->sin_port;
+    in6->sin6_addr.s6_addr[10] = 0xFF;
+    in6->sin6_addr.s6_addr[11] = 0xFF;
+    memcpy(in6->sin6_addr.s6_addr + 12, &in->sin_addr, 4);
+}
+
+const char *addr_host_string(const SNMPHostAddr *host, char *text, size_t size) {
+    if (!inet_ntop(host->family == AF_INET6 ? AF_INET6 : AF_INET, host->bytes, text, size)) {
+        snprintf(text, size, "?");
+    }
+    return text;
+}
+
+// Function to format a transport address as "a.b.c.d:port" or "[::1]:port"
+const char *addr_to_string(const struct sockaddr_storage *addr, char *text, size_t size) {
+    char host_text[ADDR_STRING_MAX];
+    SNMPHostAddr host;
+
+    if (addr_host(addr, &host) < 0) {
+        snprintf(text, size, "?");
+        return text;
+    }
+    addr_host_string(&host, host_text, sizeof(host_text));
+    snprintf(text, size, host.family == AF_INET6 ? "[%s]:%d" : "%s:%d", host_text, addr_port(addr));
+    return text;
+}
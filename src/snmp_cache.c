@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_parse.h"  // Bounded BER readers
+#include "snmp_cache.h"  // Response cache
+
+static int cacheable_pdu(unsigned char pdu_type) {
+    return pdu_type == 0xA0 || pdu_type == 0xA1 || pdu_type == 0xA5;
+}
+
+// FNV-1a over version, view, size limit, PDU type and key
+static unsigned int cache_hash(int version, int view_id, int max_response, unsigned char pdu_type,
+                               const unsigned char *key, int key_len) {
+    unsigned int hash = 2166136261u;
+
+    hash = (hash ^ (unsigned char)version) * 16777619u;
+    hash = (hash ^ (unsigned char)view_id) * 16777619u;
+    hash = (hash ^ (unsigned char)max_response) * 16777619u;
+    hash = (hash ^ (unsigned char)(max_response >> 8)) * 16777619u;
+    hash = (hash ^ (unsigned char)(max_response >> 16)) * 16777619u;
+    hash = (hash ^ pdu_type) * 16777619u;
+    for (int i = 0; i < key_len; i++) {
+        hash = (hash ^ key[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static SNMPCacheEntry *cache_set(SNMPResponseCache *cache, unsigned int hash) {
+    int sets = cache->capacity / SNMP_CACHE_WAYS;
+    return &cache->entries[(hash % sets) * SNMP_CACHE_WAYS];
+}
+
+static int entry_matches(const SNMPCacheEntry *entry, unsigned int hash, int version, int view_id, int max_response,
+                         unsigned char pdu_type, const unsigned char *key, int key_len) {
+    return entry->in_use && entry->hash == hash && entry->version == version && entry->view_id == view_id &&
+           entry->max_response == max_response && entry->pdu_type == pdu_type && entry->key_len == key_len &&
+           memcmp(entry->key, key, key_len) == 0;
+}
+
+// Function to check that no node or row an entry depends on has changed
+static int entry_valid(const SNMPCacheEntry *entry, const MIBTree *mib_tree) {
+    if (entry->structural && entry->structure_epoch != mib_tree->structure_epoch) {
+        return 0;
+    }
+    for (int i = 0; i < entry->ref_count; i++) {
+        if (__atomic_load_n(&entry->refs[i]->value_seq, __ATOMIC_ACQUIRE) != entry->ref_seq[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Function to record which nodes the varbinds of a response were encoded from.
+// Returns -1 if the answer cannot be cached (table cells, SET in progress, ...).
+static int record_refs(SNMPCacheEntry *entry, MIBTree *mib_tree, const unsigned char *body, int body_len) {
+    unsigned char tag;
+    int length;
+    int index = 0;
+
+    // error-status
+    if (read_tlv(body, body_len, &index, &tag, &length) < 0 || tag != 0x02 || length < 1) {
+        return -1;
+    }
+    int error_status = body[index + length - 1];
+    index += length;
+
+    if (error_status == 2) {
+        // noSuchName (SNMPv1) 응답은 노드 존재 여부에만 의존
+        entry->structural = 1;
+        return 0;
+    }
+    if (error_status != 0) {
+        return -1;
+    }
+
+    // error-index, varbind list
+    if (skip_tlv(body, body_len, &index, 0x02) < 0 ||
+        read_tlv(body, body_len, &index, &tag, &length) < 0 || tag != 0x30) {
+        return -1;
+    }
+
+    int list_end = index + length;
+    while (index < list_end) {
+        char oid_str[BUFFER_SIZE];
+        int oid_pos;
+        int oid_len;
+
+        if (read_tlv(body, list_end, &index, &tag, &length) < 0 || tag != 0x30 ||
+            read_tlv(body, list_end, &index, &tag, &oid_len) < 0 || tag != 0x06) {
+            return -1;
+        }
+        oid_pos = index;
+        index += oid_len;
+        if (read_tlv(body, list_end, &index, &tag, &length) < 0) {
+            return -1;
+        }
+        index += length;
+
+        if (tag == 0x05 || (tag >= 0x80 && tag <= 0x82)) {
+            // 예외 값은 노드가 없다는 뜻
+            entry->structural = 1;
+            continue;
+        }
+
+        oid_to_string((unsigned char *)&body[oid_pos], oid_len, oid_str);
+        MIBNode *node = find_mib_node_by_oid(mib_tree, oid_str);
+        if (node == NULL || node->table != NULL || node->read_handler != NULL ||
+            entry->ref_count == SNMP_CACHE_MAX_REFS) {
+            return -1;      // 테이블 셀과 카운터는 읽을 때마다 생성
+        }
+
+        unsigned int seq = __atomic_load_n(&node->value_seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            return -1;
+        }
+        entry->refs[entry->ref_count] = node;
+        entry->ref_seq[entry->ref_count] = seq;
+        entry->ref_count++;
+    }
+    return 0;
+}
+
+// Function to allocate the cache, entries is rounded up to whole sets (0 disables it)
+int response_cache_init(SNMPResponseCache *cache, int entries) {
+    memset(cache, 0, sizeof(SNMPResponseCache));
+
+    if (entries <= 0) {
+        return 0;
+    }
+
+    int capacity = (entries + SNMP_CACHE_WAYS - 1) / SNMP_CACHE_WAYS * SNMP_CACHE_WAYS;
+    cache->entries = (SNMPCacheEntry *)calloc(capacity, sizeof(SNMPCacheEntry));
+    if (!cache->entries) {
+        printf("Error: Memory allocation failed.\n");
+        return -1;
+    }
+    cache->capacity = capacity;
+    return 0;
+}
+
+// Function to find the cached answer of a request.
+// Returns the body length with *body set, or -1 on a miss.
+int response_cache_lookup(SNMPResponseCache *cache, const MIBTree *mib_tree, int view_id, int max_response,
+                          const unsigned char *request, int request_len, const unsigned char **body) {
+    int version;
+    unsigned char pdu_type;
+    int tail;
+    int tail_len;
+
+    if (cache->capacity == 0 ||
+        locate_snmp_pdu(request, request_len, &version, &pdu_type, &tail, &tail_len) < 0 || !cacheable_pdu(pdu_type)) {
+        return -1;
+    }
+
+    unsigned int hash = cache_hash(version, view_id, max_response, pdu_type, &request[tail], tail_len);
+    SNMPCacheEntry *set = cache_set(cache, hash);
+
+    for (int i = 0; i < SNMP_CACHE_WAYS; i++) {
+        SNMPCacheEntry *entry = &set[i];
+        if (!entry_matches(entry, hash, version, view_id, max_response, pdu_type, &request[tail], tail_len)) {
+            continue;
+        }
+        if (!entry_valid(entry, mib_tree)) {
+            entry->in_use = 0;
+            cache->invalidations++;
+            break;
+        }
+
+        entry->last_used = ++cache->clock;
+        cache->hits++;
+        *body = entry->body;
+        return entry->body_len;
+    }
+
+    cache->misses++;
+    return -1;
+}
+
+// Function to keep the answer of a request. The event loop encodes and stores
+// a response without yielding, so the recorded value_seq matches the body.
+void response_cache_store(SNMPResponseCache *cache, MIBTree *mib_tree, int view_id, int max_response,
+                          const unsigned char *request, int request_len,
+                          const unsigned char *response, int response_len) {
+    int version, response_version;
+    unsigned char pdu_type, response_type;
+    int key, key_len;
+    int body, body_len;
+
+    if (cache->capacity == 0 ||
+        locate_snmp_pdu(request, request_len, &version, &pdu_type, &key, &key_len) < 0 || !cacheable_pdu(pdu_type) ||
+        key_len > SNMP_CACHE_KEY_MAX ||
+        locate_snmp_pdu(response, response_len, &response_version, &response_type, &body, &body_len) < 0 ||
+        response_type != 0xA2 || body_len > BUFFER_SIZE) {
+        return;
+    }
+
+    unsigned int hash = cache_hash(version, view_id, max_response, pdu_type, &request[key], key_len);
+    SNMPCacheEntry *set = cache_set(cache, hash);
+    SNMPCacheEntry *entry = &set[0];
+
+    // 같은 키, 빈 항목, 가장 오래된 항목 순으로 선택
+    for (int i = 0; i < SNMP_CACHE_WAYS; i++) {
+        if (entry_matches(&set[i], hash, version, view_id, max_response, pdu_type, &request[key], key_len) || !set[i].in_use) {
+            entry = &set[i];
+            break;
+        }
+        if (set[i].last_used < entry->last_used) {
+            entry = &set[i];
+        }
+    }
+
+    entry->in_use = 0;
+    entry->ref_count = 0;
+    // GETNEXT/GETBULK 응답은 다음 노드가 무엇인지에도 의존
+    entry->structural = (pdu_type != 0xA0);
+    if (record_refs(entry, mib_tree, &response[body], body_len) < 0) {
+        return;
+    }
+
+    entry->hash = hash;
+    entry->version = version;
+    entry->view_id = view_id;
+    entry->max_response = max_response;
+    entry->pdu_type = pdu_type;
+    memcpy(entry->key, &request[key], key_len);
+    entry->key_len = key_len;
+    memcpy(entry->body, &response[body], body_len);
+    entry->body_len = body_len;
+    entry->structure_epoch = mib_tree->structure_epoch;
+    entry->last_used = ++cache->clock;
+    entry->in_use = 1;
+    cache->stores++;
+}
+
+void response_cache_close(SNMPResponseCache *cache) {
+    free(cache->entries);
+    cache->entries = NULL;
+    cache->capacity = 0;
+}
@@ -0,0 +1,779 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <arpa/inet.h>
+
+#include "snmp_config.h"
+#include "snmp_usm.h"
+
+// Function to reset the configuration (every version disabled, persistence on)
+void init_agent_config(SNMPAgentConfig *config) {
+    memset(config, 0, sizeof(SNMPAgentConfig));
+
+    config->store.enabled = 1;
+    strcpy(config->store.journal_path, SNMP_STORE_JOURNAL_FILE);
+    strcpy(config->store.snapshot_path, SNMP_STORE_SNAPSHOT_FILE);
+    config->store.flush_interval_ms = SNMP_STORE_FLUSH_INTERVAL;
+    config->store.compact_size = SNMP_STORE_COMPACT_SIZE;
+
+    strcpy(config->v3.boots_path, SNMP_USM_BOOTS_FILE);
+
+    config->trap.check_interval_ms = SNMP_TRAP_CHECK_INTERVAL;
+    config->trap.inform_timeout_ms = SNMP_INFORM_TIMEOUT;
+    config->trap.inform_retries = SNMP_INFORM_RETRIES;
+
+    strcpy(config->mib.image_path, SNMP_MIB_IMAGE_FILE);
+
+    config->cache.entries = SNMP_CACHE_ENTRIES;
+
+    config->rate_limit.rate = SNMP_RATE_LIMIT_RATE;
+    config->rate_limit.burst = SNMP_RATE_LIMIT_BURST;
+    config->rate_limit.clients = SNMP_RATE_LIMIT_CLIENTS;
+
+    config->sched.get_weight = SNMP_SCHED_GET_WEIGHT;
+    config->sched.bulk_weight = SNMP_SCHED_BULK_WEIGHT;
+    config->sched.bulk_cost = SNMP_SCHED_BULK_COST;
+
+    config->listen.udp_buffer = SNMP_UDP_BUFFER;
+    config->listen.path_mtu = SNMP_PATH_MTU;
+
+    config->tcp.max_connections = SNMP_TCP_MAX_CONNECTIONS;
+    config->tcp.max_message = SNMP_TCP_MAX_MESSAGE;
+    config->tcp.idle_timeout_ms = SNMP_TCP_IDLE_TIMEOUT;
+
+    config->log.console = 1;
+}
+
+// Function to add an agent bind address ("a.b.c.d[:port]", "[v6][:port]")
+int add_listen_address(SNMPListenConfig *listen, const char *address) {
+    struct sockaddr_storage addr;
+
+    if (listen->address_count == MAX_LISTEN_ADDRESSES) {
+        printf("Error: Maximum number of listen addresses reached.\n");
+        return -1;
+    }
+    if (strlen(address) >= sizeof(listen->addresses[0]) || addr_parse(address, 0, &addr) < 0) {
+        printf("Error: Invalid listen address %s\n", address);
+        return -1;
+    }
+    strcpy(listen->addresses[listen->address_count++], address);
+    return 0;
+}
+
+// Function to add a TCP bind address
+int add_tcp_listen_address(SNMPTcpConfig *tcp, const char *address) {
+    struct sockaddr_storage addr;
+
+    if (tcp->address_count == MAX_LISTEN_ADDRESSES) {
+        printf("Error: Maximum number of TCP listen addresses reached.\n");
+        return -1;
+    }
+    if (strlen(address) >= sizeof(tcp->addresses[0]) || addr_parse(address, 0, &addr) < 0) {
+        printf("Error: Invalid TCP listen address %s\n", address);
+        return -1;
+    }
+    strcpy(tcp->addresses[tcp->address_count++], address);
+    return 0;
+}
+
+// Function to add a community string to a v1/v2c policy
+int add_community(SNMPCommunityPolicy *policy, const char *community, int access) {
+    return add_community_rule(policy, community, access, NULL, NULL);
+}
+
+// Function to parse a source prefix (a.b.c.d[/len] or x:x::x[/len]),
+// clearing the host bits
+static int parse_source_prefix(const char *source, SNMPHostAddr *address, int *prefix_len) {
+    char text[ADDR_STRING_MAX + 8];
+
+    strncpy(text, source, sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+
+    long len = -1;
+    char *slash = strchr(text, '/');
+    if (slash) {
+        *slash = '\0';
+        char *end;
+        len = strtol(slash + 1, &end, 10);
+        if (*end != '\0' || end == slash + 1 || len < 0) {
+            return -1;
+        }
+    }
+    if (addr_parse_host(text, address) < 0) {
+        return -1;
+    }
+
+    // ::ffff:a.b.c.d/len은 IPv4 prefix로 변환
+    int bits = address->family == AF_INET6 ? 128 : 32;
+    if (len >= 0 && address->family == AF_INET && strchr(text, ':')) {
+        len -= 96;
+    }
+    if (len > bits || (slash && len < 0)) {
+        return -1;
+    }
+    *prefix_len = len >= 0 ? (int)len : bits;
+
+    for (int bit = *prefix_len; bit < bits; bit++) {
+        address->bytes[bit / 8] &= (unsigned char)~(0x80 >> (bit % 8));
+    }
+    return 0;
+}
+
+// Function to add a community rule for a source prefix (NULL: any source)
+// and MIB view (NULL or "": whole MIB), replacing the rule of the same
+// community and prefix
+int add_community_rule(SNMPCommunityPolicy *policy, const char *community, int access,
+                       const char *source, const char *view) {
+    SNMPHostAddr address;
+    int prefix_len = 0;
+
+    memset(&address, 0, sizeof(address));
+    if (source && parse_source_prefix(source, &address, &prefix_len) < 0) {
+        printf("Error: Invalid source prefix %s for community %s.\n", source, community);
+        return -1;
+    }
+    if (view && strlen(view) >= sizeof(policy->view[0])) {
+        printf("Error: View name %s too long.\n", view);
+        return -1;
+    }
+
+    int rule = 0;
+    while (rule < policy->community_count &&
+           !(strcmp(policy->communities[rule], community) == 0 &&
+             memcmp(&policy->source[rule], &address, sizeof(address)) == 0 &&
+             policy->prefix_len[rule] == prefix_len)) {
+        rule++;
+    }
+    if (rule == MAX_COMMUNITIES) {
+        printf("Error: Maximum number of communities reached.\n");
+        return -1;
+    }
+
+    policy->access[rule] = access;
+    policy->source[rule] = address;
+    policy->prefix_len[rule] = prefix_len;
+    strcpy(policy->view[rule], view ? view : "");
+    strncpy(policy->communities[rule], community, sizeof(policy->communities[0]) - 1);
+    policy->communities[rule][sizeof(policy->communities[0]) - 1] = '\0';
+    if (rule == policy->community_count) {
+        policy->community_count++;
+    }
+    policy->enabled = 1;
+
+    return 0;
+}
+
+// Function to parse a family mask written in hex (ff:a0 or ffa0)
+static int parse_view_mask(const char *text, unsigned char *mask) {
+    int len = 0;
+
+    while (*text) {
+        if (*text == ':') {
+            text++;
+            continue;
+        }
+        unsigned int octet;
+        if (len == VIEW_MASK_MAX || !isxdigit((unsigned char)text[0]) || !isxdigit((unsigned char)text[1]) ||
+            sscanf(text, "%2x", &octet) != 1) {
+            return -1;
+        }
+        mask[len++] = (unsigned char)octet;
+        text += 2;
+    }
+    return len;
+}
+
+// Function to add an included or excluded subtree (with an optional mask,
+// NULL: all ones) to a view, creating the view
+int add_view_subtree(SNMPAgentConfig *config, const char *view, const char *type, const char *subtree,
+                     const char *mask) {
+    int included = strcmp(type, "included") == 0;
+    unsigned char mask_octets[VIEW_MASK_MAX];
+    int mask_len = 0;
+
+    if ((!included && strcmp(type, "excluded") != 0) || strlen(view) >= sizeof(config->views[0].name) ||
+        strlen(subtree) >= sizeof(config->views[0].subtrees[0]) ||
+        (mask && (mask_len = parse_view_mask(mask, mask_octets)) < 0)) {
+        printf("Error: Invalid view %s %s %s.\n", view, type, subtree);
+        return -1;
+    }
+
+    int i = 0;
+    while (i < config->view_count && strcmp(config->views[i].name, view) != 0) {
+        i++;
+    }
+    if (i == MAX_VIEWS) {
+        printf("Error: Maximum number of views reached.\n");
+        return -1;
+    }
+    if (i == config->view_count) {
+        memset(&config->views[i], 0, sizeof(SNMPViewConfig));
+        strcpy(config->views[i].name, view);
+        config->view_count++;
+    }
+
+    SNMPViewConfig *entry = &config->views[i];
+    if (entry->subtree_count == MAX_VIEW_SUBTREES) {
+        printf("Error: Maximum number of subtrees in view %s reached.\n", view);
+        return -1;
+    }
+    strcpy(entry->subtrees[entry->subtree_count], subtree[0] == '.' ? subtree + 1 : subtree);
+    entry->included[entry->subtree_count] = included;
+    memcpy(entry->masks[entry->subtree_count], mask_octets, mask_len);
+    entry->mask_len[entry->subtree_count] = mask_len;
+    entry->subtree_count++;
+    return 0;
+}
+
+// Function to convert a security model name to SNMP_SEC_MODEL_*
+static int parse_security_model(const char *security_model) {
+    if (strcmp(security_model, "any") == 0) {
+        return SNMP_SEC_MODEL_ANY;
+    } else if (strcmp(security_model, "v1") == 0) {
+        return SNMP_SEC_MODEL_V1;
+    } else if (strcmp(security_model, "v2c") == 0) {
+        return SNMP_SEC_MODEL_V2C;
+    } else if (strcmp(security_model, "usm") == 0) {
+        return SNMP_SEC_MODEL_USM;
+    }
+    return -1;
+}
+
+// Function to copy a context or view name, "-" standing for the empty name
+static int copy_vacm_name(char *name, size_t size, const char *text) {
+    if (strcmp(text, "-") == 0) {
+        text = "";
+    }
+    if (strlen(text) >= size) {
+        return -1;
+    }
+    strcpy(name, text);
+    return 0;
+}
+
+// Function to add a context to vacmContextTable (the default "" always exists)
+int add_vacm_context(SNMPVacmConfig *vacm, const char *context) {
+    if (vacm->context_count == MAX_VACM_CONTEXTS ||
+        copy_vacm_name(vacm->contexts[vacm->context_count], sizeof(vacm->contexts[0]), context) < 0) {
+        printf("Error: Cannot add VACM context %s.\n", context);
+        return -1;
+    }
+    if (vacm->contexts[vacm->context_count][0]) {
+        vacm->context_count++;
+    }
+    return 0;
+}
+
+// Function to map a security name of one security model to a group
+int add_vacm_group(SNMPVacmConfig *vacm, const char *group, const char *security_model, const char *security_name) {
+    int model = parse_security_model(security_model);
+
+    if (vacm->group_count == MAX_VACM_GROUPS || model <= SNMP_SEC_MODEL_ANY ||
+        strlen(group) >= sizeof(vacm->groups[0].group) ||
+        strlen(security_name) >= sizeof(vacm->groups[0].security_name)) {
+        printf("Error: Cannot add VACM group %s for %s.\n", group, security_name);
+        return -1;
+    }
+
+    // 같은 보안 이름은 하나의 그룹에만 속함 (테이블 인덱스)
+    SNMPVacmGroup *entry = &vacm->groups[vacm->group_count];
+    for (int i = 0; i < vacm->group_count; i++) {
+        if (vacm->groups[i].security_model == model && strcmp(vacm->groups[i].security_name, security_name) == 0) {
+            entry = &vacm->groups[i];
+        }
+    }
+    if (entry == &vacm->groups[vacm->group_count]) {
+        vacm->group_count++;
+    }
+    entry->security_model = model;
+    strcpy(entry->security_name, security_name);
+    strcpy(entry->group, group);
+    return 0;
+}
+
+// Function to add the views a group gets in a context at a security level
+int add_vacm_access(SNMPVacmConfig *vacm, const char *group, const char *context, const char *security_model,
+                    const char *security_level, const char *match, const char *read_view,
+                    const char *write_view, const char *notify_view) {
+    SNMPVacmAccess *entry = &vacm->access[vacm->access_count];
+
+    if (vacm->access_count == MAX_VACM_ACCESS) {
+        printf("Error: Maximum number of VACM access entries reached.\n");
+        return -1;
+    }
+
+    memset(entry, 0, sizeof(SNMPVacmAccess));
+    entry->security_model = parse_security_model(security_model);
+    entry->security_level = parse_security_level(security_level);
+    entry->prefix_match = strcmp(match, "prefix") == 0;
+    if (entry->security_model < 0 || entry->security_level < 0 ||
+        (!entry->prefix_match && strcmp(match, "exact") != 0) ||
+        copy_vacm_name(entry->group, sizeof(entry->group), group) < 0 || !entry->group[0] ||
+        copy_vacm_name(entry->context, sizeof(entry->context), context) < 0 ||
+        copy_vacm_name(entry->read_view, sizeof(entry->read_view), read_view) < 0 ||
+        copy_vacm_name(entry->write_view, sizeof(entry->write_view), write_view) < 0 ||
+        copy_vacm_name(entry->notify_view, sizeof(entry->notify_view), notify_view) < 0) {
+        printf("Error: Invalid VACM access entry for group %s.\n", group);
+        return -1;
+    }
+    vacm->access_count++;
+    return 0;
+}
+
+// Function to convert a security level name to SNMP_SEC_LEVEL_*
+int parse_security_level(const char *security_level) {
+    if (security_level == NULL || strcmp(security_level, "noAuthNoPriv") == 0) {
+        return SNMP_SEC_LEVEL_NOAUTH;
+    } else if (strcmp(security_level, "authNoPriv") == 0) {
+        return SNMP_SEC_LEVEL_AUTHNOPRIV;
+    } else if (strcmp(security_level, "authPriv") == 0) {
+        return SNMP_SEC_LEVEL_AUTHPRIV;
+    }
+    return -1;
+}
+
+// Function to add a USM user to the v3 policy
+int add_usm_user(SNMPUsmPolicy *policy, const char *user_name, const char *security_level,
+                 const char *auth_protocol, const char *auth_password,
+                 const char *priv_protocol, const char *priv_password) {
+    if (policy->user_count >= MAX_USM_USERS) {
+        printf("Error: Maximum number of USM users reached.\n");
+        return -1;
+    }
+
+    int level = parse_security_level(security_level);
+    if (level < 0) {
+        printf("Error: Invalid security level '%s' for user %s.\n", security_level, user_name);
+        return -1;
+    }
+
+    if ((level & SNMP_SEC_LEVEL_AUTHNOPRIV) && (auth_protocol == NULL || auth_password == NULL)) {
+        printf("Authentication parameters required for security levels 'authNoPriv' or 'authPriv'\n");
+        return -1;
+    }
+
+    if (level == SNMP_SEC_LEVEL_AUTHPRIV && (priv_protocol == NULL || priv_password == NULL)) {
+        printf("Privacy parameters required for security level 'authPriv'\n");
+        return -1;
+    }
+
+    int auth_algorithm = (level & SNMP_SEC_LEVEL_AUTHNOPRIV) ? usm_auth_protocol(auth_protocol) : USM_AUTH_NONE;
+    if (auth_algorithm < 0) {
+        printf("Error: Unsupported authentication protocol '%s' for user %s (MD5 or SHA).\n",
+               auth_protocol, user_name);
+        return -1;
+    }
+
+    if (auth_algorithm != USM_AUTH_NONE && strlen(auth_password) < SNMP_USM_PASSWORD_MIN) {
+        printf("Error: Authentication password of user %s is shorter than %d characters.\n",
+               user_name, SNMP_USM_PASSWORD_MIN);
+        return -1;
+    }
+
+    // 암호화는 구현되어 있지 않으므로 authPriv 사용자의 요청은 unsupportedSecurityLevel로 거부됨
+    if (level == SNMP_SEC_LEVEL_AUTHPRIV) {
+        printf("Warning: Privacy is not supported, requests of user %s will be rejected.\n", user_name);
+    }
+
+    SNMPUsmUser *user = &policy->users[policy->user_count];
+    memset(user, 0, sizeof(SNMPUsmUser));
+
+    strncpy(user->user_name, user_name, sizeof(user->user_name) - 1);
+    user->security_level = level;
+    user->access = SNMP_ACCESS_READ_ONLY;
+    user->auth_algorithm = auth_algorithm;
+    if (auth_protocol) strncpy(user->auth_protocol, auth_protocol, sizeof(user->auth_protocol) - 1);
+    if (auth_password) strncpy(user->auth_password, auth_password, sizeof(user->auth_password) - 1);
+    if (priv_protocol) strncpy(user->priv_protocol, priv_protocol, sizeof(user->priv_protocol) - 1);
+    if (priv_password) strncpy(user->priv_password, priv_password, sizeof(user->priv_password) - 1);
+
+    policy->user_count++;
+    policy->enabled = 1;
+
+    return 0;
+}
+
+// Function to add a notification receiver ("host", "host:port", "[v6]:port")
+int add_trap_target(SNMPTrapConfig *trap, const char *version, const char *address, const char *security_name,
+                    int inform) {
+    if (trap->target_count >= MAX_TRAP_TARGETS) {
+        printf("Error: Maximum number of trap targets reached.\n");
+        return -1;
+    }
+
+    SNMPTrapTarget *target = &trap->targets[trap->target_count];
+    memset(target, 0, sizeof(SNMPTrapTarget));
+
+    if (strcmp(version, "1") == 0) {
+        target->version = SNMP_VERSION_1;
+    } else if (strcmp(version, "2c") == 0) {
+        target->version = SNMP_VERSION_2c;
+    } else if (strcmp(version, "3") == 0) {
+        target->version = SNMP_VERSION_3;
+    } else {
+        printf("Error: Invalid trap version '%s'.\n", version);
+        return -1;
+    }
+
+    // InformRequest는 SNMPv2 이상에서만 정의됨
+    if (inform && target->version == SNMP_VERSION_1) {
+        printf("Error: InformRequest is not supported by SNMPv1.\n");
+        return -1;
+    }
+
+    // SNMPv3 Inform은 수신자가 권한 엔진 (RFC 3414 3.1.1). 수신자 엔진 ID 발견을
+    // 하지 않으므로 관리자는 unknownEngineID 보고서만 돌려보내고 Inform은 확인되지 않음
+    if (inform && target->version == SNMP_VERSION_3) {
+        printf("Error: SNMPv3 InformRequest is not supported (no receiver engine discovery).\n");
+        return -1;
+    }
+    target->inform = inform;
+
+    if (strlen(address) >= sizeof(target->host) || addr_parse(address, SNMP_TRAP_PORT, &target->addr) < 0) {
+        printf("Error: Invalid trap target address %s\n", address);
+        return -1;
+    }
+    strcpy(target->host, address);
+
+    strncpy(target->security_name, security_name, sizeof(target->security_name) - 1);
+    trap->target_count++;
+
+    return 0;
+}
+
+// Function to add a notification trigger on a MIB node
+int add_trap_trigger(SNMPTrapConfig *trap, const char *node_name, int kind, int threshold) {
+    if (trap->trigger_count >= MAX_TRAP_TRIGGERS) {
+        printf("Error: Maximum number of trap triggers reached.\n");
+        return -1;
+    }
+
+    SNMPTrapTrigger *trigger = &trap->triggers[trap->trigger_count++];
+    memset(trigger, 0, sizeof(SNMPTrapTrigger));
+    strncpy(trigger->node_name, node_name, sizeof(trigger->node_name) - 1);
+    trigger->kind = kind;
+    trigger->threshold = threshold;
+
+    return 0;
+}
+
+// Function to parse an optional "ro"/"rw" access keyword
+static int parse_access(const char *arg) {
+    if (arg == NULL || strcmp(arg, "ro") == 0) {
+        return SNMP_ACCESS_READ_ONLY;
+    } else if (strcmp(arg, "rw") == 0) {
+        return SNMP_ACCESS_READ_WRITE;
+    }
+    return SNMP_ACCESS_NONE;
+}
+
+// Function to load the agent configuration file
+//   community1  <community> [ro|rw [<source>[/<prefix>] [<view>]]]
+//   community2c <community> [ro|rw [<source>[/<prefix>] [<view>]]]
+//   view        <name> included|excluded <subtree>
+//   usmuser     <username> [noAuthNoPriv|authNoPriv|authPriv] [authProtocol authPassword [privProtocol privPassword]] [ro|rw]
+//   usm_boots_file <path>        (snmpEngineBoots across restarts, default snmp_agent.boots)
+//   persist     on|off
+//   persist_journal  <path>
+//   persist_snapshot <path>
+//   persist_flush_interval <ms>
+//   persist_compact_size   <bytes>
+//   trap_target    <1|2c|3> <host[:port]|[ipv6][:port]> <community|username>
+//   trap_threshold <node> <value>
+//   trap_change    <node>
+//   trap_check_interval <ms>   (periodic metric refresh)
+//   inform_target  2c <host[:port]|[ipv6][:port]> <community> (v3 rejected)
+//   inform_timeout <ms>
+//   inform_retries <count>
+//   mib_dir        <directory>   (module search path, repeatable)
+//   mib_module     <name|path>   (repeatable, default CAMERA-MIB)
+//   mib_image      <path>|off    (precompiled image, default snmp_agent.mib)
+//   response_cache <entries>|off (cached responses, default 64)
+//   rate_limit     <requests/s> <burst>|off (per client, default 50 100)
+//   rate_limit_clients <count>   (tracked clients, default 256)
+//   sched_weights  <get> <bulk>  (requests served per round, default 4 1)
+//   sched_bulk_cost <varbinds>   (varbinds x max-repetitions of a bulk request, default 8)
+//   log_target     console|syslog|both (default console)
+//   listen         <address>[:port] | [<ipv6>][:port] (repeatable, default [::] dual stack)
+//   ipv6_only      on|off        (IPV6_V6ONLY on IPv6 sockets, default off)
+//   udp_buffer     <bytes>       (receive buffer and largest UDP response, 484..65507, default 1472)
+//   path_mtu       <bytes>|off   (UDP responses fit one IP packet, at least 576, default 1500)
+//   tcp_listen     <address>[:port] | [<ipv6>][:port] (repeatable, default no TCP)
+//   tcp_max_connections <count>  (open connections, default 16)
+//   tcp_max_message <bytes>      (largest request or response, at least 1024, default 131072)
+//   tcp_idle_timeout <ms>        (idle connections are closed, default 60000)
+int load_agent_config(const char *path, SNMPAgentConfig *config) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+
+    char line[256];
+    int line_number = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+
+        char *args[10];
+        int argc = 0;
+        char *token = strtok(line, " \t\r\n");
+        while (token != NULL && argc < 10) {
+            args[argc++] = token;
+            token = strtok(NULL, " \t\r\n");
+        }
+
+        if (argc == 0) {
+            continue;
+        }
+
+        if ((strcmp(args[0], "community1") == 0 || strcmp(args[0], "community2c") == 0) &&
+            argc >= 2 && argc <= 5 && parse_access(argc >= 3 ? args[2] : NULL) != SNMP_ACCESS_NONE) {
+            SNMPCommunityPolicy *policy = (strcmp(args[0], "community1") == 0) ? &config->v1 : &config->v2c;
+            add_community_rule(policy, args[1], parse_access(argc >= 3 ? args[2] : NULL),
+                               argc >= 4 ? args[3] : NULL, argc == 5 ? args[4] : NULL);
+        } else if (strcmp(args[0], "view") == 0 && (argc == 4 || argc == 5)) {
+            add_view_subtree(config, args[1], args[2], args[3], argc == 5 ? args[4] : NULL);
+        } else if (strcmp(args[0], "vacm_context") == 0 && argc == 2) {
+            add_vacm_context(&config->vacm, args[1]);
+        } else if (strcmp(args[0], "vacm_group") == 0 && argc == 4) {
+            add_vacm_group(&config->vacm, args[1], args[2], args[3]);
+        } else if (strcmp(args[0], "vacm_access") == 0 && argc == 9) {
+            add_vacm_access(&config->vacm, args[1], args[2], args[3], args[4], args[5], args[6], args[7], args[8]);
+        } else if (strcmp(args[0], "usmuser") == 0 && argc >= 2) {
+            int access = SNMP_ACCESS_READ_ONLY;
+            if (argc > 2 && (strcmp(args[argc - 1], "ro") == 0 || strcmp(args[argc - 1], "rw") == 0)) {
+                access = parse_access(args[--argc]);
+            }
+            if (add_usm_user(&config->v3, args[1], argc > 2 ? args[2] : NULL,
+                             argc > 4 ? args[3] : NULL, argc > 4 ? args[4] : NULL,
+                             argc > 6 ? args[5] : NULL, argc > 6 ? args[6] : NULL) == 0) {
+                config->v3.users[config->v3.user_count - 1].access = access;
+            }
+        } else if (strcmp(args[0], "usm_boots_file") == 0 && argc == 2 &&
+                   strlen(args[1]) < sizeof(config->v3.boots_path)) {
+            strcpy(config->v3.boots_path, args[1]);
+        } else if (strcmp(args[0], "persist") == 0 && argc == 2 &&
+                   (strcmp(args[1], "on") == 0 || strcmp(args[1], "off") == 0)) {
+            config->store.enabled = (strcmp(args[1], "on") == 0);
+        } else if (strcmp(args[0], "persist_journal") == 0 && argc == 2 &&
+                   strlen(args[1]) < sizeof(config->store.journal_path)) {
+            strcpy(config->store.journal_path, args[1]);
+        } else if (strcmp(args[0], "persist_snapshot") == 0 && argc == 2 &&
+                   strlen(args[1]) < sizeof(config->store.snapshot_path)) {
+            strcpy(config->store.snapshot_path, args[1]);
+        } else if (strcmp(args[0], "persist_flush_interval") == 0 && argc == 2 && atoi(args[1]) > 0) {
+            config->store.flush_interval_ms = atoi(args[1]);
+        } else if (strcmp(args[0], "persist_compact_size") == 0 && argc == 2 && atol(args[1]) > 0) {
+            config->store.compact_size = atol(args[1]);
+        } else if (strcmp(args[0], "trap_target") == 0 && argc == 4) {
+            add_trap_target(&config->trap, args[1], args[2], args[3], 0);
+        } else if (strcmp(args[0], "inform_target") == 0 && argc == 4) {
+            add_trap_target(&config->trap, args[1], args[2], args[3], 1);
+        } else if (strcmp(args[0], "inform_timeout") == 0 && argc == 2 && atoi(args[1]) > 0) {
+            config->trap.inform_timeout_ms = atoi(args[1]);
+        } else if (strcmp(args[0], "inform_retries") == 0 && argc == 2 && atoi(args[1]) >= 0) {
+            config->trap.inform_retries = atoi(args[1]);
+        } else if (strcmp(args[0], "trap_threshold") == 0 && argc == 3) {
+            add_trap_trigger(&config->trap, args[1], TRAP_TRIGGER_ABOVE, atoi(args[2]));
+        } else if (strcmp(args[0], "trap_change") == 0 && argc == 2) {
+            add_trap_trigger(&config->trap, args[1], TRAP_TRIGGER_CHANGE, 0);
+        } else if (strcmp(args[0], "trap_check_interval") == 0 && argc == 2 && atoi(args[1]) > 0) {
+            config->trap.check_interval_ms = atoi(args[1]);
+        } else if (strcmp(args[0], "mib_dir") == 0 && argc == 2 && strlen(args[1]) < sizeof(config->mib.dirs[0]) &&
+                   config->mib.dir_count < MAX_MIB_DIRS) {
+            strcpy(config->mib.dirs[config->mib.dir_count++], args[1]);
+        } else if (strcmp(args[0], "mib_module") == 0 && argc == 2 &&
+                   strlen(args[1]) < sizeof(config->mib.modules[0]) && config->mib.module_count < MAX_MIB_MODULES) {
+            strcpy(config->mib.modules[config->mib.module_count++], args[1]);
+        } else if (strcmp(args[0], "mib_image") == 0 && argc == 2 && strlen(args[1]) < sizeof(config->mib.image_path)) {
+            strcpy(config->mib.image_path, strcmp(args[1], "off") == 0 ? "" : args[1]);
+        } else if (strcmp(args[0], "response_cache") == 0 && argc == 2 &&
+                   (strcmp(args[1], "off") == 0 || atoi(args[1]) > 0)) {
+            config->cache.entries = strcmp(args[1], "off") == 0 ? 0 : atoi(args[1]);
+        } else if (strcmp(args[0], "rate_limit") == 0 && argc == 2 && strcmp(args[1], "off") == 0) {
+            config->rate_limit.rate = 0;
+        } else if (strcmp(args[0], "rate_limit") == 0 && argc == 3 && atoi(args[1]) > 0 && atoi(args[2]) > 0) {
+            config->rate_limit.rate = atoi(args[1]);
+            config->rate_limit.burst = atoi(args[2]);
+        } else if (strcmp(args[0], "rate_limit_clients") == 0 && argc == 2 && atoi(args[1]) > 0) {
+            config->rate_limit.clients = atoi(args[1]);
+        } else if (strcmp(args[0], "sched_weights") == 0 && argc == 3 && atoi(args[1]) > 0 && atoi(args[2]) > 0) {
+            config->sched.get_weight = atoi(args[1]);
+            config->sched.bulk_weight = atoi(args[2]);
+        } else if (strcmp(args[0], "sched_bulk_cost") == 0 && argc == 2 && atoi(args[1]) > 0) {
+            config->sched.bulk_cost = atoi(args[1]);
+        } else if (strcmp(args[0], "listen") == 0 && argc == 2) {
+            add_listen_address(&config->listen, args[1]);
+        } else if (strcmp(args[0], "ipv6_only") == 0 && argc == 2 &&
+                   (strcmp(args[1], "on") == 0 || strcmp(args[1], "off") == 0)) {
+            config->listen.ipv6_only = (strcmp(args[1], "on") == 0);
+        } else if (strcmp(args[0], "udp_buffer") == 0 && argc == 2 && atoi(args[1]) >= 484 &&
+                   atoi(args[1]) <= SNMP_UDP_BUFFER_MAX) {
+            config->listen.udp_buffer = atoi(args[1]);
+        } else if (strcmp(args[0], "path_mtu") == 0 && argc == 2 &&
+                   (strcmp(args[1], "off") == 0 || atoi(args[1]) >= 576)) {
+            config->listen.path_mtu = strcmp(args[1], "off") == 0 ? 0 : atoi(args[1]);
+        } else if (strcmp(args[0], "tcp_listen") == 0 && argc == 2) {
+            add_tcp_listen_address(&config->tcp, args[1]);
+        } else if (strcmp(args[0], "tcp_max_connections") == 0 && argc == 2 && atoi(args[1]) > 0) {
+            config->tcp.max_connections = atoi(args[1]);
+        } else if (strcmp(args[0], "tcp_max_message") == 0 && argc == 2 && atoi(args[1]) >= 1024) {
+            config->tcp.max_message = atoi(args[1]);
+        } else if (strcmp(args[0], "tcp_idle_timeout") == 0 && argc == 2 && atoi(args[1]) > 0) {
+            config->tcp.idle_timeout_ms = atoi(args[1]);
+        } else if (strcmp(args[0], "log_target") == 0 && argc == 2 &&
+                   (strcmp(args[1], "console") == 0 || strcmp(args[1], "syslog") == 0 ||
+                    strcmp(args[1], "both") == 0)) {
+            config->log.console = strcmp(args[1], "syslog") != 0;
+            config->log.syslog = strcmp(args[1], "console") != 0;
+        } else {
+            printf("%s:%d: Unknown or malformed directive '%s'\n", path, line_number, args[0]);
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+// Function to find a USM user by name
+const SNMPUsmUser *find_usm_user(const SNMPUsmPolicy *policy, const char *user_name) {
+    for (int i = 0; i < policy->user_count; i++) {
+        if (strcmp(policy->users[i].user_name, user_name) == 0) {
+            return &policy->users[i];
+        }
+    }
+    return NULL;
+}
+
+void print_agent_config(const SNMPAgentConfig *config) {
+    const SNMPCommunityPolicy *policies[2] = { &config->v1, &config->v2c };
+    const char *names[2] = { "v1", "v2c" };
+
+    printf("Listen:");
+    for (int i = 0; i < config->listen.address_count; i++) {
+        printf(" %s", config->listen.addresses[i]);
+    }
+    printf("%s%s\n", config->listen.address_count ? "" : " [::] (dual stack)",
+           config->listen.ipv6_only ? ", IPv6 sockets IPv6 only" : "");
+    printf("UDP buffer: %d bytes", config->listen.udp_buffer);
+    if (config->listen.path_mtu > 0) {
+        printf(", responses within path MTU %d", config->listen.path_mtu);
+    }
+    printf("\n");
+    if (config->tcp.address_count > 0) {
+        printf("TCP:");
+        for (int i = 0; i < config->tcp.address_count; i++) {
+            printf(" %s", config->tcp.addresses[i]);
+        }
+        printf(" (%d connections, %d byte messages, idle %d ms)\n", config->tcp.max_connections,
+               config->tcp.max_message, config->tcp.idle_timeout_ms);
+    }
+
+    for (int p = 0; p < 2; p++) {
+        if (!policies[p]->enabled) {
+            continue;
+        }
+        printf("SNMP%s enabled, communities:", names[p]);
+        for (int i = 0; i < policies[p]->community_count; i++) {
+            const SNMPCommunityPolicy *policy = policies[p];
+            printf(" %s(%s", policy->communities[i], policy->access[i] == SNMP_ACCESS_READ_WRITE ? "rw" : "ro");
+            if (policy->source[i].family != AF_UNSPEC) {
+                char source[ADDR_STRING_MAX];
+                printf(", %s/%d", addr_host_string(&policy->source[i], source, sizeof(source)),
+                       policy->prefix_len[i]);
+            }
+            if (policy->view[i][0]) {
+                printf(", view %s", policy->view[i]);
+            }
+            printf(")");
+        }
+        printf("\n");
+    }
+
+    for (int i = 0; i < config->view_count; i++) {
+        printf("View %s:", config->views[i].name);
+        for (int j = 0; j < config->views[i].subtree_count; j++) {
+            printf(" %c%s", config->views[i].included[j] ? '+' : '-', config->views[i].subtrees[j]);
+            if (config->views[i].mask_len[j] > 0) {
+                printf("/");
+                for (int k = 0; k < config->views[i].mask_len[j]; k++) {
+                    printf("%02x", config->views[i].masks[j][k]);
+                }
+            }
+        }
+        printf("\n");
+    }
+
+    static const char *model_names[] = { "any", "v1", "v2c", "usm" };
+    const SNMPVacmConfig *vacm = &config->vacm;
+    if (vacm->group_count > 0) {
+        printf("VACM contexts: \"\"");
+        for (int i = 0; i < vacm->context_count; i++) {
+            printf(" %s", vacm->contexts[i]);
+        }
+        printf("\nVACM groups:");
+        for (int i = 0; i < vacm->group_count; i++) {
+            printf(" %s/%s=%s", model_names[vacm->groups[i].security_model], vacm->groups[i].security_name,
+                   vacm->groups[i].group);
+        }
+        printf("\n");
+        for (int i = 0; i < vacm->access_count; i++) {
+            const SNMPVacmAccess *access = &vacm->access[i];
+            printf("VACM access %s: context \"%s\"%s, %s %s, read %s, write %s, notify %s\n", access->group,
+                   access->context, access->prefix_match ? "*" : "", model_names[access->security_model],
+                   access->security_level == SNMP_SEC_LEVEL_AUTHPRIV ? "authPriv" :
+                   access->security_level == SNMP_SEC_LEVEL_AUTHNOPRIV ? "authNoPriv" : "noAuthNoPriv",
+                   access->read_view[0] ? access->read_view : "-", access->write_view[0] ? access->write_view : "-",
+                   access->notify_view[0] ? access->notify_view : "-");
+        }
+    }
+
+    if (config->v3.enabled) {
+        printf("SNMPv3 enabled, users:");
+        for (int i = 0; i < config->v3.user_count; i++) {
+            printf(" %s(%s)", config->v3.users[i].user_name,
+                   config->v3.users[i].access == SNMP_ACCESS_READ_WRITE ? "rw" : "ro");
+        }
+        printf("\n");
+    }
+
+    if (config->store.enabled) {
+        printf("SET persistence: journal %s, snapshot %s, flush every %d ms, compact at %ld bytes\n",
+               config->store.journal_path, config->store.snapshot_path,
+               config->store.flush_interval_ms, config->store.compact_size);
+    }
+
+    for (int i = 0; i < config->trap.target_count; i++) {
+        const SNMPTrapTarget *target = &config->trap.targets[i];
+        char address[ADDR_STRING_MAX + 8];
+        printf("%s target: %s (%s, %s)\n", target->inform ? "Inform" : "Trap",
+               addr_to_string(&target->addr, address, sizeof(address)),
+               target->version == SNMP_VERSION_1 ? "v1" : target->version == SNMP_VERSION_2c ? "v2c" : "v3",
+               target->security_name);
+    }
+
+    for (int i = 0; i < config->mib.module_count; i++) {
+        printf("MIB module: %s\n", config->mib.modules[i]);
+    }
+
+    if (config->cache.entries > 0) {
+        printf("Response cache: %d entries\n", config->cache.entries);
+    }
+
+    if (config->rate_limit.rate > 0) {
+        printf("Rate limit: %d requests/s, burst %d, %d clients\n",
+               config->rate_limit.rate, config->rate_limit.burst, config->rate_limit.clients);
+    }
+
+    printf("Scheduling: GET %d : GETBULK %d per round, bulk above %d varbinds\n",
+           config->sched.get_weight, config->sched.bulk_weight, config->sched.bulk_cost);
+
+    printf("Logging: %s%s%s\n", config->log.console ? "console" : "",
+           config->log.console && config->log.syslog ? ", " : "", config->log.syslog ? "syslog" : "");
+}
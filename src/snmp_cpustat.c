@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "snmp_mib.h"      // MIB tree structures and functions
+#include "snmp_table.h"    // Conceptual tables
+#include "snmp_event.h"    // poll() event loop
+#include "snmp_cpustat.h"  // Per-core CPU sampler
+
+// cpuCoreTable 열 (값은 % 단위)
+static int core_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const CpuStat *cpustat = (const CpuStat *)row->data;
+    int cpu = (int)row->index[0] - 1;
+    int average = 0;
+    int max = 0;
+
+    switch (column) {
+        case 1:                                                                 // cpuCoreIndex
+            value->int_value = cpu + 1;
+            return 0;
+        case 2: cpustat_window(cpustat, cpu, CPUSTAT_WINDOW_5SEC, &average, &max); break;
+        case 3: cpustat_window(cpustat, cpu, CPUSTAT_WINDOW_1MIN, &average, &max); break;
+        case 4:                                                                 // cpuCoreUsage5Min
+        case 5:                                                                 // cpuCoreUsageMax5Min
+            cpustat_window(cpustat, cpu, CPUSTAT_WINDOW_5MIN, &average, &max);
+            if (column == 5) {
+                average = max;
+            }
+            break;
+        default:
+            return -1;
+    }
+
+    value->int_value = (average + 5) / 10;
+    return 0;
+}
+
+static const struct {
+    unsigned int subid;
+    const char *name;
+} core_columns[] = {
+    { 1, "cpuCoreIndex" },
+    { 2, "cpuCoreUsage5Sec" },
+    { 3, "cpuCoreUsage1Min" },
+    { 4, "cpuCoreUsage5Min" },
+    { 5, "cpuCoreUsageMax5Min" },
+};
+
+// Function to read the per-core tick counters, returns the number of cores found or -1
+static int read_core_times(unsigned long long *busy, unsigned long long *total, unsigned char *present) {
+    char line[512];
+    int count = 0;
+
+    FILE *fp = fopen(CPUSTAT_PROC_STAT, "r");
+    if (!fp) {
+        perror(CPUSTAT_PROC_STAT);
+        return -1;
+    }
+
+    memset(present, 0, CPUSTAT_MAX_CPUS);
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "cpu", 3) != 0) {
+            break;      // cpu 줄은 파일 앞부분에 모여 있음
+        }
+        if (!isdigit((unsigned char)line[3])) {
+            continue;   // "cpu " 합계 줄
+        }
+
+        int cpu;
+        unsigned long long user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+        if (sscanf(line + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu", &cpu, &user, &nice, &system,
+                   &idle, &iowait, &irq, &softirq, &steal) < 5 || cpu < 0 || cpu >= CPUSTAT_MAX_CPUS) {
+            continue;
+        }
+
+        total[cpu] = user + nice + system + idle + iowait + irq + softirq + steal;
+        busy[cpu] = total[cpu] - idle - iowait;
+        present[cpu] = 1;
+        count++;
+    }
+
+    fclose(fp);
+    return count;
+}
+
+static void add_core_row(CpuStat *cpustat, int cpu) {
+    MIBIndexValue index = { .int_value = (unsigned int)cpu + 1 };
+    mib_table_add_row(&cpustat->table, &index, cpustat);
+}
+
+// Function to take one sample: per-core busy share since the previous sample.
+// Cores that went offline lose their row, cores that (re)appear start a new window.
+void cpustat_sample(void *ctx) {
+    CpuStat *cpustat = (CpuStat *)ctx;
+    unsigned long long busy[CPUSTAT_MAX_CPUS];
+    unsigned long long total[CPUSTAT_MAX_CPUS];
+    unsigned char present[CPUSTAT_MAX_CPUS];
+
+    if (read_core_times(busy, total, present) < 0) {
+        return;
+    }
+
+    unsigned int head = cpustat->head;
+    CpuSample *sample = &cpustat->ring[head & (CPUSTAT_RING_SIZE - 1)];
+
+    for (int cpu = 0; cpu < CPUSTAT_MAX_CPUS; cpu++) {
+        sample->load[cpu] = 0;
+
+        if (!present[cpu]) {
+            if (cpustat->online[cpu]) {
+                MIBIndexValue index = { .int_value = (unsigned int)cpu + 1 };
+                mib_table_remove_row(&cpustat->table, &index);
+                cpustat->online[cpu] = 0;
+            }
+            continue;
+        }
+
+        if (!cpustat->online[cpu]) {
+            // 기준값만 저장, 다음 표본부터 창에 포함
+            cpustat->since[cpu] = head + 1;
+            cpustat->online[cpu] = 1;
+            add_core_row(cpustat, cpu);
+        } else if (total[cpu] > cpustat->total[cpu] && busy[cpu] >= cpustat->busy[cpu]) {
+            unsigned long long total_delta = total[cpu] - cpustat->total[cpu];
+            unsigned long long busy_delta = busy[cpu] - cpustat->busy[cpu];
+            sample->load[cpu] = (unsigned short)(busy_delta >= total_delta ? 1000 : busy_delta * 1000 / total_delta);
+        }
+
+        cpustat->busy[cpu] = busy[cpu];
+        cpustat->total[cpu] = total[cpu];
+    }
+
+    // 슬롯을 채운 뒤 공개
+    __atomic_store_n(&cpustat->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// Function to compute the average and maximum busy share (1/1000) of one core over the
+// last samples. Returns the number of samples used, 0 if the core has none yet.
+int cpustat_window(const CpuStat *cpustat, int cpu, int samples, int *average, int *max) {
+    unsigned int head = __atomic_load_n(&cpustat->head, __ATOMIC_ACQUIRE);
+    unsigned int available;
+    int sum = 0;
+
+    *average = *max = 0;
+    if (cpu < 0 || cpu >= CPUSTAT_MAX_CPUS || head <= cpustat->since[cpu]) {
+        return 0;
+    }
+
+    available = head - cpustat->since[cpu];
+    if ((unsigned int)samples > available) {
+        samples = (int)available;
+    }
+    if (samples > CPUSTAT_RING_SIZE - 1) {
+        samples = CPUSTAT_RING_SIZE - 1;    // 작성 중인 슬롯 제외
+    }
+
+    for (int i = 0; i < samples; i++) {
+        int load = cpustat->ring[(head - 1 - i) & (CPUSTAT_RING_SIZE - 1)].load[cpu];
+        sum += load;
+        if (load > *max) {
+            *max = load;
+        }
+    }
+
+    *average = sum / samples;
+    return samples;
+}
+
+// Function to compute the busy share (1/1000) averaged over all online cores
+int cpustat_usage(const CpuStat *cpustat, int samples) {
+    int sum = 0;
+    int cores = 0;
+
+    for (int cpu = 0; cpu < CPUSTAT_MAX_CPUS; cpu++) {
+        int average, max;
+
+        if (cpustat->online[cpu] && cpustat_window(cpustat, cpu, samples, &average, &max) > 0) {
+            sum += average;
+            cores++;
+        }
+    }
+    return cores > 0 ? sum / cores : 0;
+}
+
+// cpuUsage는 표본 링에서 계산 (최근 5초, 전체 코어 평균)
+static void cpu_usage_read_handler(const MIBNode *node, MIBValue *value) {
+    value->int_value = (cpustat_usage((const CpuStat *)node->read_ctx, CPUSTAT_WINDOW_5SEC) + 5) / 10;
+}
+
+// Function to register cpuCoreTable and cpuUsage, take the baseline sample and start the sampling timer
+int cpustat_init(CpuStat *cpustat, MIBTree *mib_tree, EventLoop *loop) {
+    MIBIndexType index_type = MIB_INDEX_INTEGER;
+    MIBNode *usage;
+
+    memset(cpustat, 0, sizeof(CpuStat));
+    cpustat->loop = loop;
+    cpustat->timer_id = -1;
+
+    if (mib_table_init(&cpustat->table, "cpuCoreEntry", CPUSTAT_CORE_ENTRY_OID, &index_type, 1) < 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(core_columns) / sizeof(core_columns[0]); i++) {
+        mib_table_add_column(&cpustat->table, core_columns[i].subid, core_columns[i].name, "Integer32", core_column);
+    }
+    if (!mib_table_register(mib_tree, &cpustat->table)) {
+        return -1;
+    }
+
+    // cpuUsage는 MIB 모듈이 등록한 경우에만 연결
+    usage = find_mib_node_by_oid(mib_tree, CPUSTAT_USAGE_OID);
+    if (usage) {
+        usage->read_handler = cpu_usage_read_handler;
+        usage->read_ctx = cpustat;
+    }
+
+    // 첫 호출은 기준값만 기록
+    cpustat_sample(cpustat);
+
+    cpustat->timer_id = event_loop_add_timer(loop, CPUSTAT_SAMPLE_MS, CPUSTAT_SAMPLE_MS, cpustat_sample, cpustat);
+    if (cpustat->timer_id < 0) {
+        printf("Error: Failed to start the CPU sampler.\n");
+        return -1;
+    }
+    return 0;
+}
+
+void cpustat_close(CpuStat *cpustat) {
+    if (cpustat->timer_id >= 0) {
+        event_loop_cancel_timer(cpustat->loop, cpustat->timer_id);
+        cpustat->timer_id = -1;
+    }
+    mib_table_free(&cpustat->table);
+}
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "snmp_event.h"
+
+void event_loop_init(EventLoop *loop) {
+    memset(loop, 0, sizeof(EventLoop));
+}
+
+// Function to read the monotonic clock in milliseconds
+long long event_loop_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Function to read the monotonic clock in microseconds (latency measurements)
+long long event_loop_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int event_loop_add_fd(EventLoop *loop, int fd, short events, EventFdHandler handler, void *ctx) {
+    if (loop->fd_count >= MAX_EVENT_FDS) {
+        printf("Error: Maximum number of event fds reached.\n");
+        return -1;
+    }
+
+    EventFd *entry = &loop->fds[loop->fd_count++];
+    entry->fd = fd;
+    entry->events = events;
+    entry->handler = handler;
+    entry->ctx = ctx;
+    return 0;
+}
+
+// Function to change the poll() events of a registered fd (e.g. add POLLOUT while a queue is pending)
+int event_loop_set_fd_events(EventLoop *loop, int fd, short events) {
+    for (int i = 0; i < loop->fd_count; i++) {
+        if (loop->fds[i].fd == fd) {
+            loop->fds[i].events = events;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void event_loop_remove_fd(EventLoop *loop, int fd) {
+    for (int i = 0; i < loop->fd_count; i++) {
+        if (loop->fds[i].fd == fd) {
+            loop->fds[i] = loop->fds[--loop->fd_count];
+            return;
+        }
+    }
+}
+
+// Function to add a timer, returns the timer id.
+// delay_ms: first expiry, interval_ms: period (0 for one-shot)
+int event_loop_add_timer(EventLoop *loop, long delay_ms, long interval_ms, EventTimerHandler handler, void *ctx) {
+    for (int i = 0; i < MAX_EVENT_TIMERS; i++) {
+        EventTimer *timer = &loop->timers[i];
+        if (!timer->active) {
+            timer->active = 1;
+            timer->interval_ms = interval_ms;
+            timer->expire_ms = event_loop_now_ms() + delay_ms;
+            timer->handler = handler;
+            timer->ctx = ctx;
+            return i;
+        }
+    }
+
+    printf("Error: Maximum number of event timers reached.\n");
+    return -1;
+}
+
+void event_loop_cancel_timer(EventLoop *loop, int timer_id) {
+    if (timer_id >= 0 && timer_id < MAX_EVENT_TIMERS) {
+        loop->timers[timer_id].active = 0;
+    }
+}
+
+// Function to compute the poll() timeout until the next timer expiry
+static int next_timeout_ms(EventLoop *loop, long long now) {
+    long long timeout = -1;
+
+    for (int i = 0; i < MAX_EVENT_TIMERS; i++) {
+        EventTimer *timer = &loop->timers[i];
+        if (!timer->active) {
+            continue;
+        }
+        long long remaining = timer->expire_ms - now;
+        if (remaining < 0) {
+            remaining = 0;
+        }
+        if (timeout < 0 || remaining < timeout) {
+            timeout = remaining;
+        }
+    }
+
+    return (int)timeout;
+}
+
+static void run_expired_timers(EventLoop *loop) {
+    long long now = event_loop_now_ms();
+
+    for (int i = 0; i < MAX_EVENT_TIMERS; i++) {
+        EventTimer *timer = &loop->timers[i];
+        if (!timer->active || timer->expire_ms > now) {
+            continue;
+        }
+
+        if (timer->interval_ms > 0) {
+            timer->expire_ms = now + timer->interval_ms;
+        } else {
+            timer->active = 0;
+        }
+        timer->handler(timer->ctx);
+    }
+}
+
+void event_loop_run(EventLoop *loop) {
+    struct pollfd pfds[MAX_EVENT_FDS];
+    EventFd ready[MAX_EVENT_FDS];
+
+    loop->running = 1;
+
+    while (loop->running) {
+        int count = loop->fd_count;
+        for (int i = 0; i < count; i++) {
+            pfds[i].fd = loop->fds[i].fd;
+            pfds[i].events = loop->fds[i].events;
+            pfds[i].revents = 0;
+            ready[i] = loop->fds[i];
+        }
+
+        int n = poll(pfds, count, next_timeout_ms(loop, event_loop_now_ms()));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll");
+            break;
+        }
+
+        // 콜백에서 fd 목록이 바뀔 수 있으므로 poll 시점의 복사본으로 처리
+        for (int i = 0; i < count && n > 0; i++) {
+            if (pfds[i].revents) {
+                n--;
+                ready[i].handler(ready[i].fd, pfds[i].revents, ready[i].ctx);
+            }
+        }
+
+        run_expired_timers(loop);
+    }
+}
+
+// Function to stop the loop (async-signal-safe)
+void event_loop_stop(EventLoop *loop) {
+    loop->running = 0;
+}
@@ -0,0 +1,597 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <time.h>
+#include <dirent.h>
+#include <utmp.h>
+#include <sys/statvfs.h>
+
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_table.h"  // Conceptual tables
+#include "snmp_hrmib.h"  // HOST-RESOURCES-MIB collector
+#include "utility.h"     // System utility functions
+
+// hrStorageTypes
+#define HR_STORAGE_OTHER          "1.3.6.1.2.1.25.2.1.1"
+#define HR_STORAGE_RAM            "1.3.6.1.2.1.25.2.1.2"
+#define HR_STORAGE_VIRTUAL_MEMORY "1.3.6.1.2.1.25.2.1.3"
+#define HR_STORAGE_FIXED_DISK     "1.3.6.1.2.1.25.2.1.4"
+#define HR_STORAGE_REMOVABLE_DISK "1.3.6.1.2.1.25.2.1.5"
+#define HR_STORAGE_RAM_DISK       "1.3.6.1.2.1.25.2.1.8"
+#define HR_STORAGE_FLASH_MEMORY   "1.3.6.1.2.1.25.2.1.9"
+#define HR_STORAGE_NETWORK_DISK   "1.3.6.1.2.1.25.2.1.10"
+
+// hrDeviceTypes
+#define HR_DEVICE_PROCESSOR    "1.3.6.1.2.1.25.3.1.3"
+#define HR_DEVICE_DISK_STORAGE "1.3.6.1.2.1.25.3.1.6"
+
+#define HR_DEVICE_RUNNING 2   // hrDeviceStatus
+#define HR_NULL_OID       "0.0"
+
+// 파일 시스템 종류별 hrStorageType (목록에 없는 종류는 가상 파일 시스템으로 보고 제외)
+static const struct {
+    const char *fs_type;
+    const char *storage_type;
+} fs_types[] = {
+    { "ext2", HR_STORAGE_FIXED_DISK },     { "ext3", HR_STORAGE_FIXED_DISK },
+    { "ext4", HR_STORAGE_FIXED_DISK },     { "xfs", HR_STORAGE_FIXED_DISK },
+    { "btrfs", HR_STORAGE_FIXED_DISK },    { "f2fs", HR_STORAGE_FIXED_DISK },
+    { "overlay", HR_STORAGE_FIXED_DISK },  { "vfat", HR_STORAGE_REMOVABLE_DISK },
+    { "exfat", HR_STORAGE_REMOVABLE_DISK }, { "jffs2", HR_STORAGE_FLASH_MEMORY },
+    { "ubifs", HR_STORAGE_FLASH_MEMORY },  { "yaffs2", HR_STORAGE_FLASH_MEMORY },
+    { "squashfs", HR_STORAGE_FLASH_MEMORY }, { "cramfs", HR_STORAGE_FLASH_MEMORY },
+    { "tmpfs", HR_STORAGE_RAM_DISK },      { "ramfs", HR_STORAGE_RAM_DISK },
+    { "nfs", HR_STORAGE_NETWORK_DISK },    { "nfs4", HR_STORAGE_NETWORK_DISK },
+    { "cifs", HR_STORAGE_NETWORK_DISK },
+};
+
+// --- 테이블 열 ---
+
+static int storage_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const HrStorage *storage = (const HrStorage *)row->data;
+
+    switch (column) {
+        case 1: value->int_value = storage->index; break;                    // hrStorageIndex
+        case 2: strcpy(value->oid_value, storage->type); break;              // hrStorageType
+        case 3: strcpy(value->str_value, storage->descr); break;             // hrStorageDescr
+        case 4: value->int_value = storage->units; break;                    // hrStorageAllocationUnits
+        case 5: value->int_value = storage->size; break;                     // hrStorageSize
+        case 6: value->int_value = storage->used; break;                     // hrStorageUsed
+        case 7: value->uint_value = 0; break;                                // hrStorageAllocationFailures
+        default: return -1;
+    }
+    return 0;
+}
+
+static int device_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const HrDevice *device = (const HrDevice *)row->data;
+
+    switch (column) {
+        case 1: value->int_value = device->index; break;                     // hrDeviceIndex
+        case 2: strcpy(value->oid_value, device->type); break;               // hrDeviceType
+        case 3: strcpy(value->str_value, device->descr); break;              // hrDeviceDescr
+        case 4: strcpy(value->oid_value, HR_NULL_OID); break;                // hrDeviceID
+        case 5: value->int_value = HR_DEVICE_RUNNING; break;                 // hrDeviceStatus
+        case 6: value->uint_value = 0; break;                                // hrDeviceErrors
+        default: return -1;
+    }
+    return 0;
+}
+
+static int processor_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const HrDevice *device = (const HrDevice *)row->data;
+
+    switch (column) {
+        case 1: strcpy(value->oid_value, HR_NULL_OID); break;                // hrProcessorFrwID
+        case 2: value->int_value = device->load; break;                      // hrProcessorLoad
+        default: return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    unsigned int subid;
+    const char *name;
+    const char *type;
+} HrColumn;
+
+static const HrColumn storage_columns[] = {
+    { 1, "hrStorageIndex", "Integer32" },          { 2, "hrStorageType", "OBJECT IDENTIFIER" },
+    { 3, "hrStorageDescr", "DisplayString" },      { 4, "hrStorageAllocationUnits", "Integer32" },
+    { 5, "hrStorageSize", "Integer32" },           { 6, "hrStorageUsed", "Integer32" },
+    { 7, "hrStorageAllocationFailures", "Counter32" },
+}, device_columns[] = {
+    { 1, "hrDeviceIndex", "Integer32" },           { 2, "hrDeviceType", "OBJECT IDENTIFIER" },
+    { 3, "hrDeviceDescr", "DisplayString" },       { 4, "hrDeviceID", "OBJECT IDENTIFIER" },
+    { 5, "hrDeviceStatus", "INTEGER" },            { 6, "hrDeviceErrors", "Counter32" },
+}, processor_columns[] = {
+    { 1, "hrProcessorFrwID", "OBJECT IDENTIFIER" }, { 2, "hrProcessorLoad", "Integer32" },
+};
+
+// --- 수집 ---
+
+// Function to store a size in the smallest allocation unit that keeps it within Integer32
+static void set_storage_size(HrStorage *storage, unsigned long long units, unsigned long long size,
+                             unsigned long long used) {
+    while (size > INT_MAX && units <= INT_MAX / 2) {
+        units *= 2;
+        size /= 2;
+        used /= 2;
+    }
+    storage->units = (int)units;
+    storage->size = (size > INT_MAX) ? INT_MAX : (int)size;
+    storage->used = (used > INT_MAX) ? INT_MAX : (int)used;
+}
+
+static HrStorage *add_storage(HrSnapshot *snapshot, unsigned int index, const char *type, const char *descr) {
+    if (snapshot->storage_count == HRMIB_MAX_STORAGE) {
+        return NULL;
+    }
+
+    HrStorage *storage = &snapshot->storage[snapshot->storage_count++];
+    storage->index = index;
+    storage->type = type;
+    strncpy(storage->descr, descr, sizeof(storage->descr) - 1);
+    return storage;
+}
+
+static HrDevice *add_device(HrSnapshot *snapshot, unsigned int index, const char *type, const char *descr) {
+    if (snapshot->device_count == HRMIB_MAX_DEVICES) {
+        return NULL;
+    }
+
+    HrDevice *device = &snapshot->devices[snapshot->device_count++];
+    device->index = index;
+    device->type = type;
+    strncpy(device->descr, descr, sizeof(device->descr) - 1);
+    return device;
+}
+
+// Function to read the per-CPU tick counters and derive hrProcessorLoad from the previous sample
+static void collect_processors(HrMib *hrmib, HrSnapshot *snapshot, const HrSnapshot *previous) {
+    char line[512];
+
+    FILE *fp = fopen(HRMIB_PROC_STAT, "r");
+    if (!fp) {
+        perror(HRMIB_PROC_STAT);
+        return;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "cpu", 3) != 0) {
+            break;      // cpu 줄은 파일 앞부분에 모여 있음
+        }
+        if (!isdigit((unsigned char)line[3]) || snapshot->cpu_count == HRMIB_MAX_CPUS) {
+            continue;   // "cpu " 합계 줄
+        }
+
+        int number;
+        unsigned long long user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+        if (sscanf(line + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu", &number, &user, &nice, &system,
+                   &idle, &iowait, &irq, &softirq, &steal) < 5) {
+            continue;
+        }
+
+        int slot = snapshot->cpu_count++;
+        unsigned long long total = user + nice + system + idle + iowait + irq + softirq + steal;
+        snapshot->cpu_number[slot] = number;
+        snapshot->cpu_total[slot] = total;
+        snapshot->cpu_busy[slot] = total - idle - iowait;
+
+        // 이전 표본과의 차이 (첫 표본은 부팅 이후 평균)
+        unsigned long long busy_delta = snapshot->cpu_busy[slot];
+        unsigned long long total_delta = total;
+        for (int i = 0; i < previous->cpu_count; i++) {
+            if (previous->cpu_number[i] == number && previous->cpu_total[i] <= total) {
+                busy_delta -= previous->cpu_busy[i];
+                total_delta -= previous->cpu_total[i];
+                break;
+            }
+        }
+
+        HrDevice *device = add_device(snapshot, HRMIB_DEVICE_PROCESSOR + number, HR_DEVICE_PROCESSOR,
+                                      hrmib->cpu_descr);
+        if (device) {
+            device->load = total_delta ? (int)(busy_delta * 100 / total_delta) : 0;
+        }
+    }
+
+    fclose(fp);
+}
+
+// Function to add the memory rows of hrStorageTable from one read of /proc/meminfo
+static void collect_memory(HrSnapshot *snapshot) {
+    char line[256];
+    unsigned long long total = 0, free_kb = 0, buffers = 0, cached = 0, swap_total = 0, swap_free = 0;
+
+    FILE *fp = fopen(HRMIB_PROC_MEMINFO, "r");
+    if (!fp) {
+        perror(HRMIB_PROC_MEMINFO);
+        return;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "MemTotal:", 9) == 0) {
+            sscanf(line + 9, "%llu", &total);
+        } else if (strncmp(line, "MemFree:", 8) == 0) {
+            sscanf(line + 8, "%llu", &free_kb);
+        } else if (strncmp(line, "Buffers:", 8) == 0) {
+            sscanf(line + 8, "%llu", &buffers);
+        } else if (strncmp(line, "Cached:", 7) == 0) {
+            sscanf(line + 7, "%llu", &cached);
+        } else if (strncmp(line, "SwapTotal:", 10) == 0) {
+            sscanf(line + 10, "%llu", &swap_total);
+        } else if (strncmp(line, "SwapFree:", 9) == 0) {
+            sscanf(line + 9, "%llu", &swap_free);
+        }
+    }
+    fclose(fp);
+
+    if (total == 0) {
+        return;
+    }
+
+    snapshot->memory_kb = (total > INT_MAX) ? INT_MAX : (int)total;
+
+    HrStorage *storage = add_storage(snapshot, HRMIB_STORAGE_RAM, HR_STORAGE_RAM, "Physical memory");
+    if (storage) {
+        set_storage_size(storage, 1024, total, total - free_kb);
+    }
+    storage = add_storage(snapshot, HRMIB_STORAGE_VIRTUAL, HR_STORAGE_VIRTUAL_MEMORY, "Virtual memory");
+    if (storage) {
+        set_storage_size(storage, 1024, total + swap_total, (total - free_kb) + (swap_total - swap_free));
+    }
+    storage = add_storage(snapshot, HRMIB_STORAGE_BUFFERS, HR_STORAGE_OTHER, "Memory buffers");
+    if (storage) {
+        set_storage_size(storage, 1024, total, buffers);
+    }
+    storage = add_storage(snapshot, HRMIB_STORAGE_CACHED, HR_STORAGE_OTHER, "Cached memory");
+    if (storage) {
+        set_storage_size(storage, 1024, total, cached);
+    }
+    if (swap_total > 0) {
+        storage = add_storage(snapshot, HRMIB_STORAGE_SWAP, HR_STORAGE_VIRTUAL_MEMORY, "Swap space");
+        if (storage) {
+            set_storage_size(storage, 1024, swap_total, swap_total - swap_free);
+        }
+    }
+}
+
+// Function to find the hrStorageIndex a mount point had in the previous snapshot (0 if new)
+static unsigned int previous_fs_index(const HrSnapshot *previous, const char *mount_point) {
+    for (int i = 0; i < previous->storage_count; i++) {
+        if (previous->storage[i].index >= HRMIB_STORAGE_FS_INDEX &&
+            strcmp(previous->storage[i].descr, mount_point) == 0) {
+            return previous->storage[i].index;
+        }
+    }
+    return 0;
+}
+
+// Function to add one hrStorageTable row per mounted disk, flash or RAM file system
+static void collect_filesystems(HrMib *hrmib, HrSnapshot *snapshot, const HrSnapshot *previous) {
+    char line[512];
+    char device[128], mount_point[128], fs_type[32];
+
+    FILE *fp = fopen(HRMIB_PROC_MOUNTS, "r");
+    if (!fp) {
+        perror(HRMIB_PROC_MOUNTS);
+        return;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "%127s %127s %31s", device, mount_point, fs_type) != 3) {
+            continue;
+        }
+
+        const char *type = NULL;
+        for (size_t i = 0; i < sizeof(fs_types) / sizeof(fs_types[0]); i++) {
+            if (strcmp(fs_type, fs_types[i].fs_type) == 0) {
+                type = fs_types[i].storage_type;
+                break;
+            }
+        }
+        if (!type) {
+            continue;
+        }
+        if (strncmp(device, "/dev/mmcblk", 11) == 0) {
+            type = HR_STORAGE_REMOVABLE_DISK;   // SD 카드
+        }
+
+        // 같은 위치에 다시 마운트된 경우 한 행만 유지
+        int duplicate = 0;
+        for (int i = 0; i < snapshot->storage_count; i++) {
+            if (snapshot->storage[i].index >= HRMIB_STORAGE_FS_INDEX &&
+                strcmp(snapshot->storage[i].descr, mount_point) == 0) {
+                duplicate = 1;
+                break;
+            }
+        }
+        if (duplicate) {
+            continue;
+        }
+
+        struct statvfs fs;
+        if (statvfs(mount_point, &fs) < 0 || fs.f_blocks == 0) {
+            continue;
+        }
+
+        // 마운트 지점이 유지되는 동안 같은 hrStorageIndex 사용
+        unsigned int index = previous_fs_index(previous, mount_point);
+        HrStorage *storage = add_storage(snapshot, index ? index : hrmib->next_fs_index, type, mount_point);
+        if (!storage) {
+            break;
+        }
+        if (!index) {
+            hrmib->next_fs_index++;
+        }
+        set_storage_size(storage, fs.f_frsize, fs.f_blocks, fs.f_blocks - fs.f_bfree);
+    }
+
+    fclose(fp);
+}
+
+// Function to add flash partitions (/proc/mtd) and whole MMC/SCSI disks as hrDeviceDiskStorage
+static void collect_disks(HrSnapshot *snapshot) {
+    char line[256];
+    char name[64];
+    char descr[64];
+    int number;
+
+    FILE *fp = fopen(HRMIB_PROC_MTD, "r");
+    if (fp) {
+        // mtd0: 00040000 00010000 "u-boot"
+        while (fgets(line, sizeof(line), fp)) {
+            char *label = strchr(line, '"');
+            if (sscanf(line, "mtd%d:", &number) != 1 || number < 0 || number >= HRMIB_DEVICE_MMC - HRMIB_DEVICE_MTD) {
+                continue;
+            }
+            if (label) {
+                label[strcspn(label, "\n")] = '\0';
+                snprintf(descr, sizeof(descr), "mtd%d %.40s", number, label);
+            } else {
+                snprintf(descr, sizeof(descr), "mtd%d", number);
+            }
+            add_device(snapshot, HRMIB_DEVICE_MTD + number, HR_DEVICE_DISK_STORAGE, descr);
+        }
+        fclose(fp);
+    }
+
+    fp = fopen(HRMIB_PROC_PARTITIONS, "r");
+    if (!fp) {
+        return;
+    }
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "%*u %*u %*u %63s", name) != 1) {
+            continue;   // 헤더
+        }
+
+        // 파티션(mmcblk0p1, sda1)이 아닌 디스크 전체만
+        size_t len = strlen(name);
+        if (sscanf(name, "mmcblk%d", &number) == 1 && !strchr(name, 'p') &&
+            number < HRMIB_DEVICE_SD - HRMIB_DEVICE_MMC) {
+            add_device(snapshot, HRMIB_DEVICE_MMC + number, HR_DEVICE_DISK_STORAGE, name);
+        } else if (len == 3 && strncmp(name, "sd", 2) == 0 && islower((unsigned char)name[2])) {
+            add_device(snapshot, HRMIB_DEVICE_SD + (name[2] - 'a'), HR_DEVICE_DISK_STORAGE, name);
+        }
+    }
+    fclose(fp);
+}
+
+// Function to encode the local time as DateAndTime (RFC 2579, 11 octets)
+static void encode_date_and_time(unsigned char *date) {
+    time_t now = time(NULL);
+    struct tm tm;
+
+    localtime_r(&now, &tm);
+    long offset = tm.tm_gmtoff / 60;
+    int year = tm.tm_year + 1900;
+
+    date[0] = (year >> 8) & 0xFF;
+    date[1] = year & 0xFF;
+    date[2] = tm.tm_mon + 1;
+    date[3] = tm.tm_mday;
+    date[4] = tm.tm_hour;
+    date[5] = tm.tm_min;
+    date[6] = tm.tm_sec;
+    date[7] = 0;
+    date[8] = (offset < 0) ? '-' : '+';
+    date[9] = labs(offset) / 60;
+    date[10] = labs(offset) % 60;
+}
+
+static void collect_system(HrSnapshot *snapshot) {
+    snapshot->uptime = get_system_uptime();
+    encode_date_and_time(snapshot->date);
+
+    // 로그인 사용자 수
+    struct utmp *entry;
+    setutent();
+    while ((entry = getutent()) != NULL) {
+        if (entry->ut_type == USER_PROCESS) {
+            snapshot->users++;
+        }
+    }
+    endutent();
+
+    // 실행 중인 프로세스 수 (/proc의 숫자 디렉터리)
+    DIR *dir = opendir("/proc");
+    if (dir) {
+        struct dirent *dirent;
+        while ((dirent = readdir(dir)) != NULL) {
+            if (isdigit((unsigned char)dirent->d_name[0])) {
+                snapshot->processes++;
+            }
+        }
+        closedir(dir);
+    }
+}
+
+// Function to point the table rows at the current snapshot
+static void link_rows(HrMib *hrmib) {
+    HrSnapshot *snapshot = hrmib->current;
+
+    mib_table_clear_rows(&hrmib->storage_table);
+    mib_table_clear_rows(&hrmib->device_table);
+    mib_table_clear_rows(&hrmib->processor_table);
+
+    for (int i = 0; i < snapshot->storage_count; i++) {
+        MIBIndexValue index = { .int_value = snapshot->storage[i].index };
+        mib_table_add_row(&hrmib->storage_table, &index, &snapshot->storage[i]);
+    }
+    for (int i = 0; i < snapshot->device_count; i++) {
+        MIBIndexValue index = { .int_value = snapshot->devices[i].index };
+        mib_table_add_row(&hrmib->device_table, &index, &snapshot->devices[i]);
+        if (strcmp(snapshot->devices[i].type, HR_DEVICE_PROCESSOR) == 0) {
+            mib_table_add_row(&hrmib->processor_table, &index, &snapshot->devices[i]);
+        }
+    }
+}
+
+static void write_scalar(MIBNode *node, const MIBValue *value) {
+    if (node) {
+        mib_node_write_value(node, value);
+    }
+}
+
+// Function to take a new snapshot of every source and rebuild the table rows from it
+int hrmib_refresh(HrMib *hrmib) {
+    HrSnapshot *previous = hrmib->current;
+    HrSnapshot *snapshot = (previous == &hrmib->snapshots[0]) ? &hrmib->snapshots[1] : &hrmib->snapshots[0];
+
+    memset(snapshot, 0, sizeof(HrSnapshot));
+    snapshot->max_processes = previous->max_processes;
+
+    collect_system(snapshot);
+    collect_processors(hrmib, snapshot, previous);
+    collect_disks(snapshot);
+    collect_memory(snapshot);
+    collect_filesystems(hrmib, snapshot, previous);
+
+    hrmib->current = snapshot;
+    link_rows(hrmib);
+
+    MIBValue value;
+    memset(&value, 0, sizeof(MIBValue));
+    value.ticks_value = snapshot->uptime;
+    write_scalar(hrmib->system_uptime, &value);
+
+    memset(&value, 0, sizeof(MIBValue));
+    memcpy(value.octets.data, snapshot->date, sizeof(snapshot->date));
+    value.octets.len = sizeof(snapshot->date);
+    write_scalar(hrmib->system_date, &value);
+
+    memset(&value, 0, sizeof(MIBValue));
+    value.uint_value = snapshot->users;
+    write_scalar(hrmib->system_users, &value);
+    value.uint_value = snapshot->processes;
+    write_scalar(hrmib->system_processes, &value);
+
+    memset(&value, 0, sizeof(MIBValue));
+    value.int_value = snapshot->max_processes;
+    write_scalar(hrmib->system_max_processes, &value);
+    value.int_value = snapshot->memory_kb;
+    write_scalar(hrmib->memory_size, &value);
+
+    hrmib->refresh_count++;
+    return 0;
+}
+
+// Function to read the values that do not change while running (CPU model, pid_max)
+static void read_static_values(HrMib *hrmib) {
+    static const char *model_keys[] = { "model name", "Processor", "cpu model", "Hardware", NULL };
+    char line[256];
+
+    strcpy(hrmib->cpu_descr, "Processor");
+    FILE *fp = fopen(HRMIB_PROC_CPUINFO, "r");
+    if (fp) {
+        int found = 0;
+        while (!found && fgets(line, sizeof(line), fp)) {
+            char *colon = strchr(line, ':');
+            if (!colon) {
+                continue;
+            }
+            for (int i = 0; model_keys[i]; i++) {
+                if (strncmp(line, model_keys[i], strlen(model_keys[i])) == 0) {
+                    char *model = colon + 1;
+                    while (*model == ' ') {
+                        model++;
+                    }
+                    model[strcspn(model, "\n")] = '\0';
+                    if (*model) {
+                        snprintf(hrmib->cpu_descr, sizeof(hrmib->cpu_descr), "%s", model);
+                        found = 1;
+                    }
+                    break;
+                }
+            }
+        }
+        fclose(fp);
+    }
+
+    fp = fopen(HRMIB_PID_MAX, "r");
+    if (fp) {
+        if (fscanf(fp, "%d", &hrmib->current->max_processes) != 1) {
+            hrmib->current->max_processes = 0;
+        }
+        fclose(fp);
+    }
+}
+
+static int register_table(MIBTree *mib_tree, MIBTable *table, const char *name, const char *oid,
+                          const HrColumn *column, size_t column_count, MIBColumnHandler handler) {
+    MIBIndexType index_type = MIB_INDEX_INTEGER;
+
+    if (mib_table_init(table, name, oid, &index_type, 1) < 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < column_count; i++) {
+        mib_table_add_column(table, column[i].subid, column[i].name, column[i].type, handler);
+    }
+    return mib_table_register(mib_tree, table) ? 0 : -1;
+}
+
+// Function to register hrSystem, hrMemorySize and the three tables and take the first snapshot
+int hrmib_init(HrMib *hrmib, MIBTree *mib_tree) {
+    int zero = 0;
+    unsigned int uzero = 0;
+    unsigned long ticks = 0;
+
+    memset(hrmib, 0, sizeof(HrMib));
+    hrmib->current = &hrmib->snapshots[0];
+    hrmib->next_fs_index = HRMIB_STORAGE_FS_INDEX;
+    read_static_values(hrmib);
+
+    hrmib->system_uptime = add_mib_node(mib_tree, "hrSystemUptime", HRMIB_SYSTEM_OID ".1.0", "TimeTicks",
+                                        HANDLER_CAN_RONLY, "current", &ticks, NULL);
+    hrmib->system_date = add_mib_node(mib_tree, "hrSystemDate", HRMIB_SYSTEM_OID ".2.0", "DateAndTime",
+                                      HANDLER_CAN_RONLY, "current", NULL, NULL);
+    hrmib->system_users = add_mib_node(mib_tree, "hrSystemNumUsers", HRMIB_SYSTEM_OID ".5.0", "Gauge32",
+                                       HANDLER_CAN_RONLY, "current", &uzero, NULL);
+    hrmib->system_processes = add_mib_node(mib_tree, "hrSystemProcesses", HRMIB_SYSTEM_OID ".6.0", "Gauge32",
+                                           HANDLER_CAN_RONLY, "current", &uzero, NULL);
+    hrmib->system_max_processes = add_mib_node(mib_tree, "hrSystemMaxProcesses", HRMIB_SYSTEM_OID ".7.0",
+                                               "Integer32", HANDLER_CAN_RONLY, "current", &zero, NULL);
+    hrmib->memory_size = add_mib_node(mib_tree, "hrMemorySize", HRMIB_MEMORY_SIZE_OID, "Integer32",
+                                      HANDLER_CAN_RONLY, "current", &zero, NULL);
+
+    if (register_table(mib_tree, &hrmib->storage_table, "hrStorageEntry", HRMIB_STORAGE_ENTRY_OID,
+                       storage_columns, sizeof(storage_columns) / sizeof(storage_columns[0]), storage_column) < 0 ||
+        register_table(mib_tree, &hrmib->device_table, "hrDeviceEntry", HRMIB_DEVICE_ENTRY_OID,
+                       device_columns, sizeof(device_columns) / sizeof(device_columns[0]), device_column) < 0 ||
+        register_table(mib_tree, &hrmib->processor_table, "hrProcessorEntry", HRMIB_PROCESSOR_ENTRY_OID,
+                       processor_columns, sizeof(processor_columns) / sizeof(processor_columns[0]),
+                       processor_column) < 0) {
+        return -1;
+    }
+
+    return hrmib_refresh(hrmib);
+}
+
+void hrmib_close(HrMib *hrmib) {
+    mib_table_free(&hrmib->storage_table);
+    mib_table_free(&hrmib->device_table);
+    mib_table_free(&hrmib->processor_table);
+}
@@ -0,0 +1,495 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if.h>         // IF_OPER_* (after net/if.h)
+#include <linux/if_link.h>
+
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_table.h"  // Conceptual tables
+#include "snmp_ifmib.h"  // IF-MIB collector
+#include "utility.h"     // System utility functions
+
+// IANAifType
+#define IF_TYPE_OTHER             1
+#define IF_TYPE_ETHERNET_CSMACD   6
+#define IF_TYPE_PPP               23
+#define IF_TYPE_SOFTWARE_LOOPBACK 24
+#define IF_TYPE_IEEE80211         71
+#define IF_TYPE_TUNNEL            131
+
+// ifAdminStatus / ifOperStatus (RFC 2863)
+#define IF_STATUS_UP               1
+#define IF_STATUS_DOWN             2
+#define IF_STATUS_TESTING          3
+#define IF_STATUS_UNKNOWN          4
+#define IF_STATUS_DORMANT          5
+#define IF_STATUS_NOT_PRESENT      6
+#define IF_STATUS_LOWER_LAYER_DOWN 7
+
+#define TRUTH_VALUE(x) ((x) ? 1 : 2)
+
+static int if_type(unsigned short arphrd) {
+    switch (arphrd) {
+        case ARPHRD_ETHER:     return IF_TYPE_ETHERNET_CSMACD;
+        case ARPHRD_LOOPBACK:  return IF_TYPE_SOFTWARE_LOOPBACK;
+        case ARPHRD_PPP:       return IF_TYPE_PPP;
+        case ARPHRD_IEEE80211: return IF_TYPE_IEEE80211;
+        case ARPHRD_TUNNEL:
+        case ARPHRD_TUNNEL6:
+        case ARPHRD_SIT:       return IF_TYPE_TUNNEL;
+        default:               return IF_TYPE_OTHER;
+    }
+}
+
+// Function to map IFLA_OPERSTATE to ifOperStatus
+static int if_oper_status(int operstate, unsigned int flags) {
+    switch (operstate) {
+        case IF_OPER_NOTPRESENT:     return IF_STATUS_NOT_PRESENT;
+        case IF_OPER_DOWN:           return IF_STATUS_DOWN;
+        case IF_OPER_LOWERLAYERDOWN: return IF_STATUS_LOWER_LAYER_DOWN;
+        case IF_OPER_TESTING:        return IF_STATUS_TESTING;
+        case IF_OPER_DORMANT:        return IF_STATUS_DORMANT;
+        case IF_OPER_UP:             return IF_STATUS_UP;
+        default:
+            // loopback 등 상태를 보고하지 않는 드라이버
+            if (!(flags & IFF_UP)) {
+                return IF_STATUS_DOWN;
+            }
+            return (flags & IFF_RUNNING) ? IF_STATUS_UP : IF_STATUS_UNKNOWN;
+    }
+}
+
+// Function to read the link speed in Mb/s from sysfs (0 if not reported)
+static unsigned int read_link_speed(const char *name) {
+    char path[128];
+    int speed = 0;
+
+    snprintf(path, sizeof(path), "%s/%s/speed", IFMIB_SYS_CLASS_NET, name);
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        return 0;
+    }
+    if (fscanf(fp, "%d", &speed) != 1 || speed < 0) {
+        speed = 0;
+    }
+    fclose(fp);
+    return (unsigned int)speed;
+}
+
+// --- ifTable / ifXTable 열 ---
+
+static int if_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const IfEntry *entry = (const IfEntry *)row->data;
+
+    switch (column) {
+        case 1:  value->int_value = entry->index; break;                      // ifIndex
+        case 2:  strcpy(value->str_value, entry->name); break;                 // ifDescr
+        case 3:  value->int_value = entry->type; break;                        // ifType
+        case 4:  value->int_value = entry->mtu; break;                         // ifMtu
+        case 5:                                                                // ifSpeed
+            value->uint_value = (entry->speed_mbps >= 4294) ? 0xFFFFFFFFu : entry->speed_mbps * 1000000u;
+            break;
+        case 6:                                                                // ifPhysAddress
+            memcpy(value->octets.data, entry->phys_address, entry->phys_address_len);
+            value->octets.len = entry->phys_address_len;
+            break;
+        case 7:  value->int_value = entry->admin_status; break;                // ifAdminStatus
+        case 8:  value->int_value = entry->oper_status; break;                 // ifOperStatus
+        case 9:  value->ticks_value = entry->last_change; break;               // ifLastChange
+        case 10: value->uint_value = (unsigned int)entry->rx_bytes; break;     // ifInOctets
+        case 11: value->uint_value = (unsigned int)(entry->rx_packets - entry->rx_multicast); break;
+        case 13: value->uint_value = (unsigned int)entry->rx_dropped; break;   // ifInDiscards
+        case 14: value->uint_value = (unsigned int)entry->rx_errors; break;    // ifInErrors
+        case 16: value->uint_value = (unsigned int)entry->tx_bytes; break;     // ifOutOctets
+        case 17: value->uint_value = (unsigned int)entry->tx_packets; break;   // ifOutUcastPkts
+        case 19: value->uint_value = (unsigned int)entry->tx_dropped; break;   // ifOutDiscards
+        case 20: value->uint_value = (unsigned int)entry->tx_errors; break;    // ifOutErrors
+        default: return -1;
+    }
+    return 0;
+}
+
+static int ifx_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const IfEntry *entry = (const IfEntry *)row->data;
+
+    switch (column) {
+        case 1:  strcpy(value->str_value, entry->name); break;                 // ifName
+        case 2:  value->uint_value = (unsigned int)entry->rx_multicast; break; // ifInMulticastPkts
+        case 6:  value->counter64_value = entry->rx_bytes; break;              // ifHCInOctets
+        case 7:  value->counter64_value = entry->rx_packets - entry->rx_multicast; break;
+        case 8:  value->counter64_value = entry->rx_multicast; break;          // ifHCInMulticastPkts
+        case 10: value->counter64_value = entry->tx_bytes; break;              // ifHCOutOctets
+        case 11: value->counter64_value = entry->tx_packets; break;            // ifHCOutUcastPkts
+        case 15: value->uint_value = entry->speed_mbps; break;                 // ifHighSpeed
+        case 16: value->int_value = TRUTH_VALUE(entry->promiscuous); break;    // ifPromiscuousMode
+        case 18: strcpy(value->str_value, entry->alias); break;                // ifAlias
+        case 19: value->ticks_value = 0; break;                                // ifCounterDiscontinuityTime
+        default: return -1;
+    }
+    return 0;
+}
+
+static const struct {
+    unsigned int subid;
+    const char *name;
+    const char *type;
+} if_columns[] = {
+    { 1, "ifIndex", "Integer32" },          { 2, "ifDescr", "DisplayString" },
+    { 3, "ifType", "INTEGER" },             { 4, "ifMtu", "Integer32" },
+    { 5, "ifSpeed", "Gauge32" },            { 6, "ifPhysAddress", "PhysAddress" },
+    { 7, "ifAdminStatus", "INTEGER" },      { 8, "ifOperStatus", "INTEGER" },
+    { 9, "ifLastChange", "TimeTicks" },     { 10, "ifInOctets", "Counter32" },
+    { 11, "ifInUcastPkts", "Counter32" },   { 13, "ifInDiscards", "Counter32" },
+    { 14, "ifInErrors", "Counter32" },      { 16, "ifOutOctets", "Counter32" },
+    { 17, "ifOutUcastPkts", "Counter32" },  { 19, "ifOutDiscards", "Counter32" },
+    { 20, "ifOutErrors", "Counter32" },
+}, ifx_columns[] = {
+    { 1, "ifName", "DisplayString" },                 { 2, "ifInMulticastPkts", "Counter32" },
+    { 6, "ifHCInOctets", "Counter64" },               { 7, "ifHCInUcastPkts", "Counter64" },
+    { 8, "ifHCInMulticastPkts", "Counter64" },        { 10, "ifHCOutOctets", "Counter64" },
+    { 11, "ifHCOutUcastPkts", "Counter64" },          { 15, "ifHighSpeed", "Gauge32" },
+    { 16, "ifPromiscuousMode", "INTEGER" },           { 18, "ifAlias", "DisplayString" },
+    { 19, "ifCounterDiscontinuityTime", "TimeTicks" },
+};
+
+// --- 수집 ---
+
+static IfEntry *next_entry(IfMib *ifmib, int count) {
+    if (count == ifmib->capacity) {
+        int capacity = ifmib->capacity ? ifmib->capacity * 2 : 16;
+        IfEntry *next = (IfEntry *)realloc(ifmib->next, capacity * sizeof(IfEntry));
+        if (!next) {
+            printf("Error: Memory allocation failed.\n");
+            return NULL;
+        }
+        ifmib->next = next;
+
+        // 현재 스냅샷도 같은 크기로 (교체 후 그대로 재사용)
+        IfEntry *entries = (IfEntry *)realloc(ifmib->entries, capacity * sizeof(IfEntry));
+        if (!entries) {
+            printf("Error: Memory allocation failed.\n");
+            return NULL;
+        }
+        ifmib->entries = entries;
+        ifmib->capacity = capacity;
+    }
+
+    memset(&ifmib->next[count], 0, sizeof(IfEntry));
+    return &ifmib->next[count];
+}
+
+static void parse_link_stats(IfEntry *entry, struct rtattr *attr) {
+    if (attr->rta_type == IFLA_STATS64 && RTA_PAYLOAD(attr) >= sizeof(struct rtnl_link_stats64)) {
+        struct rtnl_link_stats64 stats;
+        memcpy(&stats, RTA_DATA(attr), sizeof(stats));
+        entry->rx_bytes = stats.rx_bytes;
+        entry->rx_packets = stats.rx_packets;
+        entry->rx_multicast = stats.multicast;
+        entry->rx_errors = stats.rx_errors;
+        entry->rx_dropped = stats.rx_dropped;
+        entry->tx_bytes = stats.tx_bytes;
+        entry->tx_packets = stats.tx_packets;
+        entry->tx_errors = stats.tx_errors;
+        entry->tx_dropped = stats.tx_dropped;
+    } else if (attr->rta_type == IFLA_STATS && entry->rx_packets == 0 && entry->tx_packets == 0 &&
+               RTA_PAYLOAD(attr) >= sizeof(struct rtnl_link_stats)) {
+        // IFLA_STATS64가 없는 커널
+        struct rtnl_link_stats stats;
+        memcpy(&stats, RTA_DATA(attr), sizeof(stats));
+        entry->rx_bytes = stats.rx_bytes;
+        entry->rx_packets = stats.rx_packets;
+        entry->rx_multicast = stats.multicast;
+        entry->rx_errors = stats.rx_errors;
+        entry->rx_dropped = stats.rx_dropped;
+        entry->tx_bytes = stats.tx_bytes;
+        entry->tx_packets = stats.tx_packets;
+        entry->tx_errors = stats.tx_errors;
+        entry->tx_dropped = stats.tx_dropped;
+    }
+}
+
+// Function to collect every link with one RTM_GETLINK dump, returns the count or -1
+static int collect_netlink(IfMib *ifmib) {
+    static char buffer[IFMIB_NETLINK_BUFFER] __attribute__((aligned(__alignof__(struct nlmsghdr))));
+    struct {
+        struct nlmsghdr nh;
+        struct ifinfomsg ifi;
+    } request;
+    int count = 0;
+
+    memset(&request, 0, sizeof(request));
+    request.nh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.nh.nlmsg_type = RTM_GETLINK;
+    request.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.nh.nlmsg_seq = ++ifmib->netlink_seq;
+    request.ifi.ifi_family = AF_UNSPEC;
+
+    if (send(ifmib->netlink_fd, &request, request.nh.nlmsg_len, 0) < 0) {
+        perror("RTM_GETLINK");
+        return -1;
+    }
+
+    for (;;) {
+        ssize_t len = recv(ifmib->netlink_fd, buffer, sizeof(buffer), 0);
+        if (len <= 0) {
+            perror("RTM_GETLINK");
+            return -1;
+        }
+
+        for (struct nlmsghdr *nh = (struct nlmsghdr *)buffer; NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+            if (nh->nlmsg_seq != ifmib->netlink_seq) {
+                continue;
+            }
+            if (nh->nlmsg_type == NLMSG_DONE) {
+                return count;
+            }
+            if (nh->nlmsg_type == NLMSG_ERROR) {
+                printf("Error: RTM_GETLINK dump failed\n");
+                return -1;
+            }
+            if (nh->nlmsg_type != RTM_NEWLINK) {
+                continue;
+            }
+
+            struct ifinfomsg *ifi = (struct ifinfomsg *)NLMSG_DATA(nh);
+            IfEntry *entry = next_entry(ifmib, count);
+            if (!entry) {
+                return -1;
+            }
+
+            int operstate = IF_OPER_UNKNOWN;
+            entry->index = ifi->ifi_index;
+            entry->type = if_type(ifi->ifi_type);
+            entry->admin_status = (ifi->ifi_flags & IFF_UP) ? IF_STATUS_UP : IF_STATUS_DOWN;
+            entry->promiscuous = (ifi->ifi_flags & IFF_PROMISC) != 0;
+
+            int attr_len = IFLA_PAYLOAD(nh);
+            for (struct rtattr *attr = IFLA_RTA(ifi); RTA_OK(attr, attr_len); attr = RTA_NEXT(attr, attr_len)) {
+                switch (attr->rta_type) {
+                    case IFLA_IFNAME:
+                        strncpy(entry->name, (const char *)RTA_DATA(attr), sizeof(entry->name) - 1);
+                        break;
+                    case IFLA_IFALIAS:
+                        strncpy(entry->alias, (const char *)RTA_DATA(attr), sizeof(entry->alias) - 1);
+                        break;
+                    case IFLA_MTU:
+                        entry->mtu = *(const int *)RTA_DATA(attr);
+                        break;
+                    case IFLA_OPERSTATE:
+                        operstate = *(const unsigned char *)RTA_DATA(attr);
+                        break;
+                    case IFLA_ADDRESS: {
+                        int addr_len = RTA_PAYLOAD(attr);
+                        if (addr_len > (int)sizeof(entry->phys_address)) {
+                            addr_len = sizeof(entry->phys_address);
+                        }
+                        memcpy(entry->phys_address, RTA_DATA(attr), addr_len);
+                        entry->phys_address_len = addr_len;
+                        break;
+                    }
+                    case IFLA_STATS64:
+                    case IFLA_STATS:
+                        parse_link_stats(entry, attr);
+                        break;
+                }
+            }
+            entry->oper_status = if_oper_status(operstate, ifi->ifi_flags);
+            count++;
+        }
+    }
+}
+
+// Function to collect names and counters from /proc/net/dev (netlink unavailable)
+static int collect_proc_net_dev(IfMib *ifmib) {
+    char line[512];
+    int count = 0;
+
+    FILE *fp = fopen(IFMIB_PROC_NET_DEV, "r");
+    if (!fp) {
+        perror(IFMIB_PROC_NET_DEV);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        char *colon = strchr(line, ':');
+        if (!colon) {
+            continue;   // 헤더 두 줄
+        }
+        *colon = '\0';
+
+        char *name = line;
+        while (*name == ' ') {
+            name++;
+        }
+
+        IfEntry *entry = next_entry(ifmib, count);
+        if (!entry) {
+            break;
+        }
+        strncpy(entry->name, name, sizeof(entry->name) - 1);
+        if (sscanf(colon + 1, "%llu %llu %llu %llu %*u %*u %*u %llu %llu %llu %llu %llu",
+                   &entry->rx_bytes, &entry->rx_packets, &entry->rx_errors, &entry->rx_dropped,
+                   &entry->rx_multicast, &entry->tx_bytes, &entry->tx_packets, &entry->tx_errors,
+                   &entry->tx_dropped) != 9) {
+            continue;
+        }
+
+        entry->index = if_nametoindex(entry->name);
+        entry->type = strcmp(entry->name, "lo") == 0 ? IF_TYPE_SOFTWARE_LOOPBACK : IF_TYPE_OTHER;
+        entry->admin_status = IF_STATUS_UP;
+        entry->oper_status = IF_STATUS_UNKNOWN;
+        if (entry->index > 0) {
+            count++;
+        }
+    }
+
+    fclose(fp);
+    return count;
+}
+
+// Function to find an interface in the current snapshot (binary search by ifIndex)
+static const IfEntry *find_entry(const IfMib *ifmib, unsigned int index) {
+    int low = 0;
+    int high = ifmib->entry_count;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (ifmib->entries[mid].index < index) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < ifmib->entry_count && ifmib->entries[low].index == index) ? &ifmib->entries[low] : NULL;
+}
+
+static int compare_entries(const void *a, const void *b) {
+    unsigned int index1 = ((const IfEntry *)a)->index;
+    unsigned int index2 = ((const IfEntry *)b)->index;
+    return (index1 > index2) - (index1 < index2);
+}
+
+// Function to point the table rows at the current snapshot
+static void link_rows(IfMib *ifmib) {
+    mib_table_clear_rows(&ifmib->if_table);
+    mib_table_clear_rows(&ifmib->ifx_table);
+    for (int i = 0; i < ifmib->entry_count; i++) {
+        MIBIndexValue index = { .int_value = ifmib->entries[i].index };
+        mib_table_add_row(&ifmib->if_table, &index, &ifmib->entries[i]);
+        mib_table_add_row(&ifmib->ifx_table, &index, &ifmib->entries[i]);
+    }
+}
+
+// Function to take a new snapshot and rebuild the table rows from it.
+// Speed and ifLastChange carry over unless the operational status changed.
+int ifmib_refresh(IfMib *ifmib) {
+    int count = (ifmib->netlink_fd >= 0) ? collect_netlink(ifmib) : collect_proc_net_dev(ifmib);
+    if (count < 0) {
+        // 버퍼가 재할당되었을 수 있으므로 이전 스냅샷에 다시 연결
+        link_rows(ifmib);
+        return -1;
+    }
+
+    qsort(ifmib->next, count, sizeof(IfEntry), compare_entries);
+
+    unsigned long now = get_system_uptime();
+    for (int i = 0; i < count; i++) {
+        IfEntry *entry = &ifmib->next[i];
+        const IfEntry *previous = find_entry(ifmib, entry->index);
+
+        if (previous && previous->oper_status == entry->oper_status && strcmp(previous->name, entry->name) == 0) {
+            entry->speed_mbps = previous->speed_mbps;
+            entry->last_change = previous->last_change;
+        } else {
+            entry->speed_mbps = read_link_speed(entry->name);
+            entry->last_change = (ifmib->refresh_count > 0) ? now : 0;
+        }
+    }
+
+    // 스냅샷 교체 후 행을 새 항목으로 다시 연결
+    IfEntry *entries = ifmib->entries;
+    ifmib->entries = ifmib->next;
+    ifmib->next = entries;
+    ifmib->entry_count = count;
+    link_rows(ifmib);
+
+    if (ifmib->if_number) {
+        MIBValue value;
+        memset(&value, 0, sizeof(MIBValue));
+        value.int_value = count;
+        mib_node_write_value(ifmib->if_number, &value);
+    }
+
+    ifmib->refresh_count++;
+    return count;
+}
+
+static int open_netlink_dump(void) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        perror("netlink socket");
+        return -1;
+    }
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("netlink bind");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Function to register ifNumber, ifTable and ifXTable and take the first snapshot
+int ifmib_init(IfMib *ifmib, MIBTree *mib_tree) {
+    MIBIndexType index_type = MIB_INDEX_INTEGER;
+    int zero = 0;
+
+    memset(ifmib, 0, sizeof(IfMib));
+
+    if (mib_table_init(&ifmib->if_table, "ifEntry", IFMIB_IF_ENTRY_OID, &index_type, 1) < 0 ||
+        mib_table_init(&ifmib->ifx_table, "ifXEntry", IFMIB_IFX_ENTRY_OID, &index_type, 1) < 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(if_columns) / sizeof(if_columns[0]); i++) {
+        mib_table_add_column(&ifmib->if_table, if_columns[i].subid, if_columns[i].name, if_columns[i].type,
+                             if_column);
+    }
+    for (size_t i = 0; i < sizeof(ifx_columns) / sizeof(ifx_columns[0]); i++) {
+        mib_table_add_column(&ifmib->ifx_table, ifx_columns[i].subid, ifx_columns[i].name, ifx_columns[i].type,
+                             ifx_column);
+    }
+
+    ifmib->if_number = add_mib_node(mib_tree, "ifNumber", IFMIB_IF_NUMBER_OID, "Integer32", HANDLER_CAN_RONLY,
+                                    "current", &zero, NULL);
+    mib_table_register(mib_tree, &ifmib->if_table);
+    mib_table_register(mib_tree, &ifmib->ifx_table);
+
+    ifmib->netlink_fd = open_netlink_dump();
+    if (ifmib->netlink_fd < 0) {
+        printf("IF-MIB: netlink unavailable, using %s\n", IFMIB_PROC_NET_DEV);
+    }
+
+    return ifmib_refresh(ifmib);
+}
+
+void ifmib_close(IfMib *ifmib) {
+    if (ifmib->netlink_fd >= 0) {
+        close(ifmib->netlink_fd);
+    }
+    mib_table_free(&ifmib->if_table);
+    mib_table_free(&ifmib->ifx_table);
+    free(ifmib->entries);
+    free(ifmib->next);
+    ifmib->entries = ifmib->next = NULL;
+    ifmib->entry_count = ifmib->capacity = 0;
+    ifmib->netlink_fd = -1;
+}
@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snmp.h"        // SNMP protocol definitions
+#include "snmp_parse.h"  // SNMP message parsing functions
+#include "snmp_event.h"  // Event loop timers
+#include "snmp_trap.h"   // Notification send queue
+#include "snmp_inform.h" // InformRequest tracking
+#include "snmp_stats.h"  // Agent counters
+#include "snmp_log.h"    // Logging
+
+static void inform_timer(void *ctx);
+
+// --- 재전송 마감 시간 최소 힙 ---
+
+static void heap_swap(SNMPInformTable *table, int a, int b) {
+    int slot = table->heap[a];
+    table->heap[a] = table->heap[b];
+    table->heap[b] = slot;
+    table->entries[table->heap[a]].heap_pos = a;
+    table->entries[table->heap[b]].heap_pos = b;
+}
+
+static long long heap_deadline(SNMPInformTable *table, int pos) {
+    return table->entries[table->heap[pos]].deadline_ms;
+}
+
+static void heap_sift_up(SNMPInformTable *table, int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (heap_deadline(table, parent) <= heap_deadline(table, pos)) {
+            break;
+        }
+        heap_swap(table, parent, pos);
+        pos = parent;
+    }
+}
+
+static void heap_sift_down(SNMPInformTable *table, int pos) {
+    while (1) {
+        int smallest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+
+        if (left < table->count && heap_deadline(table, left) < heap_deadline(table, smallest)) {
+            smallest = left;
+        }
+        if (right < table->count && heap_deadline(table, right) < heap_deadline(table, smallest)) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        heap_swap(table, pos, smallest);
+        pos = smallest;
+    }
+}
+
+// Function to remove an entry from the table and the heap
+static void remove_entry(SNMPInformTable *table, int slot) {
+    InformEntry *entry = &table->entries[slot];
+    int pos = entry->heap_pos;
+
+    entry->in_use = 0;
+    table->count--;
+
+    if (pos != table->count) {
+        heap_swap(table, pos, table->count);
+        heap_sift_up(table, pos);
+        heap_sift_down(table, pos);
+    }
+}
+
+// Function to (re)arm the one-shot timer for the earliest deadline
+static void arm_timer(SNMPInformTable *table) {
+    EventLoop *loop = table->notifier->loop;
+
+    if (table->timer_id >= 0) {
+        event_loop_cancel_timer(loop, table->timer_id);
+        table->timer_id = -1;
+    }
+
+    if (table->count > 0) {
+        long long delay = heap_deadline(table, 0) - event_loop_now_ms();
+        table->timer_id = event_loop_add_timer(loop, delay > 0 ? delay : 0, 0, inform_timer, table);
+    }
+}
+
+// Function to set up the in-flight table, every entry keeps a copy of a
+// notifier message (max_message bytes)
+int inform_table_init(SNMPInformTable *table, SNMPNotifier *notifier) {
+    memset(table, 0, sizeof(SNMPInformTable));
+    table->notifier = notifier;
+    table->timer_id = -1;
+
+    table->pool = malloc((size_t)INFORM_TABLE_SIZE * notifier->max_message);
+    if (!table->pool) {
+        return -1;
+    }
+    for (int i = 0; i < INFORM_TABLE_SIZE; i++) {
+        table->entries[i].data = table->pool + (size_t)i * notifier->max_message;
+    }
+    notifier->informs = table;
+    return 0;
+}
+
+void inform_table_close(SNMPInformTable *table) {
+    if (table->notifier && table->notifier->informs == table) {
+        table->notifier->informs = NULL;
+    }
+    free(table->pool);
+    table->pool = NULL;
+}
+
+// Function to send an InformRequest and track it until acknowledged.
+// Never blocks: the message goes through the notifier send queue.
+int inform_send(SNMPInformTable *table, int target, unsigned int request_id,
+                const unsigned char *data, int len) {
+    const SNMPTrapConfig *config = table->notifier->config;
+    int slot = request_id % INFORM_TABLE_SIZE;
+    InformEntry *entry = &table->entries[slot];
+
+    if (len > table->notifier->max_message) {
+        return -1;
+    }
+    if (entry->in_use) {
+        log_warn("Inform %u dropped: in-flight table full", entry->request_id);
+        remove_entry(table, slot);
+        table->drop_count++;
+    }
+
+    entry->in_use = 1;
+    entry->request_id = request_id;
+    entry->target = target;
+    entry->retries_left = config->inform_retries;
+    entry->timeout_ms = config->inform_timeout_ms;
+    entry->deadline_ms = event_loop_now_ms() + entry->timeout_ms;
+    entry->len = len;
+    memcpy(entry->data, data, len);
+
+    entry->heap_pos = table->count;
+    table->heap[table->count++] = slot;
+    heap_sift_up(table, entry->heap_pos);
+
+    notifier_enqueue(table->notifier, target, data, len);
+
+    if (table->heap[0] == slot) {
+        arm_timer(table);
+    }
+    return 0;
+}
+
+// Timer callback: retransmit expired informs with exponential backoff
+static void inform_timer(void *ctx) {
+    SNMPInformTable *table = (SNMPInformTable *)ctx;
+    long long now = event_loop_now_ms();
+
+    // 단발 타이머는 이미 해제됨
+    table->timer_id = -1;
+
+    while (table->count > 0 && heap_deadline(table, 0) <= now) {
+        int slot = table->heap[0];
+        InformEntry *entry = &table->entries[slot];
+
+        if (entry->retries_left == 0) {
+            log_warn("Inform %u to %s not acknowledged, giving up", entry->request_id,
+                     table->notifier->config->targets[entry->target].host);
+            remove_entry(table, slot);
+            table->failed_count++;
+            continue;
+        }
+
+        entry->retries_left--;
+        entry->timeout_ms *= 2;
+        entry->deadline_ms = now + entry->timeout_ms;
+        heap_sift_down(table, 0);
+
+        notifier_enqueue(table->notifier, entry->target, entry->data, entry->len);
+        table->retransmit_count++;
+    }
+
+    arm_timer(table);
+}
+
+// Function to match a Response received on the agent socket against the
+// in-flight informs. Returns 1 if the message was an inform ack (consumed),
+// -1 if it was malformed (dropped and counted).
+// Informs are only sent as SNMPv2c, so an ack must be a v2c Response from the
+// target address carrying the inform's request-id and community.
+int inform_handle_response(SNMPInformTable *table, unsigned char *buffer, int n,
+                           const struct sockaddr_storage *from) {
+    static SNMPPacket packet;
+    int index = 0;
+
+    if (table->count == 0 || peek_snmp_version(buffer, n) != SNMP_VERSION_2c) {
+        return 0;
+    }
+
+    snmp_packet_reset(&packet);
+    if (parse_snmp_message(buffer, &index, n, &packet) < 0) {
+        log_debug("Malformed SNMP message dropped");
+        stats_inc(STATS_IN_ASN_PARSE_ERRS);
+        return -1;
+    }
+    if (packet.pdu_type != 0xA2) {
+        return 0;
+    }
+
+    int slot = packet.request_id % INFORM_TABLE_SIZE;
+    InformEntry *entry = &table->entries[slot];
+    const SNMPTrapTarget *target = &table->notifier->config->targets[entry->target];
+    if (entry->in_use && entry->request_id == packet.request_id &&
+        target->version == SNMP_VERSION_2c && strcmp(packet.community, target->security_name) == 0 &&
+        addr_equal(&table->notifier->target_addrs[entry->target], from)) {
+        int was_first = (entry->heap_pos == 0);
+        remove_entry(table, slot);
+        table->acked_count++;
+        if (was_first) {
+            arm_timer(table);
+        }
+    }
+
+    // 늦게 도착한 응답도 에이전트 요청 경로로 넘기지 않음
+    return 1;
+}
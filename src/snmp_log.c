@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <syslog.h>
+
+#include "snmp_event.h"  // Flush timer
+#include "snmp_log.h"    // Logging
+
+#define LOG_TOKEN 1000   // Rate limit token unit (1/1000 message)
+
+static SNMPLog logger = { .targets = SNMP_LOG_CONSOLE, .flush_timer_id = -1 };
+
+static void write_entry(int level, const char *text) {
+    if (logger.targets & SNMP_LOG_CONSOLE) {
+        fputs(text, stdout);
+        fputc('\n', stdout);
+    }
+    if (logger.targets & SNMP_LOG_SYSLOG) {
+        syslog(level, "%s", text);
+    }
+}
+
+// Function to report messages lost since the last report as one message
+static void report_lost(void) {
+    char text[SNMP_LOG_LINE_MAX];
+
+    if (logger.suppressed_count == 0 && logger.dropped_count == 0) {
+        return;
+    }
+    snprintf(text, sizeof(text), "Log: %lu messages rate limited, %lu dropped on a full queue",
+             logger.suppressed_count, logger.dropped_count);
+    logger.suppressed_count = 0;
+    logger.dropped_count = 0;
+    write_entry(SNMP_LOG_WARN, text);
+}
+
+static void log_flush_timer(void *ctx) {
+    (void)ctx;
+    logger.flush_timer_id = -1;
+    log_flush();
+}
+
+static void schedule_flush(void) {
+    if (logger.loop && logger.flush_timer_id < 0) {
+        logger.flush_timer_id = event_loop_add_timer(logger.loop, SNMP_LOG_FLUSH_MS, 0, log_flush_timer, NULL);
+    }
+}
+
+// Function to write up to one batch of queued messages, rearming the flush
+// timer while messages remain
+void log_flush(void) {
+    int batch = logger.loop ? SNMP_LOG_FLUSH_BATCH : SNMP_LOG_RING_SIZE;
+
+    for (int i = 0; i < batch && logger.count > 0; i++) {
+        LogEntry *entry = &logger.entries[logger.head];
+        write_entry(entry->level, entry->text);
+        logger.head = (logger.head + 1) % SNMP_LOG_RING_SIZE;
+        logger.count--;
+    }
+    if (logger.count == 0) {
+        report_lost();
+    }
+    if (logger.targets & SNMP_LOG_CONSOLE) {
+        fflush(stdout);
+    }
+
+    if (logger.count > 0) {
+        schedule_flush();
+    }
+}
+
+void log_init(int targets) {
+    logger.targets = targets;
+    logger.tokens = (long long)SNMP_LOG_BURST * LOG_TOKEN;
+    logger.last_ms = event_loop_now_ms();
+
+    if (targets & SNMP_LOG_SYSLOG) {
+        openlog("snmp", LOG_PID, LOG_DAEMON);
+    }
+}
+
+// Function to start queueing messages, written later from the event loop
+void log_attach(EventLoop *loop) {
+    logger.loop = loop;
+}
+
+// Function to write everything still queued and go back to synchronous output
+void log_close(void) {
+    if (logger.loop && logger.flush_timer_id >= 0) {
+        event_loop_cancel_timer(logger.loop, logger.flush_timer_id);
+    }
+    logger.loop = NULL;
+    logger.flush_timer_id = -1;
+    log_flush();
+
+    if (logger.targets & SNMP_LOG_SYSLOG) {
+        closelog();
+    }
+}
+
+// Function to take one rate limit token (errors are never limited)
+static int log_allow(int level) {
+    if (level <= SNMP_LOG_ERROR) {
+        return 1;
+    }
+
+    long long now_ms = event_loop_now_ms();
+    long long limit = (long long)SNMP_LOG_BURST * LOG_TOKEN;
+    if (now_ms > logger.last_ms) {
+        logger.tokens += (now_ms - logger.last_ms) * SNMP_LOG_RATE;
+        if (logger.tokens > limit) {
+            logger.tokens = limit;
+        }
+    }
+    logger.last_ms = now_ms;
+
+    if (logger.tokens < LOG_TOKEN) {
+        logger.suppressed_count++;
+        schedule_flush();   // 누락 건수 보고
+        return 0;
+    }
+    logger.tokens -= LOG_TOKEN;
+    return 1;
+}
+
+void snmp_log(int level, const char *format, ...) {
+    if (!log_allow(level)) {
+        return;
+    }
+
+    if (logger.count == SNMP_LOG_RING_SIZE) {
+        logger.dropped_count++;
+        schedule_flush();
+        return;
+    }
+
+    LogEntry *entry = &logger.entries[(logger.head + logger.count) % SNMP_LOG_RING_SIZE];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(entry->text, sizeof(entry->text), format, args);
+    va_end(args);
+    entry->level = level;
+    logger.count++;
+
+    // 이벤트 루프 밖에서는 바로 출력, 타이머를 걸 수 없을 때도 마찬가지
+    schedule_flush();
+    if (logger.flush_timer_id < 0) {
+        log_flush();
+    }
+}
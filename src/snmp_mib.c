@@ -5,19 +5,47 @@
 #include "snmp_mib.h"    // MIB tree function declarations
 #include "utility.h"     // System utility functions
 
-// Function to add a MIB node
-MIBNode *add_mib_node(MIBTree *mib_tree, const char *name, const char *oid, const char *type, int isWritable, const char *status, const void *value, MIBNode *parent) {
-    if (mib_tree->node_count >= MAX_NODES) {
-        printf("Error: Maximum number of nodes reached.\n");
-        return NULL;
+// Function to map a SYNTAX (or its SMI base type) to the stored value type
+ValueType mib_value_type(const char *type) {
+    static const char *integer_types[] = { "Integer32", "INTEGER", NULL };
+    static const char *gauge_types[] = { "Unsigned32", "Gauge32", "Gauge", NULL };
+
+    for (int i = 0; integer_types[i]; i++) {
+        if (strcmp(type, integer_types[i]) == 0) {
+            return VALUE_TYPE_INT;
+        }
     }
-
-    for (int i = 0; i < mib_tree->node_count; i++) {
-        if (strcmp(mib_tree->nodes[i]->oid, oid) == 0) {
-            printf("Error: OID %s already exists.\n", oid);
-            return NULL;
+    for (int i = 0; gauge_types[i]; i++) {
+        if (strcmp(type, gauge_types[i]) == 0) {
+            return VALUE_TYPE_GAUGE32;
         }
     }
+    if (strcmp(type, "Counter32") == 0 || strcmp(type, "Counter") == 0) {
+        return VALUE_TYPE_COUNTER32;
+    }
+    if (strcmp(type, "Counter64") == 0) {
+        return VALUE_TYPE_COUNTER64;
+    }
+    // Octets: binary OCTET STRING objects registered by the agent itself (view masks)
+    if (strcmp(type, "PhysAddress") == 0 || strcmp(type, "MacAddress") == 0 || strcmp(type, "DateAndTime") == 0 ||
+        strcmp(type, "Octets") == 0) {
+        return VALUE_TYPE_OCTETS;
+    }
+    if (strcmp(type, "TimeTicks") == 0) {
+        return VALUE_TYPE_TIME_TICKS;
+    }
+    if (strcmp(type, "OBJECT IDENTIFIER") == 0 || strcmp(type, "MODULE-IDENTITY") == 0) {
+        return VALUE_TYPE_OID;
+    }
+    return VALUE_TYPE_STRING;   // DisplayString, OCTET STRING, IpAddress, ...
+}
+
+// Function to add a MIB node (value may be NULL)
+MIBNode *add_mib_node(MIBTree *mib_tree, const char *name, const char *oid, const char *type, int isWritable, const char *status, const void *value, MIBNode *parent) {
+    if (find_mib_node_by_oid(mib_tree, oid)) {
+        printf("Error: OID %s already exists.\n", oid);
+        return NULL;
+    }
 
     if (strcmp(status, "current") != 0) {
         return NULL;
@@ -33,33 +61,45 @@ MIBNode *add_mib_node(MIBTree *mib_tree, const char *name, const char *oid, cons
     node->name[sizeof(node->name) - 1] = '\0';
     strncpy(node->oid, oid, sizeof(node->oid) - 1);
     node->oid[sizeof(node->oid) - 1] = '\0';
+    node->oid_ber_len = 0;
     strncpy(node->type, type, sizeof(node->type) - 1);
     node->type[sizeof(node->type) - 1] = '\0';
     node->isWritable = isWritable;
     strncpy(node->status, status, sizeof(node->status) - 1);
     node->status[sizeof(node->status) - 1] = '\0';
+    node->value_seq = 0;
+    node->write_handler = NULL;
+    node->read_handler = NULL;
+    node->read_ctx = NULL;
+    node->preallocated = 0;
+    node->has_range = 0;
+    node->range_min = 0;
+    node->range_max = 0;
+    node->table = NULL;
     node->parent = parent;
     node->child = NULL;
     node->next = NULL;
 
-    if (strcmp(type, "Integer32") == 0) {
-        node->value_type = VALUE_TYPE_INT;
-        node->value.int_value = *(int *)value;
-    } else if (strcmp(type, "DisplayString") == 0) {
-        node->value_type = VALUE_TYPE_STRING;
-        strncpy(node->value.str_value, (const char *)value, sizeof(node->value.str_value) - 1);
-        node->value.str_value[sizeof(node->value.str_value) - 1] = '\0';
-    } else if (strcmp(type, "TimeTicks") == 0) {
-        node->value_type = VALUE_TYPE_TIME_TICKS;
-        node->value.ticks_value = *(unsigned long *)value;
-    } else if (strcmp(type, "OBJECT IDENTIFIER") == 0 || strcmp(type, "MODULE-IDENTITY") == 0) {
-        node->value_type = VALUE_TYPE_OID;
-        strncpy(node->value.oid_value, (const char *)value, sizeof(node->value.oid_value) - 1);
-        node->value.oid_value[sizeof(node->value.oid_value) - 1] = '\0';
-    } else {
-        node->value_type = VALUE_TYPE_STRING;
-        strncpy(node->value.str_value, (const char *)value, sizeof(node->value.str_value) - 1);
-        node->value.str_value[sizeof(node->value.str_value) - 1] = '\0';
+    node->value_type = mib_value_type(type);
+    memset(&node->value, 0, sizeof(MIBValue));
+
+    // 값 없이 등록된 노드는 0 / 빈 문자열로 시작
+    if (value) {
+        if (node->value_type == VALUE_TYPE_INT) {
+            node->value.int_value = *(const int *)value;
+        } else if (node->value_type == VALUE_TYPE_TIME_TICKS) {
+            node->value.ticks_value = *(const unsigned long *)value;
+        } else if (node->value_type == VALUE_TYPE_COUNTER32 || node->value_type == VALUE_TYPE_GAUGE32) {
+            node->value.uint_value = *(const unsigned int *)value;
+        } else if (node->value_type == VALUE_TYPE_COUNTER64) {
+            node->value.counter64_value = *(const unsigned long long *)value;
+        } else if (node->value_type == VALUE_TYPE_OCTETS) {
+            memcpy(&node->value.octets, value, sizeof(node->value.octets));
+        } else if (node->value_type == VALUE_TYPE_OID) {
+            strncpy(node->value.oid_value, (const char *)value, sizeof(node->value.oid_value) - 1);
+        } else {
+            strncpy(node->value.str_value, (const char *)value, sizeof(node->value.str_value) - 1);
+        }
     }
 
     if (parent) {
@@ -72,13 +112,16 @@ MIBNode *add_mib_node(MIBTree *mib_tree, const char *name, const char *oid, cons
             }
             sibling->next = node;
         }
-    } else {
+    } else if (!mib_tree->root) {
         mib_tree->root = node;
     }
 
     if (strcmp(type, "MODULE-IDENTITY") != 0) {
         if (strcmp(type, "OBJECT IDENTIFIER") != 0 || strcmp(name, "sysObjectID") == 0) {
-            mib_tree->nodes[mib_tree->node_count++] = node;
+            if (mib_tree_insert(mib_tree, node) < 0) {
+                free(node);
+                return NULL;
+            }
         }
     }
 
@@ -102,6 +145,10 @@ void print_all_mib_nodes(MIBTree *mib_tree) {
             printf("  Value (OID): %s\n", node->value.oid_value);
         } else if (node->value_type == VALUE_TYPE_TIME_TICKS) {
             printf("  Value (TimeTicks): %lu\n", node->value.ticks_value);
+        } else if (node->value_type == VALUE_TYPE_COUNTER32 || node->value_type == VALUE_TYPE_GAUGE32) {
+            printf("  Value: %u\n", node->value.uint_value);
+        } else if (node->value_type == VALUE_TYPE_COUNTER64) {
+            printf("  Value: %llu\n", node->value.counter64_value);
         } else {
             printf("  Value: Unsupported type\n");
         }
@@ -122,90 +169,31 @@ MIBNode *find_mib_node(MIBNode *node, const char *name) {
     return find_mib_node(node->next, name);
 }
 
-// Function to parse OBJECT IDENTIFIER
-void parse_object_identifier(char *line, MIBTree *mib_tree) {
-    char name[32], parent_name[32];
-    int number;
-
-    sscanf(line, "%s OBJECT IDENTIFIER ::= { %s %d }", name, parent_name, &number);
-
-    if (strcmp(parent_name, "cam") != 0) {
-        return;
-    }
+// Function to convert OID to string
+void oid_to_string(const unsigned char *oid, int oid_len, char *oid_str) {
+    unsigned long value = 0;
 
-    MIBNode *parent = find_mib_node(mib_tree->root, parent_name);
-    if (!parent) {
-        printf("Error: Parent OID %s not found for OBJECT IDENTIFIER %s\n", parent_name, name);
+    if (oid_len <= 0) {
+        oid_str[0] = '\0';
         return;
     }
 
-    char full_oid[128];
-    snprintf(full_oid, sizeof(full_oid), "%s.%d", parent->oid, number);
-
-    add_mib_node(mib_tree, name, full_oid, "OBJECT IDENTIFIER", 0, "current", "", parent);
-}
+    int pos = sprintf(oid_str, "%d.%d", oid[0] / 40, oid[0] % 40);
 
-// Function to parse OBJECT-TYPE definition
-void parse_object_type(char *line, FILE *file, MIBTree *mib_tree) {
-    char name[32], syntax[16] = "", access[12] = "", status[12] = "", description[128] = "";
-    char oid_parent_name[128];
-    int oid_number;
-
-    sscanf(line, "%s OBJECT-TYPE", name);
-
-    while (fgets(line, 256, file)) {
-        if (strstr(line, "SYNTAX")) {
-            sscanf(line, " SYNTAX %s", syntax);
-        } else if (strstr(line, "MAX-ACCESS")) {
-            sscanf(line, " MAX-ACCESS %s", access);
-        } else if (strstr(line, "STATUS")) {
-            sscanf(line, " STATUS %s", status);
-        } else if (strstr(line, "DESCRIPTION")) {
-            char *start = strchr(line, '"');
-            if (start) {
-                strncpy(description, start +1, sizeof(description)-1);
-                description[sizeof(description)-1] = '\0';
-                char *end = strchr(description, '"');
-                if (end) {
-                    *end = '\0';
-                }
-            }
-        } else if (strstr(line, "::=")) {
-            sscanf(line, " ::= { %s %d }", oid_parent_name, &oid_number);
-            break;
+    // 하위 식별자는 7비트 단위 base-128 인코딩
+    for (int i = 1; i < oid_len; i++) {
+        value = (value << 7) | (oid[i] & 0x7F);
+        if (!(oid[i] & 0x80)) {
+            pos += sprintf(oid_str + pos, ".%lu", value);
+            value = 0;
         }
     }
-
-    MIBNode *parent = find_mib_node(mib_tree->root, oid_parent_name);
-    if (!parent) {
-        printf("Error: Parent OID %s not found for OBJECT-TYPE %s\n", oid_parent_name, name);
-        return;
-    }
-
-    char full_oid[128];
-    snprintf(full_oid, sizeof(full_oid), "%s.%d", parent->oid, oid_number);
-
-    int isWritable = (strcmp(access, "read-write") == 0 || strcmp(access, "read-create") == 0);
-    add_mib_node(mib_tree, name, full_oid, syntax, isWritable, status, "", parent);
-}
-
-// Function to convert OID to string
-void oid_to_string(unsigned char *oid, int oid_len, char *oid_str) {
-    int i;
-    char buffer[64];
-
-    sprintf(oid_str, "%d.%d", oid[0] / 40, oid[0] % 40);
-
-    for (i = 1; i < oid_len; i++) {
-        sprintf(buffer, ".%d", oid[i]);
-        strcat(oid_str, buffer);
-    }
 }
 
 // Function to parse OID string into integer array
 int parse_oid_string(const char *oid_str, unsigned int *oid_parts) {
     int oid_len = 0;
-    char oid_copy[64];
+    char oid_copy[128];
     strncpy(oid_copy, oid_str, sizeof(oid_copy) - 1);
     oid_copy[sizeof(oid_copy) - 1] = '\0';
     char *token = strtok(oid_copy, ".");
@@ -221,47 +209,215 @@ int parse_oid_string(const char *oid_str, unsigned int *oid_parts) {
     return oid_len;
 }
 
-// Function to compare OID strings
+// Function to compare OID strings numerically, component by component
 int compare_oids(const char *oid1, const char *oid2) {
-    unsigned int oid1_parts[128], oid2_parts[128];
-    int oid1_len = parse_oid_string(oid1, oid1_parts);
-    int oid2_len = parse_oid_string(oid2, oid2_parts);
-    if (oid1_len == -1 || oid2_len == -1) {
-        return 0;
+    while (*oid1 == '.') oid1++;
+    while (*oid2 == '.') oid2++;
+
+    while (*oid1 && *oid2) {
+        char *end1, *end2;
+        unsigned long part1 = strtoul(oid1, &end1, 10);
+        unsigned long part2 = strtoul(oid2, &end2, 10);
+
+        if (end1 == oid1 || end2 == oid2) {
+            int cmp = strcmp(oid1, oid2);   // 숫자가 아닌 구성 요소
+            return (cmp > 0) - (cmp < 0);
+        }
+        if (part1 != part2) {
+            return part1 < part2 ? -1 : 1;
+        }
+
+        oid1 = (*end1 == '.') ? end1 + 1 : end1;
+        oid2 = (*end2 == '.') ? end2 + 1 : end2;
     }
-    int min_len = oid1_len < oid2_len ? oid1_len : oid2_len;
 
-    for (int i = 0; i < min_len; i++) {
-        if (oid1_parts[i] < oid2_parts[i]) return -1;
-        if (oid1_parts[i] > oid2_parts[i]) return 1;
+    if (*oid1) return 1;
+    if (*oid2) return -1;
+    return 0;
+}
+
+// Function to compare the encoded OID of a registered node with an encoded OID.
+// BER sub-identifiers keep numeric order byte by byte (continuation bytes are >= 0x80).
+static int compare_node_oid(const MIBNode *node, const unsigned char *oid, int oid_len) {
+    int min_len = node->oid_ber_len < oid_len ? node->oid_ber_len : oid_len;
+    int cmp = memcmp(node->oid_ber, oid, min_len);
+
+    if (cmp != 0) {
+        return cmp;
     }
-    if (oid1_len < oid2_len) return -1;
-    if (oid1_len > oid2_len) return 1;
+    return node->oid_ber_len - oid_len;
+}
+
+// Function to encode a dotted OID as a registry key of at most max_len bytes.
+// A longer key is cut short, which keeps its order against every node that fits.
+static int encode_oid_key(const char *oid, unsigned char *key, int max_len) {
+    unsigned long first = 0;
+    int count = 0;
+    int len = 0;
+
+    while (*oid == '.') oid++;
+
+    while (*oid && len < max_len) {
+        char *end;
+        unsigned long value = strtoul(oid, &end, 10) & 0xFFFFFFFFUL;
+        if (end == oid) {
+            break;
+        }
+        oid = (*end == '.') ? end + 1 : end;
+
+        // 처음 두 구성 요소는 한 바이트 (X * 40 + Y)
+        if (count++ == 0) {
+            first = value;
+            continue;
+        }
+        if (count == 2) {
+            key[len++] = (unsigned char)(first * 40 + value);
+            continue;
+        }
+
+        // 7비트 단위 base-128, 마지막 바이트 외에는 연속 비트
+        unsigned char temp[5];
+        int temp_len = 0;
+        do {
+            temp[temp_len++] = value & 0x7F;
+            value >>= 7;
+        } while (value > 0);
+        while (temp_len-- > 0 && len < max_len) {
+            key[len++] = temp[temp_len] | (temp_len ? 0x80 : 0);
+        }
+    }
+    return len;
+}
+
+static int compare_registry_nodes(const void *a, const void *b) {
+    const MIBNode *node = *(const MIBNode * const *)a;
+    const MIBNode *other = *(const MIBNode * const *)b;
+    return compare_node_oid(node, other->oid_ber, other->oid_ber_len);
+}
+
+// Function to find the first sorted node whose OID is >= oid (binary search).
+// Nodes appended out of order during a bulk load are not searched.
+static int mib_tree_lower_bound(const MIBTree *mib_tree, const unsigned char *oid, int oid_len) {
+    int low = 0;
+    int high = mib_tree->sorted_count;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (compare_node_oid(mib_tree->nodes[mid], oid, oid_len) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Function to find the index of the first node after oid (node_count if none)
+int mib_tree_next_index(const MIBTree *mib_tree, const char *oid) {
+    unsigned char key[MIB_OID_BER_MAX + 1];
+    int key_len = encode_oid_key(oid, key, sizeof(key));
+    int index = mib_tree_lower_bound(mib_tree, key, key_len);
+
+    if (index < mib_tree->sorted_count && compare_node_oid(mib_tree->nodes[index], key, key_len) == 0) {
+        index++;
+    }
+    return index;
+}
+
+// Function to insert a node keeping the registry sorted by OID.
+// Returns -1 if the OID is already registered. During a bulk load nodes that
+// do not sort after the last one are appended and sorted by mib_tree_bulk_end().
+int mib_tree_insert(MIBTree *mib_tree, MIBNode *node) {
+    int index = mib_tree->node_count;
+
+    // 정렬 키: 이미지 로더는 인코딩된 OID를 미리 채워 둠
+    if (node->oid_ber_len == 0) {
+        node->oid_ber_len = encode_oid_key(node->oid, node->oid_ber, sizeof(node->oid_ber));
+    }
+
+    // MIB 이미지와 SMI 로더는 OID 순서로 등록하므로 끝에 추가하는 경우가 대부분
+    int in_order = (mib_tree->sorted_count == mib_tree->node_count) &&
+                   (index == 0 || compare_node_oid(mib_tree->nodes[index - 1], node->oid_ber, node->oid_ber_len) < 0);
+    if (!in_order && !mib_tree->bulk_loading) {
+        index = mib_tree_lower_bound(mib_tree, node->oid_ber, node->oid_ber_len);
+        if (index < mib_tree->node_count &&
+            compare_node_oid(mib_tree->nodes[index], node->oid_ber, node->oid_ber_len) == 0) {
+            printf("Error: OID %s already exists.\n", node->oid);
+            return -1;
+        }
+    }
+
+    if (mib_tree->node_count == mib_tree->node_capacity) {
+        int capacity = mib_tree->node_capacity ? mib_tree->node_capacity * 2 : MIB_TREE_INITIAL_CAPACITY;
+        MIBNode **nodes = (MIBNode **)realloc(mib_tree->nodes, capacity * sizeof(MIBNode *));
+        if (!nodes) {
+            printf("Error: Memory allocation failed.\n");
+            return -1;
+        }
+        mib_tree->nodes = nodes;
+        mib_tree->node_capacity = capacity;
+    }
+
+    memmove(&mib_tree->nodes[index + 1], &mib_tree->nodes[index],
+            (mib_tree->node_count - index) * sizeof(MIBNode *));
+    mib_tree->nodes[index] = node;
+    mib_tree->node_count++;
+    if (in_order || !mib_tree->bulk_loading) {
+        mib_tree->sorted_count++;
+    }
+    mib_tree->structure_epoch++;
+    mib_tree->node_epoch++;
     return 0;
 }
 
-// Function to find the next MIB entry
-int find_next_mib_entry(MIBTree *mib_tree, unsigned char *oid, int oid_len, MIBNode **nextEntry) {
-    char oid_str[64];
-    oid_to_string(oid, oid_len, oid_str);
+// Function to start a bulk load: out-of-order inserts become appends and
+// the registry is sorted once by mib_tree_bulk_end(). Until then lookups
+// only see the nodes that were already in order.
+void mib_tree_bulk_begin(MIBTree *mib_tree) {
+    mib_tree->bulk_loading = 1;
+}
+
+// Function to sort the nodes appended during a bulk load into the registry.
+// A node whose OID was appended twice is dropped (and freed unless preallocated).
+// Returns the number of dropped nodes.
+int mib_tree_bulk_end(MIBTree *mib_tree) {
+    int dropped = 0;
+
+    mib_tree->bulk_loading = 0;
+    if (mib_tree->sorted_count == mib_tree->node_count) {
+        return 0;
+    }
 
+    qsort(mib_tree->nodes, mib_tree->node_count, sizeof(MIBNode *), compare_registry_nodes);
+
+    int count = 0;
     for (int i = 0; i < mib_tree->node_count; i++) {
-        if (compare_oids(mib_tree->nodes[i]->oid, oid_str) > 0) {
-            *nextEntry = mib_tree->nodes[i];
-            return 1;
+        MIBNode *node = mib_tree->nodes[i];
+        if (count > 0 && compare_registry_nodes(&mib_tree->nodes[count - 1], &node) == 0) {
+            printf("Error: OID %s already exists.\n", node->oid);
+            if (!node->preallocated) {
+                free(node);
+            }
+            dropped++;
+            continue;
         }
+        mib_tree->nodes[count++] = node;
     }
-    *nextEntry = NULL;
-    return 0;
+
+    mib_tree->node_count = count;
+    mib_tree->sorted_count = count;
+    mib_tree->structure_epoch++;
+    mib_tree->node_epoch++;
+    return dropped;
 }
 
 // Function to convert string OID to binary
 int string_to_oid(const char *oid_str, unsigned char *oid_buf) {
     int oid_buf_len = 0;
-    unsigned int oid_parts[64];
+    unsigned int oid_parts[128];
     int oid_parts_count = 0;
 
-    char oid_copy[64];
+    char oid_copy[128];
     strncpy(oid_copy, oid_str, sizeof(oid_copy)-1);
     oid_copy[sizeof(oid_copy)-1] = '\0';
     
@@ -298,18 +454,96 @@ int string_to_oid(const char *oid_str, unsigned char *oid_buf) {
     return oid_buf_len;
 }
 
+// Function to map <prefix>1Min / 5Min / 15Min to the load average slot (-1 otherwise)
+static int load_average_index(const char *name, const char *prefix) {
+    static const char *suffixes[] = { "1Min", "5Min", "15Min" };
+    size_t len = strlen(prefix);
+
+    if (strncmp(name, prefix, len) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(name + len, suffixes[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Function to store a string value only if it differs from the current one
+static void write_string_if_changed(MIBNode *node, const char *str) {
+    MIBValue value;
+
+    if (str == NULL) {
+        return;
+    }
+
+    mib_node_read_value(node, &value);
+    if (strncmp(value.str_value, str, sizeof(value.str_value) - 1) == 0) {
+        return;
+    }
+
+    memset(&value, 0, sizeof(MIBValue));
+    strncpy(value.str_value, str, sizeof(value.str_value) - 1);
+    mib_node_write_value(node, &value);
+}
+
 // Function to update dynamic values
+// /proc/loadavg is read once per refresh and shared by the numeric (load x 100)
+// and the legacy string load average nodes.
 void update_dynamic_values(MIBTree *mib_tree) {
+    int load[3];
+    int have_load = (read_load_averages(&load[0], &load[1], &load[2]) == 0);
+
     for (int i = 0; i < mib_tree->node_count; i++) {
-        if (strcmp(mib_tree->nodes[i]->name, "sysUpTime") == 0) {
-            mib_tree->nodes[i]->value.ticks_value = get_system_uptime();
-        } else if (strcmp(mib_tree->nodes[i]->name, "dateTimeInfo") == 0) {
-            strncpy(mib_tree->nodes[i]->value.str_value, get_date(), sizeof(mib_tree->nodes[i]->value.str_value)-1);
-            mib_tree->nodes[i]->value.str_value[sizeof(mib_tree->nodes[i]->value.str_value)-1] = '\0';
-        } else if (strcmp(mib_tree->nodes[i]->name, "cpuUsage") == 0) {
-            mib_tree->nodes[i]->value.int_value = get_cpuUsage();
-        } else if (strcmp(mib_tree->nodes[i]->name, "memoryusage") == 0) {
-            mib_tree->nodes[i]->value.int_value = get_memory_usage();
+        MIBNode *node = mib_tree->nodes[i];
+        MIBValue value;
+        int load_index;
+
+        if (strcmp(node->name, "dateTimeInfo") == 0) {
+            strncpy(value.str_value, get_date(), sizeof(value.str_value)-1);
+            value.str_value[sizeof(value.str_value)-1] = '\0';
+        } else if (strcmp(node->name, "memoryusage") == 0) {
+            value.int_value = get_memory_usage();
+        } else if (have_load && (load_index = load_average_index(node->name, "cpuLoadInt")) >= 0) {
+            value.int_value = load[load_index];
+        } else if (have_load && (load_index = load_average_index(node->name, "cpuLoad")) >= 0) {
+            char load_str[16];
+            format_load_average(load[load_index], load_str, sizeof(load_str));
+            write_string_if_changed(node, load_str);
+            continue;
+        } else {
+            continue;
+        }
+
+        mib_node_write_value(node, &value);
+    }
+}
+
+// Function to refresh device status nodes (storage hot-plug)
+void update_status_values(MIBTree *mib_tree) {
+    for (int i = 0; i < mib_tree->node_count; i++) {
+        MIBNode *node = mib_tree->nodes[i];
+
+        if (strcmp(node->name, "sdCardStatus") == 0) {
+            write_string_if_changed(node, check_sdcard_installed());
+        } else if (strcmp(node->name, "flashStatus") == 0) {
+            write_string_if_changed(node, check_flash_memory_installed());
+        }
+    }
+}
+
+// Function to refresh network nodes (address / route changes)
+void update_network_values(MIBTree *mib_tree) {
+    for (int i = 0; i < mib_tree->node_count; i++) {
+        MIBNode *node = mib_tree->nodes[i];
+
+        if (strcmp(node->name, "ipAddressInfo") == 0) {
+            write_string_if_changed(node, get_current_ip());
+        } else if (strcmp(node->name, "subnetMask") == 0) {
+            write_string_if_changed(node, get_current_netmask());
+        } else if (strcmp(node->name, "gateway") == 0) {
+            write_string_if_changed(node, get_current_gateway());
         }
     }
 }
@@ -330,29 +564,104 @@ int update_mib_node_value(MIBTree *mib_tree, const char *name, const void *value
         return -1;
     }
 
+    if (!value) {
+        return -1;
+    }
+
+    MIBValue new_value;
+    memset(&new_value, 0, sizeof(MIBValue));
+
     if (node->value_type == VALUE_TYPE_INT) {
-        node->value.int_value = *(int *)value;
+        new_value.int_value = *(int *)value;
     } else if (node->value_type == VALUE_TYPE_STRING) {
-        strncpy(node->value.str_value, (const char *)value, sizeof(node->value.str_value) - 1);
-        node->value.str_value[sizeof(node->value.str_value) - 1] = '\0';
+        strncpy(new_value.str_value, (const char *)value, sizeof(new_value.str_value) - 1);
     } else if (node->value_type == VALUE_TYPE_TIME_TICKS) {
-        node->value.ticks_value = *(unsigned long *)value;
+        new_value.ticks_value = *(unsigned long *)value;
+    } else if (node->value_type == VALUE_TYPE_COUNTER32 || node->value_type == VALUE_TYPE_GAUGE32) {
+        new_value.uint_value = *(unsigned int *)value;
+    } else if (node->value_type == VALUE_TYPE_COUNTER64) {
+        new_value.counter64_value = *(unsigned long long *)value;
     } else {
         printf("Error: Unsupported value type for node %s.\n", name);
         return -1;
     }
 
+    mib_node_write_value(node, &new_value);
+
     return 0;
 }
 
+// Function to find a MIB node by its OID string
+MIBNode *find_mib_node_by_oid(MIBTree *mib_tree, const char *oid) {
+    unsigned char key[MIB_OID_BER_MAX + 1];
+    int key_len = encode_oid_key(oid, key, sizeof(key));
+    int index = mib_tree_lower_bound(mib_tree, key, key_len);
+
+    if (index < mib_tree->sorted_count && compare_node_oid(mib_tree->nodes[index], key, key_len) == 0) {
+        return mib_tree->nodes[index];
+    }
+    return NULL;
+}
+
+// Seqlock reader: copies the value, retrying if a writer was active meanwhile.
+// Readers never block the writer and never see a half-written value.
+void mib_node_read_value(const MIBNode *node, MIBValue *value) {
+    unsigned int seq;
+
+    if (node->read_handler) {
+        node->read_handler(node, value);
+        return;
+    }
+
+    do {
+        while ((seq = __atomic_load_n(&node->value_seq, __ATOMIC_ACQUIRE)) & 1) {
+            // 쓰기 진행 중
+        }
+        memcpy(value, &node->value, sizeof(MIBValue));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&node->value_seq, __ATOMIC_RELAXED) != seq);
+}
+
+// Seqlock writer: the counter is odd while the value is being replaced
+void mib_node_write_value(MIBNode *node, const MIBValue *value) {
+    __atomic_add_fetch(&node->value_seq, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&node->value, value, sizeof(MIBValue));
+    __atomic_add_fetch(&node->value_seq, 1, __ATOMIC_RELEASE);
+}
+
+// Function to copy a node with a consistent value for encoding
+void mib_node_snapshot(const MIBNode *node, MIBNode *snapshot) {
+    memcpy(snapshot, node, sizeof(MIBNode));
+    mib_node_read_value(node, &snapshot->value);
+}
+
+// Function to attach a SET callback to a node
+int register_write_handler(MIBTree *mib_tree, const char *name, MIBWriteHandler handler) {
+    for (int i = 0; i < mib_tree->node_count; i++) {
+        if (strcmp(mib_tree->nodes[i]->name, name) == 0) {
+            mib_tree->nodes[i]->write_handler = handler;
+            return 0;
+        }
+    }
+
+    printf("Error: Node %s not found.\n", name);
+    return -1;
+}
+
 // Function to free MIB nodes
 void free_mib_nodes(MIBTree *mib_tree) {
     for (int i = 0; i < mib_tree->node_count; i++) {
+        if (mib_tree->nodes[i]->preallocated) {
+            continue;
+        }
         free(mib_tree->nodes[i]->child); // 자식 노드 해제
         free(mib_tree->nodes[i]);
     }
+    free(mib_tree->nodes);
+    mib_tree->nodes = NULL;
     mib_tree->node_count = 0;
+    mib_tree->sorted_count = 0;
+    mib_tree->node_capacity = 0;
     mib_tree->root = NULL;
-
-    printf("\n\n\nfree_mib_nodes\n\n\n");
 }
@@ -0,0 +1,415 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "snmp_mib.h"        // MIB tree structures and functions
+#include "snmp_smi.h"        // SMIv2 module parser
+#include "snmp_mib_image.h"  // Precompiled MIB image
+
+#define IMAGE_CHECKSUM_SEED 2166136261u   // FNV-1a offset basis
+
+static uint32_t image_checksum(uint32_t hash, const unsigned char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// --- 컴파일러 측 ---
+
+// Growable data area
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} ImageData;
+
+static int data_append(ImageData *data, const void *bytes, size_t len, uint32_t *offset) {
+    if (data->size + len > data->capacity) {
+        size_t capacity = data->capacity ? data->capacity : 4096;
+        while (capacity < data->size + len) {
+            capacity *= 2;
+        }
+        unsigned char *grown = (unsigned char *)realloc(data->data, capacity);
+        if (!grown) {
+            printf("Error: Memory allocation failed.\n");
+            return -1;
+        }
+        data->data = grown;
+        data->capacity = capacity;
+    }
+
+    *offset = (uint32_t)data->size;
+    memcpy(data->data + data->size, bytes, len);
+    data->size += len;
+    return 0;
+}
+
+static int data_append_string(ImageData *data, const char *str, uint32_t *offset) {
+    if (str[0] == '\0') {
+        *offset = 0;
+        return 0;
+    }
+    return data_append(data, str, strlen(str) + 1, offset);
+}
+
+// Function to compile the scalars of a parsed SMI tree into an image file.
+// The file is written next to the target and renamed, so a running agent
+// keeps its mapping of the previous image.
+int mib_image_write(SMITree *tree, const char *path) {
+    SMIObject **objects;
+    ImageData data = { NULL, 0, 0 };
+    uint32_t offset;
+    int result = -1;
+
+    int count = smi_collect_scalars(tree, &objects);
+    if (count < 0) {
+        return -1;
+    }
+
+    MIBImageRecord *records = (MIBImageRecord *)calloc(count + 1, sizeof(MIBImageRecord));
+    MIBImageSource *sources = (MIBImageSource *)calloc(tree->module_count + 1, sizeof(MIBImageSource));
+    if (!records || !sources || data_append(&data, "", 1, &offset) < 0) {
+        printf("Error: Memory allocation failed.\n");
+        goto out;
+    }
+
+    for (int i = 0; i < count; i++) {
+        SMIObject *object = objects[i];
+        MIBImageRecord *record = &records[i];
+        char oid_str[sizeof(((MIBNode *)0)->oid)];
+        unsigned char oid[sizeof(((MIBNode *)0)->oid)];
+        MIBValue value;
+
+        // 에이전트의 MIBNode에 들어가지 않는 OID는 이미지에 넣을 수 없음
+        if (smi_oid_to_string(object, oid_str, sizeof(oid_str)) < 0) {
+            printf("Error: OID of %s is longer than %d characters.\n", object->name, (int)sizeof(oid_str) - 1);
+            goto out;
+        }
+        int oid_len = string_to_oid(oid_str, oid);
+        ValueType value_type = mib_value_type(smi_value_type_name(object));
+        int has_default = smi_default_value(tree, object, &value);
+
+        record->value_type = (uint8_t)value_type;
+        record->access = (object->access == SMI_ACCESS_READ_WRITE || object->access == SMI_ACCESS_READ_CREATE)
+                         ? HANDLER_CAN_RWRITE : HANDLER_CAN_RONLY;
+        record->oid_len = (uint16_t)oid_len;
+        record->has_range = (uint8_t)object->has_range;
+        record->range_min = object->range_min;
+        record->range_max = object->range_max;
+
+        if (data_append_string(&data, object->name, &record->name) < 0 ||
+            data_append_string(&data, oid_str, &record->oid_str) < 0 ||
+            data_append(&data, oid, oid_len, &record->oid) < 0 ||
+            data_append_string(&data, smi_value_type_name(object), &record->type) < 0) {
+            goto out;
+        }
+
+        if (has_default && value_type == VALUE_TYPE_INT) {
+            record->default_int = value.int_value;
+        } else if (has_default && value_type == VALUE_TYPE_TIME_TICKS) {
+            record->default_int = (int32_t)value.ticks_value;
+        } else if (has_default && (value_type == VALUE_TYPE_COUNTER32 || value_type == VALUE_TYPE_GAUGE32 ||
+                                   value_type == VALUE_TYPE_COUNTER64)) {
+            record->default_int = (int32_t)(value_type == VALUE_TYPE_COUNTER64 ? value.counter64_value
+                                                                               : value.uint_value);
+        } else if (has_default &&
+                   data_append_string(&data, value_type == VALUE_TYPE_OID ? value.oid_value : value.str_value,
+                                      &record->default_str) < 0) {
+            goto out;
+        }
+    }
+
+    // 에이전트가 오래된 이미지를 알아볼 수 있도록 원본 모듈 파일 정보를 기록
+    for (int i = 0; i < tree->module_count; i++) {
+        strncpy(sources[i].module, tree->modules[i], sizeof(sources[i].module) - 1);
+        sources[i].mtime = tree->sources[i].mtime;
+        sources[i].size = tree->sources[i].size;
+        sources[i].hash = tree->sources[i].hash;
+        sources[i].requested = (uint8_t)tree->sources[i].requested;
+    }
+
+    MIBImageHeader header;
+    memset(&header, 0, sizeof(MIBImageHeader));
+    memcpy(header.magic, MIB_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = MIB_IMAGE_VERSION;
+    header.byte_order = MIB_IMAGE_BYTE_ORDER;
+    header.record_count = count;
+    header.record_offset = sizeof(MIBImageHeader);
+    header.source_count = tree->module_count;
+    header.source_offset = header.record_offset + count * sizeof(MIBImageRecord);
+    header.data_offset = header.source_offset + tree->module_count * sizeof(MIBImageSource);
+    header.data_size = data.size;
+    header.image_size = header.data_offset + data.size;
+
+    // 체크섬은 레코드, 원본 모듈과 데이터 영역에 대해 계산
+    uint32_t checksum = image_checksum(IMAGE_CHECKSUM_SEED, (const unsigned char *)records,
+                                       count * sizeof(MIBImageRecord));
+    checksum = image_checksum(checksum, (const unsigned char *)sources, tree->module_count * sizeof(MIBImageSource));
+    header.checksum = image_checksum(checksum, data.data, data.size);
+
+    char tmp_path[256];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (!file) {
+        perror(tmp_path);
+        goto out;
+    }
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        (count > 0 && fwrite(records, sizeof(MIBImageRecord), count, file) != (size_t)count) ||
+        (tree->module_count > 0 &&
+         fwrite(sources, sizeof(MIBImageSource), tree->module_count, file) != (size_t)tree->module_count) ||
+        fwrite(data.data, 1, data.size, file) != data.size) {
+        perror(tmp_path);
+        fclose(file);
+        unlink(tmp_path);
+        goto out;
+    }
+    if (fclose(file) != 0 || rename(tmp_path, path) < 0) {
+        perror(path);
+        unlink(tmp_path);
+        goto out;
+    }
+
+    printf("Wrote %s: %d objects, %u bytes\n", path, count, header.image_size);
+    result = count;
+
+out:
+    free(objects);
+    free(records);
+    free(sources);
+    free(data.data);
+    return result;
+}
+
+// --- 에이전트 측 ---
+
+// Function to get a NUL terminated string from the data area (NULL if out of bounds)
+static const char *image_string(const MIBImage *image, uint32_t offset) {
+    uint32_t size = image->header->data_size;
+
+    if (offset >= size || memchr(image->data + offset, '\0', size - offset) == NULL) {
+        return NULL;
+    }
+    return image->data + offset;
+}
+
+static int validate_header(const MIBImage *image) {
+    const MIBImageHeader *header = image->header;
+
+    if (image->size < sizeof(MIBImageHeader) || memcmp(header->magic, MIB_IMAGE_MAGIC, sizeof(header->magic)) != 0) {
+        printf("Error: Not a MIB image\n");
+        return -1;
+    }
+    if (header->version != MIB_IMAGE_VERSION || header->byte_order != MIB_IMAGE_BYTE_ORDER) {
+        printf("Error: Unsupported MIB image version %u\n", header->version);
+        return -1;
+    }
+    if (header->image_size != image->size || header->record_offset != sizeof(MIBImageHeader) ||
+        header->source_offset != header->record_offset + (uint64_t)header->record_count * sizeof(MIBImageRecord) ||
+        header->data_offset != header->source_offset + (uint64_t)header->source_count * sizeof(MIBImageSource) ||
+        (uint64_t)header->data_offset + header->data_size != image->size || header->data_size == 0) {
+        printf("Error: Truncated or corrupt MIB image\n");
+        return -1;
+    }
+    if (image_checksum(IMAGE_CHECKSUM_SEED, (const unsigned char *)image->map + sizeof(MIBImageHeader),
+                       image->size - sizeof(MIBImageHeader)) != header->checksum) {
+        printf("Error: MIB image checksum mismatch\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int image_has_module(const MIBImage *image, const char *module) {
+    for (uint32_t i = 0; i < image->header->source_count; i++) {
+        const MIBImageSource *source = &image->sources[i];
+        if (source->requested && strncmp(source->module, module, sizeof(source->module)) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int config_has_module(const SNMPMibConfig *mib, const MIBImageSource *source) {
+    for (int i = 0; i < mib->module_count; i++) {
+        if (strncmp(mib->modules[i], source->module, sizeof(source->module)) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Function to check that the image was compiled from the configured modules
+// and that none of their files (found in the agent's MIB directories) changed
+// since. Sources that are not installed on the device are not checked.
+static int check_sources(const MIBImage *image, const SNMPMibConfig *mib, SMITree *smi_tree) {
+    char path[256];
+    struct stat st;
+    unsigned int hash;
+
+    for (int i = 0; i < mib->module_count; i++) {
+        if (!image_has_module(image, mib->modules[i])) {
+            printf("Warning: MIB image %s does not contain mib_module %s, parsing modules\n",
+                   mib->image_path, mib->modules[i]);
+            return -1;
+        }
+    }
+
+    for (uint32_t i = 0; i < image->header->source_count; i++) {
+        const MIBImageSource *source = &image->sources[i];
+        char module[SMI_MAX_NAME];
+
+        memcpy(module, source->module, sizeof(module));
+        module[sizeof(module) - 1] = '\0';
+
+        if (source->requested && !config_has_module(mib, source)) {
+            printf("Warning: MIB image %s was compiled with %s, which is not a mib_module, parsing modules\n",
+                   mib->image_path, module);
+            return -1;
+        }
+        if (source->mtime < 0 || smi_find_module_file(smi_tree, module, path, sizeof(path)) < 0 ||
+            stat(path, &st) < 0) {
+            continue;
+        }
+        if ((int64_t)st.st_mtime == source->mtime && (int64_t)st.st_size == source->size) {
+            continue;
+        }
+        if ((int64_t)st.st_size != source->size || smi_hash_file(path, &hash) < 0 || hash != source->hash) {
+            printf("Warning: MIB image %s is older than %s, parsing modules (run make mib)\n",
+                   mib->image_path, path);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Function to map an image and register its nodes. The image is not used
+// (returns -1) if it is stale against the configured modules. Nodes come from
+// a single allocation and arrive in OID order; the registry is sorted once at
+// the end in case they interleave with nodes the agent registered itself.
+int mib_image_load(MIBImage *image, const SNMPMibConfig *mib, SMITree *smi_tree, MIBTree *mib_tree) {
+    const char *path = mib->image_path;
+    struct stat st;
+
+    memset(image, 0, sizeof(MIBImage));
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno != ENOENT) {
+            perror(path);
+        }
+        return -1;
+    }
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(MIBImageHeader)) {
+        printf("Error: Truncated or corrupt MIB image\n");
+        close(fd);
+        return -1;
+    }
+
+    image->size = st.st_size;
+    image->map = mmap(NULL, image->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image->map == MAP_FAILED) {
+        perror("mmap");
+        image->map = NULL;
+        return -1;
+    }
+
+    image->header = (const MIBImageHeader *)image->map;
+    if (validate_header(image) < 0) {
+        mib_image_close(image);
+        return -1;
+    }
+    image->records = (const MIBImageRecord *)((const char *)image->map + image->header->record_offset);
+    image->sources = (const MIBImageSource *)((const char *)image->map + image->header->source_offset);
+    image->data = (const char *)image->map + image->header->data_offset;
+
+    if (check_sources(image, mib, smi_tree) < 0) {
+        mib_image_close(image);
+        return -1;
+    }
+
+    int count = image->header->record_count;
+
+    image->nodes = (MIBNode *)calloc(count + 1, sizeof(MIBNode));
+    if (!image->nodes) {
+        printf("Error: Memory allocation failed.\n");
+        mib_image_close(image);
+        return -1;
+    }
+
+    mib_tree_bulk_begin(mib_tree);
+    for (int i = 0; i < count; i++) {
+        const MIBImageRecord *record = &image->records[i];
+        const char *name = image_string(image, record->name);
+        const char *oid = image_string(image, record->oid_str);
+        const char *type = image_string(image, record->type);
+        const char *default_str = image_string(image, record->default_str);
+        MIBNode *node = &image->nodes[image->node_count];
+
+        if (!name || !oid || !type || !default_str || record->value_type > VALUE_TYPE_OCTETS) {
+            printf("Error: Corrupt MIB image record %d\n", i);
+            continue;
+        }
+
+        // 이미 등록된 노드 (sys* 등)는 유지
+        if (find_mib_node_by_oid(mib_tree, oid)) {
+            continue;
+        }
+
+        strncpy(node->name, name, sizeof(node->name) - 1);
+        strncpy(node->oid, oid, sizeof(node->oid) - 1);
+
+        // mibc가 인코딩한 OID를 정렬 키로 그대로 사용
+        if (record->oid_len <= MIB_OID_BER_MAX &&
+            (uint64_t)record->oid + record->oid_len <= image->header->data_size) {
+            memcpy(node->oid_ber, image->data + record->oid, record->oid_len);
+            node->oid_ber_len = record->oid_len;
+        }
+        strncpy(node->type, type, sizeof(node->type) - 1);
+        strcpy(node->status, "current");
+        node->isWritable = record->access;
+        node->value_type = (ValueType)record->value_type;
+        node->has_range = record->has_range;
+        node->range_min = record->range_min;
+        node->range_max = record->range_max;
+        node->preallocated = 1;
+
+        if (node->value_type == VALUE_TYPE_INT) {
+            node->value.int_value = record->default_int;
+        } else if (node->value_type == VALUE_TYPE_TIME_TICKS) {
+            node->value.ticks_value = (uint32_t)record->default_int;
+        } else if (node->value_type == VALUE_TYPE_COUNTER32 || node->value_type == VALUE_TYPE_GAUGE32) {
+            node->value.uint_value = (uint32_t)record->default_int;
+        } else if (node->value_type == VALUE_TYPE_COUNTER64) {
+            node->value.counter64_value = (uint32_t)record->default_int;
+        } else if (node->value_type == VALUE_TYPE_OID) {
+            strncpy(node->value.oid_value, default_str, sizeof(node->value.oid_value) - 1);
+        } else {
+            strncpy(node->value.str_value, default_str, sizeof(node->value.str_value) - 1);
+        }
+
+        if (mib_tree_insert(mib_tree, node) == 0) {
+            image->node_count++;
+        }
+    }
+    image->node_count -= mib_tree_bulk_end(mib_tree);
+
+    return image->node_count;
+}
+
+// Function to unmap the image; call after free_mib_nodes()
+void mib_image_close(MIBImage *image) {
+    if (image->map) {
+        munmap(image->map, image->size);
+    }
+    free(image->nodes);
+    memset(image, 0, sizeof(MIBImage));
+}
@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/inotify.h>
+#include <sys/timerfd.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include "snmp_mib.h"     // MIB tree structures and functions
+#include "snmp_event.h"   // poll() event loop
+#include "snmp_trap.h"    // Notification triggers
+#include "snmp_monitor.h" // Event driven collectors
+
+// inotify: /dev 아래 mmcblk 장치 생성/삭제
+static void inotify_handler(int fd, short revents, void *ctx) {
+    SNMPMonitor *monitor = (SNMPMonitor *)ctx;
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int storage_changed = 0;
+
+    (void)revents;
+
+    ssize_t len;
+    while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+        for (char *p = buffer; p < buffer + len; ) {
+            struct inotify_event *event = (struct inotify_event *)p;
+            if (event->len > 0 && strncmp(event->name, "mmcblk", 6) == 0) {
+                storage_changed = 1;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    if (storage_changed) {
+        monitor->storage_events++;
+        update_status_values(monitor->mib_tree);
+        hrmib_refresh(&monitor->hrmib);
+        notifier_check_triggers(monitor->notifier);
+    }
+}
+
+// netlink: IPv4 주소/경로, 링크 상태 변경
+static void netlink_handler(int fd, short revents, void *ctx) {
+    SNMPMonitor *monitor = (SNMPMonitor *)ctx;
+    char buffer[8192] __attribute__((aligned(__alignof__(struct nlmsghdr))));
+    int network_changed = 0;
+    int link_changed = 0;
+
+    (void)revents;
+
+    ssize_t len;
+    while ((len = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+        for (struct nlmsghdr *nh = (struct nlmsghdr *)buffer; NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+            switch (nh->nlmsg_type) {
+                case RTM_NEWADDR:
+                case RTM_DELADDR:
+                case RTM_NEWROUTE:
+                case RTM_DELROUTE:
+                    network_changed = 1;
+                    break;
+                case RTM_NEWLINK:
+                case RTM_DELLINK:
+                    link_changed = 1;
+                    break;
+            }
+        }
+    }
+
+    if (link_changed) {
+        monitor->link_events++;
+        ifmib_refresh(&monitor->ifmib);
+    }
+
+    if (network_changed) {
+        monitor->network_events++;
+        update_network_values(monitor->mib_tree);
+        notifier_check_triggers(monitor->notifier);
+    }
+}
+
+// timerfd: 주기적인 지표 갱신
+static void timer_handler(int fd, short revents, void *ctx) {
+    SNMPMonitor *monitor = (SNMPMonitor *)ctx;
+    uint64_t expirations;
+
+    (void)revents;
+
+    if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return;
+    }
+
+    update_dynamic_values(monitor->mib_tree);
+    ifmib_refresh(&monitor->ifmib);
+    hrmib_refresh(&monitor->hrmib);
+
+    // 이벤트를 받을 수 없는 경우에만 주기적으로 다시 확인
+    if (monitor->inotify_fd < 0) {
+        update_status_values(monitor->mib_tree);
+    }
+    if (monitor->netlink_fd < 0) {
+        update_network_values(monitor->mib_tree);
+    }
+
+    notifier_check_triggers(monitor->notifier);
+}
+
+static int open_inotify(void) {
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        perror("inotify_init1");
+        return -1;
+    }
+
+    if (inotify_add_watch(fd, MONITOR_DEV_DIR, IN_CREATE | IN_DELETE) < 0) {
+        perror("inotify_add_watch");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int open_netlink(void) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        perror("netlink socket");
+        return -1;
+    }
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_IPV4_IFADDR | RTMGRP_IPV4_ROUTE | RTMGRP_LINK;
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("netlink bind");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int open_timer(int interval_ms) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        perror("timerfd_create");
+        return -1;
+    }
+
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = interval_ms / 1000;
+    spec.it_interval.tv_nsec = (interval_ms % 1000) * 1000000L;
+    spec.it_value = spec.it_interval;
+
+    if (timerfd_settime(fd, 0, &spec, NULL) < 0) {
+        perror("timerfd_settime");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Function to open the event sources and register them with the event loop.
+// A source that cannot be opened falls back to the periodic refresh.
+int monitor_init(SNMPMonitor *monitor, MIBTree *mib_tree, SNMPNotifier *notifier,
+                 EventLoop *loop, int interval_ms) {
+    memset(monitor, 0, sizeof(SNMPMonitor));
+    monitor->mib_tree = mib_tree;
+    monitor->notifier = notifier;
+
+    monitor->inotify_fd = open_inotify();
+    monitor->netlink_fd = open_netlink();
+    monitor->timer_fd = open_timer(interval_ms);
+
+    if (ifmib_init(&monitor->ifmib, mib_tree) < 0) {
+        printf("Error: IF-MIB interface snapshot unavailable.\n");
+    }
+    if (hrmib_init(&monitor->hrmib, mib_tree) < 0) {
+        printf("Error: HOST-RESOURCES-MIB tables unavailable.\n");
+    }
+    if (cpustat_init(&monitor->cpustat, mib_tree, loop) < 0) {
+        printf("Error: Per-core CPU sampler unavailable.\n");
+    }
+
+    if (monitor->inotify_fd >= 0) {
+        event_loop_add_fd(loop, monitor->inotify_fd, POLLIN, inotify_handler, monitor);
+    }
+    if (monitor->netlink_fd >= 0) {
+        event_loop_add_fd(loop, monitor->netlink_fd, POLLIN, netlink_handler, monitor);
+    }
+    if (monitor->timer_fd >= 0) {
+        event_loop_add_fd(loop, monitor->timer_fd, POLLIN, timer_handler, monitor);
+    }
+
+    // 초기 값을 트리거 기준값으로 사용
+    notifier_check_triggers(notifier);
+
+    return (monitor->timer_fd >= 0) ? 0 : -1;
+}
+
+void monitor_close(SNMPMonitor *monitor) {
+    if (monitor->inotify_fd >= 0) {
+        close(monitor->inotify_fd);
+    }
+    if (monitor->netlink_fd >= 0) {
+        close(monitor->netlink_fd);
+    }
+    if (monitor->timer_fd >= 0) {
+        close(monitor->timer_fd);
+    }
+    monitor->inotify_fd = monitor->netlink_fd = monitor->timer_fd = -1;
+    ifmib_close(&monitor->ifmib);
+    hrmib_close(&monitor->hrmib);
+    cpustat_close(&monitor->cpustat);
+}
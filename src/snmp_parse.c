@@ -1,44 +1,61 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <limits.h>
 
 #include "snmp_parse.h"
 #include "snmp.h"
 #include "snmp_mib.h"
 #include "utility.h"
+#include "snmp_log.h"
 
-// Function to read length field in ASN.1 BER format
-int read_length(unsigned char *buffer, int *index) {
-    int len = 0;
-    unsigned char len_byte = buffer[*index];
-    (*index)++;
-    if (len_byte & 0x80) {
-        int num_len_bytes = len_byte & 0x7F;
-        len = 0;
-        for (int i = 0; i < num_len_bytes; i++) {
-            len = (len << 8) | buffer[*index];
-            (*index)++;
+// Function to read length field in ASN.1 BER format, returns -1 if the
+// field has more than 4 length bytes or the contents run past end
+int read_length(const unsigned char *buffer, int end, int *index) {
+    int i = *index;
+
+    if (i >= end) {
+        return -1;
+    }
+
+    int len = buffer[i++];
+    if (len & 0x80) {
+        int num_len_bytes = len & 0x7F;
+        if (num_len_bytes < 1 || num_len_bytes > 4 || num_len_bytes > end - i) {
+            return -1;
         }
-    } else {
-        len = len_byte;
+        unsigned int value = 0;
+        while (num_len_bytes-- > 0) {
+            value = (value << 8) | buffer[i++];
+        }
+        if (value > INT_MAX) {
+            return -1;
+        }
+        len = (int)value;
+    }
+    if (len > end - i) {
+        return -1;
     }
+
+    *index = i;
     return len;
 }
 
 // Function to read integer value in ASN.1 BER format
-int read_integer(unsigned char *buffer, int *index, int len) {
-    int value = 0;
+int read_integer(const unsigned char *buffer, int *index, int len) {
+    unsigned int value = (len > 0 && (buffer[*index] & 0x80)) ? 0xFFFFFFFF : 0;  // 음수는 부호 확장
     for (int i = 0; i < len; i++) {
         value = (value << 8) | buffer[*index];
         (*index)++;
     }
-    return value;
+    return (int)value;
 }
 
 // Function to encode length field in ASN.1 BER format
 int write_length(unsigned char *buffer, int len) {
     if (len < 0) {
-        printf("len < 0\n");
+        log_error("len < 0");
         return -1; // Return error for invalid length
     }
     if (len < 128) {
@@ -98,18 +115,16 @@ int encode_integer(long value, unsigned char *buffer) {
     int buf_len = 0;
     unsigned long val = (unsigned long)value;
 
-    // Determine the number of bytes needed
-    int num_bytes = 0;
-    unsigned long temp = val;
-    do {
-        temp >>= 8;
-        num_bytes++;
-    } while (temp > 0);
-
-    // If the most significant bit is 1, prepend a zero byte
-    if ((val >> ((num_bytes - 1) * 8)) & 0x80) {
-        buffer[buf_len++] = 0x00;
-        num_bytes++;
+    // 2의 보수 최소 길이: 다음 바이트의 부호 비트와 같은 선행 0x00/0xFF 바이트는 생략
+    int num_bytes = sizeof(long);
+    while (num_bytes > 1) {
+        unsigned int top = (val >> ((num_bytes - 1) * 8)) & 0xFF;
+        unsigned int next_sign = (val >> ((num_bytes - 2) * 8)) & 0x80;
+        if ((top == 0x00 && next_sign == 0) || (top == 0xFF && next_sign != 0)) {
+            num_bytes--;
+        } else {
+            break;
+        }
     }
 
     for (int i = num_bytes - 1; i >= 0; i--) {
@@ -119,6 +134,25 @@ int encode_integer(long value, unsigned char *buffer) {
     return buf_len;
 }
 
+// Function to encode an unsigned value (Counter32, Gauge32, TimeTicks, Counter64)
+int encode_unsigned(unsigned long long value, unsigned char *buffer) {
+    int num_bytes = 1;
+    int buf_len = 0;
+
+    while (num_bytes < 8 && (value >> (num_bytes * 8)) != 0) {
+        num_bytes++;
+    }
+
+    // 최상위 비트가 1이면 양수임을 나타내는 0x00을 앞에 추가
+    if ((value >> ((num_bytes - 1) * 8)) & 0x80) {
+        buffer[buf_len++] = 0x00;
+    }
+    for (int i = num_bytes - 1; i >= 0; i--) {
+        buffer[buf_len++] = (value >> (i * 8)) & 0xFF;
+    }
+    return buf_len;
+}
+
 int encode_oid(const oid *oid_numbers, int oid_len, unsigned char *buffer) {
     int buf_len = 0;
 
@@ -166,264 +200,378 @@ int oid_compare(const unsigned char *oid1, int oid1_len, const unsigned char *oi
     return 0;
 }
 
-void parse_tlv(unsigned char *buffer, int *index, int length, SNMPPacket *snmp_packet) {
-    while (*index < length) {
-        unsigned char type = buffer[*index];
-        (*index)++;
-        int len = read_length(buffer, index);
-        int value_start = *index;
-
-        if (type == TYPE_SEQUENCE || (type >= 0xA0 && type <= 0xA5)) {  // SEQUENCE or PDU
-            if (type >= 0xA0 && type <= 0xA5) {
-                snmp_packet->pdu_type = type;  // PDU type 저장
-            }
-            int new_index = *index;
-            parse_tlv(buffer, &new_index, value_start + len, snmp_packet);  // 내부 SEQUENCE 파싱
-            *index = value_start + len;  // 인덱스 업데이트
-        } else if (type == TYPE_INTEGER) {  // INTEGER 처리
-            if (snmp_packet->version == -1) {
-                snmp_packet->version = buffer[*index];  // SNMP 버전 저장
-            } else if (snmp_packet->pdu_type == 0xA5) {  // GET-BULK PDU
-                if (snmp_packet->request_id == 0) {
-                    snmp_packet->request_id = (buffer[*index] << 24) | (buffer[*index + 1] << 16) | (buffer[*index + 2] << 8) | buffer[*index + 3];  // Request ID 저장
-                } else if (snmp_packet->max_repetitions == 0) {
-                    snmp_packet->max_repetitions = buffer[*index];  // non-repeaters 저장
-                } else if (snmp_packet->non_repeaters == 0) {
-                    snmp_packet->non_repeaters = buffer[*index];  // max-repetitions 저장
-                }
-            } else if (len == 4) {
-                snmp_packet->request_id = (buffer[*index] << 24) | (buffer[*index + 1] << 16) | (buffer[*index + 2] << 8) | buffer[*index + 3];  // Request ID 저장
-            } else if (len == 1 && snmp_packet->error_status == 0) {
-                snmp_packet->error_status = buffer[*index];  // Error Status
-            } else if (len == 1 && snmp_packet->error_index == 0) {
-                snmp_packet->error_index = buffer[*index];  // Error Index
-            }
-            *index += len;  // 인덱스 업데이트
-        } else if (type == TYPE_OCTET_STRING) {  // OCTET STRING 처리
-            if (snmp_packet->community[0] == '\0') {
-                memcpy(snmp_packet->community, &buffer[*index], len);  // 커뮤니티 이름 저장
-                snmp_packet->community[len] = '\0';  // NULL 종료
-            }
-            *index += len;  // 인덱스 업데이트
-        } else if (type == TYPE_OID) {  // OID 처리
-            memcpy(snmp_packet->oid, &buffer[*index], len);  // OID 저장
-            snmp_packet->oid_len = len;
-            *index += len;  // 인덱스 업데이트
-        } else {
-            *index += len;  // 알 수 없는 타입은 길이만큼 인덱스 업데이트
-        }
+// Function to read the message version right after the outer SEQUENCE
+int peek_snmp_version(unsigned char *buffer, int length) {
+    unsigned char tag;
+    int len;
+    int index = 0;
+
+    if (read_tlv(buffer, length, &index, &tag, &len) < 0 || tag != TYPE_SEQUENCE) {
+        return -1;
+    }
+
+    if (read_tlv(buffer, index + len, &index, &tag, &len) < 0 || tag != TYPE_INTEGER || len < 1 || len > 4) {
+        return -1;
     }
+
+    return read_integer(buffer, &index, len);
 }
 
-void parse_pdu(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet, unsigned char pdu_type) {
-    snmp_packet->pdu_type = pdu_type;  // PDU 타입 저장
+// Function to read one BER tag and length, leaves *index at the contents
+int read_tlv(const unsigned char *buffer, int end, int *index, unsigned char *tag, int *length) {
+    int i = *index;
 
-    int pdu_end = *index + length;  // PDU 종료 위치 계산
+    if (i >= end) {
+        return -1;
+    }
+    unsigned char type = buffer[i++];
 
-    // 1. request-id
-    if (*index >= pdu_end) {
-        printf("Index out of bounds while reading request-id\n");
-        return;
+    int len = read_length(buffer, end, &i);
+    if (len < 0) {
+        return -1;
     }
-    unsigned char type = buffer[*index];
-    if (type != TYPE_INTEGER) {
-        printf("Invalid request-id Type\n");
-        return;
+
+    *index = i;
+    *tag = type;
+    *length = len;
+    return 0;
+}
+
+// Function to skip one BER element with the expected tag
+int skip_tlv(const unsigned char *buffer, int end, int *index, unsigned char expected) {
+    unsigned char tag;
+    int length;
+
+    if (read_tlv(buffer, end, index, &tag, &length) < 0 || tag != expected) {
+        return -1;
     }
-    (*index)++;
-    int len = read_length(buffer, index);
-    if (*index + len > pdu_end) {
-        printf("Invalid length for request-id\n");
-        return;
+    *index += length;
+    return 0;
+}
+
+// Function to find the PDU of a v1/v2c/v3 message and the bytes after its request-id.
+// Encrypted (authPriv) scoped PDUs cannot be located.
+int locate_snmp_pdu(const unsigned char *message, int message_len, int *version, unsigned char *pdu_type,
+                    int *tail, int *tail_len) {
+    unsigned char tag;
+    int length;
+    int index = 0;
+
+    if (read_tlv(message, message_len, &index, &tag, &length) < 0 || tag != 0x30) {
+        return -1;
     }
-    snmp_packet->request_id = read_integer(buffer, index, len);  // request-id 읽기
+    int end = index + length;
 
-    // 2. error-status
-    if (*index >= pdu_end) {
-        printf("Index out of bounds while reading error-status\n");
-        return;
+    // msgVersion
+    if (read_tlv(message, end, &index, &tag, &length) < 0 || tag != 0x02 || length != 1) {
+        return -1;
     }
-    type = buffer[*index];
-    if (type != TYPE_INTEGER) {
-        printf("Invalid error-status Type\n");
-        return;
+    *version = message[index++];
+
+    if (*version == 3) {
+        // msgGlobalData, msgSecurityParameters, 평문 Scoped PDU
+        if (skip_tlv(message, end, &index, 0x30) < 0 || skip_tlv(message, end, &index, 0x04) < 0 ||
+            read_tlv(message, end, &index, &tag, &length) < 0 || tag != 0x30) {
+            return -1;
+        }
+        end = index + length;
+        if (skip_tlv(message, end, &index, 0x04) < 0 || skip_tlv(message, end, &index, 0x04) < 0) {
+            return -1;
+        }
+    } else if (skip_tlv(message, end, &index, 0x04) < 0) {    // community
+        return -1;
+    }
+
+    if (read_tlv(message, end, &index, pdu_type, &length) < 0) {
+        return -1;
     }
-    (*index)++;
-    len = read_length(buffer, index);
-    if (*index + len > pdu_end) {
-        printf("Invalid length for error-status\n");
-        return;
+    end = index + length;
+
+    // request-id
+    if (skip_tlv(message, end, &index, 0x02) < 0) {
+        return -1;
     }
-    snmp_packet->error_status = read_integer(buffer, index, len);  // error-status 읽기
 
-    // 3. error-index
-    if (*index >= pdu_end) {
-        printf("Index out of bounds while reading error-index\n");
-        return;
+    *tail = index;
+    *tail_len = end - index;
+    return 0;
+}
+
+// Function to read the tag and length of one field with the expected tag within end,
+// leaves *index at the contents
+static int parse_field_header(unsigned char *buffer, int *index, int end, unsigned char expected, int *len,
+                              const char *field) {
+    unsigned char type;
+
+    if (*index >= end) {
+        log_debug("Index out of bounds while reading %s", field);
+        return -1;
     }
-    type = buffer[*index];
-    if (type != TYPE_INTEGER) {
-        printf("Invalid error-index Type\n");
-        return;
+    if (buffer[*index] != expected) {
+        log_debug("Invalid %s Type", field);
+        return -1;
     }
-    (*index)++;
-    len = read_length(buffer, index);
-    if (*index + len > pdu_end) {
-        printf("Invalid length for error-index\n");
-        return;
+    if (read_tlv(buffer, end, index, &type, len) < 0) {
+        log_debug("Invalid length for %s", field);
+        return -1;
     }
-    snmp_packet->error_index = read_integer(buffer, index, len);  // error-index 읽기
+    return 0;
+}
 
-    // 4. variable-bindings
-    if (*index >= pdu_end) {
-        printf("Index out of bounds while reading variable-bindings\n");
-        return;
+// Function to read one INTEGER field of a PDU header
+static int parse_pdu_integer(unsigned char *buffer, int *index, int end, int *value, const char *field) {
+    int len;
+
+    if (parse_field_header(buffer, index, end, TYPE_INTEGER, &len, field) < 0) {
+        return -1;
     }
-    type = buffer[*index];
-    if (type != TYPE_SEQUENCE) {
-        printf("Invalid variable-bindings Type\n");
-        return;
+    if (len < 1 || len > 4) {
+        log_debug("Invalid length for %s", field);
+        return -1;
     }
-    (*index)++;
-    len = read_length(buffer, index);
-    if (*index + len > pdu_end) {
-        printf("Invalid length for variable-bindings\n");
-        return;
+    *value = read_integer(buffer, index, len);
+    return 0;
+}
+
+// Function to read one OCTET STRING field of at most max_len bytes within end,
+// leaves *index at the contents
+static int parse_octet_string(unsigned char *buffer, int *index, int end, int max_len, int *len,
+                              const char *field) {
+    if (parse_field_header(buffer, index, end, TYPE_OCTET_STRING, len, field) < 0) {
+        return -1;
     }
-    int varbind_list_end = *index + len;  // VarBindList 종료 위치
+    if (*len > max_len) {
+        log_debug("Invalid length for %s", field);
+        return -1;
+    }
+    return 0;
+}
+
+// Function to clear a packet before parsing into it. The VarBind list is
+// left alone except for the first entry, which the single-OID paths read
+// even when the list is empty.
+void snmp_packet_reset(SNMPPacket *packet) {
+    memset(packet, 0, offsetof(SNMPPacket, varbind_list) + sizeof(VarBind));
+}
+
+void snmpv3_packet_reset(SNMPv3Packet *packet) {
+    memset(packet, 0, offsetof(SNMPv3Packet, varbind_list) + sizeof(VarBind));
+}
 
-    snmp_packet->varbind_count = 0;  // VarBind 수 초기화
+// Function to parse the content of a VarBindList SEQUENCE
+int parse_varbind_list(unsigned char *buffer, int *index, int varbind_list_end,
+                       VarBind *varbind_list, int *varbind_count) {
+    unsigned char type;
+    int len;
+
+    *varbind_count = 0;  // VarBind 수 초기화
 
     // VarBindList 파싱
     while (*index < varbind_list_end) {
-        // VarBind SEQUENCE
-        if (*index >= varbind_list_end) {
-            printf("Index out of bounds while reading VarBind SEQUENCE\n");
-            return;
+        if (*varbind_count >= MAX_VARBINDS) {
+            log_debug("Too many VarBinds (max %d)", MAX_VARBINDS);
+            return -1;
         }
-        type = buffer[*index];
-        if (type != TYPE_SEQUENCE) {
-            printf("Invalid VarBind Type\n");
-            return;
+        VarBind *varbind = &varbind_list[*varbind_count];
+
+        // VarBind SEQUENCE
+        if (buffer[*index] != TYPE_SEQUENCE) {
+            log_debug("Invalid VarBind Type");
+            return -1;
         }
-        (*index)++;
-        len = read_length(buffer, index);
-        if (*index + len > varbind_list_end) {
-            printf("Invalid length for VarBind SEQUENCE\n");
-            return;
+        if (read_tlv(buffer, varbind_list_end, index, &type, &len) < 0) {
+            log_debug("Invalid length for VarBind SEQUENCE");
+            return -1;
         }
         int varbind_end = *index + len;  // VarBind 종료 위치
 
         // OID 파싱
         if (*index >= varbind_end) {
-            printf("Index out of bounds while reading OID\n");
-            return;
+            log_debug("Index out of bounds while reading OID");
+            return -1;
         }
-        type = buffer[*index];
-        if (type != TYPE_OID) {
-            printf("Invalid OID Type\n");
-            return;
+        if (buffer[*index] != TYPE_OID) {
+            log_debug("Invalid OID Type");
+            return -1;
         }
-        (*index)++;
-        len = read_length(buffer, index);
-        if (*index + len > varbind_end) {
-            printf("Invalid length for OID\n");
-            return;
+        if (read_tlv(buffer, varbind_end, index, &type, &len) < 0 || len <= 0 || len > VARBIND_OID_MAX) {
+            log_debug("Invalid length for OID");
+            return -1;
         }
-        memcpy(snmp_packet->varbind_list[snmp_packet->varbind_count].oid, &buffer[*index], len);
-        snmp_packet->varbind_list[snmp_packet->varbind_count].oid_len = len;
+        varbind->oid = &buffer[*index];  // 복사하지 않고 요청 버퍼를 가리킴
+        varbind->oid_len = len;
         (*index) += len;  // 인덱스 업데이트
 
         // Value 파싱
         if (*index >= varbind_end) {
-            printf("Index out of bounds while reading Value Type\n");
-            return;
+            log_debug("Index out of bounds while reading Value Type");
+            return -1;
         }
-        type = buffer[*index];
-        (*index)++;
-        len = read_length(buffer, index);
-        if (*index + len > varbind_end) {
-            printf("Invalid length for Value\n");
-            return;
+        if (read_tlv(buffer, varbind_end, index, &type, &len) < 0) {
+            log_debug("Invalid length for Value");
+            return -1;
         }
-        snmp_packet->varbind_list[snmp_packet->varbind_count].value_type = type;
-        memcpy(snmp_packet->varbind_list[snmp_packet->varbind_count].value, &buffer[*index], len);
-        snmp_packet->varbind_list[snmp_packet->varbind_count].value_len = len;
+        varbind->value_type = type;
+        varbind->value = &buffer[*index];
+        varbind->value_len = len;
         (*index) += len;  // 인덱스 업데이트
 
-        snmp_packet->varbind_count++;  // VarBind 수 증가
+        (*varbind_count)++;  // VarBind 수 증가
 
         if (*index != varbind_end) {
-            printf("VarBind SEQUENCE length mismatch\n");
-            return;
+            log_debug("VarBind SEQUENCE length mismatch");
+            return -1;
         }
     }
 
+    return 0;
+}
+
+// Function to parse request-id, error-status, error-index and the VarBindList of a PDU
+static int parse_pdu_fields(unsigned char *buffer, int *index, int pdu_end, unsigned int *request_id,
+                            int *error_status, int *error_index, VarBind *varbind_list, int *varbind_count) {
+    int value;
+
+    // 1. request-id
+    if (parse_pdu_integer(buffer, index, pdu_end, &value, "request-id") < 0) {
+        return -1;
+    }
+    *request_id = (unsigned int)value;
+
+    // 2. error-status (non-repeaters for GET-BULK)
+    if (parse_pdu_integer(buffer, index, pdu_end, error_status, "error-status") < 0) {
+        return -1;
+    }
+
+    // 3. error-index (max-repetitions for GET-BULK)
+    if (parse_pdu_integer(buffer, index, pdu_end, error_index, "error-index") < 0) {
+        return -1;
+    }
+
+    // 4. variable-bindings
+    if (*index >= pdu_end) {
+        log_debug("Index out of bounds while reading variable-bindings");
+        return -1;
+    }
+    if (buffer[*index] != TYPE_SEQUENCE) {
+        log_debug("Invalid variable-bindings Type");
+        return -1;
+    }
+    unsigned char type;
+    int len;
+    if (read_tlv(buffer, pdu_end, index, &type, &len) < 0) {
+        log_debug("Invalid length for variable-bindings");
+        return -1;
+    }
+
+    if (parse_varbind_list(buffer, index, *index + len, varbind_list, varbind_count) < 0) {
+        return -1;
+    }
+
     if (*index != pdu_end) {
-        printf("PDU length mismatch\n");
+        log_debug("PDU length mismatch");
     }
+    return 0;
+}
+
+int parse_pdu(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet, unsigned char pdu_type) {
+    snmp_packet->pdu_type = pdu_type;  // PDU 타입 저장
+
+    int pdu_end = *index + length;  // PDU 종료 위치 계산
+
+    return parse_pdu_fields(buffer, index, pdu_end, &snmp_packet->request_id,
+                            &snmp_packet->error_status, &snmp_packet->error_index,
+                            snmp_packet->varbind_list, &snmp_packet->varbind_count);
 }
 
-void parse_scoped_pdu(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet) {
+// Function to parse a complete SNMPv1/SNMPv2c message
+int parse_snmp_message(unsigned char *buffer, int *index, int length, SNMPPacket *snmp_packet) {
     unsigned char type;
     int len;
 
-    // ScopedPDU SEQUENCE
-    if (*index >= length) {
-        printf("Index out of bounds while reading ScopedPDU\n");
-        return;
+    // 1. Message SEQUENCE
+    if (*index >= length || buffer[*index] != TYPE_SEQUENCE) {
+        log_debug("Invalid SNMP Message Type");
+        return -1;
     }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_SEQUENCE) {
-        printf("Invalid ScopedPDU Type\n");
-        return;
+    if (read_tlv(buffer, length, index, &type, &len) < 0) {
+        log_debug("Invalid length for SNMP Message");
+        return -1;
     }
+    int msg_end = *index + len;
 
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for ScopedPDU\n");
-        return;
+    // 2. version
+    if (parse_pdu_integer(buffer, index, msg_end, &snmp_packet->version, "version") < 0) {
+        return -1;
     }
-    int seq_end = (*index) + len;
 
-    // 1. contextEngineID
-    if (*index >= seq_end) {
-        printf("Index out of bounds while reading contextEngineID\n");
-        return;
+    // 3. community
+    if (*index >= msg_end || buffer[*index] != TYPE_OCTET_STRING) {
+        log_debug("Invalid community Type");
+        return -1;
     }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_OCTET_STRING) {
-        printf("Invalid contextEngineID Type\n");
-        return;
+    if (read_tlv(buffer, msg_end, index, &type, &len) < 0 || len >= (int)sizeof(snmp_packet->community)) {
+        log_debug("Invalid length for community");
+        return -1;
+    }
+    memcpy(snmp_packet->community, &buffer[*index], len);  // 커뮤니티 이름 저장
+    snmp_packet->community[len] = '\0';  // NULL 종료
+    (*index) += len;
+
+    // 4. PDU
+    if (*index >= msg_end) {
+        log_debug("Index out of bounds while reading PDU");
+        return -1;
+    }
+    if (read_tlv(buffer, msg_end, index, &snmp_packet->pdu_type, &len) < 0) {
+        log_debug("Invalid length for PDU");
+        return -1;
+    }
+
+    int first, second;
+    if (parse_pdu_fields(buffer, index, *index + len, &snmp_packet->request_id, &first, &second,
+                         snmp_packet->varbind_list, &snmp_packet->varbind_count) < 0) {
+        return -1;
+    }
+
+    if (snmp_packet->pdu_type == 0xA5) {  // GET-BULK PDU
+        snmp_packet->non_repeaters = first;
+        snmp_packet->max_repetitions = second;
+    } else {
+        snmp_packet->error_status = first;
+        snmp_packet->error_index = second;
     }
 
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > seq_end) {
-        printf("Invalid length for contextEngineID\n");
-        return;
+    // 첫 번째 VarBind의 OID (단일 OID 처리 경로 호환)
+    if (snmp_packet->varbind_count > 0) {
+        snmp_packet->oid = snmp_packet->varbind_list[0].oid;
+        snmp_packet->oid_len = snmp_packet->varbind_list[0].oid_len;
+    }
+
+    return 0;
+}
+
+int parse_scoped_pdu(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet) {
+    unsigned char pdu_type;
+    int len;
+
+    // ScopedPDU SEQUENCE
+    if (parse_field_header(buffer, index, length, TYPE_SEQUENCE, &len, "ScopedPDU") < 0) {
+        return -1;
+    }
+    int seq_end = (*index) + len;
+
+    // 1. contextEngineID
+    if (parse_octet_string(buffer, index, seq_end, SNMP_ENGINE_ID_MAX, &len, "contextEngineID") < 0) {
+        return -1;
     }
     memcpy(snmp_packet->contextEngineID, &buffer[*index], len);
     snmp_packet->contextEngineID_len = len;
     (*index) += len;  // 인덱스 업데이트
 
     // 2. contextName
-    if (*index >= seq_end) {
-        printf("Index out of bounds while reading contextName\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_OCTET_STRING) {
-        printf("Invalid contextName Type\n");
-        return;
-    }
-
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > seq_end) {
-        printf("Invalid length for contextName\n");
-        return;
+    if (parse_octet_string(buffer, index, seq_end, SNMP_ADMIN_STRING_MAX, &len, "contextName") < 0) {
+        return -1;
     }
     memcpy(snmp_packet->contextName, &buffer[*index], len);
     snmp_packet->contextName[len] = '\0';  // NULL 종료
@@ -431,326 +579,172 @@ void parse_scoped_pdu(unsigned char *buffer, int *index, int length, SNMPv3Packe
 
     // data (PDU) 파싱
     if (*index >= seq_end) {
-        printf("Index out of bounds while reading data PDU\n");
-        return;
+        log_debug("Index out of bounds while reading data PDU");
+        return -1;
     }
-    unsigned char pdu_type = buffer[*index];
-    (*index)++;
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > seq_end) {
-        printf("Invalid length for data PDU\n");
-        return;
+    if (read_tlv(buffer, seq_end, index, &pdu_type, &len) < 0) {
+        log_debug("Invalid length for data PDU");
+        return -1;
     }
 
-    parse_pdu(buffer, index, len, snmp_packet, pdu_type);  // PDU 파싱
+    return parse_pdu(buffer, index, len, snmp_packet, pdu_type);  // PDU 파싱
 }
 
-void parse_usm_security_parameters(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet) {
-    unsigned char type;
+int parse_usm_security_parameters(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet) {
     int len;
 
     // USM SEQUENCE
-    if (*index >= length) {
-        printf("Index out of bounds while reading USM Sequence\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_SEQUENCE) {
-        printf("Invalid USM Sequence Type\n");
-        return;
-    }
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for USM Sequence\n");
-        return;
+    if (parse_field_header(buffer, index, length, TYPE_SEQUENCE, &len, "USM Sequence") < 0) {
+        return -1;
     }
     int seq_end = (*index) + len;
 
     // 1. msgAuthoritativeEngineID
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgAuthoritativeEngineID\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_OCTET_STRING) {
-        printf("Invalid msgAuthoritativeEngineID Type\n");
-        return;
-    }
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for msgAuthoritativeEngineID\n");
-        return;
+    if (parse_octet_string(buffer, index, seq_end, SNMP_ENGINE_ID_MAX, &len, "msgAuthoritativeEngineID") < 0) {
+        return -1;
     }
     memcpy(snmp_packet->msgAuthoritativeEngineID, &buffer[*index], len);
     snmp_packet->msgAuthoritativeEngineID_len = len;
     (*index) += len;  // 인덱스 업데이트
 
-    // 2. msgAuthoritativeEngineBoots
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgAuthoritativeEngineBoots\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_INTEGER) {
-        printf("Invalid msgAuthoritativeEngineBoots Type\n");
-        return;
-    }
-    len = read_length(buffer, index);
-    snmp_packet->msgAuthoritativeEngineBoots = read_integer(buffer, index, len);  // msgAuthoritativeEngineBoots 읽기
-
-    // 3. msgAuthoritativeEngineTime
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgAuthoritativeEngineTime\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_INTEGER) {
-        printf("Invalid msgAuthoritativeEngineTime Type\n");
-        return;
+    // 2. msgAuthoritativeEngineBoots, 3. msgAuthoritativeEngineTime (0..2147483647)
+    if (parse_pdu_integer(buffer, index, seq_end, &snmp_packet->msgAuthoritativeEngineBoots,
+                          "msgAuthoritativeEngineBoots") < 0 ||
+        parse_pdu_integer(buffer, index, seq_end, &snmp_packet->msgAuthoritativeEngineTime,
+                          "msgAuthoritativeEngineTime") < 0) {
+        return -1;
     }
-    len = read_length(buffer, index);
-    snmp_packet->msgAuthoritativeEngineTime = read_integer(buffer, index, len);  // msgAuthoritativeEngineTime 읽기
 
     // 4. msgUserName
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgUserName\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_OCTET_STRING) {
-        printf("Invalid msgUserName Type\n");
-        return;
-    }
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for msgUserName\n");
-        return;
+    if (parse_octet_string(buffer, index, seq_end, SNMP_ADMIN_STRING_MAX, &len, "msgUserName") < 0) {
+        return -1;
     }
     memcpy(snmp_packet->msgUserName, &buffer[*index], len);
     snmp_packet->msgUserName[len] = '\0';  // NULL 종료
     (*index) += len;  // 인덱스 업데이트
 
     // 5. msgAuthenticationParameters
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgAuthenticationParameters\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_OCTET_STRING) {
-        printf("Invalid msgAuthenticationParameters Type\n");
-        return;
-    }
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for msgAuthenticationParameters\n");
-        return;
+    if (parse_octet_string(buffer, index, seq_end, SNMP_USM_PARAMS_MAX, &len, "msgAuthenticationParameters") < 0) {
+        return -1;
     }
-    memcpy(snmp_packet->msgAuthenticationParameters, &buffer[*index], len);
+    snmp_packet->msgAuthenticationParameters = &buffer[*index];  // 응답에 그대로 되돌려 보냄
     snmp_packet->msgAuthenticationParameters_len = len;
     (*index) += len;  // 인덱스 업데이트
 
     // 6. msgPrivacyParameters
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgPrivacyParameters\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_OCTET_STRING) {
-        printf("Invalid msgPrivacyParameters Type\n");
-        return;
-    }
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for msgPrivacyParameters\n");
-        return;
+    if (parse_octet_string(buffer, index, seq_end, SNMP_USM_PARAMS_MAX, &len, "msgPrivacyParameters") < 0) {
+        return -1;
     }
-    memcpy(snmp_packet->msgPrivacyParameters, &buffer[*index], len);
+    snmp_packet->msgPrivacyParameters = &buffer[*index];
     snmp_packet->msgPrivacyParameters_len = len;
     (*index) += len;  // 인덱스 업데이트
+
+    return 0;
 }
 
-void parse_snmpv3_message(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet) {
+// Function to parse a complete SNMPv3 message, returns -1 if it is malformed.
+// Every field is read with read_tlv within its enclosing SEQUENCE or OCTET STRING,
+// integers are at most 4 bytes long.
+int parse_snmpv3_message(unsigned char *buffer, int *index, int length, SNMPv3Packet *snmp_packet) {
     unsigned char type;
     int len;
+    int value;
 
     // 1. SNMPv3Message (SEQUENCE)
-    if (*index >= length) {
-        printf("Index out of bounds while reading SNMPv3 Message Type\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_SEQUENCE) {
-        printf("Invalid SNMPv3 Message Type\n");
-        return;
-    }
-    
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for SNMPv3 Message\n");
-        return;
+    if (parse_field_header(buffer, index, length, TYPE_SEQUENCE, &len, "SNMPv3 Message") < 0) {
+        return -1;
     }
     int seq_end = *index + len;
 
     // 2. msgVersion
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgVersion\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_INTEGER) {
-        printf("Invalid msgVersion Type\n");
-        return;
+    if (parse_pdu_integer(buffer, index, seq_end, &snmp_packet->version, "msgVersion") < 0) {
+        return -1;
     }
-    len = read_length(buffer, index);
-    snmp_packet->version = read_integer(buffer, index, len);  // msgVersion 읽기
 
     // 3. msgGlobalData (HeaderData)
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgGlobalData\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_SEQUENCE) {
-        printf("Invalid msgGlobalData Type\n");
-        return;
-    }
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for msgGlobalData\n");
-        return;
+    if (parse_field_header(buffer, index, seq_end, TYPE_SEQUENCE, &len, "msgGlobalData") < 0) {
+        return -1;
     }
     int header_end = *index + len;  // Header 종료 위치
 
     // 3.1 msgID
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgID\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_INTEGER) {
-        printf("Invalid msgID Type\n");
-        return;
+    if (parse_pdu_integer(buffer, index, header_end, &value, "msgID") < 0) {
+        return -1;
     }
-    len = read_length(buffer, index);
-    snmp_packet->msgID = read_integer(buffer, index, len);  // msgID 읽기
+    snmp_packet->msgID = (unsigned int)value;
 
     // 3.2 msgMaxSize
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgMaxSize\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_INTEGER) {
-        printf("Invalid msgMaxSize Type\n");
-        return;
+    if (parse_pdu_integer(buffer, index, header_end, &value, "msgMaxSize") < 0) {
+        return -1;
     }
-    len = read_length(buffer, index);
-    snmp_packet->msgMaxSize = read_integer(buffer, index, len);  // msgMaxSize 읽기
+    snmp_packet->msgMaxSize = (unsigned int)value;
 
-    // 3.3 msgFlags
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgFlags\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_OCTET_STRING) {
-        printf("Invalid msgFlags Type\n");
-        return;
+    // 3.3 msgFlags (OCTET STRING (SIZE(1)))
+    if (parse_octet_string(buffer, index, header_end, 1, &len, "msgFlags") < 0) {
+        return -1;
     }
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for msgFlags\n");
-        return;
+    if (len != 1) {
+        log_debug("Invalid length for msgFlags");
+        return -1;
     }
-    memcpy(snmp_packet->msgFlags, &buffer[*index], len);
+    snmp_packet->msgFlags[0] = buffer[*index];
     (*index) += len;  // 인덱스 업데이트
 
     // 3.4 msgSecurityModel
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgSecurityModel\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_INTEGER) {
-        printf("Invalid msgSecurityModel Type\n");
-        return;
+    if (parse_pdu_integer(buffer, index, header_end, &snmp_packet->msgSecurityModel, "msgSecurityModel") < 0) {
+        return -1;
     }
-    len = read_length(buffer, index);
-    snmp_packet->msgSecurityModel = read_integer(buffer, index, len);  // msgSecurityModel 읽기
+    *index = header_end;
 
     // 4. msgSecurityParameters
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgSecurityParameters\n");
-        return;
-    }
-    type = buffer[*index];
-    (*index)++;
-    if (type != TYPE_OCTET_STRING) {
-        printf("Invalid msgSecurityParameters Type\n");
-        return;
-    }
-    len = read_length(buffer, index);
-    if (len < 0 || *index + len > length) {
-        printf("Invalid length for msgSecurityParameters\n");
-        return;
+    if (parse_field_header(buffer, index, seq_end, TYPE_OCTET_STRING, &len, "msgSecurityParameters") < 0) {
+        return -1;
     }
 
-    // msgSecurityParameters를 임시 버퍼에 저장하여 파싱
-    unsigned char sec_params_buffer[BUFFER_SIZE];
-    memcpy(sec_params_buffer, &buffer[*index], len);
-    (*index) += len;  // 인덱스 업데이트
-
+    // msgSecurityParameters를 메시지 버퍼 안에서 바로 파싱 (TCP 메시지는 BUFFER_SIZE보다 클 수 있음)
     int sec_params_index = 0;
-    parse_usm_security_parameters(sec_params_buffer, &sec_params_index, len, snmp_packet);  // Security Parameters 파싱
+    if (parse_usm_security_parameters(&buffer[*index], &sec_params_index, len, snmp_packet) < 0) {
+        return -1;
+    }
+    (*index) += len;  // 인덱스 업데이트
 
     // 5. msgData (ScopedPDUData)
-    if (*index >= length) {
-        printf("Index out of bounds while reading msgData\n");
-        return;
+    if (*index >= seq_end) {
+        log_debug("Index out of bounds while reading msgData");
+        return -1;
     }
     type = buffer[*index];
-    (*index)++;
-    if (type == TYPE_OCTET_STRING) {  // OCTET STRING (plaintext)
-        len = read_length(buffer, index);
-        if (len < 0 || *index + len > length) {
-            printf("Invalid length for msgData OCTET STRING\n");
-            return;
+    if (type == TYPE_OCTET_STRING) {  // encryptedPDU
+        if (read_tlv(buffer, seq_end, index, &type, &len) < 0) {
+            log_debug("Invalid length for msgData OCTET STRING");
+            return -1;
         }
 
-        // ScopedPDU 파싱
-        unsigned char scoped_pdu_buffer[BUFFER_SIZE];
-        memcpy(scoped_pdu_buffer, &buffer[*index], len);
-        (*index) += len;
+        // 암호화된 ScopedPDU는 해석하지 않음 (authPriv는 unsupportedSecLevel로 응답)
+        if (snmp_packet->msgFlags[0] & 0x02) {
+            (*index) += len;
+            return 0;
+        }
 
+        // ScopedPDU 파싱 (OCTET STRING 내용 안에서)
         int scoped_pdu_index = 0;
-        // 여기서는 인덱스를 0으로 설정하고, ScopedPDU의 길이를 len으로 설정하여 파싱
-        parse_scoped_pdu(scoped_pdu_buffer, &scoped_pdu_index, len, snmp_packet);
-    } else if (type == 0x30) { // SEQUENCE (ScopedPDU directly)
-        (*index)--; // 타입 바이트를 다시 읽기 위해 인덱스 감소
-        int scoped_pdu_start = *index; // ScopedPDU 시작 위치
-        int remaining_length = length - scoped_pdu_start;
-
-        // parse_scoped_pdu를 호출할 때 index를 0으로 설정하고, length를 remaining_length로 설정합니다.
+        if (parse_scoped_pdu(&buffer[*index], &scoped_pdu_index, len, snmp_packet) < 0) {
+            return -1;
+        }
+        (*index) += len;
+    } else if (type == TYPE_SEQUENCE) { // SEQUENCE (ScopedPDU directly)
+        // ScopedPDU는 메시지의 남은 부분 안에서 파싱
         int scoped_pdu_index = 0;
-        parse_scoped_pdu(&buffer[scoped_pdu_start], &scoped_pdu_index, remaining_length, snmp_packet);
+        if (parse_scoped_pdu(&buffer[*index], &scoped_pdu_index, seq_end - *index, snmp_packet) < 0) {
+            return -1;
+        }
+        (*index) += scoped_pdu_index;
     } else {
-        printf("Invalid msgData Type: %02X\n", type);
-        return;
+        log_debug("Invalid msgData Type: %02X", type);
+        return -1;
     }
+
+    return 0;
 }
 
 // Function to print SNMPv3Packet details
@@ -796,6 +790,9 @@ void printSNMPv3Packet(SNMPv3Packet *packet) {
     printf("VarBind Count: %d\n", packet->varbind_count);
 
     for (int i = 0; i < packet->varbind_count; i++) {
-        printf("VarBind %d - OID: %s, Value: %s\n", i + 1, packet->varbind_list[i].oid, packet->varbind_list[i].value);
+        char oid_str[256];
+        oid_to_string(packet->varbind_list[i].oid, packet->varbind_list[i].oid_len, oid_str);
+        printf("VarBind %d - OID: %s, Value: type 0x%02x, %d bytes\n", i + 1, oid_str,
+               packet->varbind_list[i].value_type, packet->varbind_list[i].value_len);
     }
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snmp_ratelimit.h"  // Per-client token buckets
+#include "snmp_log.h"        // Logging
+
+static RateLimitClient *client_set(SNMPRateLimiter *limiter, const SNMPHostAddr *addr) {
+    unsigned int words[4];
+    memcpy(words, addr->bytes, sizeof(words));
+    unsigned int hash = (words[0] ^ words[1] ^ words[2] ^ words[3]) * 2654435761u;   // Knuth 곱셈 해시
+    int sets = limiter->capacity / RATE_LIMIT_WAYS;
+    return &limiter->clients[(hash >> 8) % sets * RATE_LIMIT_WAYS];
+}
+
+// Function to find the bucket of a client, replacing the least recently seen
+// client of the set if it is new. A new bucket starts full.
+static RateLimitClient *find_client(SNMPRateLimiter *limiter, const SNMPHostAddr *addr, long long now_ms) {
+    RateLimitClient *set = client_set(limiter, addr);
+    RateLimitClient *victim = &set[0];
+
+    for (int i = 0; i < RATE_LIMIT_WAYS; i++) {
+        if (set[i].in_use && memcmp(&set[i].addr, addr, sizeof(SNMPHostAddr)) == 0) {
+            return &set[i];
+        }
+        if (!set[i].in_use) {
+            if (victim->in_use) {
+                victim = &set[i];
+            }
+        } else if (victim->in_use && set[i].last_ms < victim->last_ms) {
+            victim = &set[i];
+        }
+    }
+
+    if (victim->in_use) {
+        limiter->evict_count++;
+    }
+    memset(victim, 0, sizeof(RateLimitClient));
+    victim->in_use = 1;
+    victim->addr = *addr;
+    victim->tokens = (long long)limiter->burst * RATE_LIMIT_TOKEN;
+    victim->last_ms = now_ms;
+    return victim;
+}
+
+// Function to allocate the client table, clients is rounded up to whole sets
+// (0 disables the limiter)
+int rate_limit_init(SNMPRateLimiter *limiter, int clients, int rate, int burst) {
+    memset(limiter, 0, sizeof(SNMPRateLimiter));
+
+    if (clients <= 0 || rate <= 0) {
+        return 0;
+    }
+
+    int capacity = (clients + RATE_LIMIT_WAYS - 1) / RATE_LIMIT_WAYS * RATE_LIMIT_WAYS;
+    limiter->clients = (RateLimitClient *)calloc(capacity, sizeof(RateLimitClient));
+    if (!limiter->clients) {
+        printf("Error: Memory allocation failed.\n");
+        return -1;
+    }
+    limiter->capacity = capacity;
+    limiter->rate = rate;
+    limiter->burst = burst > 0 ? burst : 1;
+    return 0;
+}
+
+// Function to take one token from the client's bucket.
+// Returns 1 if the request may be processed, 0 if it must be dropped.
+int rate_limit_allow(SNMPRateLimiter *limiter, const struct sockaddr_storage *addr, long long now_ms) {
+    SNMPHostAddr host;
+
+    if (limiter->capacity == 0 || addr_host(addr, &host) < 0) {
+        return 1;
+    }
+
+    RateLimitClient *client = find_client(limiter, &host, now_ms);
+
+    // 경과 시간만큼 충전 (rate 요청/초 = rate 단위/ms)
+    long long limit = (long long)limiter->burst * RATE_LIMIT_TOKEN;
+    if (now_ms > client->last_ms) {
+        client->tokens += (now_ms - client->last_ms) * limiter->rate;
+        if (client->tokens > limit) {
+            client->tokens = limit;
+        }
+    }
+    client->last_ms = now_ms;
+
+    if (client->tokens < RATE_LIMIT_TOKEN) {
+        // 폭주 시작과 끝만 기록 (패킷마다 출력하지 않음)
+        if (!client->limited) {
+            char text[ADDR_STRING_MAX];
+            log_warn("Rate limit: dropping requests from %s", addr_host_string(&host, text, sizeof(text)));
+        }
+        client->limited++;
+        client->drop_count++;
+        limiter->drop_count++;
+        return 0;
+    }
+
+    if (client->limited) {
+        char text[ADDR_STRING_MAX];
+        log_info("Rate limit: %s resumed after %d dropped requests", addr_host_string(&host, text, sizeof(text)),
+                 client->limited);
+        client->limited = 0;
+    }
+    client->tokens -= RATE_LIMIT_TOKEN;
+    limiter->allowed_count++;
+    return 1;
+}
+
+void rate_limit_close(SNMPRateLimiter *limiter) {
+    free(limiter->clients);
+    limiter->clients = NULL;
+    limiter->capacity = 0;
+}
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snmp_parse.h"  // Bounded BER readers
+#include "snmp_event.h"  // Monotonic clock
+#include "snmp_sched.h"  // Request scheduler
+
+// Function to set up the queues. Datagram storage is sized for the
+// configured receive buffer (max_message bytes per queue entry).
+int sched_init(SNMPScheduler *sched, int get_weight, int bulk_weight, int bulk_cost, int max_message) {
+    memset(sched, 0, sizeof(SNMPScheduler));
+
+    sched->queues[SCHED_CLASS_GET].weight = get_weight > 0 ? get_weight : 1;
+    sched->queues[SCHED_CLASS_BULK].weight = bulk_weight > 0 ? bulk_weight : 1;
+    for (int i = 0; i < SCHED_CLASSES; i++) {
+        sched->queues[i].credit = sched->queues[i].weight;
+    }
+    sched->bulk_cost = bulk_cost;
+
+    sched->pool = malloc((size_t)SCHED_CLASSES * SCHED_QUEUE_SIZE * max_message);
+    if (!sched->pool) {
+        return -1;
+    }
+    sched->max_message = max_message;
+    for (int i = 0; i < SCHED_CLASSES; i++) {
+        for (int j = 0; j < SCHED_QUEUE_SIZE; j++) {
+            sched->queues[i].entries[j].data = sched->pool + ((size_t)i * SCHED_QUEUE_SIZE + j) * max_message;
+        }
+    }
+    return 0;
+}
+
+void sched_close(SNMPScheduler *sched) {
+    free(sched->pool);
+    sched->pool = NULL;
+    sched->max_message = 0;
+}
+
+// Function to estimate the work of a request as the number of varbinds it can
+// return: non-repeaters + repeaters x max-repetitions for GETBULK, the varbind
+// count otherwise. Messages that cannot be decoded (encrypted) cost 1.
+int sched_request_cost(const unsigned char *buffer, int n) {
+    int version;
+    unsigned char pdu_type;
+    int index;
+    int end;
+    unsigned char tag;
+    int length;
+
+    if (locate_snmp_pdu(buffer, n, &version, &pdu_type, &index, &end) < 0) {
+        return 1;
+    }
+    end += index;
+
+    // error-status/non-repeaters, error-index/max-repetitions
+    int fields[2] = { 0, 0 };
+    for (int i = 0; i < 2; i++) {
+        if (read_tlv(buffer, end, &index, &tag, &length) < 0 || tag != TYPE_INTEGER || length > 4) {
+            return 1;
+        }
+        for (int j = 0; j < length; j++) {
+            fields[i] = (fields[i] << 8) | buffer[index++];
+        }
+    }
+
+    if (read_tlv(buffer, end, &index, &tag, &length) < 0 || tag != TYPE_SEQUENCE) {
+        return 1;
+    }
+
+    int varbind_count = 0;
+    int list_end = index + length;
+    while (index < list_end && skip_tlv(buffer, list_end, &index, TYPE_SEQUENCE) == 0) {
+        varbind_count++;
+    }
+
+    if (pdu_type != 0xA5) {
+        return varbind_count > 0 ? varbind_count : 1;
+    }
+
+    int non_repeaters = fields[0] < 0 ? 0 : fields[0] > varbind_count ? varbind_count : fields[0];
+    int max_repetitions = fields[1] < 1 ? 1 : fields[1] > 1024 ? 1024 : fields[1];
+    return non_repeaters + (varbind_count - non_repeaters) * max_repetitions;
+}
+
+// Function to queue a datagram in the class of its cost.
+// Returns the class, or -1 if that queue is full and the datagram was dropped.
+int sched_enqueue(SNMPScheduler *sched, const unsigned char *buffer, int n,
+                  const struct sockaddr_storage *addr, int sockfd) {
+    int class = sched_request_cost(buffer, n) > sched->bulk_cost ? SCHED_CLASS_BULK : SCHED_CLASS_GET;
+    SchedQueue *queue = &sched->queues[class];
+
+    if (queue->count == SCHED_QUEUE_SIZE || n > sched->max_message) {
+        queue->drop_count++;
+        return -1;
+    }
+
+    SchedRequest *request = &queue->entries[(queue->head + queue->count) % SCHED_QUEUE_SIZE];
+    memcpy(request->data, buffer, n);
+    request->len = n;
+    request->addr = *addr;
+    request->sockfd = sockfd;
+    request->enqueued_us = event_loop_now_us();
+
+    queue->count++;
+    queue->enqueued_count++;
+    if (queue->count > queue->max_depth) {
+        queue->max_depth = queue->count;
+    }
+    return class;
+}
+
+// Function to take the next request in weighted round robin order.
+// The request stays valid until sched_complete() and the next enqueue.
+SchedRequest *sched_next(SNMPScheduler *sched) {
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < SCHED_CLASSES; i++) {
+            SchedQueue *queue = &sched->queues[i];
+            if (queue->count == 0 || queue->credit == 0) {
+                continue;
+            }
+
+            SchedRequest *request = &queue->entries[queue->head];
+            queue->head = (queue->head + 1) % SCHED_QUEUE_SIZE;
+            queue->count--;
+            queue->credit--;
+            sched->current = i;
+            return request;
+        }
+
+        // 대기 중인 클래스가 모두 몫을 썼으면 새 라운드 시작
+        for (int i = 0; i < SCHED_CLASSES; i++) {
+            sched->queues[i].credit = sched->queues[i].weight;
+        }
+    }
+    return NULL;
+}
+
+// Function to account a served request (arrival to response latency)
+void sched_complete(SNMPScheduler *sched, const SchedRequest *request) {
+    SchedQueue *queue = &sched->queues[sched->current];
+    unsigned long latency = (unsigned long)(event_loop_now_us() - request->enqueued_us);
+
+    queue->served_count++;
+    queue->latency_total_us += latency;
+    if (latency > queue->latency_max_us) {
+        queue->latency_max_us = latency;
+    }
+}
+
+int sched_pending(const SNMPScheduler *sched) {
+    int pending = 0;
+
+    for (int i = 0; i < SCHED_CLASSES; i++) {
+        pending += sched->queues[i].count;
+    }
+    return pending;
+}
@@ -0,0 +1,266 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snmp.h"        // SNMP protocol definitions
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_parse.h"  // ASN.1 BER helpers
+#include "snmp_set.h"    // SET processing
+#include "snmp_log.h"    // Logging
+
+// SET 처리 중 VarBind 하나의 상태
+typedef struct {
+    MIBNode *node;           // Target node
+    MIBValue new_value;      // Decoded value from the request
+    MIBValue old_value;      // Value before commit (for undo)
+} SetEntry;
+
+// Function to decode a VarBind value according to the target node type
+static int decode_set_value(MIBNode *node, const VarBind *varbind, MIBValue *value) {
+    memset(value, 0, sizeof(MIBValue));
+
+    switch (node->value_type) {
+        case VALUE_TYPE_INT: {
+            if (varbind->value_type != TYPE_INTEGER) {
+                return SNMP_ERROR_WRONG_TYPE;
+            }
+            if (varbind->value_len < 1 || varbind->value_len > 4) {
+                return SNMP_ERROR_WRONG_LENGTH;
+            }
+            int index = 0;
+            value->int_value = read_integer(varbind->value, &index, varbind->value_len);
+            break;
+        }
+
+        case VALUE_TYPE_STRING:
+            if (varbind->value_type != TYPE_OCTET_STRING) {
+                return SNMP_ERROR_WRONG_TYPE;
+            }
+            if (varbind->value_len > (int)sizeof(value->str_value) - 1) {
+                return SNMP_ERROR_WRONG_LENGTH;
+            }
+            // 문자열 값은 NULL 종료 문자열로 저장되므로 중간의 NULL은 허용하지 않음
+            if (memchr(varbind->value, '\0', varbind->value_len) != NULL) {
+                return SNMP_ERROR_WRONG_VALUE;
+            }
+            memcpy(value->str_value, varbind->value, varbind->value_len);
+            break;
+
+        case VALUE_TYPE_OID: {
+            if (varbind->value_type != TYPE_OID) {
+                return SNMP_ERROR_WRONG_TYPE;
+            }
+            if (varbind->value_len < 1 || varbind->value_len > 32) {
+                return SNMP_ERROR_WRONG_LENGTH;
+            }
+            if (varbind->value[varbind->value_len - 1] & 0x80) {
+                return SNMP_ERROR_WRONG_ENCODING;
+            }
+            oid_to_string(varbind->value, varbind->value_len, value->oid_value);
+            break;
+        }
+
+        case VALUE_TYPE_TIME_TICKS: {
+            if (varbind->value_type != 0x43) {
+                return SNMP_ERROR_WRONG_TYPE;
+            }
+            if (varbind->value_len < 1 || varbind->value_len > 5) {
+                return SNMP_ERROR_WRONG_LENGTH;
+            }
+            unsigned long ticks = 0;
+            for (int i = 0; i < varbind->value_len; i++) {
+                ticks = (ticks << 8) | varbind->value[i];
+            }
+            if (ticks > 0xFFFFFFFFUL) {
+                return SNMP_ERROR_WRONG_VALUE;
+            }
+            value->ticks_value = ticks;
+            break;
+        }
+
+        case VALUE_TYPE_GAUGE32: {
+            if (varbind->value_type != TYPE_GAUGE32) {
+                return SNMP_ERROR_WRONG_TYPE;
+            }
+            if (varbind->value_len < 1 || varbind->value_len > 5) {
+                return SNMP_ERROR_WRONG_LENGTH;
+            }
+            unsigned long long gauge = 0;
+            for (int i = 0; i < varbind->value_len; i++) {
+                gauge = (gauge << 8) | varbind->value[i];
+            }
+            if (gauge > 0xFFFFFFFFULL) {
+                return SNMP_ERROR_WRONG_VALUE;
+            }
+            value->uint_value = (unsigned int)gauge;
+            break;
+        }
+
+        default:
+            // Counter32/Counter64는 SMI상 쓰기 불가
+            return SNMP_ERROR_WRONG_TYPE;
+    }
+
+    return SNMP_ERROR_NO_ERROR;
+}
+
+// Function to check a decoded value against the node's SYNTAX range or SIZE
+static int check_syntax_constraints(const MIBNode *node, const MIBValue *value) {
+    if (!node->has_range) {
+        return SNMP_ERROR_NO_ERROR;
+    }
+
+    switch (node->value_type) {
+        case VALUE_TYPE_INT:
+            if (value->int_value < node->range_min || value->int_value > node->range_max) {
+                return SNMP_ERROR_WRONG_VALUE;
+            }
+            break;
+
+        case VALUE_TYPE_GAUGE32:
+            if (value->uint_value < node->range_min || value->uint_value > node->range_max) {
+                return SNMP_ERROR_WRONG_VALUE;
+            }
+            break;
+
+        case VALUE_TYPE_STRING: {
+            // OCTET STRING의 범위는 SIZE 제약
+            long long len = strlen(value->str_value);
+            if (len < node->range_min || len > node->range_max) {
+                return SNMP_ERROR_WRONG_LENGTH;
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return SNMP_ERROR_NO_ERROR;
+}
+
+int process_set_request(MIBTree *mib_tree, const VarBind *varbind_list, int varbind_count, int *error_index) {
+    SetEntry entries[MAX_VARBINDS];
+    char oid_str[VARBIND_OID_STRING_MAX];
+
+    *error_index = 0;
+
+    // 1단계: 모든 VarBind 검증 (부작용 없음)
+    for (int i = 0; i < varbind_count; i++) {
+        oid_to_string(varbind_list[i].oid, varbind_list[i].oid_len, oid_str);
+
+        MIBNode *node = find_mib_node_by_oid(mib_tree, oid_str);
+        if (node == NULL) {
+            *error_index = i + 1;
+            return SNMP_ERROR_NO_CREATION;
+        }
+
+        if (!node->isWritable) {
+            *error_index = i + 1;
+            return SNMP_ERROR_NOT_WRITABLE;
+        }
+
+        int error = decode_set_value(node, &varbind_list[i], &entries[i].new_value);
+        if (error == SNMP_ERROR_NO_ERROR) {
+            error = check_syntax_constraints(node, &entries[i].new_value);
+        }
+        if (error == SNMP_ERROR_NO_ERROR && node->write_handler) {
+            error = node->write_handler(node, MIB_SET_ACTION_CHECK, &entries[i].new_value);
+        }
+
+        if (error != SNMP_ERROR_NO_ERROR) {
+            *error_index = i + 1;
+            return error;
+        }
+
+        entries[i].node = node;
+    }
+
+    // 2단계: 커밋, 실패 시 이미 커밋된 항목을 역순으로 되돌림
+    for (int i = 0; i < varbind_count; i++) {
+        SetEntry *entry = &entries[i];
+        int error = SNMP_ERROR_NO_ERROR;
+
+        mib_node_read_value(entry->node, &entry->old_value);
+
+        if (entry->node->write_handler) {
+            error = entry->node->write_handler(entry->node, MIB_SET_ACTION_COMMIT, &entry->new_value);
+        }
+
+        if (error == SNMP_ERROR_NO_ERROR) {
+            mib_node_write_value(entry->node, &entry->new_value);
+            continue;
+        }
+
+        int undo_failed = 0;
+        for (int j = i - 1; j >= 0; j--) {
+            SetEntry *committed = &entries[j];
+            if (committed->node->write_handler &&
+                committed->node->write_handler(committed->node, MIB_SET_ACTION_UNDO,
+                                               &committed->old_value) != SNMP_ERROR_NO_ERROR) {
+                undo_failed = 1;
+            }
+            mib_node_write_value(committed->node, &committed->old_value);
+        }
+
+        log_error("SET commit failed at VarBind %d", i + 1);
+        *error_index = i + 1;
+        return undo_failed ? SNMP_ERROR_UNDO_FAILED : SNMP_ERROR_COMMIT_FAILED;
+    }
+
+    // 전체 SET이 커밋된 후에만 알림 (부분 커밋은 저장되지 않음)
+    if (mib_tree->commit_hook) {
+        for (int i = 0; i < varbind_count; i++) {
+            mib_tree->commit_hook(mib_tree->commit_hook_ctx, entries[i].node);
+        }
+    }
+
+    return SNMP_ERROR_NO_ERROR;
+}
+
+int snmp_v1_error_status(int error_status) {
+    switch (error_status) {
+        case SNMP_ERROR_NO_ERROR:
+        case SNMP_ERROR_TOO_BIG:
+        case SNMP_ERROR_NO_SUCH_NAME:
+        case SNMP_ERROR_BAD_VALUE:
+        case SNMP_ERROR_READ_ONLY:
+        case SNMP_ERROR_GENERAL_ERROR:
+            return error_status;
+
+        case SNMP_ERROR_WRONG_VALUE:
+        case SNMP_ERROR_WRONG_ENCODING:
+        case SNMP_ERROR_WRONG_TYPE:
+        case SNMP_ERROR_WRONG_LENGTH:
+        case SNMP_ERROR_INCONSISTENT_VALUE:
+            return SNMP_ERROR_BAD_VALUE;
+
+        case SNMP_ERROR_NO_ACCESS:
+        case SNMP_ERROR_NOT_WRITABLE:
+        case SNMP_ERROR_NO_CREATION:
+        case SNMP_ERROR_INCONSISTENT_NAME:
+        case SNMP_ERROR_AUTHORIZATION_ERROR:
+            return SNMP_ERROR_NO_SUCH_NAME;
+
+        default:
+            return SNMP_ERROR_GENERAL_ERROR;
+    }
+}
+
+int display_string_write_handler(MIBNode *node, int action, const MIBValue *value) {
+    (void)node;
+
+    if (action != MIB_SET_ACTION_CHECK) {
+        return SNMP_ERROR_NO_ERROR;
+    }
+
+    // DisplayString: NVT ASCII (출력 가능한 문자와 CR, LF, TAB)
+    for (const char *p = value->str_value; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if ((c < 0x20 || c > 0x7E) && c != '\r' && c != '\n' && c != '\t') {
+            return SNMP_ERROR_WRONG_VALUE;
+        }
+    }
+
+    return SNMP_ERROR_NO_ERROR;
+}
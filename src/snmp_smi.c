@@ -0,0 +1,1312 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/stat.h>
+
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_smi.h"    // SMIv2 module parser
+
+// --- 토크나이저 ---
+
+typedef enum {
+    SMI_TOK_EOF,
+    SMI_TOK_IDENT,      // Descriptor, type reference or keyword (may contain '-')
+    SMI_TOK_NUMBER,     // Decimal number, optionally negative
+    SMI_TOK_STRING,     // "..." (may span lines)
+    SMI_TOK_BINARY,     // '...'H or '...'B
+    SMI_TOK_ASSIGN,     // ::=
+    SMI_TOK_RANGE,      // ..
+    SMI_TOK_PUNCT       // { } ( ) [ ] , ; | and any other single character
+} SMITokenType;
+
+typedef struct {
+    const char *path;             // File name for error messages
+    const char *buf;              // Whole module text, NUL terminated
+    size_t len;
+    size_t pos;
+    int line;
+    SMITokenType type;            // Current token
+    char text[SMI_MAX_NAME];      // Identifier or punctuation text
+    long long number;             // SMI_TOK_NUMBER value
+    const char *str;              // SMI_TOK_STRING contents (points into buf)
+    size_t str_len;
+} SMILexer;
+
+// Parsed SYNTAX clause or type assignment
+typedef struct {
+    char syntax[SMI_MAX_NAME];
+    int sequence_of;
+    int has_range;
+    long long range_min;
+    long long range_max;
+} SMISyntax;
+
+typedef struct {
+    SMITree *tree;
+    SMILexer lx;
+    char module[SMI_MAX_NAME];    // Module being parsed
+} SMIParser;
+
+static int is_comment_start(const SMILexer *lx, size_t pos) {
+    return pos + 1 < lx->len && lx->buf[pos] == '-' && lx->buf[pos + 1] == '-';
+}
+
+static void lex_skip_space(SMILexer *lx) {
+    while (lx->pos < lx->len) {
+        char c = lx->buf[lx->pos];
+
+        if (c == '\n') {
+            lx->line++;
+            lx->pos++;
+        } else if (isspace((unsigned char)c)) {
+            lx->pos++;
+        } else if (is_comment_start(lx, lx->pos)) {
+            // 주석은 줄 끝 또는 다음 "--" 에서 끝남
+            lx->pos += 2;
+            while (lx->pos < lx->len && lx->buf[lx->pos] != '\n') {
+                if (is_comment_start(lx, lx->pos)) {
+                    lx->pos += 2;
+                    break;
+                }
+                lx->pos++;
+            }
+        } else {
+            break;
+        }
+    }
+}
+
+// Function to advance to the next token
+static void lex_next(SMILexer *lx) {
+    lex_skip_space(lx);
+    lx->text[0] = '\0';
+
+    if (lx->pos >= lx->len) {
+        lx->type = SMI_TOK_EOF;
+        return;
+    }
+
+    const char *p = lx->buf + lx->pos;
+
+    if (isalpha((unsigned char)p[0])) {
+        size_t n = 0;
+        while (lx->pos + n < lx->len &&
+               (isalnum((unsigned char)p[n]) || (p[n] == '-' && !is_comment_start(lx, lx->pos + n)))) {
+            n++;
+        }
+        size_t copy = n < sizeof(lx->text) - 1 ? n : sizeof(lx->text) - 1;
+        memcpy(lx->text, p, copy);
+        lx->text[copy] = '\0';
+        lx->pos += n;
+        lx->type = SMI_TOK_IDENT;
+    } else if (isdigit((unsigned char)p[0]) || (p[0] == '-' && isdigit((unsigned char)p[1]))) {
+        char *end;
+        lx->number = strtoll(p, &end, 10);
+        lx->pos += end - p;
+        lx->type = SMI_TOK_NUMBER;
+    } else if (p[0] == '"') {
+        size_t n = 1;
+        while (lx->pos + n < lx->len && p[n] != '"') {
+            if (p[n] == '\n') {
+                lx->line++;
+            }
+            n++;
+        }
+        lx->str = p + 1;
+        lx->str_len = n - 1;
+        lx->pos += (lx->pos + n < lx->len) ? n + 1 : n;
+        lx->type = SMI_TOK_STRING;
+    } else if (p[0] == '\'') {
+        size_t n = 1;
+        while (lx->pos + n < lx->len && p[n] != '\'') {
+            n++;
+        }
+        if (lx->pos + n < lx->len) {
+            n++;
+            if (lx->pos + n < lx->len && strchr("HhBb", p[n])) {
+                n++;
+            }
+        }
+        lx->pos += n;
+        lx->type = SMI_TOK_BINARY;
+    } else if (lx->pos + 2 < lx->len && strncmp(p, "::=", 3) == 0) {
+        strcpy(lx->text, "::=");
+        lx->pos += 3;
+        lx->type = SMI_TOK_ASSIGN;
+    } else if (lx->pos + 1 < lx->len && p[0] == '.' && p[1] == '.') {
+        strcpy(lx->text, "..");
+        lx->pos += 2;
+        lx->type = SMI_TOK_RANGE;
+    } else {
+        lx->text[0] = p[0];
+        lx->text[1] = '\0';
+        lx->pos++;
+        lx->type = SMI_TOK_PUNCT;
+    }
+}
+
+static int tok_is(const SMILexer *lx, const char *text) {
+    return (lx->type == SMI_TOK_IDENT || lx->type == SMI_TOK_PUNCT) && strcmp(lx->text, text) == 0;
+}
+
+// Function to skip a bracketed block, the current token is the opening bracket
+static void skip_balanced(SMILexer *lx) {
+    char open = lx->text[0];
+    char close = (open == '{') ? '}' : (open == '(') ? ')' : ']';
+    int depth = 0;
+
+    do {
+        if (lx->type == SMI_TOK_PUNCT && lx->text[0] == open) {
+            depth++;
+        } else if (lx->type == SMI_TOK_PUNCT && lx->text[0] == close) {
+            depth--;
+        }
+        lex_next(lx);
+    } while (depth > 0 && lx->type != SMI_TOK_EOF);
+}
+
+static void parse_error(SMIParser *p, const char *message) {
+    printf("%s:%d: %s near '%s'\n", p->lx.path, p->lx.line, message,
+           p->lx.type == SMI_TOK_EOF ? "end of file" : p->lx.text);
+}
+
+// --- 객체/타입 테이블 ---
+
+static const char *smi_base_types[] = {
+    "INTEGER", "Integer32", "Unsigned32", "Gauge32", "Counter32", "Counter64", "TimeTicks",
+    "IpAddress", "Opaque", "OCTET STRING", "OBJECT IDENTIFIER", "BITS",
+    "Counter", "Gauge", "NetworkAddress",   // SMIv1
+    NULL
+};
+
+// SNMPv2-SMI / RFC1155-SMI roots, used when the module files are not installed
+static const struct {
+    const char *name;
+    const char *parent;
+    unsigned int subid;
+} smi_builtin_nodes[] = {
+    { "ccitt",           "",             0 },
+    { "iso",             "",             1 },
+    { "joint-iso-ccitt", "",             2 },
+    { "zeroDotZero",     "ccitt",        0 },
+    { "org",             "iso",          3 },
+    { "dod",             "org",          6 },
+    { "internet",        "dod",          1 },
+    { "directory",       "internet",     1 },
+    { "mgmt",            "internet",     2 },
+    { "mib-2",           "mgmt",         1 },
+    { "system",          "mib-2",        1 },
+    { "interfaces",      "mib-2",        2 },
+    { "transmission",    "mib-2",        10 },
+    { "snmp",            "mib-2",        11 },
+    { "experimental",    "internet",     3 },
+    { "private",         "internet",     4 },
+    { "enterprises",     "private",      1 },
+    { "security",        "internet",     5 },
+    { "snmpV2",          "internet",     6 },
+    { "snmpDomains",     "snmpV2",       1 },
+    { "snmpProxys",      "snmpV2",       2 },
+    { "snmpModules",     "snmpV2",       3 },
+};
+
+// SNMPv2-TC textual conventions
+static const struct {
+    const char *name;
+    const char *syntax;
+    int has_range;
+    long long range_min;
+    long long range_max;
+} smi_builtin_types[] = {
+    { "DisplayString",   "OCTET STRING",      1, 0, 255 },
+    { "PhysAddress",     "OCTET STRING",      0, 0, 0 },
+    { "MacAddress",      "OCTET STRING",      1, 6, 6 },
+    { "TruthValue",      "INTEGER",           1, 1, 2 },
+    { "TestAndIncr",     "INTEGER",           1, 0, 2147483647 },
+    { "AutonomousType",  "OBJECT IDENTIFIER", 0, 0, 0 },
+    { "InstancePointer", "OBJECT IDENTIFIER", 0, 0, 0 },
+    { "VariablePointer", "OBJECT IDENTIFIER", 0, 0, 0 },
+    { "RowPointer",      "OBJECT IDENTIFIER", 0, 0, 0 },
+    { "RowStatus",       "INTEGER",           1, 1, 6 },
+    { "TimeStamp",       "TimeTicks",         0, 0, 0 },
+    { "TimeInterval",    "INTEGER",           1, 0, 2147483647 },
+    { "DateAndTime",     "OCTET STRING",      1, 8, 11 },
+    { "StorageType",     "INTEGER",           1, 1, 5 },
+    { "TDomain",         "OBJECT IDENTIFIER", 0, 0, 0 },
+    { "TAddress",        "OCTET STRING",      1, 1, 255 },
+};
+
+// Modules whose definitions are built in
+static const char *smi_builtin_modules[] = {
+    "SNMPv2-SMI", "SNMPv2-TC", "SNMPv2-CONF", "RFC1155-SMI", "RFC1065-SMI", "RFC-1212", "RFC-1215",
+    NULL
+};
+
+static unsigned int smi_hash(const char *name) {
+    unsigned int hash = 2166136261u;   // FNV-1a
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int find_object_index(SMITree *tree, const char *name) {
+    if (tree->hash_size == 0) {
+        return -1;
+    }
+
+    unsigned int mask = tree->hash_size - 1;
+    for (unsigned int i = smi_hash(name) & mask; tree->hash[i]; i = (i + 1) & mask) {
+        if (strcmp(tree->objects[tree->hash[i] - 1].name, name) == 0) {
+            return tree->hash[i] - 1;
+        }
+    }
+    return -1;
+}
+
+static void hash_insert(SMITree *tree, int index) {
+    unsigned int mask = tree->hash_size - 1;
+    unsigned int i = smi_hash(tree->objects[index].name) & mask;
+
+    while (tree->hash[i]) {
+        i = (i + 1) & mask;
+    }
+    tree->hash[i] = index + 1;
+}
+
+static int hash_grow(SMITree *tree) {
+    int size = tree->hash_size ? tree->hash_size * 2 : 256;
+    int *hash = (int *)calloc(size, sizeof(int));
+    if (!hash) {
+        printf("Error: Memory allocation failed.\n");
+        return -1;
+    }
+
+    free(tree->hash);
+    tree->hash = hash;
+    tree->hash_size = size;
+    for (int i = 0; i < tree->object_count; i++) {
+        hash_insert(tree, i);
+    }
+    return 0;
+}
+
+// Function to add a parsed object; the first definition of a descriptor wins.
+// Takes ownership of object->description.
+static int add_object(SMITree *tree, SMIObject *object) {
+    if (find_object_index(tree, object->name) >= 0) {
+        free(object->description);
+        return 0;
+    }
+
+    if (tree->object_count == tree->object_capacity) {
+        int capacity = tree->object_capacity ? tree->object_capacity * 2 : 256;
+        SMIObject *objects = (SMIObject *)realloc(tree->objects, capacity * sizeof(SMIObject));
+        if (!objects) {
+            printf("Error: Memory allocation failed.\n");
+            free(object->description);
+            return -1;
+        }
+        tree->objects = objects;
+        tree->object_capacity = capacity;
+    }
+
+    if ((tree->object_count + 1) * 2 > tree->hash_size && hash_grow(tree) < 0) {
+        free(object->description);
+        return -1;
+    }
+
+    tree->objects[tree->object_count] = *object;
+    hash_insert(tree, tree->object_count);
+    tree->object_count++;
+    tree->resolved = 0;
+    return 1;
+}
+
+static SMIType *find_type(SMITree *tree, const char *name) {
+    for (int i = 0; i < tree->type_count; i++) {
+        if (strcmp(tree->types[i].name, name) == 0) {
+            return &tree->types[i];
+        }
+    }
+    return NULL;
+}
+
+static int add_type(SMITree *tree, const char *name, const SMISyntax *syntax) {
+    if (find_type(tree, name)) {
+        return 0;
+    }
+
+    if (tree->type_count == tree->type_capacity) {
+        int capacity = tree->type_capacity ? tree->type_capacity * 2 : 64;
+        SMIType *types = (SMIType *)realloc(tree->types, capacity * sizeof(SMIType));
+        if (!types) {
+            printf("Error: Memory allocation failed.\n");
+            return -1;
+        }
+        tree->types = types;
+        tree->type_capacity = capacity;
+    }
+
+    SMIType *type = &tree->types[tree->type_count++];
+    memset(type, 0, sizeof(SMIType));
+    strncpy(type->name, name, sizeof(type->name) - 1);
+    strncpy(type->syntax, syntax->syntax, sizeof(type->syntax) - 1);
+    type->has_range = syntax->has_range;
+    type->range_min = syntax->range_min;
+    type->range_max = syntax->range_max;
+    tree->resolved = 0;
+    return 1;
+}
+
+static int module_loaded(SMITree *tree, const char *name) {
+    for (int i = 0; i < tree->module_count; i++) {
+        if (strcmp(tree->modules[i], name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Function to register a module name; returns its source entry (NULL if not added)
+static SMISource *mark_module(SMITree *tree, const char *name) {
+    if (module_loaded(tree, name)) {
+        return NULL;
+    }
+    if (tree->module_count >= SMI_MAX_MODULES) {
+        printf("Error: Maximum number of MIB modules reached.\n");
+        return NULL;
+    }
+    strncpy(tree->modules[tree->module_count], name, SMI_MAX_NAME - 1);
+    tree->modules[tree->module_count][SMI_MAX_NAME - 1] = '\0';
+
+    SMISource *source = &tree->sources[tree->module_count++];
+    source->mtime = -1;
+    source->size = 0;
+    source->requested = 0;
+    return source;
+}
+
+void smi_init(SMITree *tree) {
+    memset(tree, 0, sizeof(SMITree));
+
+    for (size_t i = 0; i < sizeof(smi_builtin_nodes) / sizeof(smi_builtin_nodes[0]); i++) {
+        SMIObject object;
+        memset(&object, 0, sizeof(SMIObject));
+        strcpy(object.name, smi_builtin_nodes[i].name);
+        strcpy(object.module, "SNMPv2-SMI");
+        strcpy(object.parent, smi_builtin_nodes[i].parent);
+        strcpy(object.status, "current");
+        object.subids[0] = smi_builtin_nodes[i].subid;
+        object.subid_count = 1;
+        object.kind = SMI_KIND_NODE;
+        add_object(tree, &object);
+    }
+
+    for (size_t i = 0; i < sizeof(smi_builtin_types) / sizeof(smi_builtin_types[0]); i++) {
+        SMISyntax syntax;
+        memset(&syntax, 0, sizeof(SMISyntax));
+        strcpy(syntax.syntax, smi_builtin_types[i].syntax);
+        syntax.has_range = smi_builtin_types[i].has_range;
+        syntax.range_min = smi_builtin_types[i].range_min;
+        syntax.range_max = smi_builtin_types[i].range_max;
+        add_type(tree, smi_builtin_types[i].name, &syntax);
+    }
+}
+
+// Function to add a module search directory
+int smi_add_path(SMITree *tree, const char *dir) {
+    if (tree->path_count >= SMI_MAX_PATHS) {
+        printf("Error: Maximum number of MIB directories reached.\n");
+        return -1;
+    }
+    strncpy(tree->paths[tree->path_count], dir, sizeof(tree->paths[0]) - 1);
+    tree->paths[tree->path_count][sizeof(tree->paths[0]) - 1] = '\0';
+    tree->path_count++;
+    return 0;
+}
+
+SMIObject *smi_find_object(SMITree *tree, const char *name) {
+    int index = find_object_index(tree, name);
+    return index >= 0 ? &tree->objects[index] : NULL;
+}
+
+// --- 파서 ---
+
+// Function to collect the bounds of a range, SIZE or enumeration block.
+// Unions are widened to [lowest, highest].
+static void parse_bounds(SMILexer *lx, SMISyntax *syntax) {
+    char open = lx->text[0];
+    char close = (open == '{') ? '}' : ')';
+    int depth = 0;
+
+    do {
+        if (lx->type == SMI_TOK_PUNCT && lx->text[0] == open) {
+            depth++;
+        } else if (lx->type == SMI_TOK_PUNCT && lx->text[0] == close) {
+            depth--;
+        } else if (lx->type == SMI_TOK_NUMBER) {
+            if (!syntax->has_range || lx->number < syntax->range_min) {
+                syntax->range_min = lx->number;
+            }
+            if (!syntax->has_range || lx->number > syntax->range_max) {
+                syntax->range_max = lx->number;
+            }
+            syntax->has_range = 1;
+        }
+        lex_next(lx);
+    } while (depth > 0 && lx->type != SMI_TOK_EOF);
+}
+
+// Function to parse a type: INTEGER {..}, OCTET STRING (SIZE (..)), SEQUENCE OF X, ...
+static void parse_type(SMILexer *lx, SMISyntax *syntax) {
+    memset(syntax, 0, sizeof(SMISyntax));
+
+    // [APPLICATION n] IMPLICIT
+    if (tok_is(lx, "[")) {
+        skip_balanced(lx);
+    }
+    if (tok_is(lx, "IMPLICIT") || tok_is(lx, "EXPLICIT")) {
+        lex_next(lx);
+    }
+
+    if (tok_is(lx, "SEQUENCE")) {
+        lex_next(lx);
+        if (tok_is(lx, "OF")) {
+            lex_next(lx);
+            syntax->sequence_of = 1;
+            strcpy(syntax->syntax, lx->text);
+            lex_next(lx);
+        } else {
+            strcpy(syntax->syntax, "SEQUENCE");
+            if (tok_is(lx, "{")) {
+                skip_balanced(lx);
+            }
+        }
+        return;
+    }
+
+    if (tok_is(lx, "CHOICE")) {
+        strcpy(syntax->syntax, "CHOICE");
+        lex_next(lx);
+        if (tok_is(lx, "{")) {
+            skip_balanced(lx);
+        }
+        return;
+    }
+
+    if (tok_is(lx, "OCTET")) {
+        lex_next(lx);
+        if (tok_is(lx, "STRING")) {
+            lex_next(lx);
+        }
+        strcpy(syntax->syntax, "OCTET STRING");
+    } else if (tok_is(lx, "OBJECT")) {
+        lex_next(lx);
+        if (tok_is(lx, "IDENTIFIER")) {
+            lex_next(lx);
+        }
+        strcpy(syntax->syntax, "OBJECT IDENTIFIER");
+    } else if (lx->type == SMI_TOK_IDENT) {
+        strcpy(syntax->syntax, lx->text);
+        lex_next(lx);
+    } else {
+        return;
+    }
+
+    // 열거형 값 또는 BITS 이름 목록
+    if (tok_is(lx, "{")) {
+        if (strcmp(syntax->syntax, "BITS") == 0) {
+            skip_balanced(lx);
+        } else {
+            parse_bounds(lx, syntax);
+        }
+    }
+    if (tok_is(lx, "(")) {
+        parse_bounds(lx, syntax);
+    }
+}
+
+// Function to parse an OID value: { parent 1 2 }, { iso org(3) 6 }, { 1 3 6 }
+static int parse_oid_value(SMIParser *p, SMIObject *object) {
+    SMILexer *lx = &p->lx;
+    int first = 1;
+
+    if (!tok_is(lx, "{")) {
+        parse_error(p, "Expected an OID value");
+        return -1;
+    }
+    lex_next(lx);
+
+    while (lx->type != SMI_TOK_EOF && !tok_is(lx, "}")) {
+        long long number = -1;
+
+        if (lx->type == SMI_TOK_IDENT) {
+            char name[SMI_MAX_NAME];
+            strcpy(name, lx->text);
+            lex_next(lx);
+
+            if (tok_is(lx, "(")) {
+                lex_next(lx);
+                if (lx->type == SMI_TOK_NUMBER) {
+                    number = lx->number;
+                    lex_next(lx);
+                }
+                if (tok_is(lx, ")")) {
+                    lex_next(lx);
+                }
+            } else if (first) {
+                strcpy(object->parent, name);
+                first = 0;
+                continue;
+            }
+        } else if (lx->type == SMI_TOK_NUMBER) {
+            number = lx->number;
+            lex_next(lx);
+        }
+
+        if (number < 0 || number > 0xFFFFFFFFLL || object->subid_count >= SMI_MAX_DEF_SUBIDS) {
+            parse_error(p, "Invalid OID component");
+            return -1;
+        }
+        object->subids[object->subid_count++] = (unsigned int)number;
+        first = 0;
+    }
+
+    if (lx->type == SMI_TOK_EOF) {
+        parse_error(p, "Unterminated OID value");
+        return -1;
+    }
+    lex_next(lx);   // '}'
+    return 0;
+}
+
+static SMIAccess parse_access(const char *access) {
+    if (strcmp(access, "read-only") == 0) {
+        return SMI_ACCESS_READ_ONLY;
+    } else if (strcmp(access, "read-write") == 0 || strcmp(access, "write-only") == 0) {
+        return SMI_ACCESS_READ_WRITE;
+    } else if (strcmp(access, "read-create") == 0) {
+        return SMI_ACCESS_READ_CREATE;
+    } else if (strcmp(access, "accessible-for-notify") == 0) {
+        return SMI_ACCESS_NOTIFY;
+    }
+    return SMI_ACCESS_NOT_ACCESSIBLE;
+}
+
+// INDEX { [IMPLIED] a, b }
+static void parse_index(SMILexer *lx, SMIObject *object) {
+    if (!tok_is(lx, "{")) {
+        return;
+    }
+    lex_next(lx);
+
+    while (lx->type != SMI_TOK_EOF && !tok_is(lx, "}")) {
+        if (tok_is(lx, "IMPLIED")) {
+            object->implied = 1;
+        } else if (lx->type == SMI_TOK_IDENT && object->index_count < SMI_MAX_INDEX) {
+            strcpy(object->index[object->index_count++], lx->text);
+        }
+        lex_next(lx);
+    }
+    lex_next(lx);
+}
+
+// DEFVAL { 5 } / { "text" } / { label }, nested values ({ 0 0 }, BITS) are skipped
+static void parse_defval(SMILexer *lx, SMIObject *object) {
+    lex_next(lx);
+
+    if (lx->type == SMI_TOK_NUMBER) {
+        snprintf(object->defval, sizeof(object->defval), "%lld", lx->number);
+        object->has_defval = 1;
+    } else if (lx->type == SMI_TOK_STRING) {
+        size_t len = lx->str_len < sizeof(object->defval) - 1 ? lx->str_len : sizeof(object->defval) - 1;
+        memcpy(object->defval, lx->str, len);
+        object->defval[len] = '\0';
+        object->has_defval = 1;
+    } else if (lx->type == SMI_TOK_IDENT) {
+        strncpy(object->defval, lx->text, sizeof(object->defval) - 1);
+        object->has_defval = 1;
+    }
+
+    while (lx->type != SMI_TOK_EOF && !tok_is(lx, "}")) {
+        if (tok_is(lx, "{")) {
+            skip_balanced(lx);
+        } else {
+            lex_next(lx);
+        }
+    }
+    lex_next(lx);
+}
+
+// Function to parse a macro invocation (OBJECT-TYPE, MODULE-IDENTITY, ...) up to its OID value
+static void parse_macro_value(SMIParser *p, const char *name, const char *macro) {
+    SMILexer *lx = &p->lx;
+    SMIObject object;
+
+    memset(&object, 0, sizeof(SMIObject));
+    strcpy(object.name, name);
+    strcpy(object.module, p->module);
+    strcpy(object.status, "current");
+
+    if (strcmp(macro, "OBJECT-TYPE") == 0) {
+        object.kind = SMI_KIND_SCALAR;   // smi_resolve()에서 테이블/행/열 분류
+    } else if (strcmp(macro, "NOTIFICATION-TYPE") == 0 || strcmp(macro, "TRAP-TYPE") == 0) {
+        object.kind = SMI_KIND_NOTIFICATION;
+    } else if (strcmp(macro, "MODULE-IDENTITY") == 0 || strcmp(macro, "OBJECT-IDENTITY") == 0) {
+        object.kind = SMI_KIND_NODE;
+    } else {
+        object.kind = SMI_KIND_GROUP;
+    }
+
+    lex_next(lx);
+    while (lx->type != SMI_TOK_EOF && lx->type != SMI_TOK_ASSIGN) {
+        if (tok_is(lx, "SYNTAX")) {
+            SMISyntax syntax;
+            lex_next(lx);
+            parse_type(lx, &syntax);
+            if (object.kind == SMI_KIND_SCALAR) {
+                strcpy(object.syntax, syntax.syntax);
+                object.sequence_of = syntax.sequence_of;
+                object.has_range = syntax.has_range;
+                object.range_min = syntax.range_min;
+                object.range_max = syntax.range_max;
+            }
+        } else if (tok_is(lx, "MAX-ACCESS") || tok_is(lx, "ACCESS")) {
+            lex_next(lx);
+            if (lx->type == SMI_TOK_IDENT && object.kind == SMI_KIND_SCALAR) {
+                object.access = parse_access(lx->text);
+            }
+            lex_next(lx);
+        } else if (tok_is(lx, "STATUS")) {
+            lex_next(lx);
+            if (lx->type == SMI_TOK_IDENT) {
+                strncpy(object.status, lx->text, sizeof(object.status) - 1);
+            }
+            lex_next(lx);
+        } else if (tok_is(lx, "DESCRIPTION")) {
+            lex_next(lx);
+            if (lx->type == SMI_TOK_STRING && object.description == NULL) {
+                object.description = strndup(lx->str, lx->str_len);
+            }
+            lex_next(lx);
+        } else if (tok_is(lx, "INDEX")) {
+            lex_next(lx);
+            parse_index(lx, &object);
+        } else if (tok_is(lx, "AUGMENTS")) {
+            lex_next(lx);
+            if (tok_is(lx, "{")) {
+                lex_next(lx);
+                if (lx->type == SMI_TOK_IDENT) {
+                    strcpy(object.augments, lx->text);
+                }
+                while (lx->type != SMI_TOK_EOF && !tok_is(lx, "}")) {
+                    lex_next(lx);
+                }
+                lex_next(lx);
+            }
+        } else if (tok_is(lx, "DEFVAL")) {
+            lex_next(lx);
+            if (tok_is(lx, "{")) {
+                parse_defval(lx, &object);
+            }
+        } else if (tok_is(lx, "{") || tok_is(lx, "(") || tok_is(lx, "[")) {
+            // OBJECTS, VARIABLES, MANDATORY-GROUPS, ...
+            skip_balanced(lx);
+        } else {
+            lex_next(lx);
+        }
+    }
+
+    if (lx->type == SMI_TOK_EOF) {
+        parse_error(p, "Unterminated definition");
+        free(object.description);
+        return;
+    }
+    lex_next(lx);   // ::=
+
+    // SMIv1 TRAP-TYPE 값은 OID가 아닌 트랩 번호
+    if (lx->type == SMI_TOK_NUMBER) {
+        lex_next(lx);
+        free(object.description);
+        return;
+    }
+
+    if (parse_oid_value(p, &object) < 0) {
+        free(object.description);
+        return;
+    }
+    add_object(p->tree, &object);
+}
+
+// Type assignment: Name ::= TEXTUAL-CONVENTION ... SYNTAX <type> | <type>
+static void parse_type_assignment(SMIParser *p, const char *name) {
+    SMILexer *lx = &p->lx;
+    SMISyntax syntax;
+
+    if (tok_is(lx, "TEXTUAL-CONVENTION")) {
+        lex_next(lx);
+        while (lx->type != SMI_TOK_EOF && !tok_is(lx, "SYNTAX")) {
+            lex_next(lx);
+        }
+        if (lx->type == SMI_TOK_EOF) {
+            parse_error(p, "TEXTUAL-CONVENTION without SYNTAX");
+            return;
+        }
+        lex_next(lx);
+    }
+
+    parse_type(lx, &syntax);
+    if (syntax.syntax[0] == '\0') {
+        parse_error(p, "Expected a type");
+        lex_next(lx);
+        return;
+    }
+
+    // 행 타입(SEQUENCE { ... })은 열 정의로 충분함
+    if (strcmp(syntax.syntax, "SEQUENCE") != 0 && strcmp(syntax.syntax, "CHOICE") != 0) {
+        add_type(p->tree, name, &syntax);
+    }
+}
+
+static void parse_assignment(SMIParser *p) {
+    SMILexer *lx = &p->lx;
+    char name[SMI_MAX_NAME];
+
+    if (lx->type != SMI_TOK_IDENT) {
+        parse_error(p, "Expected a definition");
+        lex_next(lx);
+        return;
+    }
+    strcpy(name, lx->text);
+    lex_next(lx);
+
+    if (lx->type == SMI_TOK_ASSIGN) {
+        lex_next(lx);
+        parse_type_assignment(p, name);
+    } else if (tok_is(lx, "MACRO")) {
+        // 매크로 정의 (SNMPv2-SMI 등)는 건너뜀
+        while (lx->type != SMI_TOK_EOF && !tok_is(lx, "END")) {
+            lex_next(lx);
+        }
+        lex_next(lx);
+    } else if (tok_is(lx, "OBJECT")) {
+        SMIObject object;
+
+        lex_next(lx);
+        if (!tok_is(lx, "IDENTIFIER")) {
+            parse_error(p, "Expected IDENTIFIER");
+            return;
+        }
+        lex_next(lx);
+        if (lx->type != SMI_TOK_ASSIGN) {
+            parse_error(p, "Expected ::=");
+            return;
+        }
+        lex_next(lx);
+
+        memset(&object, 0, sizeof(SMIObject));
+        strcpy(object.name, name);
+        strcpy(object.module, p->module);
+        strcpy(object.status, "current");
+        object.kind = SMI_KIND_NODE;
+        if (parse_oid_value(p, &object) == 0) {
+            add_object(p->tree, &object);
+        }
+    } else if (lx->type == SMI_TOK_IDENT) {
+        char macro[SMI_MAX_NAME];
+        strcpy(macro, lx->text);
+        parse_macro_value(p, name, macro);
+    } else {
+        parse_error(p, "Unexpected token");
+        lex_next(lx);
+    }
+}
+
+// IMPORTS a, b FROM MODULE-A c FROM MODULE-B ;
+static void parse_imports(SMIParser *p) {
+    SMILexer *lx = &p->lx;
+
+    while (lx->type != SMI_TOK_EOF && !tok_is(lx, ";")) {
+        if (tok_is(lx, "FROM")) {
+            lex_next(lx);
+            if (lx->type == SMI_TOK_IDENT) {
+                char module[SMI_MAX_NAME];
+                int line = lx->line;
+                strcpy(module, lx->text);
+                lex_next(lx);
+                if (smi_load_module(p->tree, module) < 0) {
+                    printf("%s:%d: Warning: imported module %s unavailable\n", lx->path, line, module);
+                }
+            }
+            continue;
+        }
+        lex_next(lx);
+    }
+    lex_next(lx);
+}
+
+// Module: NAME DEFINITIONS ::= BEGIN [IMPORTS ...;] [EXPORTS ...;] assignments END
+static int parse_module(SMIParser *p) {
+    SMILexer *lx = &p->lx;
+
+    if (lx->type != SMI_TOK_IDENT) {
+        parse_error(p, "Expected a module name");
+        return -1;
+    }
+    strcpy(p->module, lx->text);
+    lex_next(lx);
+
+    if (tok_is(lx, "{")) {
+        skip_balanced(lx);
+    }
+    if (!tok_is(lx, "DEFINITIONS")) {
+        parse_error(p, "Expected DEFINITIONS");
+        return -1;
+    }
+    lex_next(lx);
+    if (lx->type != SMI_TOK_ASSIGN) {
+        parse_error(p, "Expected ::=");
+        return -1;
+    }
+    lex_next(lx);
+    if (!tok_is(lx, "BEGIN")) {
+        parse_error(p, "Expected BEGIN");
+        return -1;
+    }
+    lex_next(lx);
+
+    mark_module(p->tree, p->module);
+
+    if (tok_is(lx, "IMPORTS")) {
+        lex_next(lx);
+        parse_imports(p);
+    }
+    if (tok_is(lx, "EXPORTS")) {
+        while (lx->type != SMI_TOK_EOF && !tok_is(lx, ";")) {
+            lex_next(lx);
+        }
+        lex_next(lx);
+    }
+
+    while (lx->type != SMI_TOK_EOF && !tok_is(lx, "END")) {
+        parse_assignment(p);
+    }
+    lex_next(lx);
+    return 0;
+}
+
+// Function to find the file of a module in the MIB directories (no suffix,
+// .txt, .mib or .my) or by path
+int smi_find_module_file(SMITree *tree, const char *name, char *path, size_t size) {
+    static const char *suffixes[] = { "", ".txt", ".mib", ".my", NULL };
+    struct stat st;
+
+    if (strchr(name, '/')) {
+        if (stat(name, &st) == 0 && S_ISREG(st.st_mode)) {
+            snprintf(path, size, "%s", name);
+            return 0;
+        }
+        return -1;
+    }
+
+    int dir_count = tree->path_count ? tree->path_count : 1;
+    for (int i = 0; i < dir_count; i++) {
+        const char *dir = tree->path_count ? tree->paths[i] : ".";
+        for (int j = 0; suffixes[j]; j++) {
+            snprintf(path, size, "%s/%s%s", dir, name, suffixes[j]);
+            if (stat(path, &st) == 0 && S_ISREG(st.st_mode)) {
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+// Function to compute the FNV-1a hash of a module file (MIB image staleness)
+int smi_hash_file(const char *path, unsigned int *hash) {
+    unsigned char buffer[4096];
+    size_t len;
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+
+    *hash = 2166136261u;
+    while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (size_t i = 0; i < len; i++) {
+            *hash ^= buffer[i];
+            *hash *= 16777619u;
+        }
+    }
+
+    int result = ferror(file) ? -1 : 0;
+    fclose(file);
+    return result;
+}
+
+static int load_file(SMITree *tree, const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *buffer = (char *)malloc(size > 0 ? size + 1 : 1);
+    if (!buffer) {
+        printf("Error: Memory allocation failed.\n");
+        fclose(file);
+        return -1;
+    }
+    size_t len = fread(buffer, 1, size > 0 ? size : 0, file);
+    buffer[len] = '\0';
+    fclose(file);
+
+    SMIParser parser;
+    memset(&parser, 0, sizeof(SMIParser));
+    parser.tree = tree;
+    parser.lx.path = path;
+    parser.lx.buf = buffer;
+    parser.lx.len = len;
+    parser.lx.line = 1;
+    lex_next(&parser.lx);
+
+    // 한 파일에 여러 모듈이 있을 수 있음
+    int result = 0;
+    while (parser.lx.type != SMI_TOK_EOF) {
+        if (parse_module(&parser) < 0) {
+            result = -1;
+            break;
+        }
+    }
+
+    free(buffer);
+    return result;
+}
+
+// Function to load a module by name (searched in the MIB directories with
+// no suffix, .txt, .mib or .my) or by path. Imported modules are loaded first.
+int smi_load_module(SMITree *tree, const char *name) {
+    char path[256];
+    struct stat st;
+
+    if (module_loaded(tree, name)) {
+        return 0;
+    }
+
+    if (smi_find_module_file(tree, name, path, sizeof(path)) < 0) {
+        for (int i = 0; smi_builtin_modules[i]; i++) {
+            if (strcmp(smi_builtin_modules[i], name) == 0) {
+                SMISource *source = mark_module(tree, name);
+                if (source) {
+                    source->requested = (tree->load_depth == 0);
+                }
+                return 0;
+            }
+        }
+        printf("Error: MIB module %s not found\n", name);
+        return -1;
+    }
+
+    // 순환 IMPORTS 방지를 위해 파싱 전에 등록
+    SMISource *source = mark_module(tree, name);
+    if (source) {
+        source->requested = (tree->load_depth == 0);
+        if (stat(path, &st) == 0 && smi_hash_file(path, &source->hash) == 0) {
+            source->mtime = st.st_mtime;
+            source->size = st.st_size;
+        }
+    }
+
+    tree->load_depth++;
+    int result = load_file(tree, path);
+    tree->load_depth--;
+    return result;
+}
+
+// --- OID 해석 및 분류 ---
+
+static int resolve_oid(SMITree *tree, SMIObject *object, int depth) {
+    int len = 0;
+
+    if (object->oid_len != 0) {
+        return object->oid_len;
+    }
+
+    if (object->parent[0]) {
+        SMIObject *parent = smi_find_object(tree, object->parent);
+        if (!parent) {
+            printf("Error: %s::%s: unknown parent %s\n", object->module, object->name, object->parent);
+            object->oid_len = -1;
+            return -1;
+        }
+        if (depth > SMI_MAX_SUBIDS || resolve_oid(tree, parent, depth + 1) < 0) {
+            object->oid_len = -1;
+            return -1;
+        }
+        memcpy(object->oid, parent->oid, parent->oid_len * sizeof(unsigned int));
+        len = parent->oid_len;
+    }
+
+    if (len + object->subid_count == 0 || len + object->subid_count > SMI_MAX_SUBIDS) {
+        printf("Error: %s::%s: invalid OID length\n", object->module, object->name);
+        object->oid_len = -1;
+        return -1;
+    }
+
+    memcpy(object->oid + len, object->subids, object->subid_count * sizeof(unsigned int));
+    object->oid_len = len + object->subid_count;
+    return object->oid_len;
+}
+
+// Function to follow textual conventions down to a base type.
+// A range found on the way is inherited if the object has none.
+static const char *resolve_base_type(SMITree *tree, const char *syntax, SMIObject *object) {
+    for (int depth = 0; depth < 16; depth++) {
+        for (int i = 0; smi_base_types[i]; i++) {
+            if (strcmp(smi_base_types[i], syntax) == 0) {
+                return smi_base_types[i];
+            }
+        }
+
+        SMIType *type = find_type(tree, syntax);
+        if (!type) {
+            return NULL;
+        }
+        if (!object->has_range && type->has_range) {
+            object->has_range = 1;
+            object->range_min = type->range_min;
+            object->range_max = type->range_max;
+        }
+        syntax = type->syntax;
+    }
+    return NULL;
+}
+
+static int is_object_type(const SMIObject *object) {
+    return object->kind == SMI_KIND_SCALAR || object->kind == SMI_KIND_TABLE ||
+           object->kind == SMI_KIND_ROW || object->kind == SMI_KIND_COLUMN;
+}
+
+// Function to resolve every OID and classify OBJECT-TYPEs into
+// scalars, tables, rows and columns. Returns -1 if an OID is unresolvable.
+int smi_resolve(SMITree *tree) {
+    int failed = 0;
+
+    if (tree->resolved) {
+        return 0;
+    }
+
+    for (int i = 0; i < tree->object_count; i++) {
+        if (resolve_oid(tree, &tree->objects[i], 0) < 0) {
+            failed++;
+        }
+    }
+
+    for (int i = 0; i < tree->object_count; i++) {
+        SMIObject *object = &tree->objects[i];
+
+        if (!is_object_type(object)) {
+            continue;
+        }
+
+        if (object->sequence_of) {
+            object->kind = SMI_KIND_TABLE;
+        } else if (object->index_count > 0 || object->augments[0]) {
+            object->kind = SMI_KIND_ROW;
+        } else {
+            object->kind = SMI_KIND_SCALAR;
+        }
+
+        // 테이블/행의 SYNTAX는 SEQUENCE 타입
+        if (object->kind == SMI_KIND_SCALAR && object->base_type[0] == '\0' && object->syntax[0]) {
+            const char *base = resolve_base_type(tree, object->syntax, object);
+            if (base) {
+                strcpy(object->base_type, base);
+            } else {
+                printf("Error: %s::%s: unknown type %s\n", object->module, object->name, object->syntax);
+            }
+        }
+    }
+
+    // 행 바로 아래의 OBJECT-TYPE은 열
+    for (int i = 0; i < tree->object_count; i++) {
+        SMIObject *object = &tree->objects[i];
+
+        if (object->kind == SMI_KIND_SCALAR && object->subid_count == 1) {
+            SMIObject *parent = smi_find_object(tree, object->parent);
+            if (parent && parent->kind == SMI_KIND_ROW) {
+                object->kind = SMI_KIND_COLUMN;
+            }
+        }
+    }
+
+    tree->resolved = 1;
+    return failed ? -1 : 0;
+}
+
+// Function to format a resolved OID as a dotted string
+int smi_oid_to_string(const SMIObject *object, char *oid_str, size_t size) {
+    size_t pos = 0;
+
+    if (object->oid_len <= 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < object->oid_len; i++) {
+        int n = snprintf(oid_str + pos, size - pos, i ? ".%u" : "%u", object->oid[i]);
+        if (n < 0 || (size_t)n >= size - pos) {
+            return -1;
+        }
+        pos += n;
+    }
+    return (int)pos;
+}
+
+static int compare_objects(const void *a, const void *b) {
+    const SMIObject *oa = *(const SMIObject * const *)a;
+    const SMIObject *ob = *(const SMIObject * const *)b;
+    int min_len = oa->oid_len < ob->oid_len ? oa->oid_len : ob->oid_len;
+
+    for (int i = 0; i < min_len; i++) {
+        if (oa->oid[i] != ob->oid[i]) {
+            return oa->oid[i] < ob->oid[i] ? -1 : 1;
+        }
+    }
+    return oa->oid_len - ob->oid_len;
+}
+
+// Function to collect the objects served as scalars (accessible, current,
+// resolved), sorted by OID. Returns the count, *objects is freed by the caller.
+int smi_collect_scalars(SMITree *tree, SMIObject ***objects) {
+    int count = 0;
+
+    smi_resolve(tree);
+
+    *objects = (SMIObject **)malloc((tree->object_count + 1) * sizeof(SMIObject *));
+    if (!*objects) {
+        printf("Error: Memory allocation failed.\n");
+        return -1;
+    }
+
+    for (int i = 0; i < tree->object_count; i++) {
+        SMIObject *object = &tree->objects[i];
+
+        // SMIv1 "mandatory"는 SMIv2 "current"에 해당
+        // (OID가 MIBNode에 들어가지 않는 객체는 등록하는 쪽에서 오류로 보고)
+        if (object->kind == SMI_KIND_SCALAR && object->access >= SMI_ACCESS_READ_ONLY &&
+            (strcmp(object->status, "current") == 0 || strcmp(object->status, "mandatory") == 0) &&
+            object->oid_len > 0) {
+            (*objects)[count++] = object;
+        }
+    }
+    qsort(*objects, count, sizeof(SMIObject *), compare_objects);
+    return count;
+}
+
+// Function to get the type name used to pick the stored value type
+const char *smi_value_type_name(const SMIObject *object) {
+    return object->base_type[0] ? object->base_type : object->syntax;
+}
+
+// Function to convert an object's DEFVAL to a MIB value. Returns 1 if set;
+// enumeration labels and unresolvable OID names leave the value zeroed.
+int smi_default_value(SMITree *tree, const SMIObject *object, MIBValue *value) {
+    char *end;
+
+    memset(value, 0, sizeof(MIBValue));
+    if (!object->has_defval) {
+        return 0;
+    }
+
+    switch (mib_value_type(smi_value_type_name(object))) {
+        case VALUE_TYPE_INT:
+            value->int_value = (int)strtol(object->defval, &end, 10);
+            return *end == '\0';
+        case VALUE_TYPE_TIME_TICKS:
+            value->ticks_value = strtoul(object->defval, &end, 10);
+            return *end == '\0';
+        case VALUE_TYPE_COUNTER32:
+        case VALUE_TYPE_GAUGE32:
+            value->uint_value = (unsigned int)strtoul(object->defval, &end, 10);
+            return *end == '\0';
+        case VALUE_TYPE_COUNTER64:
+            value->counter64_value = strtoull(object->defval, &end, 10);
+            return *end == '\0';
+        case VALUE_TYPE_OID: {
+            SMIObject *target = smi_find_object(tree, object->defval);
+            if (!target || smi_resolve(tree) < 0 ||
+                smi_oid_to_string(target, value->oid_value, sizeof(value->oid_value)) < 0) {
+                memset(value, 0, sizeof(MIBValue));
+                return 0;
+            }
+            return 1;
+        }
+        default:
+            strncpy(value->str_value, object->defval, sizeof(value->str_value) - 1);
+            return 1;
+    }
+}
+
+// Function to register every accessible scalar in the agent MIB tree, in OID order.
+// Scalars keep the plain object OID (no ".0" instance suffix) like the camera
+// nodes always did. Nodes already registered by the agent are left alone.
+int smi_register_objects(SMITree *tree, MIBTree *mib_tree) {
+    SMIObject **objects;
+    int registered = 0;
+    int count = smi_collect_scalars(tree, &objects);
+
+    if (count < 0) {
+        return -1;
+    }
+
+    mib_tree_bulk_begin(mib_tree);
+    for (int i = 0; i < count; i++) {
+        SMIObject *object = objects[i];
+        char oid_str[sizeof(((MIBNode *)0)->oid)];
+        MIBValue value;
+
+        if (smi_oid_to_string(object, oid_str, sizeof(oid_str)) < 0) {
+            printf("Error: OID of %s is too long, object not registered.\n", object->name);
+            continue;
+        }
+        if (find_mib_node_by_oid(mib_tree, oid_str)) {
+            continue;
+        }
+
+        int writable = (object->access == SMI_ACCESS_READ_WRITE || object->access == SMI_ACCESS_READ_CREATE);
+        int has_default = smi_default_value(tree, object, &value);
+
+        // MIBValue의 모든 멤버는 같은 주소에서 시작
+        MIBNode *node = add_mib_node(mib_tree, object->name, oid_str, smi_value_type_name(object),
+                                     writable ? HANDLER_CAN_RWRITE : HANDLER_CAN_RONLY, "current",
+                                     has_default ? (const void *)&value : NULL, NULL);
+        if (node) {
+            // SET 검사에 쓰는 SYNTAX 범위/SIZE 제약
+            node->has_range = object->has_range;
+            node->range_min = object->range_min;
+            node->range_max = object->range_max;
+            registered++;
+        }
+    }
+    registered -= mib_tree_bulk_end(mib_tree);
+
+    free(objects);
+    return registered;
+}
+
+void smi_free(SMITree *tree) {
+    for (int i = 0; i < tree->object_count; i++) {
+        free(tree->objects[i].description);
+    }
+    free(tree->objects);
+    free(tree->hash);
+    free(tree->types);
+    memset(tree, 0, sizeof(SMITree));
+}
@@ -0,0 +1,346 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_table.h"  // Conceptual tables
+#include "snmp_stats.h"  // Agent counters
+
+SNMPStatsSlot snmp_stats_slots[STATS_MAX_THREADS];
+__thread SNMPStatsSlot *snmp_stats_slot;
+
+static int stats_thread_count;
+static const SNMPAgentStats *agent_stats;
+
+// 히스토그램 구간 상한 (us), 마지막 구간은 상한 없음
+static const unsigned int stage_bounds[STATS_BUCKETS] = { 10, 25, 50, 100, 250, 500, 1000, 0 };
+
+static const char *pdu_names[STATS_PDU_TYPES] = {
+    "get", "getNext", "response", "set", "trap", "getBulk", "inform", "snmpV2Trap", "report"
+};
+
+// Function to give the calling thread its own counter slot. Threads beyond
+// STATS_MAX_THREADS share the last slot (their increments may race).
+SNMPStatsSlot *stats_attach_thread(void) {
+    int slot = __atomic_fetch_add(&stats_thread_count, 1, __ATOMIC_RELAXED);
+
+    if (slot >= STATS_MAX_THREADS) {
+        slot = STATS_MAX_THREADS - 1;
+    }
+    snmp_stats_slot = &snmp_stats_slots[slot];
+    return snmp_stats_slot;
+}
+
+void stats_record_stage(StatsStage stage, long long elapsed_us) {
+    int bucket = 0;
+
+    while (bucket < STATS_BUCKETS - 1 && elapsed_us > stage_bounds[bucket]) {
+        bucket++;
+    }
+    stats_thread_slot()->histogram[stage][bucket]++;
+}
+
+void stats_record_pdu(unsigned char pdu_type, long long elapsed_us) {
+    int type = pdu_type - 0xA0;
+
+    if (type < 0 || type >= STATS_PDU_TYPES) {
+        return;
+    }
+
+    SNMPStatsSlot *slot = stats_thread_slot();
+    slot->pdu_count[type]++;
+    slot->pdu_time_us[type] += elapsed_us > 0 ? elapsed_us : 0;
+}
+
+// Function to add up one counter over every thread slot
+unsigned long stats_read(StatsCounter counter) {
+    unsigned long sum = 0;
+
+    for (int i = 0; i < STATS_MAX_THREADS; i++) {
+        sum += __atomic_load_n(&snmp_stats_slots[i].counters[counter], __ATOMIC_RELAXED);
+    }
+    return sum;
+}
+
+// --- SNMPv2-MIB snmp group ---
+
+typedef struct {
+    unsigned int subid;
+    const char *name;
+    StatsCounter counter;
+} StatsObject;
+
+static const StatsObject snmp_group[] = {
+    {  1, "snmpInPkts",              STATS_IN_PKTS },
+    {  2, "snmpOutPkts",             STATS_OUT_PKTS },
+    {  3, "snmpInBadVersions",       STATS_IN_BAD_VERSIONS },
+    {  4, "snmpInBadCommunityNames", STATS_IN_BAD_COMMUNITY_NAMES },
+    {  5, "snmpInBadCommunityUses",  STATS_IN_BAD_COMMUNITY_USES },
+    {  6, "snmpInASNParseErrs",      STATS_IN_ASN_PARSE_ERRS },
+    {  8, "snmpInTooBigs",           STATS_IN_TOO_BIGS },
+    {  9, "snmpInNoSuchNames",       STATS_IN_NO_SUCH_NAMES },
+    { 10, "snmpInBadValues",         STATS_IN_BAD_VALUES },
+    { 11, "snmpInReadOnlys",         STATS_IN_READ_ONLYS },
+    { 12, "snmpInGenErrs",           STATS_IN_GEN_ERRS },
+    { 13, "snmpInTotalReqVars",      STATS_IN_TOTAL_REQ_VARS },
+    { 14, "snmpInTotalSetVars",      STATS_IN_TOTAL_SET_VARS },
+    { 15, "snmpInGetRequests",       STATS_IN_GET_REQUESTS },
+    { 16, "snmpInGetNexts",          STATS_IN_GET_NEXTS },
+    { 17, "snmpInSetRequests",       STATS_IN_SET_REQUESTS },
+    { 18, "snmpInGetResponses",      STATS_IN_GET_RESPONSES },
+    { 19, "snmpInTraps",             STATS_IN_TRAPS },
+    { 20, "snmpOutTooBigs",          STATS_OUT_TOO_BIGS },
+    { 21, "snmpOutNoSuchNames",      STATS_OUT_NO_SUCH_NAMES },
+    { 22, "snmpOutBadValues",        STATS_OUT_BAD_VALUES },
+    { 24, "snmpOutGenErrs",          STATS_OUT_GEN_ERRS },
+    { 25, "snmpOutGetRequests",      STATS_OUT_GET_REQUESTS },
+    { 26, "snmpOutGetNexts",         STATS_OUT_GET_NEXTS },
+    { 27, "snmpOutSetRequests",      STATS_OUT_SET_REQUESTS },
+    { 28, "snmpOutGetResponses",     STATS_OUT_GET_RESPONSES },
+    { 29, "snmpOutTraps",            STATS_OUT_TRAPS },
+    { 31, "snmpSilentDrops",         STATS_SILENT_DROPS },
+    { 32, "snmpProxyDrops",          STATS_PROXY_DROPS },
+};
+
+static void snmp_group_read(const MIBNode *node, MIBValue *value) {
+    const StatsObject *object = (const StatsObject *)node->read_ctx;
+    value->uint_value = (unsigned int)stats_read(object->counter);
+}
+
+// --- agentInfo 스칼라 (캐시, 요청 수 제한) ---
+
+static unsigned int cache_hits(const SNMPAgentStats *stats) {
+    return (unsigned int)stats->cache->hits;
+}
+
+static unsigned int cache_misses(const SNMPAgentStats *stats) {
+    return (unsigned int)stats->cache->misses;
+}
+
+static unsigned int cache_invalidations(const SNMPAgentStats *stats) {
+    return (unsigned int)stats->cache->invalidations;
+}
+
+// Hits per 10000 lookups (hundredths of a percent)
+static unsigned int cache_hit_ratio(const SNMPAgentStats *stats) {
+    unsigned long long lookups = (unsigned long long)stats->cache->hits + stats->cache->misses;
+    return lookups ? (unsigned int)(stats->cache->hits * 10000ULL / lookups) : 0;
+}
+
+static unsigned int rate_limit_drops(const SNMPAgentStats *stats) {
+    return (unsigned int)stats->limiter->drop_count;
+}
+
+static unsigned int rate_limit_evictions(const SNMPAgentStats *stats) {
+    return (unsigned int)stats->limiter->evict_count;
+}
+
+typedef struct {
+    unsigned int subid;
+    const char *name;
+    const char *type;
+    unsigned int (*read)(const SNMPAgentStats *stats);
+} AgentScalar;
+
+static const AgentScalar agent_scalars[] = {
+    { 4, "agentCacheHits",          "Counter32", cache_hits },
+    { 5, "agentCacheMisses",        "Counter32", cache_misses },
+    { 6, "agentCacheInvalidations", "Counter32", cache_invalidations },
+    { 7, "agentCacheHitRatio",      "Gauge32",   cache_hit_ratio },
+    { 8, "agentRateLimitDrops",     "Counter32", rate_limit_drops },
+    { 9, "agentRateLimitEvictions", "Counter32", rate_limit_evictions },
+};
+
+static void agent_scalar_read(const MIBNode *node, MIBValue *value) {
+    const AgentScalar *scalar = (const AgentScalar *)node->read_ctx;
+    value->uint_value = scalar->read(agent_stats);
+}
+
+// --- agentInfo 테이블 ---
+
+// agentPduTable 열 (인덱스: PDU 태그 - 0xA0)
+static int pdu_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    int type = (int)row->index[0];
+    unsigned long count = 0;
+    unsigned long long time_us = 0;
+
+    for (int i = 0; i < STATS_MAX_THREADS; i++) {
+        count += __atomic_load_n(&snmp_stats_slots[i].pdu_count[type], __ATOMIC_RELAXED);
+        time_us += __atomic_load_n(&snmp_stats_slots[i].pdu_time_us[type], __ATOMIC_RELAXED);
+    }
+
+    switch (column) {
+        case 1: value->int_value = type; break;                                 // agentPduType
+        case 2: strcpy(value->str_value, pdu_names[type]); break;               // agentPduName
+        case 3: value->uint_value = (unsigned int)count; break;                 // agentPduCount
+        case 4: value->counter64_value = time_us; break;                        // agentPduTime
+        default: return -1;
+    }
+    return 0;
+}
+
+// agentLatencyTable 열 (인덱스: 단계, 구간)
+static int latency_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    int stage = (int)row->index[0] - 1;
+    int bucket = (int)row->index[1] - 1;
+    unsigned long count = 0;
+
+    switch (column) {
+        case 1: value->int_value = stage + 1; break;                            // agentLatencyStage
+        case 2: value->int_value = bucket + 1; break;                           // agentLatencyBucket
+        case 3: value->uint_value = stage_bounds[bucket]; break;                // agentLatencyBound
+        case 4:                                                                 // agentLatencyCount
+            for (int i = 0; i < STATS_MAX_THREADS; i++) {
+                count += __atomic_load_n(&snmp_stats_slots[i].histogram[stage][bucket], __ATOMIC_RELAXED);
+            }
+            value->uint_value = (unsigned int)count;
+            break;
+        default:
+            return -1;
+    }
+    return 0;
+}
+
+// agentQueueTable 열 (인덱스: 스케줄러 클래스 + 1)
+static int queue_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const SchedQueue *queue = &agent_stats->sched->queues[row->index[0] - 1];
+
+    switch (column) {
+        case 1: value->int_value = (int)row->index[0]; break;                   // agentQueueClass
+        case 2: value->uint_value = queue->count; break;                        // agentQueueDepth
+        case 3: value->uint_value = queue->max_depth; break;                    // agentQueueMaxDepth
+        case 4: value->uint_value = (unsigned int)queue->served_count; break;   // agentQueueServed
+        case 5: value->uint_value = (unsigned int)queue->drop_count; break;     // agentQueueDrops
+        case 6:                                                                 // agentQueueLatencyAvg
+            value->uint_value = queue->served_count ?
+                                (unsigned int)(queue->latency_total_us / queue->served_count) : 0;
+            break;
+        case 7: value->uint_value = (unsigned int)queue->latency_max_us; break; // agentQueueLatencyMax
+        default: return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    unsigned int subid;
+    const char *name;
+    const char *type;
+} StatsColumn;
+
+static const StatsColumn pdu_columns[] = {
+    { 1, "agentPduType",  "Integer32" },
+    { 2, "agentPduName",  "DisplayString" },
+    { 3, "agentPduCount", "Counter32" },
+    { 4, "agentPduTime",  "Counter64" },
+};
+
+static const StatsColumn latency_columns[] = {
+    { 1, "agentLatencyStage",  "INTEGER" },
+    { 2, "agentLatencyBucket", "Integer32" },
+    { 3, "agentLatencyBound",  "Gauge32" },
+    { 4, "agentLatencyCount",  "Counter32" },
+};
+
+static const StatsColumn queue_columns[] = {
+    { 1, "agentQueueClass",      "INTEGER" },
+    { 2, "agentQueueDepth",      "Gauge32" },
+    { 3, "agentQueueMaxDepth",   "Gauge32" },
+    { 4, "agentQueueServed",     "Counter32" },
+    { 5, "agentQueueDrops",      "Counter32" },
+    { 6, "agentQueueLatencyAvg", "Gauge32" },
+    { 7, "agentQueueLatencyMax", "Gauge32" },
+};
+
+static int register_table(MIBTree *mib_tree, MIBTable *table, const char *name, unsigned int subid,
+                          const MIBIndexType *index_types, int index_count,
+                          const StatsColumn *columns, int column_count, MIBColumnHandler handler) {
+    char oid[64];
+
+    snprintf(oid, sizeof(oid), "%s.%u.1", STATS_AGENT_OID, subid);
+    if (mib_table_init(table, name, oid, index_types, index_count) < 0) {
+        return -1;
+    }
+    for (int i = 0; i < column_count; i++) {
+        mib_table_add_column(table, columns[i].subid, columns[i].name, columns[i].type, handler);
+    }
+    return mib_table_register(mib_tree, table) ? 0 : -1;
+}
+
+// Function to attach a read handler to a counter, reusing the node if the
+// MIB module already registered the object
+static int register_counter(MIBTree *mib_tree, const char *name, const char *oid, const char *type,
+                            MIBReadHandler handler, const void *ctx) {
+    MIBNode *node = find_mib_node_by_oid(mib_tree, oid);
+
+    if (!node) {
+        node = add_mib_node(mib_tree, name, oid, type, HANDLER_CAN_RONLY, "current", NULL, NULL);
+    }
+    if (!node) {
+        return -1;
+    }
+    node->read_handler = handler;
+    node->read_ctx = (void *)ctx;
+    return 0;
+}
+
+// Function to register the snmp group and the agentInfo subtree
+int stats_init(SNMPAgentStats *stats, MIBTree *mib_tree, const SNMPResponseCache *cache,
+               const SNMPRateLimiter *limiter, const SNMPScheduler *sched) {
+    MIBIndexType one_index = MIB_INDEX_INTEGER;
+    MIBIndexType two_indexes[2] = { MIB_INDEX_INTEGER, MIB_INDEX_INTEGER };
+    char oid[64];
+    int disabled = 2;
+
+    memset(stats, 0, sizeof(SNMPAgentStats));
+    stats->cache = cache;
+    stats->limiter = limiter;
+    stats->sched = sched;
+    agent_stats = stats;
+
+    for (size_t i = 0; i < sizeof(snmp_group) / sizeof(snmp_group[0]); i++) {
+        snprintf(oid, sizeof(oid), "%s.%u.0", STATS_SNMP_GROUP_OID, snmp_group[i].subid);
+        register_counter(mib_tree, snmp_group[i].name, oid, "Counter32", snmp_group_read, &snmp_group[i]);
+    }
+
+    // authenticationFailure 트랩은 보내지 않음
+    snprintf(oid, sizeof(oid), "%s.30.0", STATS_SNMP_GROUP_OID);
+    add_mib_node(mib_tree, "snmpEnableAuthenTraps", oid, "INTEGER", HANDLER_CAN_RONLY, "current", &disabled, NULL);
+
+    for (size_t i = 0; i < sizeof(agent_scalars) / sizeof(agent_scalars[0]); i++) {
+        snprintf(oid, sizeof(oid), "%s.%u", STATS_AGENT_OID, agent_scalars[i].subid);
+        register_counter(mib_tree, agent_scalars[i].name, oid, agent_scalars[i].type, agent_scalar_read,
+                         &agent_scalars[i]);
+    }
+
+    if (register_table(mib_tree, &stats->pdu_table, "agentPduEntry", 1, &one_index, 1,
+                       pdu_columns, sizeof(pdu_columns) / sizeof(pdu_columns[0]), pdu_column) < 0 ||
+        register_table(mib_tree, &stats->latency_table, "agentLatencyEntry", 2, two_indexes, 2,
+                       latency_columns, sizeof(latency_columns) / sizeof(latency_columns[0]), latency_column) < 0 ||
+        register_table(mib_tree, &stats->queue_table, "agentQueueEntry", 3, &one_index, 1,
+                       queue_columns, sizeof(queue_columns) / sizeof(queue_columns[0]), queue_column) < 0) {
+        return -1;
+    }
+
+    for (int type = 0; type < STATS_PDU_TYPES; type++) {
+        MIBIndexValue index = { .int_value = (unsigned int)type };
+        mib_table_add_row(&stats->pdu_table, &index, stats);
+    }
+    for (int stage = 1; stage <= STATS_STAGES; stage++) {
+        for (int bucket = 1; bucket <= STATS_BUCKETS; bucket++) {
+            MIBIndexValue index[2] = { { .int_value = (unsigned int)stage }, { .int_value = (unsigned int)bucket } };
+            mib_table_add_row(&stats->latency_table, index, stats);
+        }
+    }
+    for (int class = 1; class <= SCHED_CLASSES; class++) {
+        MIBIndexValue index = { .int_value = (unsigned int)class };
+        mib_table_add_row(&stats->queue_table, &index, stats);
+    }
+    return 0;
+}
+
+void stats_close(SNMPAgentStats *stats) {
+    mib_table_free(&stats->pdu_table);
+    mib_table_free(&stats->latency_table);
+    mib_table_free(&stats->queue_table);
+    agent_stats = NULL;
+}
@@ -0,0 +1,471 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_store.h"  // Write-behind store
+
+// 레코드 형식: [oid 길이:1][값 타입:1][값 길이:2 (LE)][oid 문자열][값][CRC32:4 (LE)]
+// CRC는 헤더부터 값까지 (버전 1 파일에는 없음)
+#define STORE_RECORD_HEADER  4
+#define STORE_RECORD_CRC     4
+
+// Function to compute the CRC32 (IEEE 802.3) of a record
+static unsigned int record_crc32(const unsigned char *data, int len) {
+    unsigned int crc = 0xFFFFFFFFu;
+
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// Function to write a whole buffer, retrying on short writes
+static int write_all(int fd, const unsigned char *data, int len) {
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += written;
+        len -= written;
+    }
+    return 0;
+}
+
+// Function to encode the current value of a node as a journal record.
+// Returns the record length, or -1 if it does not fit in size.
+static int encode_record(const MIBNode *node, unsigned char *buf, int size) {
+    MIBValue value;
+    unsigned char value_buf[sizeof(MIBValue)];
+    int oid_len = strlen(node->oid);
+    int value_len = 0;
+
+    mib_node_read_value(node, &value);
+
+    switch (node->value_type) {
+        case VALUE_TYPE_INT:
+        case VALUE_TYPE_TIME_TICKS:
+        case VALUE_TYPE_COUNTER32:
+        case VALUE_TYPE_GAUGE32: {
+            unsigned int v = (node->value_type == VALUE_TYPE_INT) ? (unsigned int)value.int_value
+                           : (node->value_type == VALUE_TYPE_TIME_TICKS) ? (unsigned int)value.ticks_value
+                           : value.uint_value;
+            for (int i = 0; i < 4; i++) {
+                value_buf[i] = (v >> (8 * i)) & 0xFF;
+            }
+            value_len = 4;
+            break;
+        }
+        case VALUE_TYPE_COUNTER64:
+            for (int i = 0; i < 8; i++) {
+                value_buf[i] = (value.counter64_value >> (8 * i)) & 0xFF;
+            }
+            value_len = 8;
+            break;
+        case VALUE_TYPE_STRING:
+            value_len = strlen(value.str_value);
+            memcpy(value_buf, value.str_value, value_len);
+            break;
+        case VALUE_TYPE_OID:
+            value_len = strlen(value.oid_value);
+            memcpy(value_buf, value.oid_value, value_len);
+            break;
+        case VALUE_TYPE_OCTETS:
+            value_len = (value.octets.len >= 0 && value.octets.len <= MIB_OCTETS_MAX) ? value.octets.len : 0;
+            memcpy(value_buf, value.octets.data, value_len);
+            break;
+    }
+
+    int data_len = STORE_RECORD_HEADER + oid_len + value_len;
+    if (oid_len > 255 || data_len + STORE_RECORD_CRC > size) {
+        return -1;
+    }
+
+    buf[0] = oid_len;
+    buf[1] = node->value_type;
+    buf[2] = value_len & 0xFF;
+    buf[3] = (value_len >> 8) & 0xFF;
+    memcpy(buf + STORE_RECORD_HEADER, node->oid, oid_len);
+    memcpy(buf + STORE_RECORD_HEADER + oid_len, value_buf, value_len);
+
+    unsigned int crc = record_crc32(buf, data_len);
+    for (int i = 0; i < STORE_RECORD_CRC; i++) {
+        buf[data_len + i] = (crc >> (8 * i)) & 0xFF;
+    }
+
+    return data_len + STORE_RECORD_CRC;
+}
+
+// Function to apply one decoded record to the MIB tree
+static int apply_record(MIBTree *mib_tree, const unsigned char *record, int oid_len,
+                        int value_type, int value_len) {
+    char oid[sizeof(((MIBNode *)0)->oid)];
+    MIBValue value;
+
+    if (oid_len >= (int)sizeof(oid)) {
+        printf("Error: Persisted record with a %d byte OID rejected (at most %d).\n",
+               oid_len, (int)sizeof(oid) - 1);
+        return -1;
+    }
+    memcpy(oid, record + STORE_RECORD_HEADER, oid_len);
+    oid[oid_len] = '\0';
+
+    MIBNode *node = find_mib_node_by_oid(mib_tree, oid);
+    if (node == NULL || !node->isWritable || (int)node->value_type != value_type) {
+        printf("Persisted value for %s ignored (unknown or incompatible object)\n", oid);
+        return -1;
+    }
+
+    const unsigned char *data = record + STORE_RECORD_HEADER + oid_len;
+    memset(&value, 0, sizeof(MIBValue));
+
+    switch (value_type) {
+        case VALUE_TYPE_INT:
+        case VALUE_TYPE_TIME_TICKS:
+        case VALUE_TYPE_COUNTER32:
+        case VALUE_TYPE_GAUGE32: {
+            if (value_len != 4) {
+                return -1;
+            }
+            unsigned int v = data[0] | (data[1] << 8) | (data[2] << 16) | ((unsigned int)data[3] << 24);
+            if (value_type == VALUE_TYPE_INT) {
+                value.int_value = (int)v;
+            } else if (value_type == VALUE_TYPE_TIME_TICKS) {
+                value.ticks_value = v;
+            } else {
+                value.uint_value = v;
+            }
+            break;
+        }
+        case VALUE_TYPE_COUNTER64:
+            if (value_len != 8) {
+                return -1;
+            }
+            for (int i = 7; i >= 0; i--) {
+                value.counter64_value = (value.counter64_value << 8) | data[i];
+            }
+            break;
+        case VALUE_TYPE_OCTETS:
+            if (value_len > MIB_OCTETS_MAX) {
+                return -1;
+            }
+            memcpy(value.octets.data, data, value_len);
+            value.octets.len = value_len;
+            break;
+        case VALUE_TYPE_STRING:
+        case VALUE_TYPE_OID:
+            if (value_len >= (int)sizeof(value.str_value)) {
+                return -1;
+            }
+            memcpy(value.str_value, data, value_len);
+            break;
+        default:
+            return -1;
+    }
+
+    mib_node_write_value(node, &value);
+    return 0;
+}
+
+// Function to load a snapshot or journal file into the MIB tree.
+// The file is read with a single read(); replay stops at a truncated record
+// (crash during append) or at the first record that fails its CRC, and
+// *damaged is set so the caller compacts the rest away.
+// Returns the number of records, -1 on error.
+static int load_file(MIBTree *mib_tree, const char *path, const char *magic, const char *magic_v1,
+                     int *damaged) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return (errno == ENOENT) ? 0 : -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < STORE_MAGIC_LEN) {
+        close(fd);
+        return -1;
+    }
+
+    unsigned char *data = malloc(st.st_size);
+    if (data == NULL) {
+        close(fd);
+        return -1;
+    }
+
+    long total = 0;
+    while (total < st.st_size) {
+        ssize_t n = read(fd, data + total, st.st_size - total);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        total += n;
+    }
+    close(fd);
+
+    int crc_len = STORE_RECORD_CRC;
+    if (total >= STORE_MAGIC_LEN && memcmp(data, magic_v1, STORE_MAGIC_LEN) == 0) {
+        crc_len = 0;
+    } else if (total < STORE_MAGIC_LEN || memcmp(data, magic, STORE_MAGIC_LEN) != 0) {
+        printf("Error: %s is not a valid store file.\n", path);
+        free(data);
+        *damaged = 1;
+        return -1;
+    }
+
+    int count = 0;
+    long index = STORE_MAGIC_LEN;
+    while (index + STORE_RECORD_HEADER <= total) {
+        const unsigned char *record = data + index;
+        int oid_len = record[0];
+        int value_type = record[1];
+        int value_len = record[2] | (record[3] << 8);
+        long data_len = STORE_RECORD_HEADER + oid_len + value_len;
+
+        if (index + data_len + crc_len > total) {
+            break;
+        }
+
+        if (crc_len > 0) {
+            const unsigned char *stored = record + data_len;
+            unsigned int crc = stored[0] | (stored[1] << 8) | (stored[2] << 16) | ((unsigned int)stored[3] << 24);
+            if (crc != record_crc32(record, data_len)) {
+                printf("Warning: %s record %d fails its CRC, replay stopped.\n", path, count + 1);
+                break;
+            }
+        }
+
+        apply_record(mib_tree, record, oid_len, value_type, value_len);
+        index += data_len + crc_len;
+        count++;
+    }
+
+    if (index != total) {
+        printf("Warning: %s has %ld bytes after the last good record (ignored).\n", path, total - index);
+        *damaged = 1;
+    }
+
+    free(data);
+    return count;
+}
+
+// Function to (re)create an empty journal for append
+static int reset_journal(SNMPStore *store) {
+    if (store->journal_fd >= 0) {
+        close(store->journal_fd);
+    }
+
+    store->journal_fd = open(store->config.journal_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0600);
+    if (store->journal_fd < 0) {
+        perror("open journal");
+        return -1;
+    }
+
+    if (write_all(store->journal_fd, (const unsigned char *)STORE_JOURNAL_MAGIC, STORE_MAGIC_LEN) < 0 ||
+        fdatasync(store->journal_fd) < 0) {
+        perror("write journal");
+        return -1;
+    }
+
+    store->journal_size = STORE_MAGIC_LEN;
+    return 0;
+}
+
+// Function to write every writable object into a new snapshot and empty the journal.
+// The snapshot is written to a temporary file and renamed, so a crash leaves
+// either the old snapshot + journal or the new snapshot.
+int store_compact(SNMPStore *store) {
+    char tmp_path[sizeof(store->config.snapshot_path) + 4];
+    unsigned char buf[4096];
+    int len = 0;
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", store->config.snapshot_path);
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        perror("open snapshot");
+        return -1;
+    }
+
+    memcpy(buf, STORE_SNAPSHOT_MAGIC, STORE_MAGIC_LEN);
+    len = STORE_MAGIC_LEN;
+
+    int count = 0;
+    int failed = 0;
+    MIBTree *mib_tree = store->mib_tree;
+    for (int i = 0; i < mib_tree->node_count && !failed; i++) {
+        MIBNode *node = mib_tree->nodes[i];
+        if (!node->isWritable) {
+            continue;
+        }
+
+        int record_len = encode_record(node, buf + len, sizeof(buf) - len);
+        if (record_len < 0) {
+            if (write_all(fd, buf, len) < 0) {
+                failed = 1;
+                break;
+            }
+            len = 0;
+            record_len = encode_record(node, buf, sizeof(buf));
+        }
+        if (record_len > 0) {
+            len += record_len;
+            count++;
+        }
+    }
+
+    if (failed || write_all(fd, buf, len) < 0 || fsync(fd) < 0) {
+        perror("write snapshot");
+        close(fd);
+        unlink(tmp_path);
+        return -1;
+    }
+    close(fd);
+
+    if (rename(tmp_path, store->config.snapshot_path) < 0) {
+        perror("rename snapshot");
+        unlink(tmp_path);
+        return -1;
+    }
+
+    // 스냅샷에 현재 값이 모두 포함되므로 대기 중인 레코드도 버림
+    store->pending_len = 0;
+    store->compact_needed = 0;
+    printf("Store compacted: %d objects in %s\n", count, store->config.snapshot_path);
+
+    return reset_journal(store);
+}
+
+// MIBTree commit hook
+static void store_commit_hook(void *ctx, MIBNode *node) {
+    store_record_set((SNMPStore *)ctx, node);
+}
+
+// Function to load the snapshot and journal into the tree and start journaling.
+// Call before the agent socket is bound so the first request sees persisted values.
+int store_open(SNMPStore *store, const SNMPStoreConfig *config, MIBTree *mib_tree) {
+    memset(store, 0, sizeof(SNMPStore));
+    store->config = *config;
+    store->mib_tree = mib_tree;
+    store->journal_fd = -1;
+
+    if (!config->enabled) {
+        return 0;
+    }
+
+    int damaged = 0;
+    int snapshot_records = load_file(mib_tree, config->snapshot_path, STORE_SNAPSHOT_MAGIC,
+                                     STORE_SNAPSHOT_MAGIC_V1, &damaged);
+    int journal_records = load_file(mib_tree, config->journal_path, STORE_JOURNAL_MAGIC,
+                                    STORE_JOURNAL_MAGIC_V1, &damaged);
+
+    printf("Store loaded: %d snapshot records, %d journal records\n",
+           snapshot_records < 0 ? 0 : snapshot_records, journal_records < 0 ? 0 : journal_records);
+
+    // 시작 시 저널을 스냅샷으로 압축 (저널이 비어 있으면 그대로 이어서 기록).
+    // 손상된 파일은 읽은 데까지의 값으로 다시 작성
+    if (journal_records != 0 || damaged || access(config->journal_path, F_OK) != 0) {
+        if (store_compact(store) < 0) {
+            return -1;
+        }
+    } else {
+        store->journal_fd = open(config->journal_path, O_WRONLY | O_APPEND);
+        if (store->journal_fd < 0) {
+            perror("open journal");
+            return -1;
+        }
+        store->journal_size = lseek(store->journal_fd, 0, SEEK_END);
+    }
+
+    mib_tree->commit_hook = store_commit_hook;
+    mib_tree->commit_hook_ctx = store;
+    return 0;
+}
+
+// Function to queue a committed value; the caller never waits for the disk.
+// Returns -1 if the record was dropped because the journal could not be written;
+// the value is then saved by the compaction after the next successful flush.
+int store_record_set(SNMPStore *store, MIBNode *node) {
+    if (store->journal_fd < 0) {
+        return 0;
+    }
+
+    int record_len = encode_record(node, store->pending + store->pending_len,
+                                   STORE_PENDING_SIZE - store->pending_len);
+    if (record_len < 0) {
+        // 버퍼가 가득 찬 경우에만 즉시 기록
+        store_flush(store);
+        record_len = encode_record(node, store->pending + store->pending_len,
+                                   STORE_PENDING_SIZE - store->pending_len);
+    }
+
+    if (record_len < 0) {
+        printf("Error: Journal full, value of %s not persisted yet.\n", node->oid);
+        store->drop_count++;
+        store->compact_needed = 1;
+        return -1;
+    }
+
+    store->pending_len += record_len;
+    store->record_count++;
+    return 0;
+}
+
+// Function to write the pending records with a single write + fdatasync (group commit)
+int store_flush(SNMPStore *store) {
+    if (store->journal_fd < 0 || store->pending_len == 0) {
+        return 0;
+    }
+
+    if (write_all(store->journal_fd, store->pending, store->pending_len) < 0 ||
+        fdatasync(store->journal_fd) < 0) {
+        perror("write journal");
+        // 부분 기록된 레코드를 잘라내고 다음 주기에 재시도
+        if (ftruncate(store->journal_fd, store->journal_size) < 0) {
+            perror("ftruncate journal");
+        }
+        return -1;
+    }
+
+    store->journal_size += store->pending_len;
+    store->pending_len = 0;
+    store->flush_count++;
+
+    if (store->journal_size >= store->config.compact_size || store->compact_needed) {
+        return store_compact(store);
+    }
+
+    return 0;
+}
+
+// Event loop timer callback
+void store_flush_timer(void *ctx) {
+    store_flush((SNMPStore *)ctx);
+}
+
+void store_close(SNMPStore *store) {
+    if (store->journal_fd < 0) {
+        return;
+    }
+
+    store_flush(store);
+    close(store->journal_fd);
+    store->journal_fd = -1;
+
+    if (store->mib_tree->commit_hook_ctx == store) {
+        store->mib_tree->commit_hook = NULL;
+        store->mib_tree->commit_hook_ctx = NULL;
+    }
+}
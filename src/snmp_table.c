@@ -0,0 +1,409 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_table.h"  // Conceptual tables
+
+// Function to compare two encoded indexes in OID order
+static int index_compare(const unsigned int *index1, int len1, const unsigned int *index2, int len2) {
+    int len = len1 < len2 ? len1 : len2;
+
+    for (int i = 0; i < len; i++) {
+        if (index1[i] != index2[i]) {
+            return index1[i] < index2[i] ? -1 : 1;
+        }
+    }
+    return (len1 > len2) - (len1 < len2);
+}
+
+// Function to find the first row whose index is >= (or > if after) the key
+static int table_row_bound(const MIBTable *table, const unsigned int *index, int index_len, int after) {
+    int low = 0;
+    int high = table->row_count;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        const MIBTableRow *row = &table->rows[mid];
+        int cmp = index_compare(row->index, row->index_len, index, index_len);
+        if (cmp < 0 || (after && cmp == 0)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Function to note a row added or removed, GETNEXT answers may have changed
+static void table_rows_changed(MIBTable *table) {
+    if (table->mib_tree) {
+        table->mib_tree->structure_epoch++;
+    }
+}
+
+// Function to encode a row key into its instance suffix (RFC 2578 7.7)
+static int encode_index(const MIBTable *table, const MIBIndexValue *values, unsigned int *index) {
+    int len = 0;
+
+    for (int i = 0; i < table->index_count; i++) {
+        const MIBIndexValue *value = &values[i];
+
+        switch (table->index_types[i]) {
+            case MIB_INDEX_INTEGER:
+                if (len + 1 > MIB_TABLE_MAX_SUBIDS) {
+                    return -1;
+                }
+                index[len++] = value->int_value;
+                break;
+
+            case MIB_INDEX_STRING: {
+                int str_len = value->str_value ? strlen(value->str_value) : 0;
+                if (len + 1 + str_len > MIB_TABLE_MAX_SUBIDS) {
+                    return -1;
+                }
+                index[len++] = str_len;
+                for (int j = 0; j < str_len; j++) {
+                    index[len++] = (unsigned char)value->str_value[j];
+                }
+                break;
+            }
+
+            case MIB_INDEX_IP_ADDRESS:
+                if (len + 4 > MIB_TABLE_MAX_SUBIDS) {
+                    return -1;
+                }
+                for (int j = 0; j < 4; j++) {
+                    index[len++] = value->ip_value[j];
+                }
+                break;
+
+            case MIB_INDEX_OID:
+                if (len + 1 + value->oid_len > MIB_TABLE_MAX_SUBIDS) {
+                    return -1;
+                }
+                index[len++] = value->oid_len;
+                for (int j = 0; j < value->oid_len; j++) {
+                    index[len++] = value->oid_value[j];
+                }
+                break;
+        }
+    }
+    return len;
+}
+
+// Function to split an OID under prefix into its sub-identifiers.
+// Returns the total count (may exceed max, only max are stored) or -1 if the
+// OID is not in the subtree.
+static int oid_suffix(const char *oid, const char *prefix, unsigned int *subids, int max) {
+    size_t prefix_len = strlen(prefix);
+    int count = 0;
+
+    if (strncmp(oid, prefix, prefix_len) != 0 || (oid[prefix_len] != '\0' && oid[prefix_len] != '.')) {
+        return -1;
+    }
+
+    const char *cursor = oid + prefix_len;
+    while (*cursor == '.') {
+        char *end;
+        unsigned long value = strtoul(cursor + 1, &end, 10);
+        if (end == cursor + 1) {
+            break;
+        }
+        if (count < max) {
+            subids[count] = (unsigned int)value;
+        }
+        count++;
+        cursor = end;
+    }
+    return count;
+}
+
+int mib_table_init(MIBTable *table, const char *name, const char *oid,
+                   const MIBIndexType *index_types, int index_count) {
+    memset(table, 0, sizeof(MIBTable));
+
+    if (index_count < 1 || index_count > MIB_TABLE_MAX_INDEX) {
+        printf("Error: Table %s must have 1-%d index objects.\n", name, MIB_TABLE_MAX_INDEX);
+        return -1;
+    }
+
+    strncpy(table->name, name, sizeof(table->name) - 1);
+    strncpy(table->oid, oid, sizeof(table->oid) - 1);
+    memcpy(table->index_types, index_types, index_count * sizeof(MIBIndexType));
+    table->index_count = index_count;
+    return 0;
+}
+
+// Function to add a columnar object, columns are kept in subid order
+int mib_table_add_column(MIBTable *table, unsigned int subid, const char *name, const char *type,
+                         MIBColumnHandler handler) {
+    if (table->column_count >= MIB_TABLE_MAX_COLUMNS || handler == NULL) {
+        printf("Error: Cannot add column %s to table %s.\n", name, table->name);
+        return -1;
+    }
+
+    int position = table->column_count;
+    for (int i = 0; i < table->column_count; i++) {
+        if (table->columns[i].subid == subid) {
+            printf("Error: Column %u already exists in table %s.\n", subid, table->name);
+            return -1;
+        }
+        if (table->columns[i].subid > subid) {
+            position = i;
+            break;
+        }
+    }
+
+    memmove(&table->columns[position + 1], &table->columns[position],
+            (table->column_count - position) * sizeof(MIBTableColumn));
+
+    MIBTableColumn *column = &table->columns[position];
+    memset(column, 0, sizeof(MIBTableColumn));
+    column->subid = subid;
+    strncpy(column->name, name, sizeof(column->name) - 1);
+    strncpy(column->type, type, sizeof(column->type) - 1);
+    column->value_type = mib_value_type(type);
+    column->handler = handler;
+    table->column_count++;
+    return 0;
+}
+
+// Function to register the table's entry OID in the MIB tree
+MIBNode *mib_table_register(MIBTree *mib_tree, MIBTable *table) {
+    MIBNode *node = add_mib_node(mib_tree, table->name, table->oid, "SEQUENCE", HANDLER_CAN_RONLY,
+                                 "current", NULL, NULL);
+    if (node) {
+        node->table = table;
+        table->mib_tree = mib_tree;
+    }
+    return node;
+}
+
+// Function to add a row, or replace the context of an existing row with the
+// same key. The returned pointer is valid until the next add or remove.
+MIBTableRow *mib_table_add_row(MIBTable *table, const MIBIndexValue *index, void *data) {
+    unsigned int encoded[MIB_TABLE_MAX_SUBIDS];
+    char digits[16];
+    int instance_len = 0;
+
+    int index_len = encode_index(table, index, encoded);
+    for (int i = 0; i < index_len; i++) {
+        instance_len += snprintf(digits, sizeof(digits), ".%u", encoded[i]);
+    }
+
+    // 셀 OID (엔트리 + 열 번호 + 인덱스)가 MIBNode.oid에 들어가야 함
+    if (index_len < 0 || strlen(table->oid) + 11 + instance_len >= sizeof(((MIBNode *)0)->oid)) {
+        printf("Error: Row index too long for table %s.\n", table->name);
+        return NULL;
+    }
+
+    int position = table_row_bound(table, encoded, index_len, 0);
+    if (position < table->row_count &&
+        index_compare(table->rows[position].index, table->rows[position].index_len, encoded, index_len) == 0) {
+        table->rows[position].data = data;
+        return &table->rows[position];
+    }
+
+    if (table->row_count == table->row_capacity) {
+        int capacity = table->row_capacity ? table->row_capacity * 2 : MIB_TABLE_INITIAL_ROWS;
+        MIBTableRow *rows = (MIBTableRow *)realloc(table->rows, capacity * sizeof(MIBTableRow));
+        if (!rows) {
+            printf("Error: Memory allocation failed.\n");
+            return NULL;
+        }
+        table->rows = rows;
+        table->row_capacity = capacity;
+    }
+
+    memmove(&table->rows[position + 1], &table->rows[position],
+            (table->row_count - position) * sizeof(MIBTableRow));
+
+    MIBTableRow *row = &table->rows[position];
+    memcpy(row->index, encoded, index_len * sizeof(unsigned int));
+    row->index_len = index_len;
+    row->data = data;
+    table->row_count++;
+    table_rows_changed(table);
+    return row;
+}
+
+MIBTableRow *mib_table_find_row(MIBTable *table, const MIBIndexValue *index) {
+    unsigned int encoded[MIB_TABLE_MAX_SUBIDS];
+
+    int index_len = encode_index(table, index, encoded);
+    if (index_len < 0) {
+        return NULL;
+    }
+
+    int position = table_row_bound(table, encoded, index_len, 0);
+    if (position < table->row_count &&
+        index_compare(table->rows[position].index, table->rows[position].index_len, encoded, index_len) == 0) {
+        return &table->rows[position];
+    }
+    return NULL;
+}
+
+int mib_table_remove_row(MIBTable *table, const MIBIndexValue *index) {
+    MIBTableRow *row = mib_table_find_row(table, index);
+    if (!row) {
+        return -1;
+    }
+
+    int position = row - table->rows;
+    memmove(&table->rows[position], &table->rows[position + 1],
+            (table->row_count - position - 1) * sizeof(MIBTableRow));
+    table->row_count--;
+    table_rows_changed(table);
+    return 0;
+}
+
+void mib_table_clear_rows(MIBTable *table) {
+    if (table->row_count > 0) {
+        table->row_count = 0;
+        table_rows_changed(table);
+    }
+}
+
+void mib_table_free(MIBTable *table) {
+    free(table->rows);
+    table->rows = NULL;
+    table->row_count = 0;
+    table->row_capacity = 0;
+}
+
+// Function to build the instance of one cell in a caller provided node,
+// returns -1 if the column handler reports no value for this row
+static int table_fill_cell(const MIBTable *table, const MIBTableColumn *column, const MIBTableRow *row,
+                           MIBNode *cell) {
+    memset(cell, 0, sizeof(MIBNode));
+    if (column->handler(row, column->subid, &cell->value) < 0) {
+        return -1;
+    }
+
+    int pos = snprintf(cell->oid, sizeof(cell->oid), "%s.%u", table->oid, column->subid);
+    for (int i = 0; i < row->index_len && pos < (int)sizeof(cell->oid); i++) {
+        pos += snprintf(cell->oid + pos, sizeof(cell->oid) - pos, ".%u", row->index[i]);
+    }
+
+    strcpy(cell->name, column->name);
+    strcpy(cell->type, column->type);
+    strcpy(cell->status, "current");
+    cell->isWritable = HANDLER_CAN_RONLY;
+    cell->value_type = column->value_type;
+    return 0;
+}
+
+// Function to find the cell with the exact instance OID
+static int table_get_cell(const MIBTable *table, const char *oid, MIBNode *cell) {
+    unsigned int suffix[MIB_TABLE_MAX_SUBIDS + 1];
+
+    int suffix_len = oid_suffix(oid, table->oid, suffix, MIB_TABLE_MAX_SUBIDS + 1);
+    if (suffix_len < 2 || suffix_len > MIB_TABLE_MAX_SUBIDS + 1) {
+        return -1;
+    }
+
+    for (int c = 0; c < table->column_count; c++) {
+        const MIBTableColumn *column = &table->columns[c];
+        if (column->subid != suffix[0]) {
+            continue;
+        }
+
+        int position = table_row_bound(table, suffix + 1, suffix_len - 1, 0);
+        if (position < table->row_count &&
+            index_compare(table->rows[position].index, table->rows[position].index_len,
+                          suffix + 1, suffix_len - 1) == 0) {
+            return table_fill_cell(table, column, &table->rows[position], cell);
+        }
+        return -1;
+    }
+    return -1;
+}
+
+// Function to find the first cell after oid in column-major order.
+// A suffix longer than any index is cut at MIB_TABLE_MAX_SUBIDS + 1; rows
+// cannot fall between the cut and the full OID, so the order is unchanged.
+static int table_next_cell(const MIBTable *table, const char *oid, MIBNode *cell) {
+    unsigned int suffix[MIB_TABLE_MAX_SUBIDS + 1];
+
+    int suffix_len = oid_suffix(oid, table->oid, suffix, MIB_TABLE_MAX_SUBIDS + 1);
+    if (suffix_len < 0) {
+        return -1;
+    }
+    if (suffix_len > MIB_TABLE_MAX_SUBIDS + 1) {
+        suffix_len = MIB_TABLE_MAX_SUBIDS + 1;
+    }
+
+    for (int c = 0; c < table->column_count; c++) {
+        const MIBTableColumn *column = &table->columns[c];
+        int position = 0;
+
+        if (suffix_len > 0) {
+            if (column->subid < suffix[0]) {
+                continue;
+            }
+            if (column->subid == suffix[0]) {
+                position = table_row_bound(table, suffix + 1, suffix_len - 1, 1);
+            }
+        }
+
+        // 값이 없는 셀 (handler가 -1 반환)은 건너뜀
+        for (; position < table->row_count; position++) {
+            if (table_fill_cell(table, column, &table->rows[position], cell) == 0) {
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+// Function to find the scalar or table cell with the exact OID. Table cells
+// are built in *cell; the return value is the node to encode (NULL if none).
+MIBNode *find_mib_instance(MIBTree *mib_tree, const char *oid, MIBNode *cell) {
+    // 마지막으로 oid 이하인 노드: 스칼라 자신 또는 oid를 포함하는 테이블
+    return mib_instance_at(mib_tree, mib_tree_next_index(mib_tree, oid) - 1, oid, cell);
+}
+
+// Function to find the instance with the exact OID under the registry entry
+// at index (the scalar itself or a cell of the table)
+MIBNode *mib_instance_at(MIBTree *mib_tree, int index, const char *oid, MIBNode *cell) {
+    if (index < 0 || index >= mib_tree->node_count) {
+        return NULL;
+    }
+
+    MIBNode *node = mib_tree->nodes[index];
+    if (node->table) {
+        return table_get_cell(node->table, oid, cell) == 0 ? cell : NULL;
+    }
+    return compare_oids(node->oid, oid) == 0 ? node : NULL;
+}
+
+// Function to find the first instance of the registry entry at index after
+// oid (NULL: its first instance)
+MIBNode *mib_next_instance_at(MIBTree *mib_tree, int index, const char *oid, MIBNode *cell) {
+    MIBNode *node = mib_tree->nodes[index];
+
+    if (!node->table) {
+        return oid ? NULL : node;
+    }
+    return table_next_cell(node->table, oid ? oid : node->oid, cell) == 0 ? cell : NULL;
+}
+
+// Function to find the next scalar or table cell after oid (GETNEXT order)
+MIBNode *find_next_mib_instance(MIBTree *mib_tree, const char *oid, MIBNode *cell) {
+    int index = mib_tree_next_index(mib_tree, oid);
+
+    // oid가 테이블 안에 있으면 같은 테이블의 다음 셀부터
+    if (index > 0 && mib_tree->nodes[index - 1]->table &&
+        mib_next_instance_at(mib_tree, index - 1, oid, cell)) {
+        return cell;
+    }
+
+    for (; index < mib_tree->node_count; index++) {
+        MIBNode *node = mib_next_instance_at(mib_tree, index, NULL, cell);
+        if (node) {
+            return node;
+        }
+    }
+    return NULL;
+}
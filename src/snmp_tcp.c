@@ -0,0 +1,403 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "snmp_tcp.h"    // SNMP over TCP
+#include "snmp_addr.h"   // Transport addresses
+#include "snmp_log.h"    // Logging
+
+static void tcp_serve(SNMPTcpServer *server, TcpConnection *conn);
+
+// Function to make room for need more bytes after the pending data,
+// growing the buffer by doubling up to limit bytes
+static int buffer_reserve(TcpBuffer *buffer, int need, int limit) {
+    if (buffer->len + need <= buffer->size) {
+        return 0;
+    }
+
+    // 처리한 앞부분을 버리고 남은 데이터를 앞으로 당김
+    if (buffer->start > 0) {
+        memmove(buffer->data, buffer->data + buffer->start, buffer->len - buffer->start);
+        buffer->len -= buffer->start;
+        buffer->start = 0;
+        if (buffer->len + need <= buffer->size) {
+            return 0;
+        }
+    }
+
+    int size = buffer->size ? buffer->size : TCP_BUFFER_INITIAL;
+    while (size < buffer->len + need) {
+        size *= 2;
+    }
+    if (size > limit) {
+        size = limit;
+        if (size < buffer->len + need) {
+            return -1;
+        }
+    }
+
+    unsigned char *data = realloc(buffer->data, size);
+    if (!data) {
+        return -1;
+    }
+    buffer->data = data;
+    buffer->size = size;
+    return 0;
+}
+
+static void buffer_free(TcpBuffer *buffer) {
+    free(buffer->data);
+    memset(buffer, 0, sizeof(TcpBuffer));
+}
+
+// Function to get the length of the BER message at the head of the stream:
+// 0 while its header is incomplete, -1 if it is not a SEQUENCE
+static long long tcp_message_length(const unsigned char *data, int avail) {
+    if (avail < 2) {
+        return 0;
+    }
+    if (data[0] != 0x30) {
+        return -1;
+    }
+    if (!(data[1] & 0x80)) {
+        return 2 + data[1];
+    }
+
+    int num_len_bytes = data[1] & 0x7F;
+    if (num_len_bytes < 1 || num_len_bytes > 4) {
+        return -1;
+    }
+    if (avail < 2 + num_len_bytes) {
+        return 0;
+    }
+
+    long long len = 0;
+    for (int i = 0; i < num_len_bytes; i++) {
+        len = (len << 8) | data[2 + i];
+    }
+    return 2 + num_len_bytes + len;
+}
+
+static TcpConnection *find_connection(SNMPTcpServer *server, int fd) {
+    for (int i = 0; i < server->config->max_connections; i++) {
+        if (server->connections[i].fd == fd) {
+            return &server->connections[i];
+        }
+    }
+    return NULL;
+}
+
+static void tcp_close_connection(SNMPTcpServer *server, TcpConnection *conn) {
+    event_loop_remove_fd(server->loop, conn->fd);
+    close(conn->fd);
+    buffer_free(&conn->in);
+    buffer_free(&conn->out);
+    conn->fd = -1;
+}
+
+// Function to write queued responses until the socket would block
+static int tcp_flush(TcpConnection *conn) {
+    while (conn->out.start < conn->out.len) {
+        int n = send(conn->fd, conn->out.data + conn->out.start, conn->out.len - conn->out.start,
+                     MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        conn->out.start += n;
+        conn->last_ms = event_loop_now_ms();
+    }
+    conn->out.start = 0;
+    conn->out.len = 0;
+    return 0;
+}
+
+// SNMPTransport send callback: queue a response on the connection and
+// write as much of it as the socket takes now
+static int tcp_send(void *ctx, const unsigned char *data, int len) {
+    TcpConnection *conn = (TcpConnection *)ctx;
+
+    if (buffer_reserve(&conn->out, len, 2 * conn->server->config->max_message) < 0) {
+        log_warn("TCP response of %d bytes dropped: output queue full", len);
+        return -1;
+    }
+    memcpy(conn->out.data + conn->out.len, data, len);
+    conn->out.len += len;
+
+    if (tcp_flush(conn) < 0) {
+        conn->broken = 1;
+        return -1;
+    }
+    return 0;
+}
+
+static void tcp_batch_timer(void *ctx) {
+    SNMPTcpServer *server = (SNMPTcpServer *)ctx;
+
+    server->batch_timer_id = -1;
+    for (int i = 0; i < server->config->max_connections; i++) {
+        TcpConnection *conn = &server->connections[i];
+        if (conn->fd >= 0 && conn->pending) {
+            tcp_serve(server, conn);
+        }
+    }
+}
+
+// Function to serve the complete messages received on a connection, at
+// most TCP_BATCH per call so one pipelining client does not hold up the
+// UDP sockets. Reading stops while more than max_message bytes of
+// responses wait for the client.
+static void tcp_serve(SNMPTcpServer *server, TcpConnection *conn) {
+    int max_message = server->config->max_message;
+    int served = 0;
+
+    conn->pending = 0;
+    while (!conn->broken) {
+        int avail = conn->in.len - conn->in.start;
+        long long length = tcp_message_length(conn->in.data + conn->in.start, avail);
+        if (length < 0 || length > max_message) {
+            char peer[ADDR_STRING_MAX + 8];
+            if (length > max_message) {
+                server->oversize_count++;
+            }
+            log_warn("TCP connection from %s closed: %s", addr_to_string(&conn->addr, peer, sizeof(peer)),
+                     length < 0 ? "not an SNMP message" : "message too large");
+            tcp_close_connection(server, conn);
+            return;
+        }
+        if (length == 0 || length > avail) {
+            break;
+        }
+
+        // 남은 메시지는 타이머와 다른 fd를 처리한 뒤 이어서 처리
+        if (served == TCP_BATCH || conn->out.len - conn->out.start > max_message) {
+            conn->pending = 1;
+            if (server->batch_timer_id < 0 && served == TCP_BATCH) {
+                server->batch_timer_id = event_loop_add_timer(server->loop, 0, 0, tcp_batch_timer, server);
+            }
+            break;
+        }
+
+        SNMPTransport transport = { conn->fd, &conn->addr, server->response, max_message, tcp_send, conn };
+        server->handler(server->handler_ctx, &transport, conn->in.data + conn->in.start, (int)length);
+        conn->in.start += (int)length;
+        served++;
+    }
+
+    if (conn->in.start == conn->in.len) {
+        conn->in.start = 0;
+        conn->in.len = 0;
+    }
+
+    int output = conn->out.len - conn->out.start;
+    if (conn->broken || (conn->eof && !conn->pending && output == 0)) {
+        tcp_close_connection(server, conn);
+        return;
+    }
+
+    // 출력이 밀려 있거나 상대가 송신을 끝냈으면 더 읽지 않음
+    short events = 0;
+    if (!conn->eof && !conn->pending) {
+        events |= POLLIN;
+    }
+    if (output > 0) {
+        events |= POLLOUT;
+    }
+    event_loop_set_fd_events(server->loop, conn->fd, events);
+}
+
+// Function to read what the socket has, once per poll round
+static int tcp_read(SNMPTcpServer *server, TcpConnection *conn) {
+    int limit = server->config->max_message + TCP_BUFFER_INITIAL;
+
+    if (buffer_reserve(&conn->in, TCP_BUFFER_INITIAL, limit) < 0) {
+        return -1;
+    }
+
+    int n = recv(conn->fd, conn->in.data + conn->in.len, conn->in.size - conn->in.len, MSG_DONTWAIT);
+    if (n < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+    if (n == 0) {
+        conn->eof = 1;
+        return 0;
+    }
+    conn->in.len += n;
+    conn->last_ms = event_loop_now_ms();
+    return 0;
+}
+
+static void tcp_connection_handler(int fd, short revents, void *ctx) {
+    SNMPTcpServer *server = (SNMPTcpServer *)ctx;
+    TcpConnection *conn = find_connection(server, fd);
+
+    if (!conn) {
+        return;
+    }
+    if (revents & (POLLERR | POLLNVAL)) {
+        tcp_close_connection(server, conn);
+        return;
+    }
+    if ((revents & POLLOUT) && tcp_flush(conn) < 0) {
+        tcp_close_connection(server, conn);
+        return;
+    }
+    if ((revents & (POLLIN | POLLHUP)) && tcp_read(server, conn) < 0) {
+        tcp_close_connection(server, conn);
+        return;
+    }
+    tcp_serve(server, conn);
+}
+
+static void tcp_accept_handler(int fd, short revents, void *ctx) {
+    SNMPTcpServer *server = (SNMPTcpServer *)ctx;
+    (void)revents;
+
+    for (;;) {
+        struct sockaddr_storage addr;
+        socklen_t len = sizeof(addr);
+        int client = accept(fd, (struct sockaddr *)&addr, &len);
+        if (client < 0) {
+            return;
+        }
+
+        TcpConnection *conn = find_connection(server, -1);
+        if (!conn || event_loop_add_fd(server->loop, client, POLLIN, tcp_connection_handler, server) < 0) {
+            char peer[ADDR_STRING_MAX + 8];
+            log_warn("TCP connection from %s refused: too many connections",
+                     addr_to_string(&addr, peer, sizeof(peer)));
+            server->refuse_count++;
+            close(client);
+            continue;
+        }
+
+        int nodelay = 1;
+        fcntl(client, F_SETFL, fcntl(client, F_GETFL, 0) | O_NONBLOCK);
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        memset(conn, 0, sizeof(TcpConnection));
+        conn->fd = client;
+        conn->server = server;
+        conn->addr = addr;
+        conn->last_ms = event_loop_now_ms();
+        server->accept_count++;
+    }
+}
+
+// Function to close connections idle longer than the configured timeout
+static void tcp_idle_timer(void *ctx) {
+    SNMPTcpServer *server = (SNMPTcpServer *)ctx;
+    long long now = event_loop_now_ms();
+
+    for (int i = 0; i < server->config->max_connections; i++) {
+        TcpConnection *conn = &server->connections[i];
+        if (conn->fd >= 0 && now - conn->last_ms > server->config->idle_timeout_ms) {
+            log_debug("Idle TCP connection closed");
+            tcp_close_connection(server, conn);
+        }
+    }
+}
+
+// Function to open one listening socket ("a.b.c.d[:port]", "[v6][:port]")
+static int open_listen_socket(const char *address, int ipv6_only) {
+    struct sockaddr_storage servaddr;
+    int reuse = 1;
+
+    if (addr_parse(address, SNMP_PORT, &servaddr) < 0) {
+        printf("Error: Invalid TCP listen address %s\n", address);
+        return -1;
+    }
+
+    int sockfd = socket(servaddr.ss_family, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        perror("TCP socket creation failed");
+        return -1;
+    }
+    setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (servaddr.ss_family == AF_INET6 &&
+        setsockopt(sockfd, IPPROTO_IPV6, IPV6_V6ONLY, &ipv6_only, sizeof(ipv6_only)) < 0) {
+        perror("setsockopt IPV6_V6ONLY failed");
+    }
+
+    if (bind(sockfd, (const struct sockaddr *)&servaddr, addr_len(&servaddr)) < 0 ||
+        listen(sockfd, TCP_LISTEN_BACKLOG) < 0) {
+        perror("TCP bind failed");
+        close(sockfd);
+        return -1;
+    }
+    fcntl(sockfd, F_SETFL, fcntl(sockfd, F_GETFL, 0) | O_NONBLOCK);
+    printf("Listening on TCP %s\n", address);
+    return sockfd;
+}
+
+// Function to open the TCP listeners, nothing is opened without tcp_listen addresses
+int tcp_server_init(SNMPTcpServer *server, const SNMPTcpConfig *config, int ipv6_only, EventLoop *loop,
+                    TcpRequestHandler handler, void *handler_ctx) {
+    memset(server, 0, sizeof(SNMPTcpServer));
+    server->config = config;
+    server->loop = loop;
+    server->handler = handler;
+    server->handler_ctx = handler_ctx;
+    server->idle_timer_id = -1;
+    server->batch_timer_id = -1;
+
+    if (config->address_count == 0) {
+        return 0;
+    }
+
+    server->connections = calloc(config->max_connections, sizeof(TcpConnection));
+    server->response = malloc(config->max_message + SNMP_RESPONSE_RESERVE);
+    if (!server->connections || !server->response) {
+        tcp_server_close(server);
+        return -1;
+    }
+    for (int i = 0; i < config->max_connections; i++) {
+        server->connections[i].fd = -1;
+    }
+
+    for (int i = 0; i < config->address_count; i++) {
+        int sockfd = open_listen_socket(config->addresses[i], ipv6_only);
+        if (sockfd < 0) {
+            tcp_server_close(server);
+            return -1;
+        }
+        server->listen_fds[server->listen_count++] = sockfd;
+        event_loop_add_fd(loop, sockfd, POLLIN, tcp_accept_handler, server);
+    }
+
+    server->idle_timer_id = event_loop_add_timer(loop, TCP_IDLE_CHECK_MS, TCP_IDLE_CHECK_MS, tcp_idle_timer, server);
+    return 0;
+}
+
+void tcp_server_close(SNMPTcpServer *server) {
+    if (server->connections) {
+        for (int i = 0; i < server->config->max_connections; i++) {
+            if (server->connections[i].fd >= 0) {
+                tcp_close_connection(server, &server->connections[i]);
+            }
+        }
+    }
+    for (int i = 0; i < server->listen_count; i++) {
+        event_loop_remove_fd(server->loop, server->listen_fds[i]);
+        close(server->listen_fds[i]);
+    }
+    if (server->idle_timer_id >= 0) {
+        event_loop_cancel_timer(server->loop, server->idle_timer_id);
+    }
+    if (server->batch_timer_id >= 0) {
+        event_loop_cancel_timer(server->loop, server->batch_timer_id);
+    }
+
+    free(server->connections);
+    free(server->response);
+    server->connections = NULL;
+    server->response = NULL;
+    server->listen_count = 0;
+}
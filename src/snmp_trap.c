@@ -0,0 +1,284 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "snmp.h"        // Notification encoder
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_trap.h"   // Notification generator
+#include "snmp_inform.h" // InformRequest tracking
+#include "snmp_stats.h"  // Agent counters
+#include "snmp_log.h"    // Logging
+#include "utility.h"     // System utility functions
+
+// Function to find the agent socket that can send to a target: an IPv4
+// target is reached from an IPv4 socket or, as an IPv4-mapped address, from a
+// dual-stack IPv6 socket; an IPv6 target only from an IPv6 socket.
+static int target_socket(const SNMPNotifier *notifier, const struct sockaddr_storage *target,
+                         struct sockaddr_storage *addr) {
+    int mapped_fd = -1;
+
+    for (int i = 0; i < notifier->sockfd_count; i++) {
+        struct sockaddr_storage local;
+        socklen_t len = sizeof(local);
+        if (getsockname(notifier->sockfds[i], (struct sockaddr *)&local, &len) < 0) {
+            continue;
+        }
+        if (local.ss_family == target->ss_family) {
+            *addr = *target;
+            return notifier->sockfds[i];
+        }
+
+        int v6only = 1;
+        len = sizeof(v6only);
+        if (mapped_fd < 0 && local.ss_family == AF_INET6 && target->ss_family == AF_INET &&
+            getsockopt(notifier->sockfds[i], IPPROTO_IPV6, IPV6_V6ONLY, &v6only, &len) == 0 && !v6only) {
+            mapped_fd = notifier->sockfds[i];
+        }
+    }
+
+    if (mapped_fd >= 0) {
+        addr_to_mapped(target, addr);
+    }
+    return mapped_fd;
+}
+
+// Function to resolve the targets and the trigger nodes.
+// Notifications are sent from the agent sockets by the event loop, messages
+// are at most max_message bytes (the UDP buffer size).
+int notifier_init(SNMPNotifier *notifier, const SNMPTrapConfig *config, MIBTree *mib_tree,
+                  EventLoop *loop, const int *sockfds, int sockfd_count, int max_message) {
+    memset(notifier, 0, sizeof(SNMPNotifier));
+    notifier->config = config;
+    notifier->mib_tree = mib_tree;
+    notifier->loop = loop;
+    memcpy(notifier->sockfds, sockfds, sockfd_count * sizeof(int));
+    notifier->sockfd_count = sockfd_count;
+    notifier->next_request_id = 1;
+
+    notifier->pool = malloc((size_t)TRAP_QUEUE_SIZE * max_message);
+    notifier->message = malloc(max_message + SNMP_RESPONSE_RESERVE);
+    if (!notifier->pool || !notifier->message) {
+        notifier_close(notifier);
+        return -1;
+    }
+    notifier->max_message = max_message;
+    for (int i = 0; i < TRAP_QUEUE_SIZE; i++) {
+        notifier->queue[i].data = notifier->pool + (size_t)i * max_message;
+    }
+
+    for (int i = 0; i < config->target_count; i++) {
+        const SNMPTrapTarget *target = &config->targets[i];
+
+        notifier->target_fds[i] = target_socket(notifier, &target->addr, &notifier->target_addrs[i]);
+        if (notifier->target_fds[i] < 0) {
+            printf("Error: No agent socket can reach trap target %s\n", target->host);
+            continue;
+        }
+        notifier->target_valid[i] = 1;
+    }
+
+    for (int i = 0; i < config->trigger_count; i++) {
+        const SNMPTrapTrigger *trigger = &config->triggers[i];
+        MIBNode *node = NULL;
+
+        for (int j = 0; node == NULL && j < mib_tree->node_count; j++) {
+            if (strcmp(mib_tree->nodes[j]->name, trigger->node_name) == 0) {
+                node = mib_tree->nodes[j];
+            }
+        }
+
+        if (node == NULL) {
+            printf("Error: Trap trigger node %s not found.\n", trigger->node_name);
+            continue;
+        }
+        if (trigger->kind == TRAP_TRIGGER_ABOVE && node->value_type != VALUE_TYPE_INT) {
+            printf("Error: Trap threshold on %s requires an INTEGER node.\n", trigger->node_name);
+            continue;
+        }
+
+        notifier->states[i].node = node;
+    }
+
+    return 0;
+}
+
+void notifier_close(SNMPNotifier *notifier) {
+    free(notifier->pool);
+    free(notifier->message);
+    notifier->pool = NULL;
+    notifier->message = NULL;
+    notifier->max_message = 0;
+}
+
+// Function to queue a message; the oldest message is dropped when the queue is full
+void notifier_enqueue(SNMPNotifier *notifier, int target, const unsigned char *data, int len) {
+    if (len > notifier->max_message) {
+        notifier->drop_count++;
+        return;
+    }
+    if (notifier->queue_count == TRAP_QUEUE_SIZE) {
+        notifier->queue_head = (notifier->queue_head + 1) % TRAP_QUEUE_SIZE;
+        notifier->queue_count--;
+        notifier->drop_count++;
+    }
+
+    TrapMessage *message = &notifier->queue[(notifier->queue_head + notifier->queue_count) % TRAP_QUEUE_SIZE];
+    message->target = target;
+    message->len = len;
+    memcpy(message->data, data, len);
+    notifier->queue_count++;
+
+    // 소켓이 쓰기 가능해지면 이벤트 루프에서 전송
+    event_loop_set_fd_events(notifier->loop, notifier->target_fds[target], POLLIN | POLLOUT);
+}
+
+// Function to send a notification carrying the given nodes to every target
+int send_notification(SNMPNotifier *notifier, const char *trap_oid, MIBNode **nodes, int node_count) {
+    static SNMPNotification notification;
+    unsigned char *message = notifier->message;
+    int message_len;
+
+    if (!message) {
+        return -1;
+    }
+
+    // VarBind 저장 공간은 사용하는 만큼만 덮어쓰므로 헤더 필드만 초기화
+    memset(&notification, 0, offsetof(SNMPNotification, varbind_list));
+    strncpy(notification.trap_oid, trap_oid, sizeof(notification.trap_oid) - 1);
+    notification.timestamp = get_system_uptime();
+
+    MIBNode *sys_object_id = find_mib_node_by_oid(notifier->mib_tree, "1.3.6.1.2.1.1.2.0");
+    if (sys_object_id) {
+        MIBValue value;
+        mib_node_read_value(sys_object_id, &value);
+        strncpy(notification.enterprise, value.oid_value, sizeof(notification.enterprise) - 1);
+    }
+    const char *agent_ip = get_current_ip();
+    if (agent_ip) {
+        inet_pton(AF_INET, agent_ip, notification.agent_addr);
+    }
+
+    for (int i = 0; i < node_count && i < MAX_VARBINDS - 2; i++) {
+        mib_node_to_varbind(nodes[i], &notification.varbind_list[notification.varbind_count],
+                            notification.storage[notification.varbind_count]);
+        notification.varbind_count++;
+    }
+
+    for (int i = 0; i < notifier->config->target_count; i++) {
+        const SNMPTrapTarget *target = &notifier->config->targets[i];
+        if (!notifier->target_valid[i]) {
+            continue;
+        }
+
+        notification.version = target->version;
+        notification.pdu_type = target->inform ? 0xA6 : 0xA7; // InformRequest / SNMPv2-Trap
+        notification.request_id = notifier->next_request_id++;
+        strncpy(notification.security_name, target->security_name, sizeof(notification.security_name) - 1);
+
+        if (create_notification(&notification, message, &message_len, notifier->max_message) < 0 ||
+            message_len > notifier->max_message) {
+            log_error("Notification %s too big for %s", trap_oid, target->host);
+            notifier->drop_count++;
+            continue;
+        }
+
+        if (target->inform && notifier->informs) {
+            inform_send(notifier->informs, i, notification.request_id, message, message_len);
+        } else {
+            notifier_enqueue(notifier, i, message, message_len);
+        }
+    }
+
+    return 0;
+}
+
+// Function to send queued messages until the socket would block (POLLOUT handler)
+void notifier_drain(SNMPNotifier *notifier) {
+    while (notifier->queue_count > 0) {
+        TrapMessage *message = &notifier->queue[notifier->queue_head];
+
+        const struct sockaddr_storage *addr = &notifier->target_addrs[message->target];
+        int sockfd = notifier->target_fds[message->target];
+        ssize_t sent = sendto(sockfd, message->data, message->len, MSG_DONTWAIT,
+                              (const struct sockaddr *)addr, addr_len(addr));
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                event_loop_set_fd_events(notifier->loop, sockfd, POLLIN | POLLOUT);
+                return;
+            }
+            log_error("sendto trap: %s", strerror(errno));
+            notifier->drop_count++;
+        } else {
+            notifier->sent_count++;
+            stats_inc(STATS_OUT_PKTS);
+            stats_inc(STATS_OUT_TRAPS);
+        }
+
+        notifier->queue_head = (notifier->queue_head + 1) % TRAP_QUEUE_SIZE;
+        notifier->queue_count--;
+    }
+
+    for (int i = 0; i < notifier->sockfd_count; i++) {
+        event_loop_set_fd_events(notifier->loop, notifier->sockfds[i], POLLIN);
+    }
+}
+
+// Function to compare two values of the given type
+static int mib_value_equal(ValueType type, const MIBValue *a, const MIBValue *b) {
+    switch (type) {
+        case VALUE_TYPE_INT:
+            return a->int_value == b->int_value;
+        case VALUE_TYPE_TIME_TICKS:
+            return a->ticks_value == b->ticks_value;
+        case VALUE_TYPE_STRING:
+            return strcmp(a->str_value, b->str_value) == 0;
+        case VALUE_TYPE_OID:
+            return strcmp(a->oid_value, b->oid_value) == 0;
+        case VALUE_TYPE_COUNTER32:
+        case VALUE_TYPE_GAUGE32:
+            return a->uint_value == b->uint_value;
+        case VALUE_TYPE_COUNTER64:
+            return a->counter64_value == b->counter64_value;
+        case VALUE_TYPE_OCTETS:
+            return a->octets.len == b->octets.len && memcmp(a->octets.data, b->octets.data, a->octets.len) == 0;
+    }
+    return 1;
+}
+
+// Function to evaluate the triggers against the current MIB values.
+// Called by the collectors after each refresh. Threshold triggers fire once
+// when the value rises above the threshold and re-arm when it falls back;
+// change triggers fire on every change.
+void notifier_check_triggers(SNMPNotifier *notifier) {
+    for (int i = 0; i < notifier->config->trigger_count; i++) {
+        const SNMPTrapTrigger *trigger = &notifier->config->triggers[i];
+        TrapTriggerState *state = &notifier->states[i];
+        MIBValue value;
+
+        if (state->node == NULL) {
+            continue;
+        }
+
+        mib_node_read_value(state->node, &value);
+
+        if (trigger->kind == TRAP_TRIGGER_ABOVE) {
+            int above = value.int_value > trigger->threshold;
+            if (above && !state->above) {
+                log_info("Trap: %s = %d exceeds %d", trigger->node_name, value.int_value, trigger->threshold);
+                send_notification(notifier, SNMP_TRAP_THRESHOLD_EXCEEDED, &state->node, 1);
+            }
+            state->above = above;
+        } else {
+            if (state->initialized && !mib_value_equal(state->node->value_type, &state->last_value, &value)) {
+                log_info("Trap: %s changed", trigger->node_name);
+                send_notification(notifier, SNMP_TRAP_VALUE_CHANGED, &state->node, 1);
+            }
+            state->last_value = value;
+            state->initialized = 1;
+        }
+    }
+}
@@ -0,0 +1,493 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "snmp_usm.h"    // User-based security model
+#include "snmp.h"        // generate_engine_id
+#include "snmp_parse.h"  // read_tlv
+#include "snmp_event.h"  // Monotonic clock
+#include "snmp_log.h"    // Logging
+
+#define USM_HASH_BLOCK  64      // MD5 / SHA-1 block size
+#define USM_ENGINE_ID_LEN 10    // generate_engine_id output
+
+// 로컬 SNMP 엔진 (권한 엔진) 상태
+static unsigned char engine_id[USM_ENGINE_ID_LEN];
+static int engine_boots;
+static long long engine_start_ms;
+
+// -- MD5 (RFC 1321)
+
+typedef struct {
+    unsigned int state[4];
+    unsigned long long length;         // Bytes hashed
+    unsigned char block[USM_HASH_BLOCK];
+    int block_len;
+} Md5Context;
+
+#define MD5_ROTATE(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void md5_transform(unsigned int state[4], const unsigned char block[USM_HASH_BLOCK]) {
+    static const unsigned int k[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+    static const int r[64] = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+    };
+    unsigned int w[16];
+    for (int i = 0; i < 16; i++) {
+        w[i] = block[i * 4] | (block[i * 4 + 1] << 8) | (block[i * 4 + 2] << 16) |
+               ((unsigned int)block[i * 4 + 3] << 24);
+    }
+
+    unsigned int a = state[0], b = state[1], c = state[2], d = state[3];
+    for (int i = 0; i < 64; i++) {
+        unsigned int f;
+        int g;
+        if (i < 16) {
+            f = (b & c) | (~b & d);
+            g = i;
+        } else if (i < 32) {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) % 16;
+        } else if (i < 48) {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) % 16;
+        } else {
+            f = c ^ (b | ~d);
+            g = (7 * i) % 16;
+        }
+        unsigned int temp = d;
+        d = c;
+        c = b;
+        b = b + MD5_ROTATE(a + f + k[i] + w[g], r[i]);
+        a = temp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+static void md5_init(Md5Context *ctx) {
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xefcdab89;
+    ctx->state[2] = 0x98badcfe;
+    ctx->state[3] = 0x10325476;
+    ctx->length = 0;
+    ctx->block_len = 0;
+}
+
+static void md5_update(Md5Context *ctx, const unsigned char *data, int len) {
+    ctx->length += len;
+    while (len > 0) {
+        int n = USM_HASH_BLOCK - ctx->block_len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&ctx->block[ctx->block_len], data, n);
+        ctx->block_len += n;
+        data += n;
+        len -= n;
+        if (ctx->block_len == USM_HASH_BLOCK) {
+            md5_transform(ctx->state, ctx->block);
+            ctx->block_len = 0;
+        }
+    }
+}
+
+static void md5_final(Md5Context *ctx, unsigned char digest[16]) {
+    unsigned long long bits = ctx->length * 8;
+    unsigned char pad = 0x80;
+    md5_update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->block_len != 56) {
+        md5_update(ctx, &pad, 1);
+    }
+    unsigned char length_le[8];
+    for (int i = 0; i < 8; i++) {
+        length_le[i] = (bits >> (8 * i)) & 0xFF;
+    }
+    md5_update(ctx, length_le, 8);
+
+    for (int i = 0; i < 16; i++) {
+        digest[i] = (ctx->state[i / 4] >> (8 * (i % 4))) & 0xFF;
+    }
+}
+
+// -- SHA-1 (RFC 3174)
+
+typedef struct {
+    unsigned int state[5];
+    unsigned long long length;         // Bytes hashed
+    unsigned char block[USM_HASH_BLOCK];
+    int block_len;
+} Sha1Context;
+
+#define SHA1_ROTATE(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void sha1_transform(unsigned int state[5], const unsigned char block[USM_HASH_BLOCK]) {
+    unsigned int w[80];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((unsigned int)block[i * 4] << 24) | (block[i * 4 + 1] << 16) |
+               (block[i * 4 + 2] << 8) | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 80; i++) {
+        w[i] = SHA1_ROTATE(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    unsigned int a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; i++) {
+        unsigned int f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5a827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ed9eba1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8f1bbcdc;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xca62c1d6;
+        }
+        unsigned int temp = SHA1_ROTATE(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = SHA1_ROTATE(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+static void sha1_init(Sha1Context *ctx) {
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xefcdab89;
+    ctx->state[2] = 0x98badcfe;
+    ctx->state[3] = 0x10325476;
+    ctx->state[4] = 0xc3d2e1f0;
+    ctx->length = 0;
+    ctx->block_len = 0;
+}
+
+static void sha1_update(Sha1Context *ctx, const unsigned char *data, int len) {
+    ctx->length += len;
+    while (len > 0) {
+        int n = USM_HASH_BLOCK - ctx->block_len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&ctx->block[ctx->block_len], data, n);
+        ctx->block_len += n;
+        data += n;
+        len -= n;
+        if (ctx->block_len == USM_HASH_BLOCK) {
+            sha1_transform(ctx->state, ctx->block);
+            ctx->block_len = 0;
+        }
+    }
+}
+
+static void sha1_final(Sha1Context *ctx, unsigned char digest[20]) {
+    unsigned long long bits = ctx->length * 8;
+    unsigned char pad = 0x80;
+    sha1_update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->block_len != 56) {
+        sha1_update(ctx, &pad, 1);
+    }
+    unsigned char length_be[8];
+    for (int i = 0; i < 8; i++) {
+        length_be[i] = (bits >> (56 - 8 * i)) & 0xFF;
+    }
+    sha1_update(ctx, length_be, 8);
+
+    for (int i = 0; i < 20; i++) {
+        digest[i] = (ctx->state[i / 4] >> (24 - 8 * (i % 4))) & 0xFF;
+    }
+}
+
+// -- 프로토콜별 해시
+
+// 해시 하나를 MD5/SHA-1 어느 쪽이든 같은 방식으로 계산하기 위한 상태
+typedef struct {
+    int protocol;
+    Md5Context md5;
+    Sha1Context sha1;
+} UsmHash;
+
+static int hash_length(int protocol) {
+    return protocol == USM_AUTH_SHA ? 20 : 16;
+}
+
+static void hash_init(UsmHash *hash, int protocol) {
+    hash->protocol = protocol;
+    if (protocol == USM_AUTH_SHA) {
+        sha1_init(&hash->sha1);
+    } else {
+        md5_init(&hash->md5);
+    }
+}
+
+static void hash_update(UsmHash *hash, const unsigned char *data, int len) {
+    if (hash->protocol == USM_AUTH_SHA) {
+        sha1_update(&hash->sha1, data, len);
+    } else {
+        md5_update(&hash->md5, data, len);
+    }
+}
+
+static void hash_final(UsmHash *hash, unsigned char *digest) {
+    if (hash->protocol == USM_AUTH_SHA) {
+        sha1_final(&hash->sha1, digest);
+    } else {
+        md5_final(&hash->md5, digest);
+    }
+}
+
+// Function to compute HMAC-MD5-96 / HMAC-SHA-96 of a message (RFC 3414 6.3, 7.3)
+static void hmac_96(int protocol, const unsigned char *key, const unsigned char *message, int message_len,
+                    unsigned char mac[USM_AUTH_PARAMS_LEN]) {
+    unsigned char pad[USM_HASH_BLOCK];
+    unsigned char digest[20];
+    int key_len = hash_length(protocol);
+    UsmHash hash;
+
+    // 안쪽 해시: H(K XOR ipad, message)
+    memset(pad, 0x36, sizeof(pad));
+    for (int i = 0; i < key_len; i++) {
+        pad[i] ^= key[i];
+    }
+    hash_init(&hash, protocol);
+    hash_update(&hash, pad, sizeof(pad));
+    hash_update(&hash, message, message_len);
+    hash_final(&hash, digest);
+
+    // 바깥 해시: H(K XOR opad, 안쪽 해시)
+    memset(pad, 0x5c, sizeof(pad));
+    for (int i = 0; i < key_len; i++) {
+        pad[i] ^= key[i];
+    }
+    hash_init(&hash, protocol);
+    hash_update(&hash, pad, sizeof(pad));
+    hash_update(&hash, digest, hash_length(protocol));
+    hash_final(&hash, digest);
+
+    memcpy(mac, digest, USM_AUTH_PARAMS_LEN);
+}
+
+// Function to turn a password into a key localized to this engine
+// (RFC 3414 A.2: hash of 1 MB of the repeated password, then H(Ku || engineID || Ku))
+static void localize_key(int protocol, const char *password, unsigned char *key) {
+    int password_len = strlen(password);
+    unsigned char chunk[USM_HASH_BLOCK];
+    unsigned char ku[20];
+    int key_len = hash_length(protocol);
+    UsmHash hash;
+
+    hash_init(&hash, protocol);
+    int password_index = 0;
+    for (int count = 0; count < 1048576; count += USM_HASH_BLOCK) {
+        for (int i = 0; i < USM_HASH_BLOCK; i++) {
+            chunk[i] = password[password_index++ % password_len];
+        }
+        hash_update(&hash, chunk, USM_HASH_BLOCK);
+    }
+    hash_final(&hash, ku);
+
+    hash_init(&hash, protocol);
+    hash_update(&hash, ku, key_len);
+    hash_update(&hash, engine_id, sizeof(engine_id));
+    hash_update(&hash, ku, key_len);
+    hash_final(&hash, key);
+}
+
+// Function to map an authentication protocol name (MD5, SHA) to USM_AUTH_*, -1 if unknown
+int usm_auth_protocol(const char *name) {
+    if (name == NULL) {
+        return USM_AUTH_NONE;
+    }
+    if (strcasecmp(name, "MD5") == 0) {
+        return USM_AUTH_MD5;
+    }
+    if (strcasecmp(name, "SHA") == 0 || strcasecmp(name, "SHA1") == 0) {
+        return USM_AUTH_SHA;
+    }
+    return -1;
+}
+
+// Function to load and advance snmpEngineBoots (kept in a file across restarts)
+static int advance_engine_boots(const char *path) {
+    int boots = 0;
+
+    FILE *file = fopen(path, "r");
+    if (file) {
+        if (fscanf(file, "%d", &boots) != 1 || boots < 0) {
+            boots = 0;
+        }
+        fclose(file);
+    }
+
+    // 최대값에 도달하면 그대로 유지 (인증된 요청은 모두 notInTimeWindow)
+    if (boots < USM_MAX_ENGINE_BOOTS) {
+        boots++;
+    }
+
+    file = fopen(path, "w");
+    if (file == NULL || fprintf(file, "%d\n", boots) < 0) {
+        log_warn("Failed to save snmpEngineBoots to %s", path);
+    }
+    if (file) {
+        fclose(file);
+    }
+    return boots;
+}
+
+// Function to set up the local engine (ID, boots, time) and localize the
+// authentication key of every user to it
+int usm_init(SNMPUsmPolicy *policy) {
+    generate_engine_id(engine_id);
+    engine_boots = advance_engine_boots(policy->boots_path);
+    engine_start_ms = event_loop_now_ms();
+
+    for (int i = 0; i < policy->user_count; i++) {
+        SNMPUsmUser *user = &policy->users[i];
+        if (user->auth_algorithm != USM_AUTH_NONE) {
+            localize_key(user->auth_algorithm, user->auth_password, user->auth_key);
+        }
+    }
+
+    log_info("SNMP engine boots %d", engine_boots);
+    return 0;
+}
+
+// Function to copy the local snmpEngineID, returns its length
+int usm_engine_id(unsigned char *id) {
+    memcpy(id, engine_id, sizeof(engine_id));
+    return sizeof(engine_id);
+}
+
+int usm_engine_boots(void) {
+    return engine_boots;
+}
+
+// Function to get snmpEngineTime (seconds since the engine started)
+int usm_engine_time(void) {
+    return (int)((event_loop_now_ms() - engine_start_ms) / 1000);
+}
+
+// Function to check that an authenticated message is in the time window
+// of the local engine (RFC 3414 3.2.7 a)
+int usm_check_time(int boots, int engine_time) {
+    if (engine_boots == USM_MAX_ENGINE_BOOTS || boots != engine_boots) {
+        return USM_TIME_NOT_IN_WINDOW;
+    }
+    int difference = engine_time - usm_engine_time();
+    if (difference > USM_TIME_WINDOW || difference < -USM_TIME_WINDOW) {
+        return USM_TIME_NOT_IN_WINDOW;
+    }
+    return USM_TIME_OK;
+}
+
+// Function to find msgAuthenticationParameters in an encoded SNMPv3 message,
+// returns the offset of its contents or -1
+static int find_auth_params(const unsigned char *message, int message_len, int *params_len) {
+    int index = 0;
+    unsigned char tag;
+    int length;
+
+    if (read_tlv(message, message_len, &index, &tag, &length) < 0 || tag != 0x30) {
+        return -1;
+    }
+    int end = index + length;
+
+    // msgVersion, msgGlobalData
+    for (int i = 0; i < 2; i++) {
+        if (read_tlv(message, end, &index, &tag, &length) < 0) {
+            return -1;
+        }
+        index += length;
+    }
+
+    // msgSecurityParameters (OCTET STRING로 감싼 UsmSecurityParameters SEQUENCE)
+    if (read_tlv(message, end, &index, &tag, &length) < 0 || tag != 0x04) {
+        return -1;
+    }
+    if (read_tlv(message, index + length, &index, &tag, &length) < 0 || tag != 0x30) {
+        return -1;
+    }
+    end = index + length;
+
+    // msgAuthoritativeEngineID, Boots, Time, msgUserName
+    for (int i = 0; i < 4; i++) {
+        if (read_tlv(message, end, &index, &tag, &length) < 0) {
+            return -1;
+        }
+        index += length;
+    }
+
+    if (read_tlv(message, end, &index, &tag, &length) < 0 || tag != 0x04) {
+        return -1;
+    }
+    *params_len = length;
+    return index;
+}
+
+// Function to verify the HMAC of an incoming message (RFC 3414 6.3.2, 7.3.2).
+// msgAuthenticationParameters is zeroed in place for the digest; returns 0
+// if it matches the user's localized key, -1 otherwise
+int usm_authenticate(const SNMPUsmUser *user, unsigned char *message, int message_len) {
+    int params_len;
+    int offset = find_auth_params(message, message_len, &params_len);
+    if (offset < 0 || params_len != USM_AUTH_PARAMS_LEN || user->auth_algorithm == USM_AUTH_NONE) {
+        return -1;
+    }
+
+    unsigned char received[USM_AUTH_PARAMS_LEN];
+    unsigned char expected[USM_AUTH_PARAMS_LEN];
+    memcpy(received, &message[offset], USM_AUTH_PARAMS_LEN);
+    memset(&message[offset], 0, USM_AUTH_PARAMS_LEN);
+
+    hmac_96(user->auth_algorithm, user->auth_key, message, message_len, expected);
+
+    // 비교 시간이 일치하는 바이트 수에 따라 달라지지 않도록 끝까지 비교
+    unsigned char difference = 0;
+    for (int i = 0; i < USM_AUTH_PARAMS_LEN; i++) {
+        difference |= received[i] ^ expected[i];
+    }
+    return difference == 0 ? 0 : -1;
+}
+
+// Function to sign an outgoing message whose msgAuthenticationParameters
+// holds USM_AUTH_PARAMS_LEN zero bytes, returns -1 if there is no such field
+int usm_sign(const SNMPUsmUser *user, unsigned char *message, int message_len) {
+    int params_len;
+    int offset = find_auth_params(message, message_len, &params_len);
+    if (offset < 0 || params_len != USM_AUTH_PARAMS_LEN || user->auth_algorithm == USM_AUTH_NONE) {
+        return -1;
+    }
+
+    unsigned char mac[USM_AUTH_PARAMS_LEN];
+    hmac_96(user->auth_algorithm, user->auth_key, message, message_len, mac);
+    memcpy(&message[offset], mac, USM_AUTH_PARAMS_LEN);
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "snmp_mib.h"    // MIB tree structures and functions
+#include "snmp_table.h"  // Conceptual tables
+#include "snmp_acl.h"    // Compiled views
+#include "snmp_vacm.h"   // VACM MIB tables
+
+// vacmSecurityLevel 값 (1: noAuthNoPriv, 2: authNoPriv, 3: authPriv)
+static int vacm_security_level(int security_level) {
+    return security_level == SNMP_SEC_LEVEL_AUTHPRIV ? 3 : security_level + 1;
+}
+
+// vacmContextTable 열 (인덱스: vacmContextName)
+static int context_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    switch (column) {
+        case 1: strcpy(value->str_value, (const char *)row->data); break;          // vacmContextName
+        default: return -1;
+    }
+    return 0;
+}
+
+// vacmSecurityToGroupTable 열 (인덱스: vacmSecurityModel, vacmSecurityName)
+static int group_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const SNMPVacmGroup *group = (const SNMPVacmGroup *)row->data;
+
+    switch (column) {
+        case 3: strcpy(value->str_value, group->group); break;                    // vacmGroupName
+        case 4: value->int_value = VACM_STORAGE_READ_ONLY; break;                  // vacmSecurityToGroupStorageType
+        case 5: value->int_value = VACM_STATUS_ACTIVE; break;                      // vacmSecurityToGroupStatus
+        default: return -1;
+    }
+    return 0;
+}
+
+// vacmAccessTable 열 (인덱스: vacmGroupName, vacmAccessContextPrefix,
+// vacmAccessSecurityModel, vacmAccessSecurityLevel)
+static int access_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const SNMPVacmAccess *access = (const SNMPVacmAccess *)row->data;
+
+    switch (column) {
+        case 4: value->int_value = access->prefix_match ? 2 : 1; break;           // vacmAccessContextMatch
+        case 5: strcpy(value->str_value, access->read_view); break;               // vacmAccessReadViewName
+        case 6: strcpy(value->str_value, access->write_view); break;              // vacmAccessWriteViewName
+        case 7: strcpy(value->str_value, access->notify_view); break;             // vacmAccessNotifyViewName
+        case 8: value->int_value = VACM_STORAGE_READ_ONLY; break;                  // vacmAccessStorageType
+        case 9: value->int_value = VACM_STATUS_ACTIVE; break;                      // vacmAccessStatus
+        default: return -1;
+    }
+    return 0;
+}
+
+// vacmViewTreeFamilyTable 열 (인덱스: vacmViewTreeFamilyViewName, vacmViewTreeFamilySubtree)
+static int family_column(const MIBTableRow *row, unsigned int column, MIBValue *value) {
+    const ViewFamily *family = (const ViewFamily *)row->data;
+
+    switch (column) {
+        case 3:                                                                    // vacmViewTreeFamilyMask
+            memcpy(value->octets.data, family->mask, family->mask_len);
+            value->octets.len = family->mask_len;
+            break;
+        case 4: value->int_value = family->included ? 1 : 2; break;               // vacmViewTreeFamilyType
+        case 5: value->int_value = VACM_STORAGE_READ_ONLY; break;                  // vacmViewTreeFamilyStorageType
+        case 6: value->int_value = VACM_STATUS_ACTIVE; break;                      // vacmViewTreeFamilyStatus
+        default: return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    unsigned int subid;
+    const char *name;
+    const char *type;
+} VacmColumn;
+
+// 인덱스 열은 not-accessible이라 등록하지 않음 (vacmContextName 제외)
+static const VacmColumn context_columns[] = {
+    { 1, "vacmContextName", "DisplayString" },
+};
+
+static const VacmColumn group_columns[] = {
+    { 3, "vacmGroupName",                  "DisplayString" },
+    { 4, "vacmSecurityToGroupStorageType", "INTEGER" },
+    { 5, "vacmSecurityToGroupStatus",      "INTEGER" },
+};
+
+static const VacmColumn access_columns[] = {
+    { 4, "vacmAccessContextMatch",   "INTEGER" },
+    { 5, "vacmAccessReadViewName",   "DisplayString" },
+    { 6, "vacmAccessWriteViewName",  "DisplayString" },
+    { 7, "vacmAccessNotifyViewName", "DisplayString" },
+    { 8, "vacmAccessStorageType",    "INTEGER" },
+    { 9, "vacmAccessStatus",         "INTEGER" },
+};
+
+static const VacmColumn family_columns[] = {
+    { 3, "vacmViewTreeFamilyMask",        "Octets" },
+    { 4, "vacmViewTreeFamilyType",        "INTEGER" },
+    { 5, "vacmViewTreeFamilyStorageType", "INTEGER" },
+    { 6, "vacmViewTreeFamilyStatus",      "INTEGER" },
+};
+
+static int register_table(MIBTree *mib_tree, MIBTable *table, const char *name, const char *entry,
+                          const MIBIndexType *index_types, int index_count,
+                          const VacmColumn *columns, int column_count, MIBColumnHandler handler) {
+    char oid[64];
+
+    snprintf(oid, sizeof(oid), "%s.%s", VACM_MIB_OID, entry);
+    if (mib_table_init(table, name, oid, index_types, index_count) < 0) {
+        return -1;
+    }
+    for (int i = 0; i < column_count; i++) {
+        mib_table_add_column(table, columns[i].subid, columns[i].name, columns[i].type, handler);
+    }
+    return mib_table_register(mib_tree, table) ? 0 : -1;
+}
+
+// Function to register the VACM tables with one row per configured entry
+int vacm_tables_init(SNMPVacmTables *tables, MIBTree *mib_tree, const SNMPAgentConfig *config,
+                     const SNMPAccessControl *acl) {
+    static const char default_context[] = "";
+    MIBIndexType context_index = MIB_INDEX_STRING;
+    MIBIndexType group_index[2] = { MIB_INDEX_INTEGER, MIB_INDEX_STRING };
+    MIBIndexType access_index[4] = { MIB_INDEX_STRING, MIB_INDEX_STRING, MIB_INDEX_INTEGER, MIB_INDEX_INTEGER };
+    MIBIndexType family_index[2] = { MIB_INDEX_STRING, MIB_INDEX_OID };
+    const SNMPVacmConfig *vacm = &config->vacm;
+
+    memset(tables, 0, sizeof(SNMPVacmTables));
+
+    if (register_table(mib_tree, &tables->context_table, "vacmContextEntry", "1.1", &context_index, 1,
+                       context_columns, sizeof(context_columns) / sizeof(context_columns[0]), context_column) < 0 ||
+        register_table(mib_tree, &tables->group_table, "vacmSecurityToGroupEntry", "2.1", group_index, 2,
+                       group_columns, sizeof(group_columns) / sizeof(group_columns[0]), group_column) < 0 ||
+        register_table(mib_tree, &tables->access_table, "vacmAccessEntry", "4.1", access_index, 4,
+                       access_columns, sizeof(access_columns) / sizeof(access_columns[0]), access_column) < 0 ||
+        register_table(mib_tree, &tables->family_table, "vacmViewTreeFamilyEntry", "5.2.1", family_index, 2,
+                       family_columns, sizeof(family_columns) / sizeof(family_columns[0]), family_column) < 0) {
+        return -1;
+    }
+
+    MIBIndexValue index[4];
+    memset(index, 0, sizeof(index));
+
+    index[0].str_value = default_context;
+    mib_table_add_row(&tables->context_table, index, (void *)default_context);
+    for (int i = 0; i < vacm->context_count; i++) {
+        index[0].str_value = vacm->contexts[i];
+        mib_table_add_row(&tables->context_table, index, (void *)vacm->contexts[i]);
+    }
+
+    for (int i = 0; i < vacm->group_count; i++) {
+        index[0].int_value = (unsigned int)vacm->groups[i].security_model;
+        index[1].str_value = vacm->groups[i].security_name;
+        mib_table_add_row(&tables->group_table, index, (void *)&vacm->groups[i]);
+    }
+
+    for (int i = 0; i < vacm->access_count; i++) {
+        const SNMPVacmAccess *access = &vacm->access[i];
+        index[0].str_value = access->group;
+        index[1].str_value = access->context;
+        index[2].int_value = (unsigned int)access->security_model;
+        index[3].int_value = (unsigned int)vacm_security_level(access->security_level);
+        mib_table_add_row(&tables->access_table, index, (void *)access);
+    }
+
+    for (int i = 0; i < acl->view_count; i++) {
+        const SNMPView *view = &acl->views[i];
+        for (int j = 0; j < view->family_count; j++) {
+            index[0].str_value = view->name;
+            index[1].oid_value = view->families[j].subtree;
+            index[1].oid_len = view->families[j].subtree_len;
+            mib_table_add_row(&tables->family_table, index, (void *)&view->families[j]);
+        }
+    }
+    return 0;
+}
+
+void vacm_tables_close(SNMPVacmTables *tables) {
+    mib_table_free(&tables->context_table);
+    mib_table_free(&tables->group_table);
+    mib_table_free(&tables->access_table);
+    mib_table_free(&tables->family_table);
+}
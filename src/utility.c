@@ -6,6 +6,7 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <arpa/inet.h>
+#include <dirent.h>
 
 #include "utility.h"
 
@@ -252,72 +253,55 @@ int read_cpu_times(unsigned long long *idle_time, unsigned long long *total_time
     return 0;
 }
 
-int get_cpuUsage() {
-    char buffer[128];
-    FILE *fp = popen("top -bn1 | grep \"CPU:\"", "r");
+// Function to read the 1, 5 and 15 minute load averages as load x 100 (UCD-SNMP laLoadInt).
+// /proc/loadavg always prints two decimals, so no floating point is needed.
+int read_load_averages(int *load_1min, int *load_5min, int *load_15min) {
+    FILE *fp = fopen("/proc/loadavg", "r");
     if (fp == NULL) {
-        perror("Failed to run top command");
-        return -1;
-    }
-
-    // Read the output of the command
-    if (fgets(buffer, sizeof(buffer), fp) == NULL) {
-        perror("Failed to read command output");
-        pclose(fp);
+        perror("Failed to open /proc/loadavg");
         return -1;
     }
-    pclose(fp);
 
-    double user, system, idle;
-    if (sscanf(buffer, "CPU: %lf%% usr %lf%% sys %*f%% nic %lf%% idle", &user, &system, &idle) != 3) {
-        fprintf(stderr, "Failed to parse CPU usage\n");
+    unsigned int whole[3], fraction[3];
+    if (fscanf(fp, "%u.%2u %u.%2u %u.%2u", &whole[0], &fraction[0], &whole[1], &fraction[1],
+               &whole[2], &fraction[2]) != 6) {
+        perror("Failed to read /proc/loadavg");
+        fclose(fp);
         return -1;
     }
+    fclose(fp);
 
-    // Calculate the CPU usage as 100% minus idle percentage
-    int cpu_usage = (int)(100.0 - idle);
+    *load_1min = (int)(whole[0] * 100 + fraction[0]);
+    *load_5min = (int)(whole[1] * 100 + fraction[1]);
+    *load_15min = (int)(whole[2] * 100 + fraction[2]);
+    return 0;
+}
 
-    return cpu_usage;
+// Function to format a load x 100 value as the legacy "0.52" string
+void format_load_average(int load, char *buffer, size_t size) {
+    snprintf(buffer, size, "%d.%02d", load / 100, load % 100);
 }
 
 char* get_cpu_load(int duration) {
-    FILE *fp = fopen("/proc/loadavg", "r");
-    if (fp == NULL) {
-        perror("Failed to open /proc/loadavg");
-        return NULL;
-    }
+    static char result[16];
+    int load[3];
 
-    double load_1min, load_5min, load_15min;
-    // Read the first three values from /proc/loadavg
-    if (fscanf(fp, "%lf %lf %lf", &load_1min, &load_5min, &load_15min) != 3) {
-        perror("Failed to read /proc/loadavg");
-        fclose(fp);
+    if (read_load_averages(&load[0], &load[1], &load[2]) < 0) {
         return NULL;
     }
 
-    fclose(fp);
-
-    double selected_load;
     // Select the appropriate load average based on the duration
     if (duration == 1) {
-        selected_load = load_1min;
+        format_load_average(load[0], result, sizeof(result));
     } else if (duration == 5) {
-        selected_load = load_5min;
+        format_load_average(load[1], result, sizeof(result));
     } else if (duration == 15) {
-        selected_load = load_15min;
+        format_load_average(load[2], result, sizeof(result));
     } else {
         fprintf(stderr, "Invalid duration. Use 1, 5, or 15.\n");
         return NULL;
     }
 
-    // Convert the selected load average to a string
-    char *result = (char *)malloc(16); // Allocate memory for the result string
-    if (result == NULL) {
-        perror("Failed to allocate memory");
-        return NULL;
-    }
-
-    snprintf(result, 16, "%.2f", selected_load); // Format the load average to a string with 2 decimal places
     return result;
 }
 
@@ -379,17 +363,21 @@ int get_memory_usage() {
 }
 
 char* check_sdcard_installed() {
-    FILE *fp = popen("ls /dev/mmcblk*", "r");
-    if (fp == NULL) {
+    DIR *dir = opendir("/dev");
+    if (dir == NULL) {
         return "not installed";
     }
 
-    char buffer[128];
-    if (fgets(buffer, sizeof(buffer), fp) != NULL) {
-        pclose(fp);
-        return "installed";
-    } else {
-        pclose(fp);
-        return "not installed";
+    // /dev/mmcblk* 장치가 하나라도 있으면 설치된 것으로 판단
+    struct dirent *entry;
+    int found = 0;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "mmcblk", 6) == 0) {
+            found = 1;
+            break;
+        }
     }
+
+    closedir(dir);
+    return found ? "installed" : "not installed";
 }